@@ -16,6 +16,7 @@
 #include "Game.h"
 #include "GameCVars.h"
 #include "Actor.h"
+#include "GameNetProfiler.h"
 #include "ScriptBind_Actor.h"
 #include "ISerialize.h"
 #include "GameUtils.h"
@@ -1393,10 +1394,16 @@ void CActor::Update(SEntityUpdateContext& ctx, int slot)
 	{
 		IScriptTable* pScriptTable = GetEntity()->GetScriptTable();
 		if (pScriptTable)
-			pScriptTable->GetValue("actorStats", m_actorStats);
+		{
+			if (pScriptTable->GetValue("actorStats", m_actorStats))
+				m_scriptStats.Invalidate();
+		}
 	}
 	if (!(!m_actorStats))
-		UpdateScriptStats(m_actorStats);
+	{
+		UpdateScriptStats(m_scriptStats);
+		m_scriptStats.Flush(m_actorStats);
+	}
 
 	EntityId currentItemId=GetCurrentItemId();
 	if (currentItemId!=m_lastItemId)
@@ -1424,33 +1431,33 @@ bool CActor::IsRemote() const
 }
 // ~PLAYERPREDICTION
 
-void CActor::UpdateScriptStats(SmartScriptTable &rTable)
+//only changed values are written to the script table, see CActorScriptStats::Flush
+void CActor::UpdateScriptStats(CActorScriptStats &stats)
 {
-	CScriptSetGetChain stats(rTable);
-	stats.SetValue("stance",m_stance);
-	stats.SetValue("thirdPerson",IsThirdPerson());
+	stats.Set(eASS_Stance,(int)m_stance);
+	stats.Set(eASS_ThirdPerson,IsThirdPerson());
 
 	SActorStats *pStats = GetActorStats();
 	if (pStats)
 	{
 		//REUSE_VECTOR(rTable, "velocity", pStats->velocity);
 	
-		stats.SetValue("inAir",pStats->inAir);
-		stats.SetValue("onGround",pStats->onGround);
+		stats.Set(eASS_InAir,pStats->inAir);
+		stats.Set(eASS_OnGround,pStats->onGround);
 
 		//stats.SetValue("inWater",pStats->inWater);
 		//pStats->headUnderWater.SetDirtyValue(stats, "headUnderWater");
 		//stats.SetValue("waterLevel",pStats->waterLevel);
 		//stats.SetValue("bottomDepth",pStats->bottomDepth);
 
-		stats.SetValue("flatSpeed",pStats->speedFlat);
+		stats.Set(eASS_FlatSpeed,pStats->speedFlat);
 		//stats.SetValue("speedModule",pStats->speed);
 
-		stats.SetValue("godMode",IsGod());
-		stats.SetValue("inFiring",pStats->inFiring);		
-		pStats->inFreefall.SetDirtyValue(stats, "inFreeFall");
-		pStats->isHidden.SetDirtyValue(stats, "isHidden");
-		pStats->isShattered.SetDirtyValue(stats, "isShattered");
+		stats.Set(eASS_GodMode,IsGod());
+		stats.Set(eASS_InFiring,pStats->inFiring);
+		stats.Set(eASS_InFreeFall,(int)pStats->inFreefall.Value());
+		stats.Set(eASS_IsHidden,pStats->isHidden.Value());
+		stats.Set(eASS_IsShattered,pStats->isShattered.Value());
 	}
 }
 
@@ -2318,6 +2325,7 @@ bool CActor::AllowPhysicsUpdate(uint8 newCounter, uint8 oldCounter)
 
 bool CActor::NetSerialize( TSerialize ser, EEntityAspects aspect, uint8 profile, int pflags )
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	if (aspect == eEA_Physics)
 	{
 		pe_type type = PE_NONE;
@@ -3436,6 +3444,7 @@ void CActor::SetSleepTimer(float timer)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, SvRequestDropItem)
 {
+	GAME_NET_PROFILE_RMI(CActor, SvRequestDropItem);
 	CItem *pItem = GetItem(params.itemId);
 	if (!pItem)
 	{
@@ -3453,6 +3462,7 @@ IMPLEMENT_RMI(CActor, SvRequestDropItem)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, SvRequestPickUpItem)
 {
+	GAME_NET_PROFILE_RMI(CActor, SvRequestPickUpItem);
 	CItem *pItem = GetItem(params.itemId);
 	if (!pItem)
 	{
@@ -3478,6 +3488,7 @@ IMPLEMENT_RMI(CActor, SvRequestPickUpItem)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, SvRequestUseItem)
 {
+	GAME_NET_PROFILE_RMI(CActor, SvRequestUseItem);
 	if (!IsFrozen())
 		UseItem(params.itemId);
 
@@ -3864,6 +3875,7 @@ void CActor::GetActorMemoryStatistics(ICrySizer * s) const
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClSetSpectatorMode)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClSetSpectatorMode);
 	SetSpectatorMode(params.mode, params.targetId);
 
 	return true;
@@ -3872,6 +3884,7 @@ IMPLEMENT_RMI(CActor, ClSetSpectatorMode)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClSetSpectatorHealth)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClSetSpectatorHealth);
 	SetSpectatorHealth(params.health);
 	return true;
 }
@@ -3879,6 +3892,7 @@ IMPLEMENT_RMI(CActor, ClSetSpectatorHealth)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClRevive)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClRevive);
 	NetReviveAt(params.pos, params.rot, params.teamId);
 
 	// PLAYERPREDICTION
@@ -3891,6 +3905,7 @@ IMPLEMENT_RMI(CActor, ClRevive)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClReviveInVehicle)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClReviveInVehicle);
 	NetReviveInVehicle(params.vehicleId, params.seatId, params.teamId);
 
 	return true;
@@ -3899,6 +3914,7 @@ IMPLEMENT_RMI(CActor, ClReviveInVehicle)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClKill)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClKill);
 	NetKill(params.shooterId, params.weaponClassId, (int)params.damage, params.material, params.hit_type);
 
 	return true;
@@ -3907,6 +3923,7 @@ IMPLEMENT_RMI(CActor, ClKill)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClSimpleKill)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClSimpleKill);
 	NetSimpleKill();
 
 	return true;
@@ -3915,6 +3932,7 @@ IMPLEMENT_RMI(CActor, ClSimpleKill)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClMoveTo)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClMoveTo);
 	GetEntity()->SetWorldTM(Matrix34::Create(Vec3(1,1,1), params.rot, params.pos));
 
 	return true;
@@ -3923,6 +3941,7 @@ IMPLEMENT_RMI(CActor, ClMoveTo)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClSetAmmo)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClSetAmmo);
 	IInventory *pInventory=GetInventory();
 	if (pInventory)
 	{
@@ -3939,6 +3958,7 @@ IMPLEMENT_RMI(CActor, ClSetAmmo)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClAddAmmo)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClAddAmmo);
 	IInventory *pInventory=GetInventory();
 	if (pInventory)
 	{
@@ -3965,6 +3985,7 @@ IMPLEMENT_RMI(CActor, ClAddAmmo)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClPickUp)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClPickUp);
 	if (CItem *pItem=GetItem(params.itemId))
 	{
 		pItem->PickUp(GetEntityId(), params.sound, params.select);
@@ -3981,6 +4002,7 @@ IMPLEMENT_RMI(CActor, ClPickUp)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClClearInventory)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClClearInventory);
 	GetInventory()->Clear();
 
 	return true;
@@ -3989,6 +4011,7 @@ IMPLEMENT_RMI(CActor, ClClearInventory)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClDrop)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClDrop);
 	CItem *pItem=GetItem(params.itemId);
 	if (pItem)
 		pItem->Drop(params.impulseScale, params.selectNext, params.byDeath);
@@ -3999,6 +4022,7 @@ IMPLEMENT_RMI(CActor, ClDrop)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClStartUse)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClStartUse);
 	CItem *pItem=GetItem(params.itemId);
 	if (pItem)
 		pItem->StartUse(GetEntityId());
@@ -4009,6 +4033,7 @@ IMPLEMENT_RMI(CActor, ClStartUse)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CActor, ClStopUse)
 {
+	GAME_NET_PROFILE_RMI(CActor, ClStopUse);
 	CItem *pItem=GetItem(params.itemId);
 	if (pItem)
 		pItem->StopUse(GetEntityId());
@@ -36,6 +36,8 @@
 #include "GrabHandler.h"
 #include "WeaponAttachmentManager.h"
 #include "AutoEnum.h"
+#include "ActorUpdateLod.h"
+#include "ActorScriptStats.h"
 
 struct HitInfo;
 
@@ -1023,7 +1025,7 @@ public:
 	virtual SActorParams *GetActorParams() { return 0; };
 
 	virtual void SetStats(SmartScriptTable &rTable);
-	virtual void UpdateScriptStats(SmartScriptTable &rTable);
+	virtual void UpdateScriptStats(CActorScriptStats &stats);
 	virtual ICharacterInstance *GetFPArms(int i) const { return GetEntity()->GetCharacter(3+i); };
 	//set/get actor params
 	virtual void SetParams(SmartScriptTable &rTable,bool resetFirst = false);
@@ -1261,6 +1263,10 @@ public:
 	virtual bool CanPickUpObject(float mass, float volume);
 	virtual float GetActorStrength() const;
 
+	// update LOD, set by CActorUpdateLodManager every frame
+	ILINE const SActorUpdateLodState& GetUpdateLodState() const { return m_updateLodState; }
+	ILINE SActorUpdateLodState& GetUpdateLodState() { return m_updateLodState; }
+
 	//
 	virtual void ProcessIKLimbs(ICharacterInstance *pCharacter,float frameTime);
 
@@ -1414,6 +1420,7 @@ protected:
 	float m_zoomSpeedMultiplier;
 
 	SmartScriptTable m_actorStats;
+	CActorScriptStats m_scriptStats;
 
 	IAnimatedCharacter *m_pAnimatedCharacter;
 	IActorMovementController * m_pMovementController;
@@ -1471,6 +1478,8 @@ protected:
 
 	int				m_teamId;
 	EntityId	m_lastItemId;
+
+	SActorUpdateLodState m_updateLodState;
 	
 	// PLAYERPREDICTION
 	uint8		m_netPhysCounter;				 //	Physics counter, to enable us to throw away old updates
@@ -0,0 +1,241 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Dirty tracked mirror of the actorStats script table.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "ActorScriptStats.h"
+#include "GameCVars.h"
+
+namespace
+{
+	enum EStatType
+	{
+		eST_Bool = 0,
+		eST_Int,
+		eST_Float,
+	};
+
+	struct SStatDesc
+	{
+		const char*	name;
+		EStatType		type;
+	};
+
+	// order must match EActorScriptStat
+	const SStatDesc kStatDescs[eASS_Count] =
+	{
+		{ "stance",								eST_Int },
+		{ "thirdPerson",					eST_Bool },
+		{ "inAir",								eST_Float },
+		{ "onGround",							eST_Float },
+		{ "flatSpeed",						eST_Float },
+		{ "godMode",							eST_Bool },
+		{ "inFiring",							eST_Float },
+		{ "inFreeFall",						eST_Int },
+		{ "isHidden",							eST_Bool },
+		{ "isShattered",					eST_Bool },
+		{ "isFrozen",							eST_Bool },
+		{ "followCharacterHead",	eST_Int },
+		{ "firstPersonBody",			eST_Int },
+		{ "isOnLadder",						eST_Bool },
+		{ "gravityBoots",					eST_Bool },
+	};
+
+	const uint32 kAllStatsMask = BIT(eASS_Count) - 1;
+
+	const char* kAccessTableName = "ActorScriptStatsAccess";
+	const char* kBeginTrackingFunc = "ActorScriptStats_BeginTracking";
+	const char* kEndTrackingFunc = "ActorScriptStats_EndTracking";
+
+	// moves the contents of the stats table into the shadow table and
+	// routes every read through a metatable that remembers the key
+	const char kTrackingScript[] =
+		"ActorScriptStatsAccess = {}\n"
+		"function ActorScriptStats_BeginTracking(stats, shadow)\n"
+		"	for k,v in pairs(stats) do shadow[k] = v end\n"
+		"	for k,v in pairs(shadow) do stats[k] = nil end\n"
+		"	setmetatable(stats, {\n"
+		"		__index = function(t, k) ActorScriptStatsAccess[k] = true return shadow[k] end,\n"
+		"		__newindex = function(t, k, v) shadow[k] = v end,\n"
+		"	})\n"
+		"end\n"
+		"function ActorScriptStats_EndTracking(stats, shadow)\n"
+		"	setmetatable(stats, nil)\n"
+		"	for k,v in pairs(shadow) do stats[k] = v end\n"
+		"end\n";
+
+	int s_activeTrackingId = 0;		// 0 while not tracking
+	int s_lastTrackingId = 0;
+
+	bool CallTrackingFunc(const char* funcName, IScriptTable* pStats, IScriptTable* pShadow)
+	{
+		IScriptSystem* pSS = gEnv->pScriptSystem;
+		HSCRIPTFUNCTION func = pSS->GetFunctionPtr(funcName);
+		if (!func)
+			return false;
+
+		const bool ok = Script::Call(pSS, func, pStats, pShadow);
+		pSS->ReleaseFunc(func);
+		return ok;
+	}
+}
+
+//------------------------------------------------------------------------
+CActorScriptStats::CActorScriptStats()
+: m_dirtyMask(kAllStatsMask)
+, m_usedMask(0)
+, m_trackingId(0)
+{
+	for (int i = 0; i < eASS_Count; ++i)
+		m_values[i] = 0.0f;
+}
+
+//------------------------------------------------------------------------
+const char* CActorScriptStats::GetStatName(EActorScriptStat stat)
+{
+	assert(stat >= 0 && stat < eASS_Count);
+	return kStatDescs[stat].name;
+}
+
+//------------------------------------------------------------------------
+void CActorScriptStats::WriteStats(IScriptTable* pTable, uint32 mask)
+{
+	CScriptSetGetChain chain(pTable);
+
+	for (int i = 0; mask; ++i, mask >>= 1)
+	{
+		if (!(mask & 1))
+			continue;
+
+		const SStatDesc& desc = kStatDescs[i];
+		switch (desc.type)
+		{
+		case eST_Bool:
+			chain.SetValue(desc.name, m_values[i] != 0.0f);
+			break;
+		case eST_Int:
+			chain.SetValue(desc.name, (int)m_values[i]);
+			break;
+		default:
+			chain.SetValue(desc.name, m_values[i]);
+			break;
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+void CActorScriptStats::Flush(SmartScriptTable& rTable)
+{
+	if (m_trackingId != s_activeTrackingId)
+	{
+		if (m_trackingId)
+			EndTracking(rTable);
+		if (s_activeTrackingId)
+			BeginTracking(rTable);
+	}
+
+	if (m_trackingId)
+	{
+		// everything is visible while tracking, or unread stats would look unused
+		if (m_dirtyMask)
+			WriteStats(m_trackingShadow, m_dirtyMask);
+		m_dirtyMask = 0;
+		return;
+	}
+
+	const uint32 usedMask = (uint32)g_pGameCVars->g_actorScriptStats_mask & kAllStatsMask;
+	if (usedMask != m_usedMask)
+	{
+		// stats that just got enabled may hold stale values in the table
+		m_dirtyMask |= usedMask & ~m_usedMask;
+		m_usedMask = usedMask;
+	}
+
+	const uint32 writeMask = m_dirtyMask & usedMask;
+	if (writeMask)
+		WriteStats(rTable, writeMask);
+
+	m_dirtyMask = 0;
+}
+
+//------------------------------------------------------------------------
+void CActorScriptStats::BeginTracking(SmartScriptTable& rTable)
+{
+	m_trackingShadow.Create(gEnv->pScriptSystem);
+	if (CallTrackingFunc(kBeginTrackingFunc, rTable, m_trackingShadow))
+	{
+		m_trackingId = s_activeTrackingId;
+		m_dirtyMask = kAllStatsMask;
+	}
+	else
+	{
+		m_trackingShadow = NULL;
+	}
+}
+
+//------------------------------------------------------------------------
+void CActorScriptStats::EndTracking(SmartScriptTable& rTable)
+{
+	CallTrackingFunc(kEndTrackingFunc, rTable, m_trackingShadow);
+
+	m_trackingShadow = NULL;
+	m_trackingId = 0;
+	Invalidate();
+}
+
+//------------------------------------------------------------------------
+void CActorScriptStats::UpdateAccessTracking()
+{
+	const bool track = g_pGameCVars->g_actorScriptStats_track != 0;
+	if (track == (s_activeTrackingId != 0))
+		return;
+
+	IScriptSystem* pSS = gEnv->pScriptSystem;
+
+	if (track)
+	{
+		// (re)defines the helpers and starts with an empty access table
+		if (!pSS->ExecuteBuffer(kTrackingScript, sizeof(kTrackingScript) - 1, "ActorScriptStats"))
+		{
+			GameWarning("ActorScriptStats: failed to set up script access tracking");
+			g_pGameCVars->g_actorScriptStats_track = 0;
+			return;
+		}
+
+		s_activeTrackingId = ++s_lastTrackingId;
+		CryLog("ActorScriptStats: tracking actorStats reads, set g_actorScriptStats_track to 0 to apply the result");
+		return;
+	}
+
+	s_activeTrackingId = 0;
+
+	uint32 mask = 0;
+	SmartScriptTable pAccess;
+	if (pSS->GetGlobalValue(kAccessTableName, pAccess))
+	{
+		for (int i = 0; i < eASS_Count; ++i)
+		{
+			if (pAccess->HaveValue(kStatDescs[i].name))
+				mask |= BIT(i);
+			else
+				CryLog("ActorScriptStats: '%s' is not read by scripts and won't be updated", kStatDescs[i].name);
+		}
+	}
+	else
+	{
+		mask = kAllStatsMask;
+	}
+
+	pSS->SetGlobalToNull(kAccessTableName);
+
+	CryLog("ActorScriptStats: g_actorScriptStats_mask set to 0x%x", mask);
+	if (ICVar* pMaskVar = gEnv->pConsole->GetCVar("g_actorScriptStats_mask"))
+		pMaskVar->Set((int)mask);
+}
@@ -0,0 +1,86 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Dirty tracked mirror of the actorStats script table.
+
+Actors write their script visible stats here every frame; only values
+that changed since the last flush are written to the Lua table, in a
+single set/get chain. Stats no script reads can be masked out with
+g_actorScriptStats_mask, so idle actors do no script writes at all.
+
+The mask can be discovered at runtime: while g_actorScriptStats_track
+is 1 every actorStats table is emptied and given a metatable that
+records which keys scripts read. Setting it back to 0 restores the
+tables, builds the mask from the recorded keys and applies it.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __ACTORSCRIPTSTATS_H__
+#define __ACTORSCRIPTSTATS_H__
+
+#pragma once
+
+enum EActorScriptStat
+{
+	eASS_Stance = 0,
+	eASS_ThirdPerson,
+	eASS_InAir,
+	eASS_OnGround,
+	eASS_FlatSpeed,
+	eASS_GodMode,
+	eASS_InFiring,
+	eASS_InFreeFall,
+	eASS_IsHidden,
+	eASS_IsShattered,
+	eASS_IsFrozen,
+	eASS_FollowCharacterHead,
+	eASS_FirstPersonBody,
+	eASS_IsOnLadder,
+	eASS_GravityBoots,
+
+	eASS_Count
+};
+
+class CActorScriptStats
+{
+public:
+	CActorScriptStats();
+
+	ILINE void Set(EActorScriptStat stat, float value)
+	{
+		if (m_values[stat] != value)
+		{
+			m_values[stat] = value;
+			m_dirtyMask |= BIT(stat);
+		}
+	}
+	ILINE void Set(EActorScriptStat stat, int value) { Set(stat, (float)value); }
+	ILINE void Set(EActorScriptStat stat, bool value) { Set(stat, value ? 1.0f : 0.0f); }
+
+	// writes the changed stats scripts are interested in to the table
+	void	Flush(SmartScriptTable& rTable);
+
+	// forces every stat to be written on the next flush, ie. when the table changes
+	void	Invalidate() { m_dirtyMask = BIT(eASS_Count) - 1; }
+
+	// once per frame, handles g_actorScriptStats_track transitions
+	static void	UpdateAccessTracking();
+	static const char* GetStatName(EActorScriptStat stat);
+
+private:
+	void	BeginTracking(SmartScriptTable& rTable);
+	void	EndTracking(SmartScriptTable& rTable);
+	void	WriteStats(IScriptTable* pTable, uint32 mask);
+
+	float							m_values[eASS_Count];
+	uint32						m_dirtyMask;
+	uint32						m_usedMask;				// mask the table was last flushed with
+	int								m_trackingId;			// tracking session this actor's table is in, 0 if none
+	SmartScriptTable	m_trackingShadow;	// holds the real values while accesses are tracked
+};
+
+#endif //__ACTORSCRIPTSTATS_H__
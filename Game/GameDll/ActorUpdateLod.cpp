@@ -0,0 +1,199 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Update level of detail for actors other than the local client.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "ActorUpdateLod.h"
+#include "Actor.h"
+#include "Player.h"
+#include "HitDeathReactions.h"
+#include "GameCVars.h"
+#include "Utility/CryWatch.h"
+
+namespace
+{
+	const float kActorRadius = 1.0f;	// rough half height of a humanoid, used for the screen size estimate
+}
+
+//------------------------------------------------------------------------
+CActorUpdateLodManager::CActorUpdateLodManager()
+: m_frameCounter(0)
+{
+	memset(m_lodCounts, 0, sizeof(m_lodCounts));
+}
+
+//------------------------------------------------------------------------
+void CActorUpdateLodManager::Reset()
+{
+	stl::free_container(m_candidates);
+	m_frameCounter = 0;
+	memset(m_lodCounts, 0, sizeof(m_lodCounts));
+}
+
+//------------------------------------------------------------------------
+bool CActorUpdateLodManager::IsExempt(const CActor* pActor) const
+{
+	if (pActor->IsClient())
+		return true;
+
+	if (pActor->GetLinkedVehicle())
+		return true;
+
+	if (pActor->GetActorClass() == CPlayer::GetActorClassType())
+	{
+		CHitDeathReactionsConstPtr pHitDeathReactions = static_cast<const CPlayer*>(pActor)->GetHitDeathReactions();
+		if (pHitDeathReactions && pHitDeathReactions->IsInReaction())
+			return true;
+	}
+
+	return false;
+}
+
+//------------------------------------------------------------------------
+void CActorUpdateLodManager::ApplyLod(CActor* pActor, EActorUpdateLod lod, float frameTime)
+{
+	SActorUpdateLodState& state = pActor->GetUpdateLodState();
+
+	state.lod = lod;
+	state.accumulatedTime += frameTime;
+
+	switch (lod)
+	{
+	case eAUL_Full:
+		state.detailedUpdate = true;
+		break;
+
+	case eAUL_Reduced:
+		{
+			// stagger the detailed frames by entity id so reduced actors don't all update together
+			const uint32 interval = (uint32)max(1, g_pGameCVars->g_actorUpdateLod_reducedInterval);
+			state.detailedUpdate = ((m_frameCounter + pActor->GetEntityId()) % interval) == 0;
+		}
+		break;
+
+	default:
+		state.detailedUpdate = false;
+		break;
+	}
+
+	if (state.detailedUpdate)
+	{
+		state.detailedFrameTime = state.accumulatedTime;
+		state.accumulatedTime = 0.0f;
+	}
+
+	++m_lodCounts[lod];
+}
+
+//------------------------------------------------------------------------
+void CActorUpdateLodManager::Update(float frameTime)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
+
+	++m_frameCounter;
+	memset(m_lodCounts, 0, sizeof(m_lodCounts));
+
+	IActorSystem* pActorSystem = g_pGame->GetIGameFramework()->GetIActorSystem();
+
+	// there is no local view on a dedicated server to rank actors against
+	const bool enabled = g_pGameCVars->g_actorUpdateLod_enable && !gEnv->IsDedicated();
+
+	m_candidates.resize(0);
+
+	const CCamera& camera = GetISystem()->GetViewCamera();
+	const Vec3 viewPos = camera.GetPosition();
+	const float projScale = 1.0f / max(tan_tpl(camera.GetFov() * 0.5f), 0.01f);
+
+	const float reducedDistSq = sqr(g_pGameCVars->g_actorUpdateLod_reducedDistance);
+	const float minimalDistSq = sqr(g_pGameCVars->g_actorUpdateLod_minimalDistance);
+	const float minScreenSize = g_pGameCVars->g_actorUpdateLod_minScreenSize;
+
+	IActorIteratorPtr pIt = pActorSystem->CreateActorIterator();
+	while (IActor* pIActor = pIt->Next())
+	{
+		CActor* pActor = static_cast<CActor*>(pIActor);
+
+		if (!enabled || IsExempt(pActor))
+		{
+			ApplyLod(pActor, eAUL_Full, frameTime);
+			continue;
+		}
+
+		const float distSq = viewPos.GetSquaredDistance(pActor->GetEntity()->GetWorldPos());
+		const float dist = sqrt_tpl(distSq);
+		const float screenSize = (kActorRadius * projScale) / max(dist, 0.01f);
+
+		const SActorStats* pStats = pActor->GetActorStats();
+		const bool inCombat = pStats && (pStats->inFiring > 0.0f);
+		const bool visible = pActor->GetGameObject()->IsProbablyVisible();
+
+		EActorUpdateLod minLod = eAUL_Full;
+		if (distSq > minimalDistSq || screenSize < minScreenSize)
+			minLod = eAUL_Minimal;
+		else if (distSq > reducedDistSq || !visible)
+			minLod = eAUL_Reduced;
+
+		// actors fighting are never dropped to physics/network only
+		if (inCombat && minLod == eAUL_Minimal)
+			minLod = eAUL_Reduced;
+
+		SCandidate candidate;
+		candidate.pActor = pActor;
+		candidate.minLod = minLod;
+		candidate.score = dist;
+		if (!visible)
+			candidate.score *= 4.0f;
+		if (inCombat)
+			candidate.score *= 0.25f;
+
+		m_candidates.push_back(candidate);
+	}
+
+	// closest/most relevant actors get the budget first
+	std::sort(m_candidates.begin(), m_candidates.end());
+
+	int fullBudget = g_pGameCVars->g_actorUpdateLod_maxFull;
+	int reducedBudget = g_pGameCVars->g_actorUpdateLod_maxReduced;
+
+	for (TCandidates::iterator it = m_candidates.begin(), itEnd = m_candidates.end(); it != itEnd; ++it)
+	{
+		EActorUpdateLod lod = it->minLod;
+
+		if (lod == eAUL_Full)
+		{
+			if (fullBudget > 0)
+				--fullBudget;
+			else
+				lod = eAUL_Reduced;
+		}
+
+		if (lod == eAUL_Reduced)
+		{
+			if (reducedBudget > 0)
+				--reducedBudget;
+			else
+				lod = eAUL_Minimal;
+		}
+
+		ApplyLod(it->pActor, lod, frameTime);
+	}
+
+#if CRY_WATCH_ENABLED
+	if (g_pGameCVars->g_actorUpdateLod_debug)
+		CryWatch("ActorUpdateLod: full %d, reduced %d, minimal %d", m_lodCounts[eAUL_Full], m_lodCounts[eAUL_Reduced], m_lodCounts[eAUL_Minimal]);
+#endif
+}
+
+//------------------------------------------------------------------------
+void CActorUpdateLodManager::GetMemoryStatistics(ICrySizer* s) const
+{
+	s->Add(*this);
+	s->AddContainer(m_candidates);
+}
@@ -0,0 +1,90 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Update level of detail for actors other than the local client.
+
+	Full		- everything runs every frame
+	Reduced	- cosmetic updates (breathing, sounds, IK) run every Nth frame
+						with the time accumulated since the previous detailed update
+	Minimal	- cosmetic updates are skipped
+
+Stats, movement, character offset and lean always run every frame, the
+movement code depends on them.
+
+The LOD of each actor is picked once per frame from its distance to the
+local view, its projected screen size, its visibility and whether it's in
+combat, and then clamped against a global budget of full/reduced actors.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __ACTORUPDATELOD_H__
+#define __ACTORUPDATELOD_H__
+
+#pragma once
+
+class CActor;
+
+enum EActorUpdateLod
+{
+	eAUL_Full = 0,
+	eAUL_Reduced,
+	eAUL_Minimal,
+
+	eAUL_Count
+};
+
+struct SActorUpdateLodState
+{
+	SActorUpdateLodState()
+		: lod(eAUL_Full)
+		, detailedUpdate(true)
+		, detailedFrameTime(0.0f)
+		, accumulatedTime(0.0f)
+	{
+	}
+
+	// frame time to use for detailed updates this frame
+	ILINE float GetDetailedFrameTime(float frameTime) const { return (lod == eAUL_Full) ? frameTime : detailedFrameTime; }
+
+	EActorUpdateLod	lod;
+	bool						detailedUpdate;		// run breathing/sounds and recompute IK targets this frame
+	float						detailedFrameTime;
+	float						accumulatedTime;	// time since the last detailed update
+};
+
+class CActorUpdateLodManager
+{
+public:
+	CActorUpdateLodManager();
+
+	// picks the LOD of every actor for the coming frame
+	void	Update(float frameTime);
+	void	Reset();
+
+	void	GetMemoryStatistics(ICrySizer* s) const;
+
+private:
+	struct SCandidate
+	{
+		CActor*					pActor;
+		float						score;			// lower is more important
+		EActorUpdateLod	minLod;			// best LOD the actor is eligible for
+
+		bool operator<(const SCandidate& other) const { return score < other.score; }
+	};
+
+	typedef std::vector<SCandidate> TCandidates;
+
+	void	ApplyLod(CActor* pActor, EActorUpdateLod lod, float frameTime);
+	bool	IsExempt(const CActor* pActor) const;
+
+	TCandidates	m_candidates;
+	uint32			m_frameCounter;
+	int					m_lodCounts[eAUL_Count];
+};
+
+#endif //__ACTORUPDATELOD_H__
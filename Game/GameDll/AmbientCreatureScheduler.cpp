@@ -0,0 +1,256 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Update scheduling for ambient creatures.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "AmbientCreatureScheduler.h"
+#include "Actor.h"
+#include "GameCVars.h"
+#include "Utility/CryWatch.h"
+
+//------------------------------------------------------------------------
+void SAmbientCreatureUpdate::SetTickMovement(const Quat& rotation, const SCharacterMoveRequest& request)
+{
+	startRotation = rotation;
+	targetRotation = (rotation * request.rotation).GetNormalized();
+	velocity = request.velocity;
+	hasMovement = true;
+}
+
+//------------------------------------------------------------------------
+void SAmbientCreatureUpdate::GetFrameMovement(const Quat& rotation, float frameTime, SCharacterMoveRequest& request) const
+{
+	if (interval <= 0.0f || !hasMovement)
+		return;
+
+	// reach the rotation of the last tick by the time the next one is due
+	const float t = min(1.0f, (accumulatedTime + frameTime) / interval);
+	const Quat desired = Quat::CreateSlerp(startRotation, targetRotation, t);
+
+	request.rotation = rotation.GetInverted() * desired;
+	request.rotation.Normalize();
+	request.velocity = velocity;
+}
+
+//------------------------------------------------------------------------
+CAmbientCreatureProbe::CAmbientCreatureProbe()
+: m_rayId(0)
+, m_generation(0)
+, m_hasResult(false)
+{
+}
+
+//------------------------------------------------------------------------
+CAmbientCreatureProbe::~CAmbientCreatureProbe()
+{
+	Cancel();
+}
+
+//------------------------------------------------------------------------
+void CAmbientCreatureProbe::Queue(const Vec3& origin, const Vec3& dir, int objTypes, int flags)
+{
+	Cancel();
+
+	m_hasResult = false;
+	m_result.origin = origin;
+	m_result.dir = dir;
+
+	m_generation = g_pGame->GetAmbientCreatureScheduler().GetProbeGeneration();
+	m_rayId = g_pGame->GetRayCaster().Queue(
+		RayCastRequest::LowPriority,
+		RayCastRequest(origin, dir, objTypes, flags),
+		functor(*this, &CAmbientCreatureProbe::OnRayCastResult));
+}
+
+//------------------------------------------------------------------------
+void CAmbientCreatureProbe::Cancel()
+{
+	if (m_rayId)
+	{
+		// the ray caster is deleted on level unload, rays queued on it must not be cancelled on the next one
+		if (g_pGame && g_pGame->GetAmbientCreatureScheduler().GetProbeGeneration() == m_generation)
+			g_pGame->GetRayCaster().Cancel(m_rayId);
+
+		m_rayId = 0;
+	}
+
+	m_hasResult = false;
+}
+
+//------------------------------------------------------------------------
+bool CAmbientCreatureProbe::IsPending() const
+{
+	// a ray queued before the last level unload never comes back
+	return m_rayId != 0 && g_pGame->GetAmbientCreatureScheduler().GetProbeGeneration() == m_generation;
+}
+
+//------------------------------------------------------------------------
+bool CAmbientCreatureProbe::ConsumeResult(SAmbientProbeResult& result)
+{
+	if (!m_hasResult)
+		return false;
+
+	result = m_result;
+	m_hasResult = false;
+
+	return true;
+}
+
+//------------------------------------------------------------------------
+void CAmbientCreatureProbe::OnRayCastResult(const QueuedRayID& rayID, const RayCastResult& result)
+{
+	CRY_ASSERT(rayID == m_rayId);
+
+	m_rayId = 0;
+	m_hasResult = true;
+
+	m_result.hit = (result.hitCount > 0);
+	if (m_result.hit)
+	{
+		m_result.pt = result.hits[0].pt;
+		m_result.dist = result.hits[0].dist;
+	}
+}
+
+//------------------------------------------------------------------------
+CAmbientCreatureScheduler::CAmbientCreatureScheduler()
+: m_probeGeneration(1)
+{
+}
+
+//------------------------------------------------------------------------
+void CAmbientCreatureScheduler::Register(CActor* pActor, SAmbientCreatureUpdate* pUpdate)
+{
+	for (TCreatures::iterator it = m_creatures.begin(), itEnd = m_creatures.end(); it != itEnd; ++it)
+	{
+		if (it->pActor == pActor)
+		{
+			it->pUpdate = pUpdate;
+			return;
+		}
+	}
+
+	// spread the first ticks so creatures spawned together don't tick on the same frame
+	pUpdate->accumulatedTime = (float)(pActor->GetEntityId() & 7) * 0.125f * g_pGameCVars->g_ambientCreatures_maxInterval;
+
+	SCreature creature;
+	creature.pActor = pActor;
+	creature.pUpdate = pUpdate;
+
+	m_creatures.push_back(creature);
+}
+
+//------------------------------------------------------------------------
+void CAmbientCreatureScheduler::Unregister(const CActor* pActor)
+{
+	for (TCreatures::iterator it = m_creatures.begin(), itEnd = m_creatures.end(); it != itEnd; ++it)
+	{
+		if (it->pActor == pActor)
+		{
+			m_creatures.erase(it);
+			return;
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+float CAmbientCreatureScheduler::GetInterval(const CActor* pActor, const SAmbientCreatureUpdate& update, const Vec3& viewPos) const
+{
+	if (update.threat)
+		return 0.0f;
+
+	const float nearDistance = g_pGameCVars->g_ambientCreatures_nearDistance;
+	const float farDistance = max(g_pGameCVars->g_ambientCreatures_farDistance, nearDistance + 1.0f);
+	const float minInterval = g_pGameCVars->g_ambientCreatures_minInterval;
+	const float maxInterval = max(g_pGameCVars->g_ambientCreatures_maxInterval, minInterval);
+
+	const bool visible = pActor->GetGameObject()->IsProbablyVisible();
+
+	const float dist = viewPos.GetDistance(pActor->GetEntity()->GetWorldPos());
+	if (dist < nearDistance && visible)
+		return 0.0f;
+
+	const float t = clamp_tpl((dist - nearDistance) / (farDistance - nearDistance), 0.0f, 1.0f);
+	float interval = minInterval + t * (maxInterval - minInterval);
+
+	// nobody sees it move, only keep it roughly on track
+	if (!visible)
+		interval = maxInterval;
+
+	return interval;
+}
+
+//------------------------------------------------------------------------
+void CAmbientCreatureScheduler::Update(float frameTime)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
+
+	if (m_creatures.empty())
+		return;
+
+	// there is no local view on a dedicated server to rank creatures against
+	const bool enabled = g_pGameCVars->g_ambientCreatures_enable && !gEnv->IsDedicated();
+
+	const Vec3 viewPos = GetISystem()->GetViewCamera().GetPosition();
+
+	int numTicking = 0;
+
+	for (TCreatures::iterator it = m_creatures.begin(), itEnd = m_creatures.end(); it != itEnd; ++it)
+	{
+		SAmbientCreatureUpdate& update = *it->pUpdate;
+
+		const float interval = enabled ? GetInterval(it->pActor, update, viewPos) : 0.0f;
+
+		update.accumulatedTime += frameTime;
+
+		if (interval <= 0.0f)
+		{
+			update.interval = 0.0f;
+			update.accumulatedTime = 0.0f;
+			update.tickTime = frameTime;
+			update.tick = true;
+		}
+		else
+		{
+			update.tick = (update.accumulatedTime >= interval);
+			update.interval = interval;
+
+			if (update.tick)
+			{
+				update.tickTime = update.accumulatedTime;
+				update.accumulatedTime = 0.0f;
+			}
+		}
+
+		if (update.tick)
+			++numTicking;
+	}
+
+#if CRY_WATCH_ENABLED
+	if (g_pGameCVars->g_ambientCreatures_debug)
+		CryWatch("AmbientCreatures: %d registered, %d ticking", (int)m_creatures.size(), numTicking);
+#endif
+}
+
+//------------------------------------------------------------------------
+void CAmbientCreatureScheduler::Reset()
+{
+	stl::free_container(m_creatures);
+
+	// the ray caster goes away with the level
+	++m_probeGeneration;
+}
+
+//------------------------------------------------------------------------
+void CAmbientCreatureScheduler::GetMemoryStatistics(ICrySizer* s) const
+{
+	s->Add(*this);
+	s->AddContainer(m_creatures);
+}
@@ -0,0 +1,130 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Update scheduling for ambient creatures (sharks, flyers and other
+scripted animals that are not regular AI humanoids).
+
+Each registered creature gets an update interval picked once per frame
+from its distance to the local view, its visibility and whether it is a
+threat right now. Between two ticks the creature only replays the
+movement of the last tick, spread over the interval, and its environment
+probes go through the global ray caster at low priority.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __AMBIENTCREATURESCHEDULER_H__
+#define __AMBIENTCREATURESCHEDULER_H__
+
+#pragma once
+
+#include "Game.h"
+
+class CActor;
+struct SCharacterMoveRequest;
+
+struct SAmbientCreatureUpdate
+{
+	SAmbientCreatureUpdate()
+		: startRotation(IDENTITY)
+		, targetRotation(IDENTITY)
+		, velocity(ZERO)
+		, interval(0.0f)
+		, accumulatedTime(0.0f)
+		, tickTime(0.0f)
+		, tick(true)
+		, threat(false)
+		, hasMovement(false)
+	{
+	}
+
+	// frame time to use for the behaviour update on a tick
+	ILINE float GetTickTime(float frameTime) const { return (interval > 0.0f) ? tickTime : frameTime; }
+
+	// records the movement computed on a tick, it's spread over the frames until the next one
+	void	SetTickMovement(const Quat& rotation, const SCharacterMoveRequest& request);
+	// overrides the request with the share of the tick movement for this frame, does nothing at full rate
+	void	GetFrameMovement(const Quat& rotation, float frameTime, SCharacterMoveRequest& request) const;
+
+	Quat	startRotation;
+	Quat	targetRotation;
+	Vec3	velocity;
+
+	float	interval;					// seconds between ticks, 0 when updated every frame
+	float	accumulatedTime;	// time since the last tick
+	float	tickTime;					// time covered by this tick
+	bool	tick;							// run the behaviour update this frame
+	bool	threat;						// set by the creature, threatening creatures update every frame
+	bool	hasMovement;
+};
+
+struct SAmbientProbeResult
+{
+	Vec3	origin;
+	Vec3	dir;
+	Vec3	pt;
+	float	dist;
+	bool	hit;
+};
+
+// Environment ray of an ambient creature, queued on the global ray caster at
+// low priority. The result is kept until the creature consumes it.
+class CAmbientCreatureProbe
+{
+public:
+	CAmbientCreatureProbe();
+	~CAmbientCreatureProbe();
+
+	void	Queue(const Vec3& origin, const Vec3& dir, int objTypes, int flags);
+	void	Cancel();
+
+	bool	IsPending() const;
+
+	// hands out the result once, false if none arrived yet
+	bool	ConsumeResult(SAmbientProbeResult& result);
+
+private:
+	void	OnRayCastResult(const QueuedRayID& rayID, const RayCastResult& result);
+
+	SAmbientProbeResult	m_result;
+	QueuedRayID					m_rayId;
+	uint32							m_generation;		// ray caster generation the ray was queued on
+	bool								m_hasResult;
+};
+
+class CAmbientCreatureScheduler
+{
+public:
+	CAmbientCreatureScheduler();
+
+	void	Register(CActor* pActor, SAmbientCreatureUpdate* pUpdate);
+	void	Unregister(const CActor* pActor);
+
+	// picks the update interval of every registered creature and flags the ones ticking this frame
+	void	Update(float frameTime);
+	void	Reset();
+
+	// changes whenever the global ray caster is recreated, rays queued before are gone
+	ILINE uint32 GetProbeGeneration() const { return m_probeGeneration; }
+
+	void	GetMemoryStatistics(ICrySizer* s) const;
+
+private:
+	struct SCreature
+	{
+		CActor*									pActor;
+		SAmbientCreatureUpdate*	pUpdate;
+	};
+
+	typedef std::vector<SCreature> TCreatures;
+
+	float	GetInterval(const CActor* pActor, const SAmbientCreatureUpdate& update, const Vec3& viewPos) const;
+
+	TCreatures	m_creatures;
+	uint32			m_probeGeneration;
+};
+
+#endif //__AMBIENTCREATURESCHEDULER_H__
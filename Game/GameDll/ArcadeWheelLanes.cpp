@@ -0,0 +1,203 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Structure of arrays wheel maths for arcade wheeled vehicles.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "ArcadeWheelLanes.h"
+
+#if (defined(_CPU_SSE) && defined(_CPU_X86)) || defined(_CPU_AMD64)
+	#define ARCADE_WHEEL_LANES_SSE 1
+	#include <xmmintrin.h>
+#endif
+
+namespace
+{
+#if ARCADE_WHEEL_LANES_SSE
+
+	typedef __m128 TLane;
+
+	ILINE TLane LaneLoad(const float* p) { return _mm_loadu_ps(p); }
+	ILINE void LaneStore(float* p, TLane a) { _mm_storeu_ps(p, a); }
+	ILINE TLane LaneSet(float f) { return _mm_set1_ps(f); }
+	ILINE TLane LaneAdd(TLane a, TLane b) { return _mm_add_ps(a, b); }
+	ILINE TLane LaneSub(TLane a, TLane b) { return _mm_sub_ps(a, b); }
+	ILINE TLane LaneMul(TLane a, TLane b) { return _mm_mul_ps(a, b); }
+	ILINE TLane LaneDiv(TLane a, TLane b) { return _mm_div_ps(a, b); }
+	ILINE TLane LaneMax(TLane a, TLane b) { return _mm_max_ps(a, b); }
+	ILINE TLane LaneSqrt(TLane a) { return _mm_sqrt_ps(a); }
+	ILINE TLane LaneAbs(TLane a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+
+#else
+
+	struct TLane
+	{
+		float v[SArcadeWheelLanes::kWidth];
+	};
+
+	#define LANE_OP(expr) TLane r; for (int i = 0; i < SArcadeWheelLanes::kWidth; ++i) { r.v[i] = (expr); } return r
+
+	ILINE TLane LaneLoad(const float* p) { LANE_OP(p[i]); }
+	ILINE void LaneStore(float* p, const TLane& a) { for (int i = 0; i < SArcadeWheelLanes::kWidth; ++i) p[i] = a.v[i]; }
+	ILINE TLane LaneSet(float f) { LANE_OP(f); }
+	ILINE TLane LaneAdd(const TLane& a, const TLane& b) { LANE_OP(a.v[i] + b.v[i]); }
+	ILINE TLane LaneSub(const TLane& a, const TLane& b) { LANE_OP(a.v[i] - b.v[i]); }
+	ILINE TLane LaneMul(const TLane& a, const TLane& b) { LANE_OP(a.v[i] * b.v[i]); }
+	ILINE TLane LaneDiv(const TLane& a, const TLane& b) { LANE_OP(a.v[i] / b.v[i]); }
+	ILINE TLane LaneMax(const TLane& a, const TLane& b) { LANE_OP(max(a.v[i], b.v[i])); }
+	ILINE TLane LaneSqrt(const TLane& a) { LANE_OP(sqrtf(a.v[i])); }
+	ILINE TLane LaneAbs(const TLane& a) { LANE_OP(fabsf(a.v[i])); }
+
+	#undef LANE_OP
+
+#endif
+
+	struct SLaneVec3
+	{
+		TLane x, y, z;
+	};
+
+	ILINE SLaneVec3 LaneLoad3(const float* px, const float* py, const float* pz)
+	{
+		SLaneVec3 r = { LaneLoad(px), LaneLoad(py), LaneLoad(pz) };
+		return r;
+	}
+
+	ILINE SLaneVec3 LaneSet3(const Vec3& v)
+	{
+		SLaneVec3 r = { LaneSet(v.x), LaneSet(v.y), LaneSet(v.z) };
+		return r;
+	}
+
+	ILINE void LaneStore3(float* px, float* py, float* pz, const SLaneVec3& v)
+	{
+		LaneStore(px, v.x);
+		LaneStore(py, v.y);
+		LaneStore(pz, v.z);
+	}
+
+	ILINE SLaneVec3 LaneAdd3(const SLaneVec3& a, const SLaneVec3& b)
+	{
+		SLaneVec3 r = { LaneAdd(a.x, b.x), LaneAdd(a.y, b.y), LaneAdd(a.z, b.z) };
+		return r;
+	}
+
+	ILINE SLaneVec3 LaneScale3(const SLaneVec3& a, const TLane& s)
+	{
+		SLaneVec3 r = { LaneMul(a.x, s), LaneMul(a.y, s), LaneMul(a.z, s) };
+		return r;
+	}
+
+	ILINE TLane LaneDot3(const SLaneVec3& a, const SLaneVec3& b)
+	{
+		return LaneAdd(LaneAdd(LaneMul(a.x, b.x), LaneMul(a.y, b.y)), LaneMul(a.z, b.z));
+	}
+
+	ILINE SLaneVec3 LaneCross3(const SLaneVec3& a, const SLaneVec3& b)
+	{
+		SLaneVec3 r =
+		{
+			LaneSub(LaneMul(a.y, b.z), LaneMul(a.z, b.y)),
+			LaneSub(LaneMul(a.z, b.x), LaneMul(a.x, b.z)),
+			LaneSub(LaneMul(a.x, b.y), LaneMul(a.y, b.x))
+		};
+		return r;
+	}
+
+	ILINE SLaneVec3 LaneNormalize3(const SLaneVec3& a)
+	{
+		// zero length vectors (padding lanes) stay zero
+		const TLane invLength = LaneDiv(LaneSet(1.0f), LaneMax(LaneSqrt(LaneDot3(a, a)), LaneSet(1e-10f)));
+		return LaneScale3(a, invLength);
+	}
+
+	// velocity change of the point at offset for a unit impulse along norm, see computeDenominator in VehicleMovementArcadeWheeled.cpp
+	ILINE TLane LaneComputeDenominator(const TLane& invMass, const TLane& invInertia, const SLaneVec3& offset, const SLaneVec3& norm)
+	{
+		const SLaneVec3 angular = LaneCross3(LaneScale3(LaneCross3(offset, norm), invInertia), offset);
+		return LaneAdd(LaneDot3(norm, angular), invMass);
+	}
+}
+
+//------------------------------------------------------------------------
+SArcadeWheelLanes::SArcadeWheelLanes()
+{
+	memset(this, 0, sizeof(*this));
+}
+
+//------------------------------------------------------------------------
+void SArcadeWheelLanes::ClearPadding()
+{
+	for (int i = numWheels; i < kMaxWheels; ++i)
+	{
+		offsetX[i] = offsetY[i] = offsetZ[i] = 0.0f;
+		cosSteer[i] = 1.0f;
+		sinSteer[i] = 0.0f;
+		statusNormalX[i] = statusNormalY[i] = statusNormalZ[i] = 0.0f;
+		radius[i] = w[i] = invMass[i] = invInertia[i] = 0.0f;
+	}
+}
+
+//------------------------------------------------------------------------
+void ArcadeWheelsComputeFrames(const SArcadeWheelBatchItem* pItems, int numItems)
+{
+	for (int item = 0; item < numItems; ++item)
+	{
+		const SArcadeChassisFrame& chassis = *pItems[item].pChassis;
+		SArcadeWheelLanes& lanes = *pItems[item].pLanes;
+
+		CRY_ASSERT(lanes.numWheels <= SArcadeWheelLanes::kMaxWheels);
+
+		const SLaneVec3 xAxis = LaneSet3(chassis.xAxis);
+		const SLaneVec3 yAxis = LaneSet3(chassis.yAxis);
+		const SLaneVec3 zAxis = LaneSet3(chassis.zAxis);
+		const SLaneVec3 vel = LaneSet3(chassis.vel);
+		const SLaneVec3 angVel = LaneSet3(chassis.angVel);
+		const SLaneVec3 baseNormal = LaneSet3(chassis.contactNormal);
+		const TLane chassisInvMass = LaneSet(chassis.invMass);
+		const TLane chassisInvInertia = LaneSet(chassis.invInertia);
+
+		for (int i = 0; i < lanes.numWheels; i += SArcadeWheelLanes::kWidth)
+		{
+			const SLaneVec3 offset = LaneLoad3(&lanes.offsetX[i], &lanes.offsetY[i], &lanes.offsetZ[i]);
+			const TLane cosSteer = LaneLoad(&lanes.cosSteer[i]);
+			const TLane sinSteer = LaneLoad(&lanes.sinSteer[i]);
+			const TLane radius = LaneLoad(&lanes.radius[i]);
+			const TLane wheelInvMass = LaneLoad(&lanes.invMass[i]);
+			const TLane wheelInvInertia = LaneLoad(&lanes.invInertia[i]);
+
+			// bodyRot * offset
+			const SLaneVec3 worldOffset = LaneAdd3(LaneAdd3(LaneScale3(xAxis, offset.x), LaneScale3(yAxis, offset.y)), LaneScale3(zAxis, offset.z));
+
+			const SLaneVec3 contactNormal = LaneNormalize3(LaneAdd3(baseNormal, LaneLoad3(&lanes.statusNormalX[i], &lanes.statusNormalY[i], &lanes.statusNormalZ[i])));
+
+			// steering axis, xAxis * cos(steer) - yAxis * sin(steer)
+			SLaneVec3 axis = LaneScale3(xAxis, cosSteer);
+			axis.x = LaneSub(axis.x, LaneMul(yAxis.x, sinSteer));
+			axis.y = LaneSub(axis.y, LaneMul(yAxis.y, sinSteer));
+			axis.z = LaneSub(axis.z, LaneMul(yAxis.z, sinSteer));
+
+			const SLaneVec3 inlineDir = LaneNormalize3(LaneCross3(contactNormal, axis));
+			const SLaneVec3 lateralDir = LaneNormalize3(LaneCross3(inlineDir, contactNormal));
+
+			const SLaneVec3 wheelVel = LaneAdd3(vel, LaneCross3(angVel, worldOffset));
+			const TLane slipSpeed = LaneAbs(LaneSub(LaneDot3(wheelVel, inlineDir), LaneMul(LaneLoad(&lanes.w[i]), radius)));
+
+			LaneStore3(&lanes.worldOffsetX[i], &lanes.worldOffsetY[i], &lanes.worldOffsetZ[i], worldOffset);
+			LaneStore3(&lanes.contactNormalX[i], &lanes.contactNormalY[i], &lanes.contactNormalZ[i], contactNormal);
+			LaneStore3(&lanes.inlineDirX[i], &lanes.inlineDirY[i], &lanes.inlineDirZ[i], inlineDir);
+			LaneStore3(&lanes.lateralDirX[i], &lanes.lateralDirY[i], &lanes.lateralDirZ[i], lateralDir);
+			LaneStore(&lanes.slipSpeed[i], slipSpeed);
+
+			LaneStore(&lanes.wheelDenom[i], LaneAdd(wheelInvMass, LaneMul(LaneMul(radius, radius), wheelInvInertia)));
+			LaneStore(&lanes.inlineDenom[i], LaneComputeDenominator(chassisInvMass, chassisInvInertia, worldOffset, inlineDir));
+			LaneStore(&lanes.lateralDenom[i], LaneComputeDenominator(chassisInvMass, chassisInvInertia, worldOffset, lateralDir));
+		}
+	}
+}
@@ -0,0 +1,73 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Structure of arrays view of the wheels of an arcade wheeled vehicle for
+the per physics tick wheel maths: world offsets, contact normals, friction
+directions, slip speeds and the impulse denominators used by the friction
+solver. The wheels are processed four at a time (SSE where available) and
+the kernel takes any number of vehicles in one call.
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __ARCADEWHEELLANES_H__
+#define __ARCADEWHEELLANES_H__
+
+#pragma once
+
+struct SArcadeWheelLanes
+{
+	enum
+	{
+		kWidth = 4,
+		kMaxWheels = 12,		// CVehicleMovementArcadeWheeled::maxWheels rounded up to kWidth
+	};
+
+	SArcadeWheelLanes();
+
+	// zeroes the lanes past numWheels so the last group can be processed whole
+	void	ClearPadding();
+
+	int		numWheels;
+
+	// inputs: body space wheel offsets, steering, the wheel status contact normal (zero without contact)
+	float	offsetX[kMaxWheels], offsetY[kMaxWheels], offsetZ[kMaxWheels];
+	float	cosSteer[kMaxWheels], sinSteer[kMaxWheels];
+	float	statusNormalX[kMaxWheels], statusNormalY[kMaxWheels], statusNormalZ[kMaxWheels];
+	float	radius[kMaxWheels];
+	float	w[kMaxWheels];
+	float	invMass[kMaxWheels];
+	float	invInertia[kMaxWheels];
+
+	// outputs, world space
+	float	worldOffsetX[kMaxWheels], worldOffsetY[kMaxWheels], worldOffsetZ[kMaxWheels];
+	float	contactNormalX[kMaxWheels], contactNormalY[kMaxWheels], contactNormalZ[kMaxWheels];
+	float	inlineDirX[kMaxWheels], inlineDirY[kMaxWheels], inlineDirZ[kMaxWheels];
+	float	lateralDirX[kMaxWheels], lateralDirY[kMaxWheels], lateralDirZ[kMaxWheels];
+	float	slipSpeed[kMaxWheels];
+	float	wheelDenom[kMaxWheels];			// wheel only response to an inline impulse at the contact
+	float	inlineDenom[kMaxWheels];		// chassis response to an impulse along inlineDir at worldOffset
+	float	lateralDenom[kMaxWheels];		// chassis response to an impulse along lateralDir at worldOffset
+};
+
+struct SArcadeChassisFrame
+{
+	Vec3	xAxis, yAxis, zAxis;
+	Vec3	vel, angVel;
+	Vec3	contactNormal;		// base contact normal, every wheel's normal is bent towards its own contact
+	float	invMass;
+	float	invInertia;
+};
+
+struct SArcadeWheelBatchItem
+{
+	const SArcadeChassisFrame*	pChassis;
+	SArcadeWheelLanes*					pLanes;
+};
+
+// fills the outputs of the lanes of every item
+void ArcadeWheelsComputeFrames(const SArcadeWheelBatchItem* pItems, int numItems);
+
+#endif //__ARCADEWHEELLANES_H__
@@ -12,6 +12,87 @@ History:
 
 #include "Player.h"
 
+//-------------POST EFFECT PARAMS-----------------------
+
+std::vector<CPostEffectParams::SParam>  CPostEffectParams::s_params;
+std::vector<CPostEffectParams::THandle> CPostEffectParams::s_pending;
+
+//---------------------------------
+CPostEffectParams::THandle CPostEffectParams::GetHandle(const char *paramName)
+{
+	if (!paramName || !paramName[0])
+		return InvalidHandle;
+
+	const int count = (int)s_params.size();
+	for (int i = 0; i < count; ++i)
+	{
+		if (!stricmp(s_params[i].name.c_str(), paramName))
+			return i;
+	}
+
+	s_params.push_back(SParam(paramName));
+	return count;
+}
+
+//---------------------------------
+float CPostEffectParams::Get(THandle handle)
+{
+	if (handle < 0 || handle >= (int)s_params.size())
+		return 0.0f;
+
+	SParam &param = s_params[handle];
+	if (param.pending)
+		return param.value;
+
+	float value = 0.0f;
+	gEnv->p3DEngine->GetPostEffectParam(param.name.c_str(), value);
+	return value;
+}
+
+//---------------------------------
+void CPostEffectParams::Set(THandle handle, float value, bool bForceValue)
+{
+	if (handle < 0 || handle >= (int)s_params.size())
+		return;
+
+	SParam &param = s_params[handle];
+	if (!param.pending)
+	{
+		param.pending = true;
+		param.forceValue = false;
+		s_pending.push_back(handle);
+	}
+	param.value = value;
+	param.forceValue |= bForceValue;
+}
+
+//---------------------------------
+void CPostEffectParams::Submit()
+{
+	if (s_pending.empty())
+		return;
+
+	I3DEngine *p3DEngine = gEnv->p3DEngine;
+
+	const int count = (int)s_pending.size();
+	for (int i = 0; i < count; ++i)
+	{
+		SParam &param = s_params[s_pending[i]];
+		p3DEngine->SetPostEffectParam(param.name.c_str(), param.value, param.forceValue);
+		param.pending = false;
+	}
+	s_pending.resize(0);
+}
+
+//---------------------------------
+void CPostEffectParams::GetMemoryUsage(ICrySizer * s)
+{
+	s->AddContainer(s_params);
+	s->AddContainer(s_pending);
+	for (std::vector<SParam>::const_iterator it = s_params.begin(); it != s_params.end(); ++it)
+		s->Add(it->name);
+}
+
 //-------------FOV EFFECT-------------------------------
 
 CFOVEffect::CFOVEffect(EntityId ownerID, float goalFOV)
@@ -48,10 +129,10 @@ void CFOVEffect::Update(float point)
 
 //-------------------POST PROCESS FX--------------------
 
-CPostProcessEffect::CPostProcessEffect(EntityId ownerID, string paramName, float goalVal)
+CPostProcessEffect::CPostProcessEffect(EntityId ownerID, const char *paramName, float goalVal)
 {
-	m_paramName = paramName;
-	m_goalVal = goalVal;
+	m_param = CPostEffectParams::GetHandle(paramName);
+	m_startVal = m_currentVal = m_goalVal = goalVal;
 	m_ownerID = ownerID;
 }
 
@@ -61,7 +142,7 @@ void CPostProcessEffect::Init()
 	IActor *client = gEnv->pGame->GetIGameFramework()->GetIActorSystem()->GetActor(m_ownerID);
 	if (client && client->IsClient())
 	{
-		gEnv->p3DEngine->GetPostEffectParam(m_paramName, m_currentVal);
+		m_currentVal = CPostEffectParams::Get(m_param);
 		m_startVal = m_currentVal;
 	}
 }
@@ -73,6 +154,6 @@ void CPostProcessEffect::Update(float point)
 	if (client && client->IsClient())
 	{
 		m_currentVal = (point * (m_goalVal - m_startVal)) + m_startVal;
-		gEnv->p3DEngine->SetPostEffectParam(m_paramName, m_currentVal);
+		CPostEffectParams::Set(m_param, m_currentVal);
 	}
 }
\ No newline at end of file
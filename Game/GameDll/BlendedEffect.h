@@ -20,6 +20,43 @@ History:
 
 #include "PoolAllocator.h"
 
+//-PostEffectParams---------------------
+// Post effect parameters resolved once to dense handles.
+// Blended effects write into a per frame batch that the client's CScreenEffects
+// submits in PostUpdate, so several blends driving the same parameter cost a
+// single engine call per frame.
+class CPostEffectParams
+{
+public:
+	typedef int THandle;
+	enum { InvalidHandle = -1 };
+
+	static THandle GetHandle(const char *paramName);
+
+	// Pending value if written this frame, otherwise the engine value
+	static float Get(THandle handle);
+	static void Set(THandle handle, float value, bool bForceValue = false);
+
+	// Sends the parameters written since the last submit to the 3D engine
+	static void Submit();
+
+	static void GetMemoryUsage(ICrySizer * s);
+
+private:
+	struct SParam
+	{
+		SParam(const char *_name) : name(_name), value(0.0f), forceValue(false), pending(false) {}
+
+		string name;
+		float  value;
+		bool   forceValue;
+		bool   pending;
+	};
+
+	static std::vector<SParam>  s_params;
+	static std::vector<THandle> s_pending;
+};
+
 //-BlendedEffects-----------------------
 // BlendedEffect interface
 struct IBlendedEffect 
@@ -104,7 +141,7 @@ class CPostProcessEffect
 {
 
  public:
-		CPostProcessEffect(EntityId ownerID, string paramName, float goalVal);
+		CPostProcessEffect(EntityId ownerID, const char *paramName, float goalVal);
 		virtual ~CPostProcessEffect() {};
 	
 		virtual void Init();
@@ -115,7 +152,7 @@ private:
 		float m_startVal;
 		float m_currentVal;
 		float m_goalVal;
-		string m_paramName;
+		CPostEffectParams::THandle m_param;
 		EntityId m_ownerID;
 };
 #endif
\ No newline at end of file
@@ -12,6 +12,7 @@ History:
 *************************************************************************/
 #include "StdAfx.h"
 #include "C4.h"
+#include "GameNetProfiler.h"
 #include "Plant.h"
 
 #include "Game.h"
@@ -191,6 +192,7 @@ void CC4::SelectDetonator()
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CC4, ClSetProjectileId)
 {
+	GAME_NET_PROFILE_RMI(CC4, ClSetProjectileId);
 	IFireMode *pFireMode=GetFireMode(params.fmId);
 	if (pFireMode)
 		pFireMode->SetProjectileId(params.id);
@@ -203,6 +205,7 @@ IMPLEMENT_RMI(CC4, ClSetProjectileId)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CC4, SvRequestTime)
 {
+	GAME_NET_PROFILE_RMI(CC4, SvRequestTime);
 	IFireMode *pFireMode=GetFireMode(params.fmId);
 	if (pFireMode && !stricmp(pFireMode->GetType(), "Plant"))
 	{
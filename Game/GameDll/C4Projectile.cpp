@@ -12,6 +12,7 @@ History:
 *************************************************************************/
 #include "StdAfx.h"
 #include "C4Projectile.h"
+#include "GameNetProfiler.h"
 #include "Player.h"
 #include "GameRules.h"
 
@@ -317,6 +318,7 @@ bool CC4Projectile::StickToCharacter(bool stick,IEntity* pActor)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CC4Projectile, ClSetPosition)
 {
+	GAME_NET_PROFILE_RMI(CC4Projectile, ClSetPosition);
 	Matrix34 mat;
 	mat.SetRotation33(Matrix33(params.rot));
 	mat.SetTranslation(params.pos);
@@ -330,6 +332,7 @@ IMPLEMENT_RMI(CC4Projectile, ClSetPosition)
 //-------------------------------------------------------------------------
 IMPLEMENT_RMI(CC4Projectile, ClStickToEntity)
 {
+	GAME_NET_PROFILE_RMI(CC4Projectile, ClStickToEntity);
 	if(IEntity* pEntity = gEnv->pEntitySystem->GetEntity(params.targetId))
 	{
 		Matrix34 localMatrix;
@@ -15,10 +15,13 @@ History:
 #include "StdAfx.h"
 #include "CameraRayScan.h"
 #include "Game.h"
+#include "GameCVars.h"
 
 //this is used to make sure the camera has some extra space inside the rayscan range
 const static float RAY_SCAN_BUFFER_SCALE = 1.1f;
 const static float RAY_SCAN_OFFSET_DISTANCE = 0.2f;
+//radius of the swept sphere, covers the spread of the corner rays
+const static float RAY_SCAN_SWEEP_RADIUS = 0.15f;
 //raycast settings
 const int CCameraRayScan::g_objTypes = (ent_all | ent_water) & ~(ent_living | ent_independent | ent_rigid);
 const int CCameraRayScan::g_geomFlags = geom_colltype0|geom_colltype_player|rwi_stop_at_pierceable;
@@ -27,12 +30,33 @@ const static Vec3 g_vRayUpOffset(0,0,0.1f);
 const static Vec3 g_vRayUpDir(0,0,0.1f);
 
 CCameraRayScan::CCameraRayScan()
+: m_sweepID(INVALID_RAY_ID)
+, m_nextExternalResult(0)
 {
 	Reset();
 }
 
 CCameraRayScan::~CCameraRayScan()
 {
+	CancelPending();
+}
+
+void CCameraRayScan::CancelPending()
+{
+	for(int i = 0; i < eNUM_RAYS; ++i)
+	{
+		if (m_rayInfo[i].rayID != INVALID_RAY_ID)
+		{
+			g_pGame->GetRayCaster().Cancel(m_rayInfo[i].rayID);
+			m_rayInfo[i].rayID = INVALID_RAY_ID;
+		}
+	}
+
+	if (m_sweepID != INVALID_RAY_ID)
+	{
+		g_pGame->GetIntersectionTester().Cancel(m_sweepID);
+		m_sweepID = INVALID_RAY_ID;
+	}
 }
 
 void CCameraRayScan::OnRayCastResult(const QueuedRayID &rayID, const RayCastResult &result)
@@ -48,19 +72,50 @@ void CCameraRayScan::OnRayCastResult(const QueuedRayID &rayID, const RayCastResu
 			return;
 		}
 	}
-	assert(m_ExternalRayCasts.find(rayID) == m_ExternalRayCasts.end());
-	m_ExternalRayCasts[rayID] = result;
+
+	//overwrites the oldest result if the callers didn't remove it
+	SExternalResult& external = m_externalResults[m_nextExternalResult];
+	external.rayID = rayID;
+	external.result = result;
+	m_nextExternalResult = (m_nextExternalResult + 1) % eNUM_EXTERNAL_RESULTS;
+}
+
+void CCameraRayScan::OnSweepResult(const QueuedIntersectionID &sweepID, const IntersectionTestResult &result)
+{
+	if (sweepID != m_sweepID)
+		return;
+	m_sweepID = INVALID_RAY_ID;
+
+	SRayCastInfo &info = m_rayInfo[eRAY_CENTER];
+	//a sweep starting in penetration reports a contact (with its normal) at distance <= 0, which is still a hit
+	info.hashit = (result.distance > 0.0f) || (result.normal.GetLengthSquared() > 0.0f);
+	if (info.hashit)
+	{
+		ray_hit &hit = info.hit;
+		memset(&hit, 0, sizeof(hit));
+		hit.dist = max(result.distance, 0.0f);
+		hit.pt = result.point;
+		hit.n = result.normal;
+		hit.partid = result.partId;
+		hit.surface_idx = result.idxMat;
+		hit.idmatOrg = result.idxMat;
+	}
 }
 
 void CCameraRayScan::Reset()
 {
+	CancelPending();
+
 	//clear results
 	for(int i = 0; i < eNUM_RAYS; ++i)
 	{
 		m_rayInfo[i].rayID = INVALID_RAY_ID;
 		m_rayInfo[i].hashit = false;
 	}
-	m_ExternalRayCasts.clear();
+
+	for(int i = 0; i < eNUM_EXTERNAL_RESULTS; ++i)
+		m_externalResults[i].rayID = INVALID_RAY_ID;
+	m_nextExternalResult = 0;
 }
 
 ray_hit * CCameraRayScan::GetHit(ECameraRays nr)
@@ -94,20 +149,30 @@ const Vec3& CCameraRayScan::GetRayDir(ECameraRays nr) const
 
 const RayCastResult* CCameraRayScan::GetExternalHit(const QueuedRayID& queuedId) const
 {
-	TRayCastResultMap::const_iterator it = m_ExternalRayCasts.find(queuedId);
-	if (it != m_ExternalRayCasts.end())
-		return &it->second;
+	if (queuedId == INVALID_RAY_ID)
+		return NULL;
+
+	for(int i = 0; i < eNUM_EXTERNAL_RESULTS; ++i)
+	{
+		if (m_externalResults[i].rayID == queuedId)
+			return &m_externalResults[i].result;
+	}
 	return NULL;
 }
 
 void CCameraRayScan::RemoveExternalHit(const QueuedRayID& queuedId)
 {
-	TRayCastResultMap::iterator it = m_ExternalRayCasts.find(queuedId);
-	if (it != m_ExternalRayCasts.end())
-		m_ExternalRayCasts.erase(it);
+	if (queuedId == INVALID_RAY_ID)
+		return;
+
+	for(int i = 0; i < eNUM_EXTERNAL_RESULTS; ++i)
+	{
+		if (m_externalResults[i].rayID == queuedId)
+			m_externalResults[i].rayID = INVALID_RAY_ID;
+	}
 }
 
-void CCameraRayScan::ShootRays(const Vec3 &rayPos, const Vec3 &rayDir, IPhysicalEntity **pSkipEnts, int numSkipEnts)
+void CCameraRayScan::ShootRays(const Vec3 &rayPos, const Vec3 &rayDir, IPhysicalEntity **pSkipEnts, int numSkipEnts, bool bSideRays)
 {
 
 	//shoot rays for all ray_hits
@@ -119,10 +184,32 @@ void CCameraRayScan::ShootRays(const Vec3 &rayPos, const Vec3 &rayDir, IPhysical
 
 	const Vec3 rayPos2 = rayPos + (dirNorm * RAY_SCAN_OFFSET_DISTANCE); //move the rays away from the head to prevent clipping
 
-	//center ray
 	Vec3 tempPos = rayPos2;
 	Vec3 tempDir = dirNorm;
-	ShootRayInt(eRAY_CENTER, tempPos, tempDir, len, pSkipEnts, numSkipEnts);
+
+	if (g_pGameCVars->cl_cam_rayScanMode == 1)
+	{
+		//one swept sphere instead of the center ray, the distance covers the corner rays as well
+		if (m_rayInfo[eRAY_CENTER].rayID != INVALID_RAY_ID)
+		{
+			g_pGame->GetRayCaster().Cancel(m_rayInfo[eRAY_CENTER].rayID);
+			m_rayInfo[eRAY_CENTER].rayID = INVALID_RAY_ID;
+		}
+		m_rayInfo[eRAY_CENTER].dir = tempDir;
+		ShootSweep(tempPos, tempDir, len, pSkipEnts, numSkipEnts);
+
+		if (!bSideRays)
+		{
+			for(int i = eRAY_CENTER + 1; i < eNUM_RAYS; ++i)
+				m_rayInfo[i].hashit = false;
+			return;
+		}
+	}
+	else
+	{
+		//center ray
+		ShootRayInt(eRAY_CENTER, tempPos, tempDir, len, pSkipEnts, numSkipEnts);
+	}
 
 	tempDir = (dirNorm - rightDir + g_vRayUpDir).normalized();
 	tempPos = rayPos2 - rightOff + g_vRayUpOffset;
@@ -161,6 +248,20 @@ void CCameraRayScan::ShootRayInt(ECameraRays camRay, const Vec3 &rayPos, const V
 	}
 }
 
+void CCameraRayScan::ShootSweep(const Vec3 &rayPos, const Vec3 &rayDir, const float& len, IPhysicalEntity **pSkipEnts, int numSkipEnts)
+{
+	if (m_sweepID != INVALID_RAY_ID)
+		return;
+
+	primitives::sphere sphere;
+	sphere.center = rayPos;
+	sphere.r = RAY_SCAN_SWEEP_RADIUS;
+
+	m_sweepID = g_pGame->GetIntersectionTester().Queue(IntersectionTestRequest::MediumPriority,
+		IntersectionTestRequest(primitives::sphere::type, sphere, rayDir * len, g_objTypes, 0, geom_colltype0|geom_colltype_player, pSkipEnts, numSkipEnts),
+		functor(*this, &CCameraRayScan::OnSweepResult));
+}
+
 QueuedRayID CCameraRayScan::ShootRay(const Vec3 &rayPos, const Vec3 &rayDir, int objTypes /*= g_objTypes*/, int geomFlags /*= g_geomFlags*/, IPhysicalEntity **pSkipEnts /*= NULL*/, int numSkipEnts /*= 0*/)
 {
 	return g_pGame->GetRayCaster().Queue(RayCastRequest::MediumPriority,
@@ -16,6 +16,7 @@ History:
 #define CAMERA_RAY_SCAN
 
 #include "RayCastQueue.h"
+#include "IntersectionTestQueue.h"
 
 enum ECameraRays
 {
@@ -40,8 +41,9 @@ public:
 
 	void Reset();
 
-	//update all rays
-	void ShootRays(const Vec3 &rayPos, const Vec3 &rayDir, IPhysicalEntity **pSkipEnts = NULL, int numSkipEnts = 0);
+	//update all rays, with cl_cam_rayScanMode 1 the collision distance comes from one swept sphere
+	//and the side rays are only cast when bSideRays is set (needed by the camera tracking)
+	void ShootRays(const Vec3 &rayPos, const Vec3 &rayDir, IPhysicalEntity **pSkipEnts = NULL, int numSkipEnts = 0, bool bSideRays = true);
 	//send one ray and save in pHit (deferred)
 	QueuedRayID ShootRay(const Vec3 &rayPos, const Vec3 &rayDir, int objTypes = g_objTypes, int geomFlags = g_geomFlags, IPhysicalEntity **pSkipEnts = NULL, int numSkipEnts = 0);
 	//get current hit
@@ -54,7 +56,10 @@ public:
 
 private:
 	void ShootRayInt(ECameraRays camRay, const Vec3 &rayPos, const Vec3 &rayDir, const float& len, IPhysicalEntity **pSkipEnts, int numSkipEnts);
+	void ShootSweep(const Vec3 &rayPos, const Vec3 &rayDir, const float& len, IPhysicalEntity **pSkipEnts, int numSkipEnts);
 	void OnRayCastResult(const QueuedRayID &rayID, const RayCastResult &result);
+	void OnSweepResult(const QueuedIntersectionID &sweepID, const IntersectionTestResult &result);
+	void CancelPending();
 
 private:
 	static const int g_objTypes;
@@ -69,9 +74,18 @@ private:
 		bool hashit;
 	};
 	SRayCastInfo m_rayInfo[eNUM_RAYS];
+	QueuedIntersectionID m_sweepID;
 
-	typedef std::map<QueuedRayID, RayCastResult> TRayCastResultMap;
-	TRayCastResultMap m_ExternalRayCasts;
+	//results of ShootRay, the callers poll and remove them within a few frames
+	enum { eNUM_EXTERNAL_RESULTS = 4 };
+	struct SExternalResult
+	{
+		SExternalResult() : rayID(INVALID_RAY_ID) {}
+		QueuedRayID rayID;
+		RayCastResult result;
+	};
+	SExternalResult m_externalResults[eNUM_EXTERNAL_RESULTS];
+	int m_nextExternalResult;
 };
 
 #endif
\ No newline at end of file
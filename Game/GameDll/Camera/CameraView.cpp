@@ -350,14 +350,15 @@ void CCameraView::RunScanAndTrack(SViewParams &viewParams)
 
 	//strange bugs are happening since living entities are being hit
 	IPhysicalEntity *pTargetPhysics = m_pTarget->GetPhysics();
-	m_pCamRayScan->ShootRays(vCamTarget, -vCamDir * viewParams.dist, &pTargetPhysics, 1);
+	const bool bTracking = (m_curSettings.collisionType == ECCT_CollisionTrack || m_curSettings.collisionType == ECCT_CollisionTrackOrCut);
+	m_pCamRayScan->ShootRays(vCamTarget, -vCamDir * viewParams.dist, &pTargetPhysics, 1, bTracking && g_pGameCVars->cl_cam_tracking);
 	ray_hit *pHit = m_pCamRayScan->GetHit();
 
 	//was there a collision ?
 	bool bCollision = (pHit != 0 && pHit->dist > 0.0f && pHit->dist < viewParams.dist);
 
 	//camera tracking
-	if(m_curSettings.collisionType == ECCT_CollisionTrack || m_curSettings.collisionType == ECCT_CollisionTrackOrCut)
+	if(bTracking)
 	{
 		float hOffTemp = 0.0f;
 		//this shouldn't need the hero to update -> refactor camera tracker
@@ -55,103 +55,87 @@ size_t CClientGameTokenSynch::CResetMsg::GetSize()
 
 
 //------------------------------------------------------------------------
-// GLOBAL
+// BATCH
 //------------------------------------------------------------------------
-#define DEFINE_MESSAGE(class, type, msgdef) \
-	CClientGameTokenSynch::class::class(int _channelId, TGameTokenName _name, TGameTokenValue &_value) \
-	:	CSetMsg(CClientGameTokenSynch::msgdef, _channelId, _name, _value) {}; \
-	EMessageSendResult CClientGameTokenSynch::class::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq) \
-{ CClientGameTokenSynch::SerializeGameToken(ser, name, value, NTypelist::IndexOf<type, TGameTokenValueTypes>::value); \
-	return eMSR_SentOk; }
-
-#define IMPLEMENT_IMMEDIATE_MESSAGE(type) \
-	TGameTokenName	name; \
-	TGameTokenValue value; \
-	CClientGameTokenSynch::SerializeGameToken(ser, name, value, NTypelist::IndexOf<type, TGameTokenValueTypes>::value); \
-	m_pGTS->SetOrCreateToken(name, value); \
-	return true;
-
-//------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientGameTokenSynch, SetIntMsg, eNRT_ReliableUnordered, 0)
+NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientGameTokenSynch, SetBatchMsg, eNRT_ReliableOrdered, 0)
 {
-	IMPLEMENT_IMMEDIATE_MESSAGE(int);
-}
+	uint8 count=0;
+	ser.Value("count", count, 'ui8');
 
-//------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientGameTokenSynch, SetFloatMsg, eNRT_ReliableUnordered, 0)
-{
-	IMPLEMENT_IMMEDIATE_MESSAGE(float);
-}
+	for (int i=0; i<count; ++i)
+	{
+		uint16 id=0;
+		ser.Value("id", id, 'ui16');
 
+		bool define=false;
+		ser.Value("define", define, 'bool');
+		if (define)
+		{
+			if (id>=m_names.size())
+				m_names.resize(id+1);
+			ser.Value("name", m_names[id]);
+		}
 
-//------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientGameTokenSynch, SetEntityIdMsg, eNRT_ReliableUnordered, 0)
-{
-	IMPLEMENT_IMMEDIATE_MESSAGE(EntityId);
-}
+		uint8 type=0;
+		ser.Value("type", type, 'ui3');
 
-//------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientGameTokenSynch, SetVec3Msg, eNRT_ReliableUnordered, 0)
-{
-	IMPLEMENT_IMMEDIATE_MESSAGE(Vec3);
-}
+		TGameTokenValue value;
+		SerializeGameTokenValue(ser, value, type);
 
-//------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientGameTokenSynch, SetStringMsg, eNRT_ReliableUnordered, 0)
-{
-	IMPLEMENT_IMMEDIATE_MESSAGE(string);
-}
+		if (id<m_names.size() && !m_names[id].empty())
+			m_pGTS->SetOrCreateToken(m_names[id], value);
+		else
+			GameWarning("Game token %d changed before being defined", id);
+	}
 
-//------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientGameTokenSynch, SetBoolMsg, eNRT_ReliableUnordered, 0)
-{
-	IMPLEMENT_IMMEDIATE_MESSAGE(bool);
+	return true;
 }
 
 //------------------------------------------------------------------------
-CClientGameTokenSynch::CSetMsg::CSetMsg(const SNetMessageDef *pDef, int _channelId, TGameTokenName &_name, TGameTokenValue &_value)
-:	channelId(_channelId),
-	name(_name),
-	value(_value),
-	INetMessage(pDef)
+CClientGameTokenSynch::CSetBatchMsg::CSetBatchMsg(int _channelId)
+:	INetMessage(CClientGameTokenSynch::SetBatchMsg),
+	channelId(_channelId)
 {
 	SetGroup( 'stor' );
 };
 
 //------------------------------------------------------------------------
-EMessageSendResult CClientGameTokenSynch::CSetMsg::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq)
+EMessageSendResult CClientGameTokenSynch::CSetBatchMsg::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq)
 {
+	uint8 count=entries.size();
+	ser.Value("count", count, 'ui8');
+
+	for (TEntries::iterator it=entries.begin(); it!=entries.end(); ++it)
+	{
+		ser.Value("id", it->id, 'ui16');
+		ser.Value("define", it->define, 'bool');
+		if (it->define)
+			ser.Value("name", it->name);
+
+		uint8 type=it->value.GetType();
+		ser.Value("type", type, 'ui3');
+
+		CClientGameTokenSynch::SerializeGameTokenValue(ser, it->value, type);
+	}
+
 	return eMSR_SentOk;
 }
 
 //------------------------------------------------------------------------
-void CClientGameTokenSynch::CSetMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
+void CClientGameTokenSynch::CSetBatchMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
 {
 }
 
 //------------------------------------------------------------------------
-size_t CClientGameTokenSynch::CSetMsg::GetSize()
+size_t CClientGameTokenSynch::CSetBatchMsg::GetSize()
 {
-	return sizeof(*this);
+	return sizeof(*this)+entries.capacity()*sizeof(SEntry);
 };
 
 
-DEFINE_MESSAGE(CSetIntMsg,			int,			SetIntMsg);
-DEFINE_MESSAGE(CSetFloatMsg,		float,		SetFloatMsg);
-DEFINE_MESSAGE(CSetVec3Msg,			Vec3,			SetVec3Msg);
-DEFINE_MESSAGE(CSetEntityIdMsg, EntityId, SetEntityIdMsg);
-DEFINE_MESSAGE(CSetStringMsg,		string,		SetStringMsg);
-DEFINE_MESSAGE(CSetBoolMsg,			bool,			SetBoolMsg);
-
-#undef DEFINE_MESSAGE
-#undef IMPLEMENT_IMMEDIATE_MESSAGE
-
-
 //------------------------------------------------------------------------
-void CClientGameTokenSynch::SerializeGameToken(TSerialize ser, TGameTokenName &name, TGameTokenValue &value, int type)
+void CClientGameTokenSynch::SerializeGameTokenValue(TSerialize ser, TGameTokenValue &value, int type)
 {
-	ser.Value("name", name);
-
 	switch (type)
 	{
 	case eFDT_Int:
@@ -222,8 +206,15 @@ void CClientGameTokenSynch::SerializeGameToken(TSerialize ser, TGameTokenName &n
 }
 
 
+//------------------------------------------------------------------------
+void CClientGameTokenSynch::Reset()
+{
+	m_names.clear();
+}
+
 //------------------------------------------------------------------------
 void CClientGameTokenSynch::GetMemoryUsage(ICrySizer *pSizer) const
 {
 	pSizer->Add(*this);
+	pSizer->AddContainer(m_names);
 }
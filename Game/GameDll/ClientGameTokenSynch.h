@@ -29,14 +29,6 @@ typedef TFlowSystemDataTypes	TGameTokenValueTypes;
 
 
 
-#define DECLARE_MESSAGE(classname) \
-class classname: public CSetMsg \
-	{ \
-	public: \
-	classname(int _channelId, TGameTokenName _name, TGameTokenValue &_value); \
-	EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq); \
-	}; \
-
 
 struct IGameFramework;
 class CServerGameTokenSynch;
@@ -48,7 +40,7 @@ public:
 	CClientGameTokenSynch(IGameTokenSystem *pGTS) { m_pGTS=pGTS; };
 	virtual ~CClientGameTokenSynch() {};
 
-	void Reset() {}; // TODO: implement
+	void Reset();
 	void GetMemoryUsage(ICrySizer *pSizer) const ;
 
 	// INetMessageSink
@@ -69,44 +61,44 @@ public:
 	};
 
 	//------------------------------------------------------------------------
-	class CSetMsg: public INetMessage
+	// Tokens changed on a channel since the last flush. Tokens are referred to by an id interned on
+	// the server, their name is only sent the first time the channel sees them.
+	class CSetBatchMsg: public INetMessage
 	{
 	public:
-		CSetMsg(const SNetMessageDef *pDef, int _channelId, TGameTokenName &_name, TGameTokenValue &_value);
+		enum { k_maxEntries = 64 };
+
+		struct SEntry
+		{
+			uint16					id;
+			bool						define;			// name not sent to the channel yet
+			TGameTokenName	name;
+			TGameTokenValue	value;
+		};
+		typedef std::vector<SEntry>	TEntries;
+
+		CSetBatchMsg(int _channelId);
 
 		int							channelId;
 
-		TGameTokenName	name;
-		TGameTokenValue	value;
+		TEntries				entries;
 
 		virtual EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq);
 		virtual void UpdateState(uint32 fromSeq, ENetSendableStateUpdate update);
 		virtual size_t GetSize();
 	};
 
-	static void SerializeGameToken(TSerialize ser, TGameTokenName &name, TGameTokenValue &value, int type);
-	
-	DECLARE_MESSAGE(CSetIntMsg);
-	DECLARE_MESSAGE(CSetFloatMsg);
-	DECLARE_MESSAGE(CSetVec3Msg);
-	DECLARE_MESSAGE(CSetEntityIdMsg);
-	DECLARE_MESSAGE(CSetStringMsg);
-	DECLARE_MESSAGE(CSetBoolMsg);
+	static void SerializeGameTokenValue(TSerialize ser, TGameTokenValue &value, int type);
 
 	//------------------------------------------------------------------------
 	NET_DECLARE_IMMEDIATE_MESSAGE(ResetMsg);
 	
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetIntMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetFloatMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetVec3Msg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetEntityIdMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetStringMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetBoolMsg);
+	NET_DECLARE_IMMEDIATE_MESSAGE(SetBatchMsg);
 
 protected:
 	IGameTokenSystem *m_pGTS;
-};
 
-#undef DECLARE_MESSAGE
+	std::vector<TGameTokenName>	m_names;		// token names by id, as defined by the server
+};
 
 #endif //__CLIENTGAMETOKENSYNCH_H__
@@ -13,6 +13,7 @@ History:
 #include "StdAfx.h"
 #include "ClientSynchedStorage.h"
 #include "ServerSynchedStorage.h"
+#include <PoolAllocator.h>
 
 
 //------------------------------------------------------------------------
@@ -58,266 +59,280 @@ size_t CClientSynchedStorage::CResetMsg::GetSize()
 
 
 //------------------------------------------------------------------------
-// GLOBAL
+// DELTA
 //------------------------------------------------------------------------
 
-#define DEFINE_GLOBAL_MESSAGE(class, type, msgdef) \
-	CClientSynchedStorage::class::class(int _channelId, CServerSynchedStorage *pStorage, TSynchedKey _key, TSynchedValue &_value) \
-	:	CSetGlobalMsg(CClientSynchedStorage::msgdef, _channelId, pStorage, _key, _value) {}; \
-	EMessageSendResult CClientSynchedStorage::class::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq) \
-{ m_pStorage->SerializeValue(ser, key, value, NTypelist::IndexOf<type, TSynchedValueTypes>::value); \
-	return eMSR_SentOk; }
-
-#define IMPLEMENT_IMMEDIATE_GLOBAL_MESSAGE(type) \
-	CryAutoCriticalSection lock(m_mutex); \
-	TSynchedKey		key; \
-	TSynchedValue value; \
-	SerializeValue(ser, key, value, NTypelist::IndexOf<type, TSynchedValueTypes>::value); \
-	return true;
-
-
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetGlobalBoolMsg, eNRT_ReliableUnordered, 0)
-{
-	IMPLEMENT_IMMEDIATE_GLOBAL_MESSAGE(bool);
-}
+typedef stl::PoolAllocator<sizeof(CClientSynchedStorage::CSetDeltaMsg), stl::PoolAllocatorSynchronizationMultithreaded> TDeltaMsgAlloc;
+static TDeltaMsgAlloc s_deltaMsgAlloc;
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetGlobalFloatMsg, eNRT_ReliableUnordered, 0)
+NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetGlobalDeltaMsg, eNRT_ReliableUnordered, 0)
 {
-	IMPLEMENT_IMMEDIATE_GLOBAL_MESSAGE(float);
+	return ReadDelta(ser, false);
 }
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetGlobalIntMsg, eNRT_ReliableUnordered, 0)
+NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetChannelDeltaMsg, eNRT_ReliableUnordered, 0)
 {
-	IMPLEMENT_IMMEDIATE_GLOBAL_MESSAGE(int);
+	return ReadDelta(ser, false);
 }
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetGlobalEntityIdMsg, eNRT_ReliableUnordered, 0)
+NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetEntityDeltaMsg, eNRT_ReliableUnordered, eMPF_AfterSpawning)
 {
-	IMPLEMENT_IMMEDIATE_GLOBAL_MESSAGE(EntityId);
+	return ReadDelta(ser, true);
 }
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetGlobalStringMsg, eNRT_ReliableUnordered, 0)
+bool CClientSynchedStorage::ReadDelta(TSerialize ser, bool entities)
 {
-	IMPLEMENT_IMMEDIATE_GLOBAL_MESSAGE(string);
+	CryAutoCriticalSection lock(m_mutex);
+
+	uint8 count=0;
+	ser.Value("count", count, 'ui8');
+
+	EntityId id=0;
+	for (int i=0; i<count; ++i)
+	{
+		if (entities)
+		{
+			bool newEntity=false;
+			ser.Value("newEntity", newEntity, 'bool');
+			if (newEntity)
+				ser.Value("entityId", id, 'eid');
+		}
+
+		uint8 type=0;
+		ser.Value("type", type, 'ui3');
+
+		TSynchedKey		key;
+		TSynchedValue value;
+		if (entities)
+			SerializeEntityValue(ser, id, key, value, type);
+		else
+			SerializeValue(ser, key, value, type);
+	}
+
+	return true;
 }
 
 //------------------------------------------------------------------------
-CClientSynchedStorage::CSetGlobalMsg::CSetGlobalMsg(const SNetMessageDef *pDef, int _channelId, CServerSynchedStorage *pStorage, TSynchedKey _key, TSynchedValue &_value)
-:	channelId(_channelId),
+CClientSynchedStorage::CSetDeltaMsg::CSetDeltaMsg(EScope _scope, int _channelId, CServerSynchedStorage *pStorage)
+:	INetMessage(GetScopeDef(_scope)),
+	channelId(_channelId),
 	m_pStorage(pStorage),
-	key(_key),
-	value(_value),
-	INetMessage(pDef)
+	scope(_scope),
+	numEntries(0)
 {
 	SetGroup( 'stor' );
 };
 
 //------------------------------------------------------------------------
-EMessageSendResult CClientSynchedStorage::CSetGlobalMsg::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq)
+const SNetMessageDef *CClientSynchedStorage::CSetDeltaMsg::GetScopeDef(EScope scope)
 {
-	return eMSR_SentOk;
+	switch (scope)
+	{
+	case eS_Channel:
+		return CClientSynchedStorage::SetChannelDeltaMsg;
+	case eS_Entity:
+		return CClientSynchedStorage::SetEntityDeltaMsg;
+	}
+
+	return CClientSynchedStorage::SetGlobalDeltaMsg;
 }
 
 //------------------------------------------------------------------------
-void CClientSynchedStorage::CSetGlobalMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
+void CClientSynchedStorage::CSetDeltaMsg::AddEntry(EntityId id, TSynchedKey key, const TSynchedValue &value)
 {
+	assert(!IsFull());
+
+	entityIds[numEntries]=id;
+	keys[numEntries]=key;
+	values[numEntries]=value;
+	++numEntries;
 }
 
 //------------------------------------------------------------------------
-size_t CClientSynchedStorage::CSetGlobalMsg::GetSize()
+EMessageSendResult CClientSynchedStorage::CSetDeltaMsg::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq)
 {
-	return sizeof(*this);
-};
+	uint8 count=numEntries;
+	ser.Value("count", count, 'ui8');
 
-DEFINE_GLOBAL_MESSAGE(CSetGlobalBoolMsg, bool, SetGlobalBoolMsg);
-DEFINE_GLOBAL_MESSAGE(CSetGlobalFloatMsg, float, SetGlobalFloatMsg);
-DEFINE_GLOBAL_MESSAGE(CSetGlobalIntMsg, int, SetGlobalIntMsg);
-DEFINE_GLOBAL_MESSAGE(CSetGlobalEntityIdMsg, EntityId, SetGlobalEntityIdMsg);
-DEFINE_GLOBAL_MESSAGE(CSetGlobalStringMsg, string, SetGlobalStringMsg);
+	for (int i=0; i<numEntries; ++i)
+	{
+		if (scope==eS_Entity)
+		{
+			bool newEntity=(i==0) || (entityIds[i]!=entityIds[i-1]);
+			ser.Value("newEntity", newEntity, 'bool');
+			if (newEntity)
+				ser.Value("entityId", entityIds[i], 'eid');
+		}
 
-#undef DEFINE_GLOBAL_MESSAGE
-#undef IMPLEMENT_IMMEDIATE_GLOBAL_MESSAGE
+		uint8 type=values[i].GetType();
+		ser.Value("type", type, 'ui3');
 
+		if (scope==eS_Entity)
+			m_pStorage->SerializeEntityValue(ser, entityIds[i], keys[i], values[i], type);
+		else
+			m_pStorage->SerializeValue(ser, keys[i], values[i], type);
+	}
 
-
-//------------------------------------------------------------------------
-// CHANNEL
-//------------------------------------------------------------------------
-
-#define DEFINE_CHANNEL_MESSAGE(class, type, msgdef) \
-	CClientSynchedStorage::class::class(int _channelId, CServerSynchedStorage *pStorage, TSynchedKey _key, TSynchedValue &_value) \
-	:	CSetChannelMsg(CClientSynchedStorage::msgdef, _channelId, pStorage, _key, _value) {}; \
-	EMessageSendResult CClientSynchedStorage::class::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq) \
-{ m_pStorage->SerializeValue(ser, key, value, NTypelist::IndexOf<type, TSynchedValueTypes>::value); \
-	return eMSR_SentOk; }
-
-#define IMPLEMENT_IMMEDIATE_CHANNEL_MESSAGE(type) \
-	CryAutoCriticalSection lock(m_mutex); \
-	TSynchedKey		key; \
-	TSynchedValue value; \
-	SerializeValue(ser, key, value, NTypelist::IndexOf<type, TSynchedValueTypes>::value); \
-	return true;
-
-
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetChannelBoolMsg, eNRT_ReliableUnordered, 0)
-{
-	IMPLEMENT_IMMEDIATE_CHANNEL_MESSAGE(bool);
+	return eMSR_SentOk;
 }
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetChannelFloatMsg, eNRT_ReliableUnordered, 0)
+void CClientSynchedStorage::CSetDeltaMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
 {
-	IMPLEMENT_IMMEDIATE_CHANNEL_MESSAGE(float);
 }
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetChannelIntMsg, eNRT_ReliableUnordered, 0)
+size_t CClientSynchedStorage::CSetDeltaMsg::GetSize()
 {
-	IMPLEMENT_IMMEDIATE_CHANNEL_MESSAGE(int);
-}
+	return sizeof(*this);
+};
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetChannelEntityIdMsg, eNRT_ReliableUnordered, 0)
+void *CClientSynchedStorage::CSetDeltaMsg::operator new(size_t size)
 {
-	IMPLEMENT_IMMEDIATE_CHANNEL_MESSAGE(EntityId);
+	assert(size==sizeof(CSetDeltaMsg));
+	return s_deltaMsgAlloc.Allocate();
 }
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetChannelStringMsg, eNRT_ReliableUnordered, 0)
+void CClientSynchedStorage::CSetDeltaMsg::operator delete(void *p)
 {
-	IMPLEMENT_IMMEDIATE_CHANNEL_MESSAGE(string);
+	if (p)
+		s_deltaMsgAlloc.Deallocate(p);
 }
 
 //------------------------------------------------------------------------
-CClientSynchedStorage::CSetChannelMsg::CSetChannelMsg(const SNetMessageDef *pDef, int _channelId, CServerSynchedStorage *pStorage, TSynchedKey _key, TSynchedValue &_value)
-:	channelId(_channelId),
-	m_pStorage(pStorage),
-	key(_key),
-	value(_value),
-	INetMessage(pDef)
-{
-	SetGroup( 'stor' );
-};
-
+// SNAPSHOT
 //------------------------------------------------------------------------
-EMessageSendResult CClientSynchedStorage::CSetChannelMsg::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq)
+
+NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetSnapshotMsg, eNRT_ReliableOrdered, 0)
 {
-	return eMSR_SentOk;
+	return ReadSnapshot(ser, false);
 }
 
 //------------------------------------------------------------------------
-void CClientSynchedStorage::CSetChannelMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
+NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetEntitySnapshotMsg, eNRT_ReliableUnordered, eMPF_AfterSpawning)
 {
+	return ReadSnapshot(ser, true);
 }
 
 //------------------------------------------------------------------------
-size_t CClientSynchedStorage::CSetChannelMsg::GetSize()
+bool CClientSynchedStorage::ReadSnapshot(TSerialize ser, bool entities)
 {
-	return sizeof(*this);
-};
-
-DEFINE_CHANNEL_MESSAGE(CSetChannelBoolMsg, bool, SetChannelBoolMsg);
-DEFINE_CHANNEL_MESSAGE(CSetChannelFloatMsg, float, SetChannelFloatMsg);
-DEFINE_CHANNEL_MESSAGE(CSetChannelIntMsg, int, SetChannelIntMsg);
-DEFINE_CHANNEL_MESSAGE(CSetChannelEntityIdMsg, EntityId, SetChannelEntityIdMsg);
-DEFINE_CHANNEL_MESSAGE(CSetChannelStringMsg, string, SetChannelStringMsg);
-
-#undef DEFINE_CHANNEL_MESSAGE
-#undef IMPLEMENT_IMMEDIATE_CHANNEL_MESSAGE
+	CryAutoCriticalSection lock(m_mutex);
 
-//------------------------------------------------------------------------
-// ENTITY
-//------------------------------------------------------------------------
+	uint16 count=0;
+	ser.Value("count", count, 'ui16');
+
+	EntityId id=0;
+	for (int i=0; i<count; ++i)
+	{
+		if (entities)
+		{
+			bool newEntity=false;
+			ser.Value("newEntity", newEntity, 'bool');
+			if (newEntity)
+				ser.Value("entityId", id, 'eid');
+		}
+
+		uint8 type=0;
+		ser.Value("type", type, 'ui3');
+
+		TSynchedKey		key;
+		TSynchedValue value;
+		if (entities)
+			SerializeEntityValue(ser, id, key, value, type);
+		else
+			SerializeValue(ser, key, value, type);
+	}
 
-#define DEFINE_ENTITY_MESSAGE(class, type, msgdef) \
-	CClientSynchedStorage::class::class(int _channelId, CServerSynchedStorage *pStorage, EntityId id, TSynchedKey _key, TSynchedValue &_value) \
-	:	CSetEntityMsg(CClientSynchedStorage::msgdef, _channelId, pStorage, id, _key, _value) {}; \
-	EMessageSendResult CClientSynchedStorage::class::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq) \
-{ ser.Value("entityId", entityId, 'eid'); \
-	m_pStorage->SerializeValue(ser, key, value, NTypelist::IndexOf<type, TSynchedValueTypes>::value); \
-	return eMSR_SentOk; }
-
-#define IMPLEMENT_IMMEDIATE_ENTITY_MESSAGE(type) \
-	CryAutoCriticalSection lock(m_mutex); \
-	TSynchedKey		key; \
-	TSynchedValue value; \
-	EntityId			id; \
-	ser.Value("entityId", id, 'eid'); \
-	SerializeEntityValue(ser, id, key, value, NTypelist::IndexOf<type, TSynchedValueTypes>::value); \
 	return true;
-
-//------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetEntityBoolMsg, eNRT_ReliableUnordered, eMPF_AfterSpawning)
-{
-	IMPLEMENT_IMMEDIATE_ENTITY_MESSAGE(bool);
 }
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetEntityFloatMsg, eNRT_ReliableUnordered, eMPF_AfterSpawning)
+CClientSynchedStorage::CSetSnapshotMsg::CSetSnapshotMsg(bool _entities, int _channelId, CServerSynchedStorage *pStorage)
+:	INetMessage(_entities?CClientSynchedStorage::SetEntitySnapshotMsg:CClientSynchedStorage::SetSnapshotMsg),
+	channelId(_channelId),
+	m_pStorage(pStorage),
+	entities(_entities)
 {
-	IMPLEMENT_IMMEDIATE_ENTITY_MESSAGE(float);
-}
+	SetGroup( 'stor' );
+};
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetEntityIntMsg, eNRT_ReliableUnordered, eMPF_AfterSpawning)
-{
-	IMPLEMENT_IMMEDIATE_ENTITY_MESSAGE(int);
+uint32 CClientSynchedStorage::CSetSnapshotMsg::GetEntryBits(const SEntry &entry, bool entities, bool newEntity)
+{
+	uint32 bits=3+32;	// type, key
+	if (entities)
+		bits+=1+(newEntity?32:0);
+
+	switch (entry.value.GetType())
+	{
+	case eSVT_Bool:
+		bits+=1;
+		break;
+	case eSVT_Float:
+	case eSVT_Int:
+	case eSVT_EntityId:
+		bits+=32;
+		break;
+	case eSVT_String:
+		{
+			const string *pString=0;
+			entry.value.GetPtr(&pString);
+			bits+=32+8*(pString?pString->length():0);	// length and characters
+		}
+		break;
+	}
+
+	return bits;
 }
 
 //------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetEntityEntityIdMsg, eNRT_ReliableUnordered, eMPF_AfterSpawning)
+EMessageSendResult CClientSynchedStorage::CSetSnapshotMsg::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq)
 {
-	IMPLEMENT_IMMEDIATE_ENTITY_MESSAGE(EntityId);
-}
+	uint16 count=entries.size();
+	ser.Value("count", count, 'ui16');
 
-//------------------------------------------------------------------------
-NET_IMPLEMENT_IMMEDIATE_MESSAGE(CClientSynchedStorage, SetEntityStringMsg, eNRT_ReliableUnordered, eMPF_AfterSpawning)
-{
-	IMPLEMENT_IMMEDIATE_ENTITY_MESSAGE(string);
-}
+	for (int i=0; i<count; ++i)
+	{
+		SEntry &entry=entries[i];
 
-//------------------------------------------------------------------------
-CClientSynchedStorage::CSetEntityMsg::CSetEntityMsg(const SNetMessageDef *pDef, int _channelId, CServerSynchedStorage *pStorage, EntityId id, TSynchedKey _key, TSynchedValue &_value)
-:	channelId(_channelId),
-	m_pStorage(pStorage),
-	entityId(id), 
-	key(_key),
-	value(_value),
-	INetMessage(pDef)
-{
-	SetGroup( 'stor' );
-};
+		if (entities)
+		{
+			bool newEntity=(i==0) || (entry.entityId!=entries[i-1].entityId);
+			ser.Value("newEntity", newEntity, 'bool');
+			if (newEntity)
+				ser.Value("entityId", entry.entityId, 'eid');
+		}
+
+		uint8 type=entry.value.GetType();
+		ser.Value("type", type, 'ui3');
+
+		if (entities)
+			m_pStorage->SerializeEntityValue(ser, entry.entityId, entry.key, entry.value, type);
+		else
+			m_pStorage->SerializeValue(ser, entry.key, entry.value, type);
+	}
 
-//------------------------------------------------------------------------
-EMessageSendResult CClientSynchedStorage::CSetEntityMsg::WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq)
-{
 	return eMSR_SentOk;
 }
 
 //------------------------------------------------------------------------
-void CClientSynchedStorage::CSetEntityMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
+void CClientSynchedStorage::CSetSnapshotMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
 {
 }
 
 //------------------------------------------------------------------------
-size_t CClientSynchedStorage::CSetEntityMsg::GetSize()
+size_t CClientSynchedStorage::CSetSnapshotMsg::GetSize()
 {
-	return sizeof(*this);
+	return sizeof(*this)+entries.capacity()*sizeof(SEntry);
 };
 
-DEFINE_ENTITY_MESSAGE(CSetEntityBoolMsg, bool, SetEntityBoolMsg);
-DEFINE_ENTITY_MESSAGE(CSetEntityFloatMsg, float, SetEntityFloatMsg);
-DEFINE_ENTITY_MESSAGE(CSetEntityIntMsg, int, SetEntityIntMsg);
-DEFINE_ENTITY_MESSAGE(CSetEntityEntityIdMsg, EntityId, SetEntityEntityIdMsg);
-DEFINE_ENTITY_MESSAGE(CSetEntityStringMsg, string, SetEntityStringMsg);
-
-#undef DEFINE_ENTITY_MESSAGE
-#undef IMPLEMENT_IMMEDIATE_ENTITY_MESSAGE
-
 //------------------------------------------------------------------------
 void CClientSynchedStorage::GetMemoryUsage(ICrySizer * s) const
 {
@@ -21,32 +21,6 @@ History:
 #include <NetHelpers.h>
 #include "SynchedStorage.h"
 
-#define DECLARE_GLOBAL_MESSAGE(classname) \
-class classname: public CSetGlobalMsg \
-	{ \
-	public: \
-	classname(int _channelId, CServerSynchedStorage *pStorage, TSynchedKey _key, TSynchedValue &_value); \
-	EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq); \
-	}; \
-
-#define DECLARE_CHANNEL_MESSAGE(classname) \
-class classname: public CSetChannelMsg \
-	{ \
-	public: \
-	classname(int _channelId, CServerSynchedStorage *pStorage, TSynchedKey _key, TSynchedValue &_value); \
-	EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq); \
-	}; \
-
-
-#define DECLARE_ENTITY_MESSAGE(classname) \
-	class classname: public CSetEntityMsg \
-	{ \
-		public: \
-		classname(int _channelId, CServerSynchedStorage *pStorage, EntityId id, TSynchedKey _key, TSynchedValue &_value); \
-		EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq); \
-	}; \
-
-
 class CServerSynchedStorage;
 class CClientSynchedStorage:
 	public CNetMessageSinkHelper<CClientSynchedStorage, CSynchedStorage>
@@ -76,102 +50,98 @@ public:
 	};
 
 	//------------------------------------------------------------------------
-	class CSetGlobalMsg: public INetMessage
+	// Values of one scope changed on a channel since the last flush, captured when the message is built.
+	// Pooled, so steady-state updates don't allocate.
+	class CSetDeltaMsg: public INetMessage
 	{
 	public:
-		CSetGlobalMsg(const SNetMessageDef *pDef, int _channelId, CServerSynchedStorage *pStorage, TSynchedKey _key, TSynchedValue &_value);
+		enum EScope
+		{
+			eS_Global = 0,
+			eS_Channel,
+			eS_Entity,
 
-		int											channelId;
-		CServerSynchedStorage		*m_pStorage;
+			eS_Count
+		};
 
-		TSynchedKey							key;
-		TSynchedValue						value;
+		enum { k_maxEntries = 32 };
 
-		virtual EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq);
-		virtual void UpdateState(uint32 fromSeq, ENetSendableStateUpdate update);
-		virtual size_t GetSize();
-	};
+		CSetDeltaMsg(EScope _scope, int _channelId, CServerSynchedStorage *pStorage);
 
-	DECLARE_GLOBAL_MESSAGE(CSetGlobalBoolMsg);
-	DECLARE_GLOBAL_MESSAGE(CSetGlobalFloatMsg);
-	DECLARE_GLOBAL_MESSAGE(CSetGlobalIntMsg);
-	DECLARE_GLOBAL_MESSAGE(CSetGlobalEntityIdMsg);
-	DECLARE_GLOBAL_MESSAGE(CSetGlobalStringMsg);
-
-	//------------------------------------------------------------------------
-	class CSetChannelMsg: public INetMessage
-	{
-	public:
-		CSetChannelMsg(const SNetMessageDef *pDef, int _channelId, CServerSynchedStorage *pStorage, TSynchedKey _key, TSynchedValue &_value);
+		ILINE bool IsFull() const { return numEntries >= k_maxEntries; }
+		void AddEntry(EntityId id, TSynchedKey key, const TSynchedValue &value);
 
 		int											channelId;
 		CServerSynchedStorage		*m_pStorage;
+		EScope									scope;
 
-		TSynchedKey							key;
-		TSynchedValue						value;
+		int											numEntries;
+		EntityId								entityIds[k_maxEntries];	// only for eS_Entity, entries of the same entity are consecutive
+		TSynchedKey							keys[k_maxEntries];
+		TSynchedValue						values[k_maxEntries];
 
 		virtual EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq);
 		virtual void UpdateState(uint32 fromSeq, ENetSendableStateUpdate update);
 		virtual size_t GetSize();
-	};
 
-	DECLARE_CHANNEL_MESSAGE(CSetChannelBoolMsg);
-	DECLARE_CHANNEL_MESSAGE(CSetChannelFloatMsg);
-	DECLARE_CHANNEL_MESSAGE(CSetChannelIntMsg);
-	DECLARE_CHANNEL_MESSAGE(CSetChannelEntityIdMsg);
-	DECLARE_CHANNEL_MESSAGE(CSetChannelStringMsg);
+		static void *operator new(size_t size);
+		static void operator delete(void *p);
 
+	private:
+		static const SNetMessageDef *GetScopeDef(EScope scope);
+	};
 
 	//------------------------------------------------------------------------
-	class CSetEntityMsg: public INetMessage
+	// Part of the values a channel gets in one go when it joins, instead of a message per value.
+	// Global and channel values are ordered after the reset, entity values wait for spawning.
+	class CSetSnapshotMsg: public INetMessage
 	{
 	public:
-		CSetEntityMsg(const SNetMessageDef *pDef, int _channelId, CServerSynchedStorage *pStorage, EntityId id, TSynchedKey _key, TSynchedValue &_value);
+		enum
+		{
+			k_headerBits = 16,					// entry count
+			k_maxPayloadBits = 800*8,		// leaves room for the packet headers and other messages
+		};
+
+		struct SEntry
+		{
+			EntityId								entityId;		// only for entity snapshots, entries of the same entity are consecutive
+			TSynchedKey							key;
+			TSynchedValue						value;
+		};
+		typedef std::vector<SEntry>	TEntries;
+
+		CSetSnapshotMsg(bool _entities, int _channelId, CServerSynchedStorage *pStorage);
+
+		// upper bound of the bits WritePayload spends on the entry
+		static uint32 GetEntryBits(const SEntry &entry, bool entities, bool newEntity);
 
 		int											channelId;
 		CServerSynchedStorage		*m_pStorage;
+		bool										entities;
 
-		EntityId								entityId;
-		TSynchedKey							key;
-		TSynchedValue						value;
+		TEntries								entries;
 
 		virtual EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq);
 		virtual void UpdateState(uint32 fromSeq, ENetSendableStateUpdate update);
 		virtual size_t GetSize();
 	};
 
-	DECLARE_ENTITY_MESSAGE(CSetEntityBoolMsg);
-	DECLARE_ENTITY_MESSAGE(CSetEntityFloatMsg);
-	DECLARE_ENTITY_MESSAGE(CSetEntityIntMsg);
-	DECLARE_ENTITY_MESSAGE(CSetEntityEntityIdMsg);
-	DECLARE_ENTITY_MESSAGE(CSetEntityStringMsg);
-
 	//------------------------------------------------------------------------
 	NET_DECLARE_IMMEDIATE_MESSAGE(ResetMsg);
 
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetGlobalBoolMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetGlobalFloatMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetGlobalIntMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetGlobalEntityIdMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetGlobalStringMsg);
-
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetChannelBoolMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetChannelFloatMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetChannelIntMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetChannelEntityIdMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetChannelStringMsg);
+	NET_DECLARE_IMMEDIATE_MESSAGE(SetGlobalDeltaMsg);
+	NET_DECLARE_IMMEDIATE_MESSAGE(SetChannelDeltaMsg);
+	NET_DECLARE_IMMEDIATE_MESSAGE(SetEntityDeltaMsg);
 
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetEntityBoolMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetEntityFloatMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetEntityIntMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetEntityEntityIdMsg);
-	NET_DECLARE_IMMEDIATE_MESSAGE(SetEntityStringMsg);
+	NET_DECLARE_IMMEDIATE_MESSAGE(SetSnapshotMsg);
+	NET_DECLARE_IMMEDIATE_MESSAGE(SetEntitySnapshotMsg);
 
 protected:
+	bool ReadDelta(TSerialize ser, bool entities);
+	bool ReadSnapshot(TSerialize ser, bool entities);
+
 	CryCriticalSection m_mutex;
 };
 
-#undef DECLARE_GLOBAL_MESSAGE
-#undef DECLARE_ENTITY_MESSAGE
-
 #endif //__CLIENTSYNCHEDSTORAGE_H__
@@ -15,14 +15,16 @@
 #include "GameCVars.h"
 #include "CodeCheckpointDebugMgr.h"
 
+#include <BitFiddling.h>
+
 const static int LABEL_LENGTH = 100;
 const static int BUFF_SIZE = LABEL_LENGTH + 3;
 
 CCodeCheckpointDebugMgr* s_pCodeCheckPointDebugManager = NULL;
 
-bool SortDebugRecord( const CCodeCheckpointDebugMgr::CheckpointDebugRecord& rec1, const CCodeCheckpointDebugMgr::CheckpointDebugRecord& rec2 )
+bool SortDebugRecord( const CCodeCheckpointDebugMgr::CheckpointDebugRecord* rec1, const CCodeCheckpointDebugMgr::CheckpointDebugRecord* rec2 )
 {
-	return rec1.m_lastHitTime > rec2.m_lastHitTime;
+	return rec1->m_lastHitTime > rec2->m_lastHitTime;
 }
 
 
@@ -45,6 +47,20 @@ void CmdCodeCheckPointSearch(IConsoleCmdArgs *pArgs)
 		CryLogAlways("Checkpoint:%s Count:%i", fIt->first.c_str(), fIt->second);
 }
 
+void CmdCodeCheckPointDump(IConsoleCmdArgs *pArgs)
+{
+	if(pArgs->GetArgCount() > 2)
+	{
+		CryLogAlways("Usage: %s [filename]", pArgs->GetArg(0));
+		return;
+	}
+
+	string filePath = PathUtil::Make( "../USER", (pArgs->GetArgCount() == 2) ? pArgs->GetArg(1) : "CodeCheckpointHistograms.bin" );
+
+	if(CCodeCheckpointDebugMgr::RetrieveCodeCheckpointDebugMgr()->DumpHistograms(filePath.c_str()))
+		CryLogAlways("Code checkpoint histograms written to %s", filePath.c_str());
+}
+
 CCodeCheckpointDebugMgr* CCodeCheckpointDebugMgr::s_pCodeCheckPointDebugManager = NULL;
 
 CCodeCheckpointDebugMgr* CCodeCheckpointDebugMgr::RetrieveCodeCheckpointDebugMgr()
@@ -56,37 +72,75 @@ CCodeCheckpointDebugMgr* CCodeCheckpointDebugMgr::RetrieveCodeCheckpointDebugMgr
 }
 
 CCodeCheckpointDebugMgr::CCodeCheckpointDebugMgr()
-:REGISTER_GAME_MECHANISM(CCodeCheckpointDebugMgr),m_timeSinceLastRun(0)
+:REGISTER_GAME_MECHANISM(CCodeCheckpointDebugMgr),m_histogramFrames(0),m_timeSinceLastRun(0)
 {
 	m_debug_ccoverage = 0;
 	m_debug_ccoverage_rate = 0.05f;
 	m_debug_ccoverage_maxlines = 10;
 	m_debug_ccoverage_filter_maxcount = 0;
 	m_debug_ccoverage_filter_mincount = 0;
+	m_debug_ccoverage_histogram = 0;
 
 	IConsole * pConsole = GetISystem()->GetIConsole();
 	assert (pConsole);
 
 	pConsole->AddCommand("ft_debug_checkpoint_search", CmdCodeCheckPointSearch, VF_CHEAT, "FEATURE TESTER: Search for code checkpoints that have been encountered by substring");
+	pConsole->AddCommand("ft_debug_ccoverage_dump", CmdCodeCheckPointDump, VF_CHEAT, "FEATURE TESTER: Write the per frame hit histograms of all code checkpoints to a binary file in the user folder (default CodeCheckpointHistograms.bin)");
 
-	pConsole->Register("ft_debug_ccoverage", &m_debug_ccoverage, m_debug_ccoverage, VF_CHEAT, "FEATURE TESTER: Turn on debug drawing of code checkpoints. 1 = watched checkpoints only. 2 = unwatched only. 3 = both with watched higher priority. 4 = both equal prioirity");
+	pConsole->Register("ft_debug_ccoverage", &m_debug_ccoverage, m_debug_ccoverage, VF_CHEAT, "FEATURE TESTER: Turn on debug drawing of code checkpoints. 1 = watched checkpoints only. 2 = unwatched only. 3 = both with watched higher priority. 4 = both equal prioirity")->SetOnChangeCallback(OnDebugCoverageChanged);
 	pConsole->Register("ft_debug_ccoverage_rate", &m_debug_ccoverage_rate, m_debug_ccoverage_rate, VF_CHEAT, "FEATURE TESTER: Max number of code checkpoints to output");
 	pConsole->Register("ft_debug_ccoverage_maxlines", &m_debug_ccoverage_maxlines, m_debug_ccoverage_maxlines, VF_CHEAT, "FEATURE TESTER: Max number of code checkpoints to output");
 	pConsole->Register("ft_debug_ccoverage_filter_maxcount", &m_debug_ccoverage_filter_maxcount, m_debug_ccoverage_filter_maxcount, VF_CHEAT, "FEATURE TEST: Only print out checkpoints with less than this number of hits");
 	pConsole->Register("ft_debug_ccoverage_filter_mincount", &m_debug_ccoverage_filter_mincount, m_debug_ccoverage_filter_mincount, VF_CHEAT, "FEATURE TEST: Only print out checkpoints with more than this number of hit");
+	pConsole->Register("ft_debug_ccoverage_histogram", &m_debug_ccoverage_histogram, m_debug_ccoverage_histogram, VF_CHEAT, "FEATURE TESTER: Sample code checkpoints every frame into per frame hit histograms, see ft_debug_ccoverage_dump. Turning it on clears the histograms")->SetOnChangeCallback(OnDebugHistogramChanged);
 
 	string filePath = PathUtil::Make( "../USER", "CodeCheckpointList.txt" );
 	ReadFile(filePath.c_str());
 
+	//Nothing to do until debug drawing or histograms are turned on, the cvars may already be set from a config
+	UpdatePolicy();
+}
+
+void CCodeCheckpointDebugMgr::UpdatePolicy()
+{
+	SetUpdatePolicy((m_debug_ccoverage || m_debug_ccoverage_histogram) ? kGMUpdatePolicy_EveryFrame : kGMUpdatePolicy_Idle);
+	m_timeSinceLastRun = 0;
+}
+
+void CCodeCheckpointDebugMgr::OnDebugCoverageChanged(ICVar* pVar)
+{
+	if(s_pCodeCheckPointDebugManager)
+		s_pCodeCheckPointDebugManager->UpdatePolicy();
+}
+
+void CCodeCheckpointDebugMgr::OnDebugHistogramChanged(ICVar* pVar)
+{
+	if(s_pCodeCheckPointDebugManager)
+	{
+		if(pVar->GetIVal())
+		{
+			//Start from a snapshot so hits from before don't land in the first frame
+			s_pCodeCheckPointDebugManager->UpdateRecords();
+			s_pCodeCheckPointDebugManager->ClearHistograms();
+		}
+
+		s_pCodeCheckPointDebugManager->UpdatePolicy();
+	}
 }
 
 /// Searches all registered check points for the given substring and returns their counts in the input list
 void CCodeCheckpointDebugMgr::SearchCheckpoints(RecordNameCountPairs& outputList, string& searchStr) const
 {
-	SearchRecordForString searchFunc(outputList, searchStr);
-
-	std::for_each(m_watchedPoints.begin(), m_watchedPoints.end(), searchFunc);
-	std::for_each(m_unwatchedPoints.begin(), m_unwatchedPoints.end(), searchFunc);
+	for(TCheckpointDebugVector::const_iterator it = m_records.begin(); it != m_records.end(); ++it)
+	{
+		// Is there a registered checkpoint for this record?
+		if (it->m_pCheckpoint)
+		{
+			//If the search string is empty, or the checkpoint contains the substring anywhere inside of it
+			if(searchStr.empty() || it->m_name.find(searchStr) != string::npos)
+				outputList.push_back(std::make_pair(it->m_name, it->m_pCheckpoint->HitCount()));
+		}
+	}
 }
 
 void CCodeCheckpointDebugMgr::ReadFile(const char* fileName)
@@ -103,9 +157,6 @@ void CCodeCheckpointDebugMgr::ReadFile(const char* fileName)
 
 		while(int numRead = GetLine(lineBlock, cpFile))
 		{
-			ICodeCheckpointMgr* pCheckpointManager = gEnv->pCodeCheckpointMgr;
-			if(pCheckpointManager)
-				pCheckpointManager->GetCheckpointIndex(lineBlock);
 			RegisterWatchPoint(lineBlock);
 		}
 
@@ -159,18 +210,16 @@ int CCodeCheckpointDebugMgr::GetLine( char * pBuff, FILE * fp )
 
 void CCodeCheckpointDebugMgr::Update(float dt)
 {
-	//Don't do any work if we haven't requested this as active
-	if(!m_debug_ccoverage)
-		return;
-
+	//Histograms need a snapshot every frame, drawing alone only at the requested rate
 	m_timeSinceLastRun += dt;
-	if( m_timeSinceLastRun > m_debug_ccoverage_rate)
+	if( m_debug_ccoverage_histogram || m_timeSinceLastRun > m_debug_ccoverage_rate)
 	{
 		UpdateRecords();
 		m_timeSinceLastRun = 0;
 	}
 
-	DrawDebugInfo();
+	if(m_debug_ccoverage)
+		DrawDebugInfo();
 
 }
 
@@ -180,85 +229,96 @@ void CCodeCheckpointDebugMgr::DrawDebugInfo()
 	
 	IRenderer* pRenderer = gEnv->pRenderer;
 
-	int totalHit = (int) std::count_if(m_unwatchedPoints.begin(), m_unwatchedPoints.end(), RecordHasHits);
-	int watchedHit = (int) std::count_if(m_watchedPoints.begin(), m_watchedPoints.end(), RecordHasHits);
+	int totalHit = 0, watchedHit = 0, totalWatched = 0;
 
-	totalHit += watchedHit;
+	TCheckpointDebugPtrVector watchedPts, unwatchedPts;
+	watchedPts.reserve(m_records.size());
+	unwatchedPts.reserve(m_records.size());
 
-	TCheckpointDebugVector outputPoints;
-	outputPoints.reserve(m_watchedPoints.size() + m_unwatchedPoints.size());
+	for(TCheckpointDebugVector::const_iterator it = m_records.begin(); it != m_records.end(); ++it)
+	{
+		const bool hasHits = it->m_currHitcount > 0;
+		totalHit += hasHits;
+
+		if(it->m_queried)
+		{
+			++totalWatched;
+			watchedHit += hasHits;
+			watchedPts.push_back(&(*it));
+		}
+		else if(it->m_pCheckpoint)
+		{
+			unwatchedPts.push_back(&(*it));
+		}
+	}
 
 	//Get the sorted output points. For now assume you want to sort based on time
+	TCheckpointDebugPtrVector outputPoints;
 
 	//Only show watched
 	if(displayLevel == 1)
 	{
-		outputPoints.assign(m_watchedPoints.begin(), m_watchedPoints.end());
+		outputPoints.swap(watchedPts);
 		std::sort(outputPoints.begin(), outputPoints.end(), SortDebugRecord);
 	}
 	//Only show unwatched
 	else if(displayLevel == 2)
 	{
-		outputPoints.assign(m_unwatchedPoints.begin(), m_unwatchedPoints.end());
+		outputPoints.swap(unwatchedPts);
 		std::sort(outputPoints.begin(), outputPoints.end(), SortDebugRecord);
 
 	}
 	//Show both with watched having priority
 	else if(displayLevel == 3)
 	{
-		///Retrieve and sort watched
-		TCheckpointDebugVector watchedPts;
-		watchedPts.assign(m_watchedPoints.begin(), m_watchedPoints.end());
 		std::sort(watchedPts.begin(), watchedPts.end(), SortDebugRecord);
-
-		///Retrieve and sort unwatched
-		TCheckpointDebugVector unwatchedPts;
-		unwatchedPts.assign(m_unwatchedPoints.begin(), m_unwatchedPoints.end());
 		std::sort(unwatchedPts.begin(), unwatchedPts.end(), SortDebugRecord);
 
 		///Combined with watched first
-		outputPoints.assign(watchedPts.begin(), watchedPts.end());
+		outputPoints.swap(watchedPts);
 		outputPoints.insert(outputPoints.end(),unwatchedPts.begin(), unwatchedPts.end());
 	}
 	//Show both with equal priority
 	else if(displayLevel == 4)
 	{
 		///Combine sort
-		outputPoints.assign(m_unwatchedPoints.begin(), m_unwatchedPoints.end());
-		outputPoints.insert(outputPoints.end(), m_watchedPoints.begin(), m_watchedPoints.end());
+		outputPoints.swap(unwatchedPts);
+		outputPoints.insert(outputPoints.end(), watchedPts.begin(), watchedPts.end());
 		std::sort(outputPoints.begin(), outputPoints.end(), SortDebugRecord);
 	}
 
 	float percHit = 0.0f;
-	if(!m_watchedPoints.empty())
-		percHit = (float) watchedHit / m_watchedPoints.size();
+	if(totalWatched)
+		percHit = (float) watchedHit / totalWatched;
 
 	static float statusColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
 	float height = (float) 0.05 * pRenderer->GetHeight();
 	pRenderer->Draw2dLabel(30.f, height, 2.f, statusColor, false, 
 		"THit: %i | TWatched: %i | WatchedHit: %i | %% WatchedHit: %.2f", 
-		totalHit, (int32)m_watchedPoints.size(), watchedHit, percHit * 100.0f );
+		totalHit, totalWatched, watchedHit, percHit * 100.0f );
 
 	//Output the interesting lines
 	float outputOffset = 0.08f;
 	int numberOutput = 0;
 	int maxNumberOutput =  m_debug_ccoverage_maxlines;
-	for(TCheckpointDebugVector::iterator outputIt = outputPoints.begin(); 
+	for(TCheckpointDebugPtrVector::iterator outputIt = outputPoints.begin();
 		outputIt != outputPoints.end() && numberOutput < maxNumberOutput;
 		++outputIt)
 	{
 		static float watchedColor[] = {1.0f, 0.0f, 1.0f, 1.0f};
 		static float unwatchedColor[] = {0.0f, 0.0f, 1.0f, 1.0f};
 
+		const CheckpointDebugRecord& record = **outputIt;
+
 		//Check filters and skip outputting of ones that don't qualify
 		int filterMin = m_debug_ccoverage_filter_mincount, filterMax = m_debug_ccoverage_filter_maxcount;
-		if(filterMax && (int)outputIt->m_currHitcount > filterMax)
+		if(filterMax && (int)record.m_currHitcount > filterMax)
 			continue;
-		else if(filterMin && (int)outputIt->m_currHitcount < filterMin)
+		else if(filterMin && (int)record.m_currHitcount < filterMin)
 			continue;
 
-		pRenderer->Draw2dLabel(30.f, outputOffset * pRenderer->GetHeight(), 2.f, outputIt->m_queried? watchedColor : unwatchedColor, false, 
-			"CheckPoint: %s Count:%i", outputIt->m_name.c_str(), outputIt->m_currHitcount);
+		pRenderer->Draw2dLabel(30.f, outputOffset * pRenderer->GetHeight(), 2.f, record.m_queried? watchedColor : unwatchedColor, false,
+			"CheckPoint: %s Count:%i", record.m_name.c_str(), record.m_currHitcount);
 
 		//Update the display output height
 		outputOffset += 0.03f;
@@ -270,114 +330,53 @@ void CCodeCheckpointDebugMgr::DrawDebugInfo()
 ///Register name to be marked as a watch point
 void CCodeCheckpointDebugMgr::RegisterWatchPoint(const string& name)
 {
-	//Check if its already watched, if so just increment
-	TCheckpointDebugList::iterator currentLocation = std::find_if(m_watchedPoints.begin(), m_watchedPoints.end(), RecordMatchAndUpdate(name));
-
-	bool recordFound = currentLocation != m_watchedPoints.end();
-
-	//Check unwatched
-	if(currentLocation == m_watchedPoints.end())
-	{
-		currentLocation = std::find_if(m_unwatchedPoints.begin(), m_unwatchedPoints.end(), RecordMatchAndUpdate(name));
-
-		if(currentLocation != m_unwatchedPoints.end())
-		{
-			recordFound = true;
-
-			//Move this record to the appropriate watched location
-			TCheckpointDebugList::iterator currwIt = m_watchedPoints.begin();
-			for(;currwIt != m_watchedPoints.end(); ++currwIt)
-			{
-				if(currentLocation->m_checkPointIdx < currwIt->m_checkPointIdx)
-				{
-					currentLocation->UpdateWatched();
-					m_watchedPoints.insert(currwIt,*currentLocation);
-					break;
-				}
-			}
-
-			if(currwIt == m_watchedPoints.end())
-			{
-				currentLocation->UpdateWatched();
-				m_watchedPoints.push_back(*currentLocation);
-			}
-
-			m_unwatchedPoints.erase(currentLocation);
-		}	
-	}
-
-	//Point hasn't been reached yet so bookmark it
-	if(!recordFound)
-	{
-		//Check if bookmark exists, if so update the count of requests for it
-		TBookmarkMap::iterator currBookmark = m_bookmarkedNames.find(name);
-		if(currBookmark != m_bookmarkedNames.end())
-			++currBookmark->second;
-		else
-			m_bookmarkedNames.insert(std::make_pair(name, 1));
-
-	}
+	UpdateWatchPoint(name, 1);
 }
 
 ///Unregister name to be marked as a watch point
 void CCodeCheckpointDebugMgr::UnregisterWatchPoint(const string& name)
 {
-	TCheckpointDebugList::iterator currentLocation = m_watchedPoints.end();
+	UpdateWatchPoint(name, -1);
+}
 
-	//Check for an existing record in the watched points and if found decrement its refcount of watchers
-	currentLocation = std::find_if(m_watchedPoints.begin(), m_watchedPoints.end(), RecordMatchAndUpdate(name, -1));
+void CCodeCheckpointDebugMgr::UpdateWatchPoint(const string& name, int count)
+{
+	ICodeCheckpointMgr* pCodeCheckpointMgr = gEnv->pCodeCheckpointMgr;
+	if(!pCodeCheckpointMgr)
+		return;
 
-	if(currentLocation != m_watchedPoints.end())
-	{
-		//If there is no longer a reference to this checkpoint then move it back to the unwatched at the appropriate spot.
-		if(currentLocation->m_refCount <= 0)
-		{
-			TCheckpointDebugList::iterator currwIt = m_unwatchedPoints.begin();
-			for(;currwIt != m_unwatchedPoints.end(); ++currwIt)
-			{
-				if(currentLocation->m_checkPointIdx < currwIt->m_checkPointIdx)
-				{
-					m_unwatchedPoints.insert(currwIt,*currentLocation);
-					break;
-				}
-			}
-
-			if(currwIt == m_unwatchedPoints.end())
-				m_unwatchedPoints.push_back(*currentLocation);
-
-			m_watchedPoints.erase(currentLocation);
-		}
-	}
+	//The manager reserves a blank record for names that haven't been reached yet, so every watch point has an index
+	//straight away and the snapshots never need to match names
+	size_t checkpointIdx = pCodeCheckpointMgr->GetCheckpointIndex(name.c_str());
 
-	///If we haven't yet reached the checkpoint somehow then check the bookmarks to see if one was waiting
-	if(currentLocation == m_watchedPoints.end())
+	AddNewRecords(pCodeCheckpointMgr);
+
+	if(checkpointIdx < m_records.size())
 	{
-		///Check if bookmark exists, if so update the count of requests for it
-		TBookmarkMap::iterator currBookmark = m_bookmarkedNames.find(name);
-		if(currBookmark != m_bookmarkedNames.end())
-		{
-			--currBookmark->second;
-			if(currBookmark->second <= 0)
-				m_bookmarkedNames.erase(currBookmark);
-		}
-		else
-			///Shouldn't be able to request to unregister a watch point that is not currently registered
-			CRY_ASSERT(false);
+		CheckpointDebugRecord& record = m_records[checkpointIdx];
+		record.UpdateWatched(count);
 
+		///Shouldn't be able to request to unregister a watch point that is not currently registered
+		CRY_ASSERT(record.m_refCount >= 0);
 	}
 }
 
-void CCodeCheckpointDebugMgr::UpdateRecord(const CCodeCheckpoint* pCheckpoint,CheckpointDebugRecord& record )
+void CCodeCheckpointDebugMgr::AddNewRecords(ICodeCheckpointMgr* pCodeCheckpointMgr)
 {
-	if(!pCheckpoint)
+	size_t nextSnapshotCount = pCodeCheckpointMgr->GetTotalCount();
+
+	if(m_records.size() >= nextSnapshotCount)
 		return;
 
-	//Update the existing record
-	if(record.m_prevHitcount < pCheckpoint->HitCount())
+	m_records.reserve(nextSnapshotCount);
+	m_histograms.resize(nextSnapshotCount * eNumHistogramBuckets, 0);
+
+	for(size_t currIdx = m_records.size(); currIdx < nextSnapshotCount; ++currIdx)
 	{
-		record.m_prevHitcount = record.m_currHitcount;
-		record.m_currHitcount = pCheckpoint->HitCount();
-		record.m_lastHitTime = gEnv->pTimer->GetCurrTime();
+		const char* name = pCodeCheckpointMgr->GetCheckPointName(currIdx);
+		const CCodeCheckpoint* pCheckpoint = pCodeCheckpointMgr->GetCheckpoint(currIdx);
+
+		m_records.push_back(CheckpointDebugRecord(pCheckpoint, name, currIdx));
 	}
 }
 
@@ -385,66 +384,98 @@ void CCodeCheckpointDebugMgr::UpdateRecords()
 {
 	//Retrieve the latest snapshot
 	ICodeCheckpointMgr* pCodeCheckpointMgr = gEnv->pCodeCheckpointMgr;
-	if (pCodeCheckpointMgr)
+	if (!pCodeCheckpointMgr)
+		return;
+
+	AddNewRecords(pCodeCheckpointMgr);
+
+	const float currTime = gEnv->pTimer->GetCurrTime();
+	const bool sampleHistograms = m_debug_ccoverage_histogram != 0;
+
+	uint32* pHistogram = m_histograms.empty() ? NULL : &m_histograms[0];
+
+	//Counters are only read here, checkpoints keep incrementing their own without any locking
+	for(TCheckpointDebugVector::iterator it = m_records.begin(); it != m_records.end(); ++it, pHistogram += eNumHistogramBuckets)
 	{
-		size_t nextSnapshotCount = pCodeCheckpointMgr->GetTotalCount();
+		CheckpointDebugRecord& record = *it;
 
-		size_t currIdx = 0;
+		//Blank records get their checkpoint once the code is reached for the first time
+		if(!record.m_pCheckpoint)
+		{
+			record.m_pCheckpoint = pCodeCheckpointMgr->GetCheckpoint(record.m_checkPointIdx);
+			if(!record.m_pCheckpoint)
+				continue;
+		}
+
+		uint32 hitCount = record.m_pCheckpoint->HitCount();
 
-		TCheckpointDebugList::iterator unwatchedIt = m_unwatchedPoints.begin(),watchedIt = m_watchedPoints.begin();
+		//A counter going backwards was reset, everything it has now is new
+		uint32 newHits = (hitCount >= record.m_currHitcount) ? (hitCount - record.m_currHitcount) : hitCount;
 
-		///Update existing points with their snapshot
-		size_t currSnapShotcount = m_watchedPoints.size() + m_unwatchedPoints.size();
-		while( currIdx < currSnapShotcount && currIdx < nextSnapshotCount)
+		if(newHits || hitCount != record.m_currHitcount)
 		{
-			string name = pCodeCheckpointMgr->GetCheckPointName(currIdx);
-			const CCodeCheckpoint* pCheckpoint = pCodeCheckpointMgr->GetCheckpoint(currIdx);
-
-			///Check if we are a watched point
-			if(watchedIt != m_watchedPoints.end() && (name == watchedIt->m_name))
-			{
-				CheckpointDebugRecord& currentRec = *watchedIt;
-				UpdateRecord(pCheckpoint, currentRec);
-				++watchedIt;
-			}
-			//Otherwise checked if we are unwatched point
-			else if(unwatchedIt != m_unwatchedPoints.end() && (name == unwatchedIt->m_name))
-			{
-				CheckpointDebugRecord& currentRec = *unwatchedIt;
-				UpdateRecord(pCheckpoint, currentRec);	
-				++unwatchedIt;
-			}
-			///This should never happen, as each existing point should already have been inserted into either the watched or unwatched vector.
-			else
-			{
-				CRY_ASSERT(false);
-			}
-
-			++currIdx;
+			record.m_prevHitcount = record.m_currHitcount;
+			record.m_currHitcount = hitCount;
+			record.m_lastHitTime = currTime;
 		}
 
-		///Add entities that are new to this snapshot
-		while(currIdx < nextSnapshotCount)
+		if(sampleHistograms)
 		{
-			const char* name = pCodeCheckpointMgr->GetCheckPointName(currIdx);
-			const CCodeCheckpoint* pCheckpoint = pCodeCheckpointMgr->GetCheckpoint(currIdx);
+			int bucket = newHits ? min((int)IntegerLog2(newHits) + 1, (int)eNumHistogramBuckets - 1) : 0;
+			++pHistogram[bucket];
+		}
+	}
 
-			CheckpointDebugRecord newRecord(pCheckpoint, name, currIdx);
+	if(sampleHistograms)
+		++m_histogramFrames;
+}
 
-			//If we have a current request to watch this point, make sure it goes into watched points
-			TBookmarkMap::iterator bookmarkedIt = m_bookmarkedNames.find(name);
-			if(bookmarkedIt != m_bookmarkedNames.end())
-			{
-				newRecord.UpdateWatched(bookmarkedIt->second);
-				m_watchedPoints.push_back(newRecord);
-				//Clean up the bookmark as its already been hit
-				m_bookmarkedNames.erase(bookmarkedIt);
-			}
-			else
-				m_unwatchedPoints.push_back(newRecord);
+void CCodeCheckpointDebugMgr::ClearHistograms()
+{
+	std::fill(m_histograms.begin(), m_histograms.end(), 0);
+	m_histogramFrames = 0;
+}
 
+bool CCodeCheckpointDebugMgr::DumpHistograms(const char* fileName) const
+{
+	ICryPak* pCryPak = gEnv->pCryPak;
 
-			++currIdx;
-		}
+	FILE* pFile = pCryPak->FOpen(fileName, "wb");
+	if(!pFile)
+	{
+		GameWarning("CodeCheckpointDebugMgr: unable to open '%s' for writing", fileName);
+		return false;
 	}
+
+	SCodeCheckpointHistogramHeader header;
+	header.magic = SCodeCheckpointHistogramHeader::eMagic;
+	header.version = SCodeCheckpointHistogramHeader::eVersion;
+	header.numCheckpoints = 0;
+	header.numBuckets = eNumHistogramBuckets;
+	header.numFrames = m_histogramFrames;
+
+	for(TCheckpointDebugVector::const_iterator it = m_records.begin(); it != m_records.end(); ++it)
+		header.numCheckpoints += (it->m_pCheckpoint != NULL);
+
+	pCryPak->FWrite(&header, sizeof(header), 1, pFile);
+
+	const uint32* pHistogram = m_histograms.empty() ? NULL : &m_histograms[0];
+
+	for(TCheckpointDebugVector::const_iterator it = m_records.begin(); it != m_records.end(); ++it, pHistogram += eNumHistogramBuckets)
+	{
+		if(!it->m_pCheckpoint)
+			continue;
+
+		uint16 nameLength = (uint16)min(it->m_name.length(), (size_t)0xffff);
+		uint32 hitCount = it->m_pCheckpoint->HitCount();
+
+		pCryPak->FWrite(&nameLength, sizeof(nameLength), 1, pFile);
+		pCryPak->FWrite(it->m_name.c_str(), 1, nameLength, pFile);
+		pCryPak->FWrite(&hitCount, sizeof(hitCount), 1, pFile);
+		pCryPak->FWrite(pHistogram, sizeof(uint32), eNumHistogramBuckets, pFile);
+	}
+
+	pCryPak->FClose(pFile);
+
+	return true;
 }
\ No newline at end of file
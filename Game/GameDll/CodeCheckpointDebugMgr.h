@@ -28,14 +28,36 @@
 
 #if defined CODECHECKPOINT_DEBUG_ENABLED
 static void CmdCodeCheckPointSearch(IConsoleCmdArgs *pArgs);
+static void CmdCodeCheckPointDump(IConsoleCmdArgs *pArgs);
 #endif
 
+/// Layout of the histogram dump written by ft_debug_ccoverage_dump. The header is followed by one entry per registered
+/// checkpoint: uint16 name length, the name (not terminated), uint32 total hit count, then eNumBuckets uint32 frame counts.
+/// Entries are keyed by name so dumps of different runs can be diffed even when checkpoints registered in another order.
+struct SCodeCheckpointHistogramHeader
+{
+	enum
+	{
+		eMagic = 0x47484343,	// 'CCHG'
+		eVersion = 1,
+	};
+
+	uint32 magic;
+	uint32 version;
+	uint32 numCheckpoints;
+	uint32 numBuckets;
+	uint32 numFrames;			/// Frames sampled since the histograms were last cleared
+};
+
 class CCodeCheckpointDebugMgr : public CGameMechanismBase
 {
 public:
 
 	typedef std::vector< std::pair<string, int> > RecordNameCountPairs;
 
+	/// Per frame hit histograms: bucket 0 counts frames without hits, bucket n frames with [2^(n-1), 2^n) hits, the last one everything above
+	enum { eNumHistogramBuckets = 16 };
+
 	struct CheckpointDebugRecord
 	{
 		CheckpointDebugRecord(const CCodeCheckpoint* checkPoint, const char* name, int checkpointIdx)
@@ -47,17 +69,13 @@ public:
 				m_lastHitTime = gEnv->pTimer->GetCurrTime();
 				m_currHitcount = checkPoint->HitCount();
 			}
-			else
-			{
-				m_queried = true;
-			}
 		}
 		
 		/// Function to update the reference count, defaults to an increment of 1.
-		void UpdateWatched(int count = 1){m_refCount += count; m_queried = (m_refCount != 0);}
+		void UpdateWatched(int count = 1){m_refCount += count; m_queried = (m_refCount > 0);}
 
 		const CCodeCheckpoint*	m_pCheckpoint;	/// The checkpoint if registered otherwise NULL
-		string			m_name;		/// The name of the checkpoint (owned if m_pCheckpoint is NULL)
+		string			m_name;		/// The name of the checkpoint
 
 		float	 m_lastHitTime;				/// Last clock time this checkpoint was hit as determined by the snapshots
 		uint32 m_prevHitcount;					/// Hit count for this node as of the last snapshot
@@ -65,59 +83,10 @@ public:
 
 		uint32 m_checkPointIdx;				/// Index into checkpoint manager
 
-		bool m_queried;						/// Flag to indicate this checkpoint was specifically requested for at load time
+		bool m_queried;						/// Flag to indicate this checkpoint was specifically requested for observation
 		int m_refCount;						/// Count of references that requested this point for observation
 	};
 
-	///Predicate functions on records
-	static bool RecordHasHits(CheckpointDebugRecord& rec){return rec.m_currHitcount > 0;}
-
-	///Predicate functors on records
-
-	//Checks for a named record and updates its watched information if found
-	class RecordMatchAndUpdate
-	{
-	public:
-		RecordMatchAndUpdate(const string& name, int count = 1)
-			: m_name(name), m_count(count)
-		{}
-
-		bool operator() (CheckpointDebugRecord& record) const
-		{
-			if(record.m_name == m_name)
-			{
-				record.UpdateWatched(m_count);
-				return true;
-			}
-			return false;
-		}
-
-	private:
-		string m_name;
-		int m_count;
-	};
-
-	class SearchRecordForString {
-
-	public:
-
-		SearchRecordForString(RecordNameCountPairs& namePairs, const string& substr = ""): m_namePairs(namePairs), m_searchStr(substr){}
-		void operator() (const CheckpointDebugRecord& rec) 
-		{
-			// Is there a registered checkpoint for this record?
-			if (rec.m_pCheckpoint)
-			{
-				//If the search string is empty, or the checkpoint contains the substring anywhere inside of it
-				if(m_searchStr == "" || rec.m_name.find(m_searchStr) != string::npos)
-					m_namePairs.push_back(std::make_pair(rec.m_name, rec.m_pCheckpoint->HitCount()));
-			}
-		}
-
-	private:
-		RecordNameCountPairs& m_namePairs;
-		string m_searchStr;
-	};
-
 	CCodeCheckpointDebugMgr();
 	virtual ~CCodeCheckpointDebugMgr(){s_pCodeCheckPointDebugManager=NULL;}
 
@@ -135,6 +104,9 @@ public:
 
 	void SearchCheckpoints(RecordNameCountPairs& outputList, string& searchStr) const;
 
+	///Writes the per frame hit histograms of all registered checkpoints, see SCodeCheckpointHistogramHeader
+	bool DumpHistograms(const char* fileName) const;
+
 	void ReadFile(const char* fileName);
 
 	int GetLine( char * pBuff, FILE * fp );
@@ -151,28 +123,37 @@ private:
 
 	static CCodeCheckpointDebugMgr* s_pCodeCheckPointDebugManager;
 
+	///Only keeps the mechanism manager updating this while drawing or histograms are on
+	static void OnDebugCoverageChanged(ICVar* pVar);
+	static void OnDebugHistogramChanged(ICVar* pVar);
+	void UpdatePolicy();
+
 	///CVar variables
 	int m_debug_ccoverage;
 	float m_debug_ccoverage_rate;
 	int m_debug_ccoverage_maxlines;
 	int m_debug_ccoverage_filter_maxcount;
 	int m_debug_ccoverage_filter_mincount;
+	int m_debug_ccoverage_histogram;
+
+	void UpdateWatchPoint(const string& name, int count);
 
-	void UpdateRecord(const CCodeCheckpoint* pCheckpoint,CheckpointDebugRecord& record );
+	///Adds records for the checkpoints (or name reservations) the checkpoint manager got since the last call
+	void AddNewRecords(ICodeCheckpointMgr* pCodeCheckpointMgr);
 	void UpdateRecords();
+	void ClearHistograms();
 
 	void DrawDebugInfo();
 
-	typedef std::list<CheckpointDebugRecord> TCheckpointDebugList;
 	typedef std::vector<CheckpointDebugRecord> TCheckpointDebugVector;
+	typedef std::vector<const CheckpointDebugRecord*> TCheckpointDebugPtrVector;
 
-	typedef std::pair<string, int>	TBookmarkPair;
-	typedef std::map<string, int> TBookmarkMap;
-	TBookmarkMap m_bookmarkedNames;			/// List of points to be marked as watched with their current ref counts.
+	///One record per checkpoint manager index, so snapshots never need to look checkpoints up by name
+	TCheckpointDebugVector m_records;
 
-	///Keep watched points and unwatched points separate. This way when watched points must be queried/sorted, it can be done more quickly.
-	TCheckpointDebugList m_watchedPoints;		/// Current snapshot of checkpoints that have been requested for monitoring
-	TCheckpointDebugList m_unwatchedPoints;	/// Current snapshot of checkpoints that are not watched with all required debug information
+	///eNumHistogramBuckets frame counts per record, laid out in record order
+	std::vector<uint32> m_histograms;
+	uint32 m_histogramFrames;
 
 	float m_timeSinceLastRun;
 };
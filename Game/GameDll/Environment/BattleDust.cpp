@@ -15,6 +15,7 @@ History:
 #include "StdAfx.h"
 
 #include "BattleDust.h"
+#include "../GameNetProfiler.h"
 
 #include "Game.h"
 #include "GameCVars.h"
@@ -29,13 +30,8 @@ History:
 
 CBattleEvent::CBattleEvent()
 : m_worldPos(Vec3(0,0,0))
-, m_radius(0)
-, m_peakRadius(0)
-, m_lifetime(1)
-, m_lifeRemaining(1)
 , m_numParticles(0)
 , m_pParticleEffect(NULL)
-, m_entityId(0)
 {
 }
 
@@ -50,16 +46,6 @@ bool CBattleEvent::Init(IGameObject *pGameObject)
 	if(!GetGameObject()->BindToNetwork())
 		return false;
 
-	if(GetEntity())
-		m_entityId = GetEntity()->GetId();
-
-	if(gEnv->bServer && g_pGame->GetGameRules())
-	{
-		CBattleDust* pBD = g_pGame->GetGameRules()->GetBattleDust();
-		if(pBD)
-			pBD->NewBattleArea(this);
-	}
-
 	return true;
 }
 //------------------------------------------------------------------------
@@ -71,13 +57,7 @@ void CBattleEvent::PostInit(IGameObject *pGameObject)
 //------------------------------------------------------------------------
 void CBattleEvent::Release()
 {
-	// once this object is released it must also be removed from the list in CBattleDust
-	if(gEnv->bServer && g_pGame && g_pGame->GetGameRules())
-	{
-		CBattleDust* pBD = g_pGame->GetGameRules()->GetBattleDust();
-		if(pBD)
-			pBD->RemoveBattleArea(this);		
-	}
+	// CBattleDust finds out on its next update that the emitter is gone
 	delete this;
 }
 
@@ -87,20 +67,16 @@ void CBattleEvent::FullSerialize(TSerialize ser)
 	ser.BeginGroup("BattleEvent");
 	ser.Value("worldPos", m_worldPos);
 	ser.Value("numParticles", m_numParticles);
-	ser.Value("radius", m_radius);
-	ser.Value("m_peakRadius", m_peakRadius);
-	ser.Value("m_lifetime", m_lifetime);
-	ser.Value("m_lifeRemaining", m_lifeRemaining);
 	ser.EndGroup();
 	if(ser.IsReading())
 	{
 		m_pParticleEffect = NULL;
-		m_entityId = (GetEntity() != NULL) ? GetEntity()->GetId() : 0;
 	}
 }
 
 bool CBattleEvent::NetSerialize( TSerialize ser, EEntityAspects aspect, uint8 profile, int flags )
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	if (aspect == PROPERTIES_ASPECT)
 	{
 		ser.Value("worldPos", m_worldPos, 'wrld');
@@ -194,6 +170,10 @@ CBattleDust::CBattleDust()
 	m_distanceBetweenEvents = 0;
 
 	m_maxBattleEvents = 0;
+	m_nextSerial = 0;
+
+	for(int i = 0; i < eHashBuckets; ++i)
+		m_hashBuckets[i] = -1;
 
 	// load xml file and process it
 
@@ -394,85 +374,30 @@ void CBattleDust::RecordEvent(EBattleDustEventType event, Vec3 worldPos, const I
 	if(param.m_power == 0 || worldPos.IsEquivalent(Vec3(0,0,0)))
 		return;
 
-	if(m_pBattleEventClass == NULL)
-		m_pBattleEventClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass( "BattleEvent" );
-
-	// first check if we need a new event
-	bool newEvent = true;
-	for(std::list<EntityId>::iterator it = m_eventIdList.begin(); it != m_eventIdList.end(); ++it)
-	{
-		EntityId areaId = (*it);
-		CBattleEvent *pBattleArea = FindEvent(areaId);
-		if(pBattleArea && CheckIntersection(pBattleArea, worldPos, param.m_power))
-		{
-			// don't need a new event as this one is within an existing one. Just merge them.
-			MergeAreas(pBattleArea, worldPos, param.m_power);
-			pBattleArea->m_lifeRemaining += param.m_lifetime;
-			pBattleArea->m_lifetime = pBattleArea->m_lifeRemaining;
-			pBattleArea->m_lifetime = CLAMP(pBattleArea->m_lifetime, 0.0f, m_maxLifetime);
-			pBattleArea->m_lifeRemaining = CLAMP(pBattleArea->m_lifeRemaining, 0.0f, m_maxLifetime);
-			newEvent = false;			
-			break;
-		}
-	}
- 
-	if(newEvent)
+	// first check if we need a new area
+	if(SBattleDustArea* pBattleArea = FindOverlappingArea(worldPos, param.m_power))
 	{
-		IEntitySystem * pEntitySystem = gEnv->pEntitySystem;
- 		SEntitySpawnParams esp;
- 		esp.id = 0;
- 		esp.nFlags = 0;
- 		esp.pClass = m_pBattleEventClass;
- 		if (!esp.pClass)
- 			return;
- 		esp.pUserData = NULL;
- 		esp.sName = "BattleDust";
- 		esp.vPosition	= worldPos;
-	
-		// when CBattleEvent is created it will add itself to the list
-		IEntity * pEntity = pEntitySystem->SpawnEntity( esp );
-		if(pEntity)
-		{
-			// find the just-added entity in the list, and set it's properties
-			IGameObject* pGO = g_pGame->GetIGameFramework()->GetGameObject(pEntity->GetId());
-			if(pGO)
-			{
-				CBattleEvent* pNewEvent = static_cast<CBattleEvent*>(pGO->QueryExtension("BattleEvent"));
-				if(pNewEvent)
-				{
-					pNewEvent->m_radius = param.m_power;
-					pNewEvent->m_peakRadius = param.m_power;
-					pNewEvent->m_lifetime = param.m_lifetime;
-					pNewEvent->m_lifeRemaining = param.m_lifetime;
-					pNewEvent->m_worldPos = worldPos;
-
-					pNewEvent->m_lifetime = CLAMP(pNewEvent->m_lifetime, 0.0f, m_maxLifetime);
-					pNewEvent->m_lifeRemaining = CLAMP(pNewEvent->m_lifeRemaining, 0.0f, m_maxLifetime);
-
-					pGO->ChangedNetworkState(CBattleEvent::PROPERTIES_ASPECT);
-				}
-			}
-		}
-	}
-}
-
-void CBattleDust::NewBattleArea(CBattleEvent* pEvent)
-{
-	if(!g_pGameCVars->g_battleDust_enable)
+		// don't need a new area as this one is within an existing one. Just merge them.
+		MergeAreas(*pBattleArea, worldPos, param.m_power);
+		pBattleArea->m_lifeRemaining += param.m_lifetime;
+		pBattleArea->m_lifetime = pBattleArea->m_lifeRemaining;
+		pBattleArea->m_lifetime = CLAMP(pBattleArea->m_lifetime, 0.0f, m_maxLifetime);
+		pBattleArea->m_lifeRemaining = CLAMP(pBattleArea->m_lifeRemaining, 0.0f, m_maxLifetime);
 		return;
-
-	if (pEvent)
- 	{
-		m_eventIdList.push_back(pEvent->GetEntityId());
 	}
-}
 
-void CBattleDust::RemoveBattleArea(CBattleEvent* pEvent)
-{
-	if(pEvent)
-	{
-		stl::find_and_erase(m_eventIdList, pEvent->GetEntityId());
-	}
+	SBattleDustArea area;
+	area.m_worldPos = worldPos;
+	area.m_radius = param.m_power;
+	area.m_peakRadius = param.m_power;
+	area.m_lifetime = CLAMP(param.m_lifetime, 0.0f, m_maxLifetime);
+	area.m_lifeRemaining = area.m_lifetime;
+	area.m_numParticles = 0.0f;
+	area.m_serial = ++m_nextSerial;
+	area.m_nextInCell = -1;
+
+	m_areas.push_back(area);
+	AddToHash((int)m_areas.size() - 1);
 }
 
 void CBattleDust::Update()
@@ -491,63 +416,61 @@ void CBattleDust::Update()
 	if(g_pGameCVars->g_battleDust_debug != 0)
 	{
 		float col[] = {1,1,1,1};
-		gEnv->pRenderer->Draw2dLabel(50, 40, 2.0f, col, false, "Num BD areas: %d (max %d)", (int32)m_eventIdList.size(), m_maxBattleEvents);
+		gEnv->pRenderer->Draw2dLabel(50, 40, 2.0f, col, false, "Num BD areas: %d (max %d), emitters: %d", (int32)m_areas.size(), m_maxBattleEvents, (int32)m_emitters.size());
 	}
 	float ypos = 60.0f;
 
 	// go through the list of areas, remove any which are too small
-	m_maxBattleEvents = MAX(m_maxBattleEvents, m_eventIdList.size());
-	std::list<EntityId>::iterator next;
-	std::list<EntityId>::iterator it = m_eventIdList.begin();
-	for(; it != m_eventIdList.end(); it = next)
+	m_maxBattleEvents = MAX(m_maxBattleEvents, (int)m_areas.size());
+
+	const float frameTime = gEnv->pTimer->GetFrameTime();
+	for(int i = 0; i < (int)m_areas.size(); )
 	{
-		next = it; ++next;
-		EntityId areaId = (*it);
-		CBattleEvent *pBattleArea = FindEvent(areaId);
-		if(!pBattleArea)
-			continue;
+		SBattleDustArea& area = m_areas[i];
 
-		if(pBattleArea->m_lifetime > 0.0f)
+		if(area.m_lifetime > 0.0f)
 		{
-			pBattleArea->m_lifeRemaining -= gEnv->pTimer->GetFrameTime();
-			pBattleArea->m_radius = pBattleArea->m_peakRadius * (pBattleArea->m_lifeRemaining / pBattleArea->m_lifetime);
+			area.m_lifeRemaining -= frameTime;
+			area.m_radius = area.m_peakRadius * (area.m_lifeRemaining / area.m_lifetime);
 		}
 
 		if(g_pGameCVars->g_battleDust_debug != 0)
 		{
 			float col[] = {1,1,1,1};
-			gEnv->pRenderer->Draw2dLabel(50, ypos, 1.4f, col, false, "Area: (%.2f, %.2f, %.2f), Radius: %.2f/%.2f, Particles: %.0f, Lifetime: %.2f/%.2f", pBattleArea->m_worldPos.x, pBattleArea->m_worldPos.y, pBattleArea->m_worldPos.z, pBattleArea->m_radius, pBattleArea->m_peakRadius, pBattleArea->m_numParticles, pBattleArea->m_lifeRemaining, pBattleArea->m_lifetime);
+			gEnv->pRenderer->Draw2dLabel(50, ypos, 1.4f, col, false, "Area: (%.2f, %.2f, %.2f), Radius: %.2f/%.2f, Particles: %.0f, Lifetime: %.2f/%.2f", area.m_worldPos.x, area.m_worldPos.y, area.m_worldPos.z, area.m_radius, area.m_peakRadius, area.m_numParticles, area.m_lifeRemaining, area.m_lifetime);
 			ypos += 10.0f;
 		}
 
-		if(pBattleArea->m_lifeRemaining < 0.0f)
+		if(area.m_lifeRemaining < 0.0f)
 		{
-			// remove it (NB this will also call RemoveBattleArea(), which will remove it from the list)
-			gEnv->pEntitySystem->RemoveEntity(areaId);
+			// swap with the last one, the hash is rebuilt below
+			area = m_areas.back();
+			m_areas.pop_back();
 		}
 		else
 		{
-			if(pBattleArea->GetEntity())
-			{
-				UpdateParticlesForArea(pBattleArea);
-			}
+			UpdateParticlesForArea(area);
+			++i;
 		}
 	}
+
+	// areas move when they merge and indices change on removal
+	RebuildHash();
+
+	UpdateEmitters();
 }
 
 void CBattleDust::RemoveAllEvents()
 {
-	// go through the list and remove all entities (eg if user switches off battledust)
-	std::list<EntityId>::iterator next;
-	std::list<EntityId>::iterator it = m_eventIdList.begin();
-	for(; it != m_eventIdList.end(); it = next)
-	{
-		next = it; ++next;
-		EntityId areaId = (*it);
+	// remove all areas and the emitter entities (eg if user switches off battledust)
+	stl::free_container(m_areas);
+	RebuildHash();
 
-		// remove it (NB this will also call RemoveBattleArea(), which will remove it from the list)
-		gEnv->pEntitySystem->RemoveEntity(areaId);
+	for(std::vector<SEmitter>::const_iterator it = m_emitters.begin(); it != m_emitters.end(); ++it)
+	{
+		gEnv->pEntitySystem->RemoveEntity(it->m_entityId);
 	}
+	stl::free_container(m_emitters);
 }
 
 bool CBattleDust::GetEventParams(EBattleDustEventType event, const IEntityClass* pClass, SBattleEventParameter& out)
@@ -625,89 +548,209 @@ bool CBattleDust::GetEventParams(EBattleDustEventType event, const IEntityClass*
 	return (out.m_power != 0);
 }
 
-bool CBattleDust::CheckForMerging(CBattleEvent* pEvent)
+SBattleDustArea* CBattleDust::FindOverlappingArea(const Vec3& pos, float radius)
 {
 	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
 
-	if(!g_pGameCVars->g_battleDust_enable)
-		return false;
-
-	if(!pEvent)
-		return false;
+	// areas further apart than m_distanceBetweenEvents never merge, so the 3x3 cells around pos hold all candidates
+	int cellX, cellY;
+	GetCell(pos, cellX, cellY);
 
-	if(!gEnv->bServer)
-		return false;
-
-	// check if area can merge with nearby areas
-	for(std::list<EntityId>::iterator it = m_eventIdList.begin(); it != m_eventIdList.end(); ++it)
+	for(int y = cellY - 1; y <= cellY + 1; ++y)
 	{
-		EntityId areaId = (*it);
-		CBattleEvent *pBattleArea = FindEvent(areaId);
-		if(!pBattleArea)
-			continue;
-
-		if(CheckIntersection(pEvent, pBattleArea->m_worldPos, pBattleArea->m_radius) && pBattleArea->m_radius > 0 && (pBattleArea != pEvent) && pBattleArea->GetEntity())
+		for(int x = cellX - 1; x <= cellX + 1; ++x)
 		{
-			MergeAreas(pBattleArea, pEvent->m_worldPos, pEvent->m_radius);
-			return true;
+			for(int i = m_hashBuckets[GetBucket(x, y)]; i >= 0; i = m_areas[i].m_nextInCell)
+			{
+				if(CheckIntersection(m_areas[i], pos, radius))
+					return &m_areas[i];
+			}
 		}
 	}
 
-	return false;
+	return NULL;
 }
 
-bool CBattleDust::MergeAreas(CBattleEvent* pExisting, Vec3& pos, float radius)
+void CBattleDust::MergeAreas(SBattleDustArea& existing, const Vec3& pos, float radius)
 {
-	if(!pExisting)
-		return false;
-
 	// increase the size of existing area to take into account toAdd which overlaps.
 	// NB we don't need the new volume to completely enclose both starting volumes,
 	//	so for now:
 	//	- new centre pos is the average position, weighted by initial radius
 	//	- new radius is total of the two starting radii
 
-	float totalRadii = pExisting->m_radius + radius;
-	float oldFraction = pExisting->m_radius / totalRadii;
+	float totalRadii = existing.m_radius + radius;
+	float oldFraction = existing.m_radius / totalRadii;
 	float newFraction = radius / totalRadii;
 
-	pExisting->m_worldPos = (oldFraction * pExisting->m_worldPos) + (newFraction * pos);
-	pExisting->m_radius = CLAMP(totalRadii, 0.0f, m_maxEventPower);
-	pExisting->m_peakRadius = pExisting->m_radius;
+	existing.m_worldPos = (oldFraction * existing.m_worldPos) + (newFraction * pos);
+	existing.m_radius = CLAMP(totalRadii, 0.0f, m_maxEventPower);
+	existing.m_peakRadius = existing.m_radius;
+}
 
-	// position has moved, so need to serialize
-	if(pExisting->GetGameObject())
-	{
-		pExisting->GetGameObject()->ChangedNetworkState(CBattleEvent::PROPERTIES_ASPECT);
-	}
+void CBattleDust::UpdateParticlesForArea(SBattleDustArea& area)
+{
+	float fraction = CLAMP((area.m_radius - m_entitySpawnPower) / (m_maxEventPower - m_entitySpawnPower), 0.0f, 1.0f);
+	area.m_numParticles = LERP(m_minParticleCount, m_maxParticleCount, fraction);
+}
 
-	return true;
+bool CBattleDust::CheckIntersection(const SBattleDustArea& area, const Vec3& pos, float radius) const
+{
+	Vec3 centreToCentre = pos - area.m_worldPos;
+	float sumRadiiSquared = (radius * radius) + (area.m_radius * area.m_radius);
+	float distanceSquared = centreToCentre.GetLengthSquared();
+
+	return ((distanceSquared < sumRadiiSquared) && (distanceSquared < m_distanceBetweenEvents*m_distanceBetweenEvents));
+}
+
+void CBattleDust::GetCell(const Vec3& pos, int& x, int& y) const
+{
+	const float invCellSize = 1.0f / max(m_distanceBetweenEvents, 1.0f);
+	x = (int)floorf(pos.x * invCellSize);
+	y = (int)floorf(pos.y * invCellSize);
+}
+
+void CBattleDust::AddToHash(int areaIndex)
+{
+	SBattleDustArea& area = m_areas[areaIndex];
+
+	int x, y;
+	GetCell(area.m_worldPos, x, y);
+
+	int& head = m_hashBuckets[GetBucket(x, y)];
+	area.m_nextInCell = head;
+	head = areaIndex;
 }
 
-void CBattleDust::UpdateParticlesForArea(CBattleEvent* pEvent)
+void CBattleDust::RebuildHash()
 {
-	float oldParticleCount = pEvent->m_numParticles;
-	float fraction = CLAMP((pEvent->m_radius - m_entitySpawnPower) / (m_maxEventPower - m_entitySpawnPower), 0.0f, 1.0f);
-	pEvent->m_numParticles = LERP(m_minParticleCount, m_maxParticleCount, fraction);
+	for(int i = 0; i < eHashBuckets; ++i)
+		m_hashBuckets[i] = -1;
+
+	const int numAreas = (int)m_areas.size();
+	for(int i = 0; i < numAreas; ++i)
+		AddToHash(i);
+}
 
-	if(pEvent->GetGameObject() && oldParticleCount != pEvent->m_numParticles)
+namespace
+{
+	struct SDenserArea
 	{
-		pEvent->GetGameObject()->ChangedNetworkState(CBattleEvent::PROPERTIES_ASPECT);
-	}
+		SDenserArea(const std::vector<SBattleDustArea>& areas) : m_areas(areas) {}
+		bool operator()(int a, int b) const { return m_areas[a].m_numParticles > m_areas[b].m_numParticles; }
+		const std::vector<SBattleDustArea>& m_areas;
+	};
 }
 
-bool CBattleDust::CheckIntersection(CBattleEvent* pEventOne, Vec3& pos, float radius)
+void CBattleDust::UpdateEmitters()
 {
 	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
 
-	if(!pEventOne)
-		return false;
+	// pick the densest areas, one emitter each
+	m_densestAreas.resize(0);
+	const int numAreas = (int)m_areas.size();
+	for(int i = 0; i < numAreas; ++i)
+	{
+		if(m_areas[i].m_numParticles > 0.0f)
+			m_densestAreas.push_back(i);
+	}
 
-	Vec3 centreToCentre = pos - pEventOne->m_worldPos;
-	float sumRadiiSquared = (radius * radius) + (pEventOne->m_radius * pEventOne->m_radius);
-	float distanceSquared = centreToCentre.GetLengthSquared();
+	const int numDensest = min((int)m_densestAreas.size(), max(g_pGameCVars->g_battleDust_maxEmitters, 0));
+	std::partial_sort(m_densestAreas.begin(), m_densestAreas.begin() + numDensest, m_densestAreas.end(), SDenserArea(m_areas));
+	m_densestAreas.resize(numDensest);
 
-	return ((distanceSquared < sumRadiiSquared) && (distanceSquared < m_distanceBetweenEvents*m_distanceBetweenEvents));
+	// emitters keep their area while it stays among the densest, so they don't jump around
+	const int numEmitters = (int)m_emitters.size();
+	for(int e = 0; e < numEmitters; ++e)
+	{
+		SEmitter& emitter = m_emitters[e];
+		emitter.m_areaIndex = -1;
+		for(int d = 0; d < numDensest; ++d)
+		{
+			if(m_areas[m_densestAreas[d]].m_serial == emitter.m_areaSerial)
+			{
+				emitter.m_areaIndex = m_densestAreas[d];
+				break;
+			}
+		}
+		if(emitter.m_areaIndex < 0)
+			emitter.m_areaSerial = 0;
+	}
+
+	for(int d = 0; d < numDensest; ++d)
+	{
+		const SBattleDustArea& area = m_areas[m_densestAreas[d]];
+
+		SEmitter* pFree = NULL;
+		bool assigned = false;
+		for(std::vector<SEmitter>::iterator it = m_emitters.begin(); it != m_emitters.end() && !assigned; ++it)
+		{
+			assigned = (it->m_areaSerial == area.m_serial);
+			if(!pFree && it->m_areaSerial == 0)
+				pFree = &(*it);
+		}
+
+		if(assigned)
+			continue;
+
+		if(!pFree)
+		{
+			EntityId entityId = SpawnEmitter(area.m_worldPos);
+			if(!entityId)
+				break;
+
+			SEmitter emitter;
+			emitter.m_entityId = entityId;
+			m_emitters.push_back(emitter);
+			pFree = &m_emitters.back();
+		}
+
+		pFree->m_areaSerial = area.m_serial;
+		pFree->m_areaIndex = m_densestAreas[d];
+	}
+
+	// push the area state to the emitter entities, unassigned ones go quiet
+	for(std::vector<SEmitter>::iterator it = m_emitters.begin(); it != m_emitters.end(); )
+	{
+		CBattleEvent* pEmitter = FindEvent(it->m_entityId);
+		if(!pEmitter)
+		{
+			// removed from outside, eg a level reset
+			it = m_emitters.erase(it);
+			continue;
+		}
+
+		const Vec3 worldPos = (it->m_areaIndex >= 0) ? m_areas[it->m_areaIndex].m_worldPos : pEmitter->m_worldPos;
+		const float numParticles = (it->m_areaIndex >= 0) ? m_areas[it->m_areaIndex].m_numParticles : 0.0f;
+
+		if(numParticles != pEmitter->m_numParticles || !worldPos.IsEquivalent(pEmitter->m_worldPos))
+		{
+			pEmitter->m_worldPos = worldPos;
+			pEmitter->m_numParticles = numParticles;
+			pEmitter->GetGameObject()->ChangedNetworkState(CBattleEvent::PROPERTIES_ASPECT);
+		}
+
+		++it;
+	}
+}
+
+EntityId CBattleDust::SpawnEmitter(const Vec3& pos)
+{
+	if(m_pBattleEventClass == NULL)
+		m_pBattleEventClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass( "BattleEvent" );
+
+	SEntitySpawnParams esp;
+	esp.id = 0;
+	esp.nFlags = ENTITY_FLAG_NO_SAVE;
+	esp.pClass = m_pBattleEventClass;
+	if (!esp.pClass)
+		return 0;
+	esp.pUserData = NULL;
+	esp.sName = "BattleDust";
+	esp.vPosition	= pos;
+
+	IEntity * pEntity = gEnv->pEntitySystem->SpawnEntity( esp );
+	return pEntity ? pEntity->GetId() : 0;
 }
 
 void CBattleDust::Serialize(TSerialize ser)
@@ -715,31 +758,46 @@ void CBattleDust::Serialize(TSerialize ser)
 	if(ser.GetSerializationTarget() != eST_Network)
 	{
 		ser.BeginGroup("BattleDust");
-		int amount = m_eventIdList.size();
-		ser.Value("AmountOfBattleEvents", amount);
-		std::list<EntityId>::iterator begin = m_eventIdList.begin();
-		std::list<EntityId>::iterator end = m_eventIdList.end();
+		int amount = (int)m_areas.size();
+		ser.Value("AmountOfBattleAreas", amount);
 
 		if(ser.IsReading())
 		{
-			m_eventIdList.clear();
-			for(int i = 0; i < amount; ++i)
+			m_areas.resize(0);
+			m_areas.reserve(amount);
+		}
+
+		for(int i = 0; i < amount; ++i)
+		{
+			SBattleDustArea area;
+			if(!ser.IsReading())
+				area = m_areas[i];
+
+			ser.BeginGroup("BattleArea");
+			ser.Value("worldPos", area.m_worldPos);
+			ser.Value("radius", area.m_radius);
+			ser.Value("peakRadius", area.m_peakRadius);
+			ser.Value("lifetime", area.m_lifetime);
+			ser.Value("lifeRemaining", area.m_lifeRemaining);
+			ser.EndGroup();
+
+			if(ser.IsReading())
 			{
-				EntityId id = 0;
-				ser.BeginGroup("BattleEventId");
-				ser.Value("BattleEventId", id);
-				ser.EndGroup();
-				m_eventIdList.push_back(id);
+				area.m_numParticles = 0.0f;
+				area.m_serial = ++m_nextSerial;
+				area.m_nextInCell = -1;
+				m_areas.push_back(area);
 			}
 		}
-		else
+
+		if(ser.IsReading())
 		{
-			for(; begin != end; ++begin)
+			RebuildHash();
+
+			for(std::vector<SEmitter>::iterator it = m_emitters.begin(); it != m_emitters.end(); ++it)
 			{
-				EntityId id = (*begin);
-				ser.BeginGroup("BattleEventId");
-				ser.Value("BattleEventId", id);
-				ser.EndGroup();
+				it->m_areaSerial = 0;
+				it->m_areaIndex = -1;
 			}
 		}
 
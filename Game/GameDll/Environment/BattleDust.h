@@ -17,7 +17,6 @@ History:
 
 #pragma once
 
-#include <list>
 #include <IGameObject.h>
 
 // possible events that might cause dust
@@ -29,7 +28,7 @@ enum EBattleDustEventType
 	eBDET_VehicleExplosion,
 };
 
-// a game object created when a particle effect is needed for an event
+// a pooled game object carrying the particle emitter of one of the densest battle areas
 class CBattleEvent : public CGameObjectExtensionHelper<CBattleEvent, IGameObjectExtension>
 {
 public:
@@ -67,13 +66,21 @@ protected:
 	static const int PROPERTIES_ASPECT = eEA_GameServerStatic;
 
 	Vec3	m_worldPos;					// where in the world are we?
+	float m_numParticles;			// 0 while the emitter isn't assigned to an area
+	IParticleEffect* m_pParticleEffect;
+};
+
+// a battle area, events close to each other are merged into one
+struct SBattleDustArea
+{
+	Vec3	m_worldPos;
 	float m_radius;						// how big now
 	float m_peakRadius;				// how big it has been
 	float m_lifetime;					// how long we will live (total)
 	float m_lifeRemaining;		// how long before we are removed
 	float m_numParticles;
-	IParticleEffect* m_pParticleEffect;
-	EntityId m_entityId;			// needed so we can find this event in the list after adding it.
+	uint32 m_serial;					// identifies the area across frames for the emitter assignment
+	int		m_nextInCell;				// next area in the same spatial hash bucket
 };
 
 // since weapon events have lifetime as well as power
@@ -96,20 +103,41 @@ public:
 	void ReloadXml();
 	void RecordEvent(EBattleDustEventType event, Vec3 worldPos, const IEntityClass* pClass);
 	void Update();
-	void NewBattleArea(CBattleEvent* pEvent);
-	void RemoveBattleArea(CBattleEvent* pEvent);
 
 	void Serialize(TSerialize ser);
 
 protected:
+	enum
+	{
+		eHashBuckets = 256,			// power of two
+	};
+
+	// an emitter entity of the pool and the area it currently shows
+	struct SEmitter
+	{
+		EntityId	m_entityId;
+		uint32		m_areaSerial;		// 0 when unassigned
+		int				m_areaIndex;
+	};
+
 	bool GetEventParams(EBattleDustEventType event, const IEntityClass* pClass, SBattleEventParameter& out);
 	
 	// if two areas overlap, make a big one instead
-	bool CheckForMerging(CBattleEvent* pEvent);								
-	bool CheckIntersection(CBattleEvent* pEventOne, Vec3& pos, float radius);
-	bool MergeAreas(CBattleEvent* pExisting, Vec3& pos, float radius);
+	SBattleDustArea* FindOverlappingArea(const Vec3& pos, float radius);
+	bool CheckIntersection(const SBattleDustArea& area, const Vec3& pos, float radius) const;
+	void MergeAreas(SBattleDustArea& existing, const Vec3& pos, float radius);
+
+	void UpdateParticlesForArea(SBattleDustArea& area);
 
-	void UpdateParticlesForArea(CBattleEvent* pEvent);
+	// spatial hash over the xy plane, cells are m_distanceBetweenEvents wide
+	void GetCell(const Vec3& pos, int& x, int& y) const;
+	static int GetBucket(int x, int y) { return ((x * 73856093) ^ (y * 19349663)) & (eHashBuckets - 1); }
+	void AddToHash(int areaIndex);
+	void RebuildHash();
+
+	// hands the pooled emitters to the areas with the most particles
+	void UpdateEmitters();
+	EntityId SpawnEmitter(const Vec3& pos);
 
 	void RemoveAllEvents();
 
@@ -128,7 +156,12 @@ protected:
 	SBattleEventParameter m_defaultVehicleExplosion;
 	SBattleEventParameter m_defaultBulletImpact;
 
-	std::list<EntityId> m_eventIdList;												// what has happened recently
+	std::vector<SBattleDustArea> m_areas;											// what has happened recently
+	int m_hashBuckets[eHashBuckets];													// first area index of each bucket, -1 if empty
+	uint32 m_nextSerial;
+
+	std::vector<SEmitter> m_emitters;													// pooled, never more than g_battleDust_maxEmitters
+	std::vector<int> m_densestAreas;
 	std::vector<SBattleEventParameter> m_weaponPower;					// what effect each shot has
 	std::vector<SBattleEventParameter> m_explosionPower;			// what effect each explosion has
 	std::vector<SBattleEventParameter> m_vehicleExplosionPower;// similar for vehicle explosions
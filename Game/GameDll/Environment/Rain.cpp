@@ -1,6 +1,7 @@
 #include "StdAfx.h"
 #include "Rain.h"
 #include "Game.h"
+#include "WeatherArbiter.h"
 
 CRain::CRain()
 {
@@ -20,7 +21,11 @@ bool CRain::Init(IGameObject *pGameObject)
 	SetGameObject(pGameObject);
 	PreloadTextures();
 
-	return Reset();
+	if (!Reset())
+		return false;
+
+	UpdateContribution();
+	return true;
 }
 
 //------------------------------------------------------------------------
@@ -55,7 +60,9 @@ void CRain::PreloadTextures()
 //------------------------------------------------------------------------
 void CRain::PostInit(IGameObject *pGameObject)
 {
-	GetGameObject()->EnableUpdateSlot(this, 0);
+	// properties can only change at runtime in the editor, in game the entity is event driven
+	if (gEnv->IsEditor())
+		GetGameObject()->EnableUpdateSlot(this, 0);
 }
 
 //------------------------------------------------------------------------
@@ -95,33 +102,47 @@ void CRain::FullSerialize(TSerialize ser)
 	ser.Value("bRainDrops", m_bRainDrops);
 	ser.Value("fRainDropsSpeed", m_fRainDropsSpeed);
 	ser.Value("fUmbrellaRadius", m_fUmbrellaRadius);
+
+	if (ser.IsReading())
+		UpdateContribution();
 }
 
 //------------------------------------------------------------------------
 void CRain::Update(SEntityUpdateContext &ctx, int updateSlot)
 {
-	const IActor * pClient = g_pGame->GetIGameFramework()->GetClientActor();
-	if (pClient && Reset())
-	{
-		const Vec3 vCamPos = gEnv->pRenderer->GetCamera().GetPosition();
-		Vec3 vR = (GetEntity()->GetWorldPos() - vCamPos) / max(m_fRadius, 1e-3f);
-		float fAttenAmount = max(0.f, 1.0f - vR.dot(vR));
-		fAttenAmount *= m_fAmount;
+	// editor only, pick up property changes
+	if (Reset() && !GetEntity()->IsHidden())
+		UpdateContribution();
+}
 
-		// Force set if current values not valid
-		float fCurRadius, fCurAmount;
-		Vec3 vCurColor;
-		bool bSet = !gEnv->p3DEngine->GetRainParams(vR, fCurRadius, fCurAmount, vCurColor);
+//------------------------------------------------------------------------
+void CRain::UpdateContribution()
+{
+	if (!m_bEnabled || m_fAmount <= 0.f)
+	{
+		RemoveContribution();
+		return;
+	}
 
-		// Set if stronger
-		bSet |= fAttenAmount > fCurAmount;
+	SRainParams params;
+	params.fRadius = m_fRadius;
+	params.fAmount = m_fAmount;
+	params.vColor = m_vColor;
+	params.fReflectionAmount = m_fReflectionAmount;
+	params.fFakeGlossiness = m_fFakeGlossiness;
+	params.fPuddlesAmount = m_fPuddlesAmount;
+	params.bRainDrops = m_bRainDrops;
+	params.fRainDropsSpeed = m_fRainDropsSpeed;
+	params.fUmbrellaRadius = m_fUmbrellaRadius;
+
+	g_pGame->GetWeatherArbiter().SetRain(GetEntityId(), GetEntity()->GetWorldPos(), params);
+}
 
-		if (bSet)
-		{
-			gEnv->p3DEngine->SetRainParams(GetEntity()->GetWorldPos(), m_fRadius, fAttenAmount, m_vColor);
-			gEnv->p3DEngine->SetRainParams(0.5f * m_fReflectionAmount, m_fFakeGlossiness, m_fPuddlesAmount, m_bRainDrops, m_fRainDropsSpeed, m_fUmbrellaRadius);
-		}
-	}
+//------------------------------------------------------------------------
+void CRain::RemoveContribution()
+{
+	if (g_pGame)
+		g_pGame->GetWeatherArbiter().RemoveRain(GetEntityId());
 }
 
 //------------------------------------------------------------------------
@@ -136,14 +157,17 @@ void CRain::ProcessEvent(SEntityEvent &event)
 	{
 	case ENTITY_EVENT_RESET:
 		Reset();
+		UpdateContribution();
+		break;
+	case ENTITY_EVENT_XFORM:
+	case ENTITY_EVENT_UNHIDE:
+		if (!GetEntity()->IsHidden())
+			UpdateContribution();
 		break;
 	case ENTITY_EVENT_HIDE:
 	case ENTITY_EVENT_DONE:
-		if (gEnv && gEnv->p3DEngine)
-		{
-			static const Vec3 vZero(ZERO);
-			gEnv->p3DEngine->SetRainParams(vZero, 0, 0, vZero);
-		}
+		// the arbiter clears the engine rain once no volume contributes
+		RemoveContribution();
 		break;
 	}
 }
@@ -54,6 +54,10 @@ protected:
 
 	void PreloadTextures();
 
+	// hands the current properties to the weather arbiter, which decides what the engine gets
+	void UpdateContribution();
+	void RemoveContribution();
+
 	bool	m_bEnabled;
 	float	m_fRadius;
 	float	m_fAmount;
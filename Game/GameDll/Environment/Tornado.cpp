@@ -1,5 +1,6 @@
 #include "StdAfx.h"
 #include "Tornado.h"
+#include "../GameNetProfiler.h"
 #include "../Game.h"
 #include "../Actor.h"
 #include "Environment/FlowTornado.h"
@@ -9,6 +10,13 @@
 
 #include <IRenderAuxGeom.h>
 
+#if (defined(_CPU_SSE) && defined(_CPU_X86)) || defined(_CPU_AMD64)
+	#define TORNADO_SSE 1
+	#include <xmmintrin.h>
+#endif
+
+std::vector<CTornado*> CTornado::s_tornados;
+
 //------------------------------------------------------------------------
 CTornado::CTornado() :
 	m_pPhysicalEntity(0),
@@ -18,11 +26,21 @@ CTornado::CTornado() :
 	m_pGroundEffect(0),
 	m_pTargetEntity(0)
 {
+	// one deletion listener for all tornados, so held bodies are dropped as soon as physics removes them
+	if (s_tornados.empty())
+		gEnv->pPhysicalWorld->AddEventClient(EventPhysEntityDeleted::id, OnPhysEntityDeleted, 1);
+	s_tornados.push_back(this);
 }
 
 //------------------------------------------------------------------------
 CTornado::~CTornado()
 {
+	ReleaseSpinningEnts();
+
+	stl::find_and_erase(s_tornados, this);
+	if (s_tornados.empty())
+		gEnv->pPhysicalWorld->RemoveEventClient(EventPhysEntityDeleted::id, OnPhysEntityDeleted, 1);
+
 	if (m_pGroundEffect)
 		delete m_pGroundEffect;
 }
@@ -80,6 +98,7 @@ bool CTornado::Reset()
 	m_isInAir = false;
 
 	m_nextEntitiesCheck = 0;
+	ReleaseSpinningEnts();
 
 	Vec3 pos = GetEntity()->GetWorldPos();
 	gEnv->pLog->Log("TORNADO INIT POS: %f %f %f", pos.x, pos.y, pos.z);
@@ -122,6 +141,7 @@ void CTornado::FullSerialize(TSerialize ser)
 //------------------------------------------------------------------------
 bool CTornado::NetSerialize( TSerialize ser, EEntityAspects aspect, uint8 profile, int flags )
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	if (aspect == POSITION_ASPECT)
 	{
 		ser.Value("Pos", m_currentPos, 'wrld');
@@ -396,13 +416,13 @@ void CTornado::UpdateTornadoSpline()
 
 void CTornado::UpdateFlow()
 {
+	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
+
 	IVehicleSystem* pVehicleSystem = g_pGame->GetIGameFramework()->GetIVehicleSystem();
 	assert(pVehicleSystem);
 
 	float frameTime(gEnv->pTimer->GetFrameTime());
 
-	IPhysicalWorld *ppWorld = gEnv->pPhysicalWorld;
-
 	Vec3 pos(GetEntity()->GetWorldPos());
 
 	//first, check the entities in range
@@ -410,94 +430,262 @@ void CTornado::UpdateFlow()
 	if (m_nextEntitiesCheck<0.0f)
 	{
 		m_nextEntitiesCheck = 1.0f;
-		
-		Vec3 radiusVec(m_radius,m_radius,0);
-		
-		IPhysicalEntity **ppList = NULL;
+		RefreshSpinningEnts(pos);
+		//OutputDistance();
+	}
 
-		int	numEnts = ppWorld->GetEntitiesInBox(pos-radiusVec,pos+radiusVec+Vec3(0,0,m_cloudHeight*0.5f),ppList,ent_sleeping_rigid|ent_rigid|ent_living);
+	SSpinningBodies& bodies = m_spinningEnts;
+	if (!bodies.count)
+		return;
+
+	//gather: read the state of all bodies before touching any of them
+	for (int i=0;i<bodies.count;++i)
+	{
+		IPhysicalEntity *ppEnt = bodies.pEntities[i];
+		if (!ppEnt)
+			continue;
 
-		m_spinningEnts.clear();
-		for (int i=0;i<numEnts;++i)
+		pe_status_pos spos;
+		pe_status_dynamics sdyn;
+
+		if (!ppEnt->GetStatus(&spos) || !ppEnt->GetStatus(&sdyn))
 		{
-			// add check for spectating players...
-			EntityId id = ppWorld->GetPhysicalEntityId(ppList[i]);
-			CActor* pActor = static_cast<CActor*>(g_pGame->GetIGameFramework()->GetIActorSystem()->GetActor(id));
-			if(!pActor || !pActor->GetSpectatorMode())
-			{
-				m_spinningEnts.push_back(id);
-			}
+			ppEnt->Release();
+			bodies.ClearSlot(i);
+			continue;
 		}
-		//OutputDistance();
+
+		bodies.posX[i] = spos.pos.x;
+		bodies.posY[i] = spos.pos.y;
+		bodies.mass[i] = sdyn.mass;
 	}
 
-	//mess entities around
-	for (int i=0;i<m_spinningEnts.size();++i)
+	ComputeSpinImpulses(pos, frameTime);
+
+	const int numAirVehicles = (int)bodies.airVehicles.size();
+	for (int i=0;i<numAirVehicles;++i)
 	{
-		IPhysicalEntity *ppEnt = ppWorld->GetPhysicalEntityById(m_spinningEnts[i]);
-		if (ppEnt)
+		const int slot = bodies.airVehicles[i];
+		IEntity* pEntity = bodies.pEntities[slot] ? gEnv->pEntitySystem->GetEntityFromPhysics(bodies.pEntities[slot]) : NULL;
+		IVehicle* pVehicle = pEntity ? pVehicleSystem->GetVehicle(pEntity->GetId()) : NULL;
+		IVehicleMovement* pMovement = pVehicle ? pVehicle->GetMovement() : NULL;
+
+		if (pMovement && pMovement->GetMovementType() == IVehicleMovement::eVMT_Air)
 		{
-			pe_status_pos spos;
-			pe_status_dynamics sdyn;
+			SVehicleMovementEventParams params;
+			params.fValue = bodies.forceMult[slot];
+			pMovement->OnEvent(IVehicleMovement::eVME_Turbulence, params);
+		}
+	}
 
-			if (!ppEnt->GetStatus(&spos) || !ppEnt->GetStatus(&sdyn))
-				continue;
-		
-			//gEnv->pRenderer->GetIRenderAuxGeom()->DrawSphere(spos.pos,2.0f,ColorB(255,0,255,255));
-						
-			Vec3 delta(pos - spos.pos);
-			delta.z = 0.0f;
+	//apply: bodies outside the radius get nothing, so they aren't woken up
+	pe_action_impulse aimpulse;
+	aimpulse.iApplyTime = 0;
 
-			float dLen(delta.len());
-			float forceMult(max(0.0f,(m_radius-dLen)/m_radius));
+	for (int i=0;i<bodies.count;++i)
+	{
+		if (!bodies.pEntities[i] || bodies.forceMult[i] <= 0.0f)
+			continue;
 
-			if (dLen>0.001f)
-				delta /= dLen;
-			else
-				delta.zero();
+		aimpulse.impulse.Set(bodies.impulseX[i], bodies.impulseY[i], bodies.impulseZ[i]);
+		aimpulse.angImpulse.Set(bodies.angImpulseX[i], bodies.angImpulseY[i], bodies.angImpulseZ[i]);
+		bodies.pEntities[i]->Action(&aimpulse);
 
-			Vec3 upVector(0,0,1);
+		//gEnv->pRenderer->GetIRenderAuxGeom()->DrawLine(Vec3(bodies.posX[i],bodies.posY[i],pos.z),ColorB(255,0,255,255),Vec3(bodies.posX[i],bodies.posY[i],pos.z)+aimpulse.impulse.GetNormalizedSafe(ZERO),ColorB(255,0,255,255));
+	}
+}
 
-			float spinImpulse(m_spinImpulse);
-			float attractionImpulse(m_attractionImpulse);
-			float upImpulse(m_upImpulse);
+//------------------------------------------------------------------------
+void CTornado::RefreshSpinningEnts(const Vec3& pos)
+{
+	IPhysicalWorld *ppWorld = gEnv->pPhysicalWorld;
+	IVehicleSystem* pVehicleSystem = g_pGame->GetIGameFramework()->GetIVehicleSystem();
+	IActorSystem* pActorSystem = g_pGame->GetIGameFramework()->GetIActorSystem();
 
-			//FIXME:kind of workaround, living entities needs some "help" to get out of the vortex
-			if (ppEnt->GetType() == PE_LIVING)
-			{
-				upImpulse *= 0.75f;
-				attractionImpulse *= 0.35f;
-				spinImpulse *= 1.5f;
-			}
+	Vec3 radiusVec(m_radius,m_radius,0);
 
-			
-			if (IVehicle* pVehicle = pVehicleSystem->GetVehicle(m_spinningEnts[i]))
-			{
-				IVehicleMovement* pMovement = pVehicle->GetMovement();
+	IPhysicalEntity **ppList = NULL;
 
-				if (pMovement && pMovement->GetMovementType() == IVehicleMovement::eVMT_Air)
-				{
-					SVehicleMovementEventParams params;
-					params.fValue = forceMult;
-					pMovement->OnEvent(IVehicleMovement::eVME_Turbulence, params);
-				}
-			}
+	int	numEnts = ppWorld->GetEntitiesInBox(pos-radiusVec,pos+radiusVec+Vec3(0,0,m_cloudHeight*0.5f),ppList,ent_sleeping_rigid|ent_rigid|ent_living);
 
-			Vec3 spinForce( (delta % upVector) * spinImpulse );
-			Vec3 attractionForce(delta * attractionImpulse);
-			Vec3 upForce(0,0,upImpulse);
+	// reference the new set before releasing the old one, most bodies are in both
+	for (int i=0;i<numEnts;++i)
+		ppList[i]->AddRef();
+	ReleaseSpinningEnts();
 
-			pe_action_impulse aimpulse;
+	SSpinningBodies& bodies = m_spinningEnts;
+	bodies.Resize(numEnts);
 
-			aimpulse.impulse = (spinForce + attractionForce + upForce) * (forceMult * sdyn.mass * frameTime);
-			aimpulse.angImpulse = (upVector + (delta % upVector)) * (gf_PI * 0.33f * forceMult * sdyn.mass * frameTime);
+	int count = 0;
+	for (int i=0;i<numEnts;++i)
+	{
+		IPhysicalEntity* ppEnt = ppList[i];
+		IEntity* pEntity = gEnv->pEntitySystem->GetEntityFromPhysics(ppEnt);
+		EntityId id = pEntity ? pEntity->GetId() : 0;
 
-			aimpulse.iApplyTime = 0;
-			ppEnt->Action(&aimpulse);
+		// add check for spectating players...
+		CActor* pActor = id ? static_cast<CActor*>(pActorSystem->GetActor(id)) : NULL;
+		if (pActor && pActor->GetSpectatorMode())
+		{
+			ppEnt->Release();
+			continue;
+		}
+
+		bodies.pEntities[count] = ppEnt;
+		bodies.spinImpulse[count] = m_spinImpulse;
+		bodies.attractionImpulse[count] = m_attractionImpulse;
+		bodies.upImpulse[count] = m_upImpulse;
 
-			//gEnv->pRenderer->GetIRenderAuxGeom()->DrawLine(spos.pos,ColorB(255,0,255,255),spos.pos+aimpulse.impulse.GetNormalizedSafe(ZERO),ColorB(255,0,255,255));
+		//FIXME:kind of workaround, living entities needs some "help" to get out of the vortex
+		if (ppEnt->GetType() == PE_LIVING)
+		{
+			bodies.upImpulse[count] *= 0.75f;
+			bodies.attractionImpulse[count] *= 0.35f;
+			bodies.spinImpulse[count] *= 1.5f;
 		}
+
+		if (id && pVehicleSystem->GetVehicle(id))
+			bodies.airVehicles.push_back(count);
+
+		++count;
 	}
+
+	bodies.count = count;
+}
+
+//------------------------------------------------------------------------
+void CTornado::ReleaseSpinningEnts()
+{
+	SSpinningBodies& bodies = m_spinningEnts;
+	for (int i=0;i<bodies.count;++i)
+	{
+		if (bodies.pEntities[i])
+			bodies.pEntities[i]->Release();
+	}
+
+	bodies.count = 0;
+	bodies.airVehicles.clear();
+}
+
+//------------------------------------------------------------------------
+void CTornado::ComputeSpinImpulses(const Vec3& pos, float frameTime)
+{
+	SSpinningBodies& bodies = m_spinningEnts;
+
+	// per body: delta is the horizontal direction to the tornado, spin is delta % up
+	//	impulse = (spin * spinImpulse + delta * attractionImpulse + up * upImpulse) * forceMult * mass * frameTime
+	//	angImpulse = (up + spin) * pi * 0.33 * forceMult * mass * frameTime
+	const float invRadius = (m_radius > 0.0f) ? 1.0f / m_radius : 0.0f;
+
+#if TORNADO_SSE
+	const __m128 centerX = _mm_set1_ps(pos.x);
+	const __m128 centerY = _mm_set1_ps(pos.y);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 minLen = _mm_set1_ps(0.001f);
+	const __m128 invRadius4 = _mm_set1_ps(invRadius);
+	const __m128 frameTime4 = _mm_set1_ps(frameTime);
+	const __m128 angScale = _mm_set1_ps(gf_PI * 0.33f);
+
+	for (int i=0;i<bodies.count;i+=4)
+	{
+		__m128 dx = _mm_sub_ps(centerX, _mm_loadu_ps(&bodies.posX[i]));
+		__m128 dy = _mm_sub_ps(centerY, _mm_loadu_ps(&bodies.posY[i]));
+		const __m128 dLen = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+		// (radius - dLen) / radius, clamped at zero
+		const __m128 forceMult = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(dLen, invRadius4)));
+
+		const __m128 invLen = _mm_and_ps(_mm_cmpgt_ps(dLen, minLen), _mm_div_ps(one, _mm_max_ps(dLen, minLen)));
+		dx = _mm_mul_ps(dx, invLen);
+		dy = _mm_mul_ps(dy, invLen);
+
+		const __m128 scale = _mm_mul_ps(_mm_mul_ps(forceMult, _mm_loadu_ps(&bodies.mass[i])), frameTime4);
+		const __m128 spin = _mm_loadu_ps(&bodies.spinImpulse[i]);
+		const __m128 attraction = _mm_loadu_ps(&bodies.attractionImpulse[i]);
+
+		// spin = (dy, -dx, 0)
+		_mm_storeu_ps(&bodies.impulseX[i], _mm_mul_ps(_mm_add_ps(_mm_mul_ps(dy, spin), _mm_mul_ps(dx, attraction)), scale));
+		_mm_storeu_ps(&bodies.impulseY[i], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dy, attraction), _mm_mul_ps(dx, spin)), scale));
+		_mm_storeu_ps(&bodies.impulseZ[i], _mm_mul_ps(_mm_loadu_ps(&bodies.upImpulse[i]), scale));
+
+		const __m128 angImpulse = _mm_mul_ps(angScale, scale);
+		_mm_storeu_ps(&bodies.angImpulseX[i], _mm_mul_ps(dy, angImpulse));
+		_mm_storeu_ps(&bodies.angImpulseY[i], _mm_sub_ps(zero, _mm_mul_ps(dx, angImpulse)));
+		_mm_storeu_ps(&bodies.angImpulseZ[i], angImpulse);
+		_mm_storeu_ps(&bodies.forceMult[i], forceMult);
+	}
+#else
+	for (int i=0;i<bodies.count;++i)
+	{
+		float dx = pos.x - bodies.posX[i];
+		float dy = pos.y - bodies.posY[i];
+		const float dLen = sqrtf(dx*dx + dy*dy);
+
+		const float forceMult = max(0.0f, 1.0f - dLen * invRadius);
+
+		const float invLen = (dLen > 0.001f) ? 1.0f / dLen : 0.0f;
+		dx *= invLen;
+		dy *= invLen;
+
+		const float scale = forceMult * bodies.mass[i] * frameTime;
+
+		bodies.impulseX[i] = (dy * bodies.spinImpulse[i] + dx * bodies.attractionImpulse[i]) * scale;
+		bodies.impulseY[i] = (dy * bodies.attractionImpulse[i] - dx * bodies.spinImpulse[i]) * scale;
+		bodies.impulseZ[i] = bodies.upImpulse[i] * scale;
+
+		const float angImpulse = gf_PI * 0.33f * scale;
+		bodies.angImpulseX[i] = dy * angImpulse;
+		bodies.angImpulseY[i] = -dx * angImpulse;
+		bodies.angImpulseZ[i] = angImpulse;
+		bodies.forceMult[i] = forceMult;
+	}
+#endif
+}
+
+//------------------------------------------------------------------------
+int CTornado::OnPhysEntityDeleted(const EventPhys* pEvent)
+{
+	const EventPhysEntityDeleted* pDeleted = static_cast<const EventPhysEntityDeleted*>(pEvent);
+
+	for (std::vector<CTornado*>::const_iterator it = s_tornados.begin(); it != s_tornados.end(); ++it)
+	{
+		SSpinningBodies& bodies = (*it)->m_spinningEnts;
+		for (int i=0;i<bodies.count;++i)
+		{
+			if (bodies.pEntities[i] == pDeleted->pEntity)
+			{
+				bodies.pEntities[i]->Release();
+				bodies.ClearSlot(i);
+			}
+		}
+	}
+
+	return 1;
+}
+
+//------------------------------------------------------------------------
+void CTornado::SSpinningBodies::Resize(int count)
+{
+	const int padded = (count + 3) & ~3;
+
+	pEntities.resize(padded);
+	posX.resize(padded); posY.resize(padded); mass.resize(padded);
+	spinImpulse.resize(padded); attractionImpulse.resize(padded); upImpulse.resize(padded);
+	forceMult.resize(padded);
+	impulseX.resize(padded); impulseY.resize(padded); impulseZ.resize(padded);
+	angImpulseX.resize(padded); angImpulseY.resize(padded); angImpulseZ.resize(padded);
+
+	for (int i=0;i<padded;++i)
+		ClearSlot(i);
+}
+
+//------------------------------------------------------------------------
+void CTornado::SSpinningBodies::ClearSlot(int i)
+{
+	pEntities[i] = NULL;
+	posX[i] = posY[i] = mass[i] = 0.0f;
+	spinImpulse[i] = attractionImpulse[i] = upImpulse[i] = 0.0f;
 }
 
 void CTornado::OutputDistance()
@@ -526,5 +714,12 @@ void CTornado::OutputDistance()
 void CTornado::GetMemoryUsage( ICrySizer *s ) const
 {
 	s->Add(*this);
-	s->AddContainer(m_spinningEnts);
+	const SSpinningBodies& bodies = m_spinningEnts;
+	s->AddContainer(bodies.pEntities);
+	s->AddContainer(bodies.posX); s->AddContainer(bodies.posY); s->AddContainer(bodies.mass);
+	s->AddContainer(bodies.spinImpulse); s->AddContainer(bodies.attractionImpulse); s->AddContainer(bodies.upImpulse);
+	s->AddContainer(bodies.forceMult);
+	s->AddContainer(bodies.impulseX); s->AddContainer(bodies.impulseY); s->AddContainer(bodies.impulseZ);
+	s->AddContainer(bodies.angImpulseX); s->AddContainer(bodies.angImpulseY); s->AddContainer(bodies.angImpulseZ);
+	s->AddContainer(bodies.airVehicles);
 }
@@ -62,6 +62,12 @@ protected:
 	void	UpdateFlow();
 	void	OutputDistance();
 
+	void	RefreshSpinningEnts(const Vec3& pos);
+	void	ReleaseSpinningEnts();
+	void	ComputeSpinImpulses(const Vec3& pos, float frameTime);
+
+	static int OnPhysEntityDeleted(const EventPhys* pEvent);
+
 protected:
 	static const int POSITION_ASPECT = eEA_GameServerStatic;
 
@@ -98,7 +104,28 @@ protected:
 	float m_attractionImpulse;
 	float m_upImpulse;
 
-	std::vector<int> m_spinningEnts;
+	// bodies inside the tornado, structure of arrays padded to a multiple of 4 for the impulse pass.
+	// The physical entities are referenced while held, empty slots have a NULL entity and zero mass.
+	struct SSpinningBodies
+	{
+		SSpinningBodies() : count(0) {}
+
+		void Resize(int count);
+		void ClearSlot(int i);
+
+		std::vector<IPhysicalEntity*> pEntities;
+		std::vector<float> posX, posY, mass;
+		std::vector<float> spinImpulse, attractionImpulse, upImpulse;
+		std::vector<float> forceMult;
+		std::vector<float> impulseX, impulseY, impulseZ;
+		std::vector<float> angImpulseX, angImpulseY, angImpulseZ;
+		std::vector<int> airVehicles;		// slots holding air vehicles, they get turbulence events
+		int count;
+	};
+
+	SSpinningBodies m_spinningEnts;
+
+	static std::vector<CTornado*> s_tornados;
 };
 
 #endif //__TORNADO_H__
@@ -0,0 +1,155 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Game side arbitration of the weather parameters.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "WeatherArbiter.h"
+#include "Game.h"
+#include "GameCVars.h"
+
+//------------------------------------------------------------------------
+CWeatherArbiter::CWeatherArbiter()
+: m_pushedRainId(0)
+, m_pushedAmount(0.f)
+, m_paramsChanged(false)
+{
+}
+
+//------------------------------------------------------------------------
+void CWeatherArbiter::SetRain(EntityId entityId, const Vec3& vCenter, const SRainParams& params)
+{
+	SRainVolume* pVolume = NULL;
+	for (TRainVolumes::iterator it = m_rainVolumes.begin(), itEnd = m_rainVolumes.end(); it != itEnd; ++it)
+	{
+		if (it->entityId == entityId)
+		{
+			pVolume = &(*it);
+			break;
+		}
+	}
+
+	if (!pVolume)
+	{
+		m_rainVolumes.push_back(SRainVolume());
+		pVolume = &m_rainVolumes.back();
+		pVolume->entityId = entityId;
+	}
+
+	pVolume->vCenter = vCenter;
+	pVolume->params = params;
+
+	if (entityId == m_pushedRainId)
+		m_paramsChanged = true;
+}
+
+//------------------------------------------------------------------------
+void CWeatherArbiter::RemoveRain(EntityId entityId)
+{
+	for (TRainVolumes::iterator it = m_rainVolumes.begin(), itEnd = m_rainVolumes.end(); it != itEnd; ++it)
+	{
+		if (it->entityId == entityId)
+		{
+			m_rainVolumes.erase(it);
+			break;
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+void CWeatherArbiter::Update()
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
+
+	if (m_rainVolumes.empty() && m_pushedAmount == 0.f)
+		return;
+
+	if (!g_pGame->GetIGameFramework()->GetClientActor())
+		return;
+
+	const Vec3 vCamPos = gEnv->pRenderer->GetCamera().GetPosition();
+
+	const SRainVolume* pWinner = NULL;
+	float fWinnerAmount = 0.f;
+
+	for (TRainVolumes::const_iterator it = m_rainVolumes.begin(), itEnd = m_rainVolumes.end(); it != itEnd; ++it)
+	{
+		const Vec3 vR = (it->vCenter - vCamPos) / max(it->params.fRadius, 1e-3f);
+		const float fAttenAmount = max(0.f, 1.0f - vR.dot(vR)) * it->params.fAmount;
+
+		if (fAttenAmount > fWinnerAmount)
+		{
+			pWinner = &(*it);
+			fWinnerAmount = fAttenAmount;
+		}
+	}
+
+	PushRain(pWinner, fWinnerAmount);
+}
+
+//------------------------------------------------------------------------
+void CWeatherArbiter::PushRain(const SRainVolume* pWinner, float fAmount)
+{
+	I3DEngine* p3DEngine = gEnv->p3DEngine;
+
+	const float threshold = g_pGameCVars->g_weatherArbiter_threshold;
+
+	if (!pWinner)
+	{
+		if (m_pushedAmount != 0.f)
+		{
+			static const Vec3 vZero(ZERO);
+			p3DEngine->SetRainParams(vZero, 0, 0, vZero);
+
+			m_pushedRainId = 0;
+			m_pushedAmount = 0.f;
+		}
+		return;
+	}
+
+	// force the push while the engine reports its rain parameters as invalid, as the volumes used to
+	Vec3 vCurCenter, vCurColor;
+	float fCurRadius, fCurAmount;
+	const bool bValid = p3DEngine->GetRainParams(vCurCenter, fCurRadius, fCurAmount, vCurColor);
+
+	const bool bNewWinner = !bValid || pWinner->entityId != m_pushedRainId || m_paramsChanged;
+	const bool bAmountChanged = fabsf(fAmount - m_pushedAmount) > threshold || (fAmount == 0.f) != (m_pushedAmount == 0.f);
+
+	if (bNewWinner || bAmountChanged)
+	{
+		const SRainParams& params = pWinner->params;
+		p3DEngine->SetRainParams(pWinner->vCenter, params.fRadius, fAmount, params.vColor);
+
+		if (bNewWinner)
+		{
+			p3DEngine->SetRainParams(0.5f * params.fReflectionAmount, params.fFakeGlossiness, params.fPuddlesAmount, params.bRainDrops, params.fRainDropsSpeed, params.fUmbrellaRadius);
+		}
+
+		m_pushedRainId = pWinner->entityId;
+		m_pushedAmount = fAmount;
+		m_paramsChanged = false;
+	}
+}
+
+//------------------------------------------------------------------------
+void CWeatherArbiter::Reset()
+{
+	stl::free_container(m_rainVolumes);
+
+	m_pushedRainId = 0;
+	m_pushedAmount = 0.f;
+	m_paramsChanged = false;
+}
+
+//------------------------------------------------------------------------
+void CWeatherArbiter::GetMemoryStatistics(ICrySizer* s) const
+{
+	s->Add(*this);
+	s->AddContainer(m_rainVolumes);
+}
@@ -0,0 +1,81 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Collects the contributions of the weather entities (rain volumes) and
+decides once per frame which one drives the 3D engine. The engine is only
+written when the winning parameters change noticeably, the entities
+themselves don't talk to the engine.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __WEATHERARBITER_H__
+#define __WEATHERARBITER_H__
+
+#pragma once
+
+struct SRainParams
+{
+	SRainParams()
+	: vColor(1,1,1)
+	, fRadius(50.f)
+	, fAmount(1.f)
+	, fReflectionAmount(1.f)
+	, fFakeGlossiness(1.f)
+	, fPuddlesAmount(3.f)
+	, fRainDropsSpeed(1.f)
+	, fUmbrellaRadius(0.f)
+	, bRainDrops(true)
+	{
+	}
+
+	Vec3	vColor;
+	float	fRadius;
+	float	fAmount;
+	float	fReflectionAmount;
+	float	fFakeGlossiness;
+	float	fPuddlesAmount;
+	float	fRainDropsSpeed;
+	float	fUmbrellaRadius;
+	bool	bRainDrops;
+};
+
+class CWeatherArbiter
+{
+public:
+	CWeatherArbiter();
+
+	// contributions are keyed by the owning entity, setting again replaces the previous one
+	void	SetRain(EntityId entityId, const Vec3& vCenter, const SRainParams& params);
+	void	RemoveRain(EntityId entityId);
+
+	// picks the rain volume with the strongest amount at the camera and pushes it to the engine
+	void	Update();
+	void	Reset();
+
+	void	GetMemoryStatistics(ICrySizer* s) const;
+
+private:
+	struct SRainVolume
+	{
+		EntityId		entityId;
+		Vec3				vCenter;
+		SRainParams	params;
+	};
+
+	typedef std::vector<SRainVolume> TRainVolumes;
+
+	void	PushRain(const SRainVolume* pWinner, float fAmount);
+
+	TRainVolumes	m_rainVolumes;
+
+	// last values sent to the engine
+	EntityId			m_pushedRainId;
+	float					m_pushedAmount;
+	bool					m_paramsChanged;	// the pushed contribution changed since the last push
+};
+
+#endif //__WEATHERARBITER_H__
@@ -2,6 +2,8 @@
 #include "Flyer.h"
 #include "FlyerMovementController.h"
 #include "GameUtils.h"
+#include "Game.h"
+#include "IAIActor.h"
 
 
 CFlyer::CFlyer() : 
@@ -12,6 +14,13 @@ CFlyer::CFlyer() :
 }
 
 
+CFlyer::~CFlyer()
+{
+	if (g_pGame)
+		g_pGame->GetAmbientCreatureScheduler().Unregister(this);
+}
+
+
 void CFlyer::FullSerialize(TSerialize ser)
 {
 	CPlayer::FullSerialize(ser);
@@ -50,9 +59,20 @@ void CFlyer::PrePhysicsUpdate()
 		m_pMovementController->Update(frameTime, params);
 	}
 
+	// a flyer with a threatening attention target is kept at full rate
+	IAIActor* pAIActor = CastToIAIActorSafe(pEntity->GetAI());
+	m_ambientUpdate.threat = pAIActor && (pAIActor->GetAttentionTargetThreat() >= AITHREAT_THREATENING);
+
 	if (m_linkStats.CanMove() && m_linkStats.CanRotate())
 	{
-		ProcessMovement(frameTime);
+		// between two ticks of the ambient creature scheduler the movement of the last tick is replayed
+		if (m_ambientUpdate.tick)
+		{
+			ProcessMovement(m_ambientUpdate.GetTickTime(frameTime));
+			m_ambientUpdate.SetTickMovement(pEntity->GetRotation(), m_moveRequest);
+		}
+
+		m_ambientUpdate.GetFrameMovement(pEntity->GetRotation(), frameTime, m_moveRequest);
 
 		if (m_pAnimatedCharacter)
 		{
@@ -68,6 +88,8 @@ void CFlyer::Revive(bool bFromInit)
 
 	SetDesiredVelocity(Vec3Constants<float>::fVec3_Zero);
 	SetDesiredDirection(GetEntity()->GetWorldTM().GetColumn1());
+
+	g_pGame->GetAmbientCreatureScheduler().Register(this, &m_ambientUpdate);
 }
 
 
@@ -6,6 +6,7 @@
 #endif
 
 #include "Player.h"
+#include "AmbientCreatureScheduler.h"
 
 
 class CFlyer : public CPlayer
@@ -44,6 +45,7 @@ public:
 
 
 	CFlyer();
+	virtual ~CFlyer();
 
 	
 	virtual void GetMemoryUsage(ICrySizer* pCrySizer) const { pCrySizer->Add(*this); }
@@ -72,6 +74,8 @@ private:
 	Quat m_qDesiredRotation;
 
 	SCharacterMoveRequest m_moveRequest;
+
+	SAmbientCreatureUpdate m_ambientUpdate;
 };
 
 #endif	// #ifndef __FLYER_H__
@@ -77,6 +77,13 @@
 
 #include "ScriptBind_HitDeathReactions.h"
 #include "HitDeathReactionsSystem.h"
+#include "WaterQueryCache.h"
+#include "VehicleSurfaceEffectCache.h"
+#include "Environment/WeatherArbiter.h"
+#include "ActorUpdateLod.h"
+#include "AmbientCreatureScheduler.h"
+#include "GameNetProfiler.h"
+#include "ActorScriptStats.h"
 
 #define GAME_DEBUG_MEM  // debug memory usage
 #undef  GAME_DEBUG_MEM
@@ -125,7 +132,13 @@ CGame::CGame()
   m_pRayCaster(0),
 	m_pScriptBindHitDeathReactions(0),
 	m_pHitDeathReactionsSystem(NULL),
-	m_pIntersectionTester(NULL)
+	m_pIntersectionTester(NULL),
+	m_pWaterQueryCache(NULL),
+	m_pVehicleSurfaceEffectCache(NULL),
+	m_pWeatherArbiter(NULL),
+	m_pActorUpdateLodManager(NULL),
+	m_pAmbientCreatureScheduler(NULL),
+	m_pNetProfiler(NULL)
 {
 	m_pCVars = new SCVars();
 	g_pGameCVars = m_pCVars;
@@ -175,6 +188,14 @@ CGame::~CGame()
 	SAFE_DELETE(m_pGameActions);
 	SAFE_DELETE(m_pHitDeathReactionsSystem);
 	SAFE_DELETE(m_pIntersectionTester);
+	SAFE_DELETE(m_pWaterQueryCache);
+	SAFE_DELETE(m_pVehicleSurfaceEffectCache);
+	SAFE_DELETE(m_pWeatherArbiter);
+	SAFE_DELETE(m_pActorUpdateLodManager);
+	SAFE_DELETE(m_pAmbientCreatureScheduler);
+#if GAME_NET_PROFILER_ENABLED
+	SAFE_DELETE(m_pNetProfiler);
+#endif
 	gEnv->pGame = 0;
 }
 
@@ -487,6 +508,15 @@ bool CGame::Init(IGameFramework *pFramework)
 	m_pIntersectionTester = new GlobalIntersectionTester;
 	m_pIntersectionTester->SetQuota(6);
 
+	m_pWaterQueryCache = new CWaterQueryCache;
+	m_pVehicleSurfaceEffectCache = new CVehicleSurfaceEffectCache;
+	m_pWeatherArbiter = new CWeatherArbiter;
+	m_pActorUpdateLodManager = new CActorUpdateLodManager;
+	m_pAmbientCreatureScheduler = new CAmbientCreatureScheduler;
+#if GAME_NET_PROFILER_ENABLED
+	m_pNetProfiler = new CGameNetProfiler;
+#endif
+
 	if (m_pServerSynchedStorage == NULL)
 		m_pServerSynchedStorage = new CServerSynchedStorage(GetIGameFramework());
 
@@ -562,6 +592,9 @@ extern Vec3 g_vel;
 
 int CGame::Update(bool haveFocus, unsigned int updateFlags)
 {
+	// game objects query water during the framework update, start a fresh cache frame before it
+	m_pWaterQueryCache->Update();
+
 	bool bRun = m_pFramework->PreUpdate( true, updateFlags );
 
 	float frameTime = gEnv->pTimer->GetFrameTime();
@@ -580,6 +613,15 @@ int CGame::Update(bool haveFocus, unsigned int updateFlags)
 			m_pIntersectionTester->Update(frameTime);
 	}
 
+	m_pActorUpdateLodManager->Update(frameTime);
+	m_pAmbientCreatureScheduler->Update(frameTime);
+	m_pWeatherArbiter->Update();
+#if GAME_NET_PROFILER_ENABLED
+	m_pNetProfiler->Update(gEnv->pTimer->GetRealFrameTime());
+#endif
+	m_pHitDeathReactionsSystem->Update(frameTime);
+	CActorScriptStats::UpdateAccessTracking();
+
 	if (m_pFramework->IsGamePaused() == false)
 	{
 		m_pWeaponSystem->Update(frameTime);
@@ -592,6 +634,11 @@ int CGame::Update(bool haveFocus, unsigned int updateFlags)
 
 	m_pGameMechanismManager->Update(frameTime);
 
+	if (m_pServerSynchedStorage && gEnv->bServer)
+		m_pServerSynchedStorage->Update();
+	if (m_pServerGameTokenSynch && gEnv->bServer)
+		m_pServerGameTokenSynch->Update();
+
 
 
 
@@ -1069,6 +1116,7 @@ void CGame::GetMemoryStatistics(ICrySizer * s) const
 
 	m_pItemSharedParamsList->GetMemoryUsage(s);
 	m_pWeaponSharedParamsList->GetMemoryUsage(s);
+	CPostEffectParams::GetMemoryUsage(s);
 
 	if (m_pPlayerProfileManager)
 	  m_pPlayerProfileManager->GetMemoryUsage(s);
@@ -1087,6 +1135,18 @@ void CGame::GetMemoryStatistics(ICrySizer * s) const
 
 	if (m_pHitDeathReactionsSystem)
 			m_pHitDeathReactionsSystem->GetMemoryUsage(s);
+
+	if (m_pVehicleSurfaceEffectCache)
+		m_pVehicleSurfaceEffectCache->GetMemoryStatistics(s);
+	if (m_pWeatherArbiter)
+		m_pWeatherArbiter->GetMemoryStatistics(s);
+	if (m_pAmbientCreatureScheduler)
+		m_pAmbientCreatureScheduler->GetMemoryStatistics(s);
+
+#if GAME_NET_PROFILER_ENABLED
+	if (m_pNetProfiler)
+		m_pNetProfiler->GetMemoryStatistics(s);
+#endif
 }
 
 void CGame::OnClearPlayerIds()
@@ -1338,6 +1398,13 @@ void CGame::OnSystemEvent( ESystemEvent event, UINT_PTR wparam, UINT_PTR lparam
 						SAFE_DELETE(m_pRayCaster);
 						SAFE_DELETE(m_pIntersectionTester);
 
+						m_pWaterQueryCache->Reset();
+						m_pVehicleSurfaceEffectCache->Reset();
+						m_pWeatherArbiter->Reset();
+						m_pActorUpdateLodManager->Reset();
+						m_pAmbientCreatureScheduler->Reset();
+						m_colorGradientManager->Reset();
+
 						m_pHitDeathReactionsSystem->Reset();
 				}
 				break;
@@ -80,6 +80,12 @@ class CBitmapUi;
 //HIT DEATH REACTIONSYSTEM
 class CScriptBind_HitDeathReactions;
 class CHitDeathReactionsSystem;
+class CWaterQueryCache;
+class CVehicleSurfaceEffectCache;
+class CWeatherArbiter;
+class CActorUpdateLodManager;
+class CAmbientCreatureScheduler;
+class CGameNetProfiler;
 //~HIT DEATH REACTIONSYSTEM
 
 #if !defined(FINAL_RELEASE)
@@ -220,6 +226,11 @@ public:
 	CCameraManager *GetCameraManager();
   ILINE GlobalRayCaster& GetRayCaster() { assert(m_pRayCaster); return *m_pRayCaster; }
 	GlobalIntersectionTester& GetIntersectionTester() { assert(m_pIntersectionTester); return *m_pIntersectionTester; }
+	ILINE CWaterQueryCache& GetWaterQueryCache() { assert(m_pWaterQueryCache); return *m_pWaterQueryCache; }
+	ILINE CVehicleSurfaceEffectCache& GetVehicleSurfaceEffectCache() { assert(m_pVehicleSurfaceEffectCache); return *m_pVehicleSurfaceEffectCache; }
+	ILINE CWeatherArbiter& GetWeatherArbiter() { assert(m_pWeatherArbiter); return *m_pWeatherArbiter; }
+	ILINE CActorUpdateLodManager& GetActorUpdateLodManager() { assert(m_pActorUpdateLodManager); return *m_pActorUpdateLodManager; }
+	ILINE CAmbientCreatureScheduler& GetAmbientCreatureScheduler() { assert(m_pAmbientCreatureScheduler); return *m_pAmbientCreatureScheduler; }
 
 	ILINE CSynchedStorage *GetSynchedStorage() const
 	{
@@ -300,6 +311,8 @@ protected:
   static void CmdVote(IConsoleCmdArgs* pArgs);
 	static void CmdReloadHitDeathReactions(IConsoleCmdArgs* pArgs);
 	static void CmdDumpHitDeathReactionsAssetUsage(IConsoleCmdArgs* pArgs);
+	static void CmdNetProfileDump(IConsoleCmdArgs* pArgs);
+	static void CmdNetProfileReset(IConsoleCmdArgs* pArgs);
 
   static void CmdQuickGame(IConsoleCmdArgs* pArgs);
   static void CmdQuickGameStop(IConsoleCmdArgs* pArgs);
@@ -366,6 +379,12 @@ protected:
 
   GlobalRayCaster* m_pRayCaster;
 	GlobalIntersectionTester* m_pIntersectionTester;
+	CWaterQueryCache* m_pWaterQueryCache;
+	CVehicleSurfaceEffectCache* m_pVehicleSurfaceEffectCache;
+	CWeatherArbiter* m_pWeatherArbiter;
+	CActorUpdateLodManager* m_pActorUpdateLodManager;
+	CAmbientCreatureScheduler* m_pAmbientCreatureScheduler;
+	CGameNetProfiler* m_pNetProfiler;
 
   CBulletTime						*m_pBulletTime;
 	typedef std::map<string, string, stl::less_stricmp<string> > TLevelMapMap;
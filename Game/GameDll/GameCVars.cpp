@@ -35,6 +35,7 @@
 
 #include "HitDeathReactions.h"
 #include "HitDeathReactionsSystem.h"
+#include "GameNetProfiler.h"
 
 static void BroadcastChangeSafeMode( ICVar * )
 {
@@ -268,6 +269,9 @@ void SCVars::InitCVars(IConsole *pConsole)
 	REGISTER_CVAR(cl_cam_orbit_offsetZ, 1.f, VF_DUMPTODISK,"Z Offset of orbit camera.");
 	REGISTER_CVAR(cl_cam_orbit_distance, 5.f, VF_DUMPTODISK,"Distance of orbit camera.");
 	REGISTER_CVAR(cl_cam_debug, 0, VF_DUMPTODISK,"Camera system debug output.");
+	REGISTER_CVAR(cl_cam_rayScanMode, 1, VF_DUMPTODISK,"Camera collision query.\n"
+		"0: seven queued rays\n"
+		"1: one swept sphere through the intersection tester, side rays only for the camera tracking");
 
 	pConsole->Register("cl_enable_tree_transparency", &cl_enable_tree_transparency, 1, VF_DUMPTODISK, "Switches tree transparency on/off.");
 	pConsole->Register("cl_fake_first_person",&cl_fake_first_person,0,VF_DUMPTODISK,"Enable fake first person view in new new camera control system (cl_cam_orbit 1).");
@@ -532,6 +536,8 @@ void SCVars::InitCVars(IConsole *pConsole)
 
 	REGISTER_CVAR(pl_netAimLerpFactor, 0.5f, 0, "Factor to lerp the remote aim directions by");
 	REGISTER_CVAR(pl_netSerialiseMaxSpeed, 4.0f, 0, "Maximum char speed, used by interpolation");
+	REGISTER_CVAR(pl_netJitterBuffer, 0, 0, "Buffers the remote player positions and plays them back delayed by the measured network jitter, extrapolated with a cubic hermite past the last one (experimental)");
+	REGISTER_CVAR(pl_netJitterBufferMaxDelay, 0.2f, 0, "Maximum delay in seconds the remote player positions are played back with to absorb network jitter");
 	REGISTER_CVAR(pl_playerErrorSnapDistSquare, 5.0f, 0, "Maximum distance between local and remote player pos to perform error snapping");
 	
 	// ~PLAYERPREDICTION
@@ -585,6 +591,8 @@ void SCVars::InitCVars(IConsole *pConsole)
 
   REGISTER_CVAR(v_profileMovement, 0, VF_NULL, "Used to enable profiling of the current vehicle movement (1 to enable)");    
   REGISTER_CVAR(v_pa_surface, 1, VF_CHEAT, "Enables/disables vehicle surface particles");
+  REGISTER_CVAR(v_pa_surface_lodDist, 100.f, VF_CHEAT, "Distance beyond which vehicle surface particles use the reduced LOD");
+  REGISTER_CVAR(v_pa_surface_lodCountScale, 0.5f, VF_CHEAT, "Particle count scale of the reduced vehicle surface particle LOD");
   REGISTER_CVAR(v_wind_minspeed, 0.f, VF_CHEAT, "If non-zero, vehicle wind areas always set wind >= specified value");
   REGISTER_CVAR(v_draw_suspension, 0, VF_DUMPTODISK, "Enables/disables display of wheel suspension, for the vehicle that has v_profileMovement enabled");
   REGISTER_CVAR(v_draw_slip, 0, VF_DUMPTODISK, "Draw wheel slip status");  
@@ -696,6 +704,7 @@ void SCVars::InitCVars(IConsole *pConsole)
 	REGISTER_CVAR(g_battleDust_enable, 1, VF_NULL, "Enable/Disable battledust");
 	REGISTER_CVAR(g_battleDust_debug, 0, VF_NULL, "0: off, 1: text, 2: text+gfx");
 	g_battleDust_effect = REGISTER_STRING("g_battleDust_effect", "misc.battledust.light", VF_NULL, "Sets the effect to use for battledust");
+	REGISTER_CVAR(g_battleDust_maxEmitters, 8, VF_NULL, "Number of pooled battledust emitters, only the densest areas get one");
 	
 	REGISTER_CVAR(g_proneNotUsableWeapon_FixType, 1, VF_NULL, "Test various fixes for not selecting hurricane while prone");
 	REGISTER_CVAR(g_proneAimAngleRestrict_Enable, 1, VF_NULL, "Test fix for matching aim restrictions between 1st and 3rd person");
@@ -756,9 +765,44 @@ void SCVars::InitCVars(IConsole *pConsole)
 	REGISTER_CVAR(g_hitDeathReactions_debug, 0, 0, "Enables/Disables debug information for hit and death reactions system");
 	REGISTER_CVAR(g_hitDeathReactions_disableRagdoll, 0, 0, "Disables switching to ragdoll at the end of animations");
 	REGISTER_CVAR(g_hitDeathReactions_logReactionAnimsOnLoading, eHDRLRAT_DontLog, 0, "Non-Release only CVar: Enables logging of animations used by non-animation graph-based reactions. 0: don't log, 1: log anim names, 2: log filepaths");
-	REGISTER_CVAR(g_hitDeathReactions_streaming, gEnv->bMultiplayer ? eHDRSP_EntityLifespanBased : eHDRSP_ActorsAliveAndNotInPool, 0, "Enables/Disables reactionAnims streaming. 0: Disabled, 1: DBA Registering-based, 2: Entity lifespan-based");
+	REGISTER_CVAR(g_hitDeathReactions_streaming, gEnv->bMultiplayer ? eHDRSP_EntityLifespanBased : eHDRSP_ActorsAliveAndNotInPool, 0, "Enables/Disables reactionAnims streaming. 0: Disabled, 1: DBA Registering-based, 2: Entity lifespan-based, 3: Predictive (combat range/aimed at)");
+	REGISTER_CVAR(g_hitDeathReactions_prefetchDistance, 40.0f, 0, "Predictive reactionAnims streaming: actors closer than this to the local player get their reaction anims requested");
+	REGISTER_CVAR(g_hitDeathReactions_prefetchMemoryBudget, 16384, 0, "Predictive reactionAnims streaming: maximum size in KB of the requested reaction anims, the least relevant profiles are evicted first");
+	REGISTER_CVAR(g_hitDeathReactions_useDecisionIndex, 1, 0, "Uses the index compiled at load to discard reactions that can't be valid for a hit before validating them");
+	REGISTER_CVAR(g_hitDeathReactions_binaryCache, 1, 0, "Reads the reaction params of every data file from a binary cache in the user folder, rebuilt whenever the data file changes");
 	REGISTER_CVAR(g_animatorDebug, false, 0, "Animator Debug Info");
 
+	REGISTER_CVAR(g_waterQueryCache_cellSize, 0.5f, 0, "Grid cell size used to share water level/bottom queries between actors within a frame. 0 disables the cache");
+	REGISTER_CVAR(g_waterQueryCache_debug, 0, 0, "Shows water query cache hits and engine queries per frame");
+
+	REGISTER_CVAR(g_actorUpdateLod_enable, 0, 0, "Enables distance/visibility based update LOD for actors other than the local client (experimental)");
+	REGISTER_CVAR(g_actorUpdateLod_debug, 0, 0, "Shows how many actors are on each update LOD");
+	REGISTER_CVAR(g_actorUpdateLod_maxFull, 16, 0, "Maximum number of actors updated at full rate, the rest drop to reduced");
+	REGISTER_CVAR(g_actorUpdateLod_maxReduced, 32, 0, "Maximum number of actors on reduced update LOD, the rest drop to minimal");
+	REGISTER_CVAR(g_actorUpdateLod_reducedInterval, 3, 0, "Actors on reduced update LOD run their detailed update every N frames");
+	REGISTER_CVAR(g_actorUpdateLod_reducedDistance, 30.0f, 0, "Distance from the view beyond which actors use reduced update LOD");
+	REGISTER_CVAR(g_actorUpdateLod_minimalDistance, 80.0f, 0, "Distance from the view beyond which actors not in combat use minimal update LOD");
+	REGISTER_CVAR(g_actorUpdateLod_minScreenSize, 0.02f, 0, "Projected size (fraction of the screen height) below which actors not in combat use minimal update LOD");
+
+	REGISTER_CVAR(g_actorScriptStats_mask, -1, 0, "Bit mask of the actorStats script fields that are kept up to date, see EActorScriptStat");
+	REGISTER_CVAR(g_actorScriptStats_track, 0, 0, "1: records which actorStats fields scripts read; setting it back to 0 applies the result to g_actorScriptStats_mask");
+
+	REGISTER_CVAR(g_netProfile, 0, 0, "Counts the estimated bits serialized per entity class, aspect and field, and the RMIs handled per type. Shown in the Game PerfHUD menu, g_netProfileDump writes them to a CSV file");
+	REGISTER_CVAR(g_netProfileMaxRows, 24, 0, "Maximum number of aspects and of RMIs listed in the net profile PerfHUD table");
+
+	REGISTER_CVAR(hud_dynTexTag_maxDistance, 300.f, VF_NULL, "Entity tags with dynamic UI textures are hidden beyond this distance to the camera (0 = no limit)");
+
+	REGISTER_CVAR(g_colorGradientCacheSize, 4, VF_NULL, "Number of unused color charts kept loaded, switching back to a recently used one doesn't reload it.");
+
+	REGISTER_CVAR(g_weatherArbiter_threshold, 0.01f, VF_NULL, "Smallest rain amount change that is sent to the 3D engine");
+
+	REGISTER_CVAR(g_ambientCreatures_enable, 1, 0, "Enables distance/visibility based update intervals for ambient creatures (sharks, flyers)");
+	REGISTER_CVAR(g_ambientCreatures_debug, 0, 0, "Shows how many ambient creatures are registered and ticking");
+	REGISTER_CVAR(g_ambientCreatures_nearDistance, 30.0f, 0, "Distance from the view within which visible ambient creatures update every frame");
+	REGISTER_CVAR(g_ambientCreatures_farDistance, 120.0f, 0, "Distance from the view at which ambient creatures reach the maximum update interval");
+	REGISTER_CVAR(g_ambientCreatures_minInterval, 0.1f, 0, "Update interval in seconds of ambient creatures just beyond the near distance");
+	REGISTER_CVAR(g_ambientCreatures_maxInterval, 0.5f, 0, "Update interval in seconds of ambient creatures beyond the far distance or out of sight");
+
   NetInputChainInitCVars();
 
 	InitAIPerceptionCVars(pConsole);
@@ -825,6 +869,7 @@ void SCVars::ReleaseCVars()
 	pConsole->UnregisterVariable("cl_cam_orbit_distance", true);
 
 	pConsole->UnregisterVariable("cl_cam_debug", true);
+	pConsole->UnregisterVariable("cl_cam_rayScanMode", true);
 
 	pConsole->UnregisterVariable("pl_inputAccel", true);
 
@@ -900,6 +945,8 @@ void SCVars::ReleaseCVars()
 	
 	pConsole->UnregisterVariable("v_profileMovement", true);    
 	pConsole->UnregisterVariable("v_pa_surface", true);
+	pConsole->UnregisterVariable("v_pa_surface_lodDist", true);
+	pConsole->UnregisterVariable("v_pa_surface_lodCountScale", true);
 	pConsole->UnregisterVariable("v_wind_minspeed", true);
 	pConsole->UnregisterVariable("v_draw_suspension", true);
 	pConsole->UnregisterVariable("v_draw_slip", true);  
@@ -1004,6 +1051,7 @@ void SCVars::ReleaseCVars()
   pConsole->UnregisterVariable("g_battleDust_enable", true);
   pConsole->UnregisterVariable("g_battleDust_debug", true);
 	pConsole->UnregisterVariable("g_battleDust_effect", true);
+	pConsole->UnregisterVariable("g_battleDust_maxEmitters", true);
 
   pConsole->UnregisterVariable("g_proneNotUsableWeapon_FixType", true);
 	pConsole->UnregisterVariable("g_proneAimAngleRestrict_Enable", true);
@@ -1062,9 +1110,44 @@ void SCVars::ReleaseCVars()
 	pConsole->UnregisterVariable("g_hitDeathReactions_disable_ai", true);
 	pConsole->UnregisterVariable("g_hitDeathReactions_debug", true);
 	pConsole->UnregisterVariable("g_hitDeathReactions_disableRagdoll", true);
+	pConsole->UnregisterVariable("g_hitDeathReactions_useDecisionIndex", true);
+	pConsole->UnregisterVariable("g_hitDeathReactions_binaryCache", true);
+	pConsole->UnregisterVariable("g_hitDeathReactions_prefetchDistance", true);
+	pConsole->UnregisterVariable("g_hitDeathReactions_prefetchMemoryBudget", true);
 	pConsole->UnregisterVariable("g_hitDeathReactions_disableHitAnimatedCollisions", true);
 	pConsole->UnregisterVariable("g_animatorDebug", true);
 
+	pConsole->UnregisterVariable("g_waterQueryCache_cellSize", true);
+	pConsole->UnregisterVariable("g_waterQueryCache_debug", true);
+
+	pConsole->UnregisterVariable("g_actorUpdateLod_enable", true);
+	pConsole->UnregisterVariable("g_actorUpdateLod_debug", true);
+	pConsole->UnregisterVariable("g_actorUpdateLod_maxFull", true);
+	pConsole->UnregisterVariable("g_actorUpdateLod_maxReduced", true);
+	pConsole->UnregisterVariable("g_actorUpdateLod_reducedInterval", true);
+	pConsole->UnregisterVariable("g_actorUpdateLod_reducedDistance", true);
+	pConsole->UnregisterVariable("g_actorUpdateLod_minimalDistance", true);
+	pConsole->UnregisterVariable("g_actorUpdateLod_minScreenSize", true);
+
+	pConsole->UnregisterVariable("g_actorScriptStats_mask", true);
+	pConsole->UnregisterVariable("g_actorScriptStats_track", true);
+
+	pConsole->UnregisterVariable("g_netProfile", true);
+	pConsole->UnregisterVariable("g_netProfileMaxRows", true);
+
+	pConsole->UnregisterVariable("hud_dynTexTag_maxDistance", true);
+
+	pConsole->UnregisterVariable("g_colorGradientCacheSize", true);
+
+	pConsole->UnregisterVariable("g_weatherArbiter_threshold", true);
+
+	pConsole->UnregisterVariable("g_ambientCreatures_enable", true);
+	pConsole->UnregisterVariable("g_ambientCreatures_debug", true);
+	pConsole->UnregisterVariable("g_ambientCreatures_nearDistance", true);
+	pConsole->UnregisterVariable("g_ambientCreatures_farDistance", true);
+	pConsole->UnregisterVariable("g_ambientCreatures_minInterval", true);
+	pConsole->UnregisterVariable("g_ambientCreatures_maxInterval", true);
+
 	ReleaseAIPerceptionCVars(pConsole);
 }
 
@@ -1350,6 +1433,11 @@ void CGame::RegisterConsoleCommands()
 
 	REGISTER_COMMAND("g_hitDeathReactions_reload", CmdReloadHitDeathReactions, VF_CHEAT, "Reloads hitDeathReactions for the specified actor, or for everyone if not specified");
 	REGISTER_COMMAND("g_hitDeathReactions_dumpAssetUsage", CmdDumpHitDeathReactionsAssetUsage, VF_CHEAT, "Dumps information about asset usage in the system, streaming, and so.");
+
+#if GAME_NET_PROFILER_ENABLED
+	REGISTER_COMMAND("g_netProfileDump", CmdNetProfileDump, VF_NULL, "Writes the game net profile counters to a CSV file (default %USER%/NetProfile.csv)");
+	REGISTER_COMMAND("g_netProfileReset", CmdNetProfileReset, VF_NULL, "Clears the game net profile counters");
+#endif
 }
 
 //------------------------------------------------------------------------
@@ -1398,6 +1486,11 @@ void CGame::UnregisterConsoleCommands()
 
 	m_pConsole->RemoveCommand("g_hitDeathReactions_reload");
 	m_pConsole->RemoveCommand("g_hitDeathReactions_dumpAssetUsage");
+
+#if GAME_NET_PROFILER_ENABLED
+	m_pConsole->RemoveCommand("g_netProfileDump");
+	m_pConsole->RemoveCommand("g_netProfileReset");
+#endif
 }
 
 //------------------------------------------------------------------------
@@ -2063,3 +2156,21 @@ void CGame::CmdDumpHitDeathReactionsAssetUsage(IConsoleCmdArgs* pArgs)
 {
 		g_pGame->GetHitDeathReactionsSystem().DumpHitDeathReactionsAssetUsage();
 }
+
+//------------------------------------------------------------------------
+void CGame::CmdNetProfileDump(IConsoleCmdArgs* pArgs)
+{
+#if GAME_NET_PROFILER_ENABLED
+	if (g_pGame->m_pNetProfiler)
+		g_pGame->m_pNetProfiler->Dump((pArgs->GetArgCount() > 1) ? pArgs->GetArg(1) : "%USER%/NetProfile.csv");
+#endif
+}
+
+//------------------------------------------------------------------------
+void CGame::CmdNetProfileReset(IConsoleCmdArgs* pArgs)
+{
+#if GAME_NET_PROFILER_ENABLED
+	if (g_pGame->m_pNetProfiler)
+		g_pGame->m_pNetProfiler->Reset();
+#endif
+}
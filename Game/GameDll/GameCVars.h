@@ -65,6 +65,7 @@ struct SCVars
 	float cl_cam_orbit_distance;
 
 	int		cl_cam_debug;
+	int		cl_cam_rayScanMode;
 
 	int		cl_enable_tree_transparency;
 	int		cl_fake_first_person;
@@ -344,6 +345,8 @@ struct SCVars
 
 	float pl_netAimLerpFactor;
 	float pl_netSerialiseMaxSpeed;
+	int pl_netJitterBuffer;
+	float pl_netJitterBufferMaxDelay;
 
 	int pl_serialisePhysVel;
 	float pl_clientInertia;
@@ -367,6 +370,8 @@ struct SCVars
 	int   v_draw_suspension;
 	int   v_draw_slip;
 	int   v_pa_surface;    
+	float v_pa_surface_lodDist;
+	float v_pa_surface_lodCountScale;
 	int   v_invertPitchControl;  
 	float v_wind_minspeed; 
 	float v_sprintSpeed;
@@ -493,6 +498,7 @@ struct SCVars
   int			g_battleDust_enable;
 	int			g_battleDust_debug;
 	ICVar*  g_battleDust_effect;
+	int			g_battleDust_maxEmitters;
 
 	int			g_proneNotUsableWeapon_FixType;
 	int			g_proneAimAngleRestrict_Enable;
@@ -560,10 +566,51 @@ struct SCVars
 			eHDRSP_Disabled = 0,
 			eHDRSP_ActorsAliveAndNotInPool,		// the assets are locked if at least one of the actors using the profile is alive and not in the pool
 			eHDRSP_EntityLifespanBased,				// the assets are requested/released whenever the entities using them are spawned/removed
+			eHDRSP_Predictive,								// the assets are requested while an actor using them is in combat range or aimed at, within a memory budget
 	};
 	int			g_hitDeathReactions_streaming;
+	float		g_hitDeathReactions_prefetchDistance;
+	int			g_hitDeathReactions_prefetchMemoryBudget;
+	int			g_hitDeathReactions_useDecisionIndex;
+	int			g_hitDeathReactions_binaryCache;
 	// ~Hit Death Reactions CVars
 
+	// water query cache
+	float		g_waterQueryCache_cellSize;
+	int			g_waterQueryCache_debug;
+
+	// actor update LOD
+	int			g_actorUpdateLod_enable;
+	int			g_actorUpdateLod_debug;
+	int			g_actorUpdateLod_maxFull;
+	int			g_actorUpdateLod_maxReduced;
+	int			g_actorUpdateLod_reducedInterval;
+	float		g_actorUpdateLod_reducedDistance;
+	float		g_actorUpdateLod_minimalDistance;
+	float		g_actorUpdateLod_minScreenSize;
+
+	// actor script stats
+	int			g_actorScriptStats_mask;
+	int			g_actorScriptStats_track;
+
+	// game net profiler
+	int			g_netProfile;
+	int			g_netProfileMaxRows;
+
+	float hud_dynTexTag_maxDistance;
+
+	int		g_colorGradientCacheSize;
+
+	float g_weatherArbiter_threshold;
+
+	// ambient creature scheduling
+	int			g_ambientCreatures_enable;
+	int			g_ambientCreatures_debug;
+	float		g_ambientCreatures_nearDistance;
+	float		g_ambientCreatures_farDistance;
+	float		g_ambientCreatures_minInterval;
+	float		g_ambientCreatures_maxInterval;
+
 	SCVars()
 	{
 		memset(this,0,sizeof(SCVars));
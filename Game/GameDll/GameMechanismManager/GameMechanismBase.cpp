@@ -5,6 +5,9 @@
 CGameMechanismBase::CGameMechanismBase(const char * className)
 {
 	memset (& m_linkedListPointers, 0, sizeof(m_linkedListPointers));
+	memset (& m_updateSchedule, 0, sizeof(m_updateSchedule));
+	m_updateSchedule.m_policy = kGMUpdatePolicy_EveryFrame;
+	m_updateSchedule.m_lastUpdateFrame = -1;
 	m_className = className;
 	CGameMechanismManager * manager = CGameMechanismManager::GetInstance();
 	manager->RegisterMechanism(this);
@@ -15,3 +18,11 @@ CGameMechanismBase::~CGameMechanismBase()
 	CGameMechanismManager * manager = CGameMechanismManager::GetInstance();
 	manager->UnregisterMechanism(this);
 }
+
+void CGameMechanismBase::SetUpdatePolicy(EGameMechanismUpdatePolicy policy, float rateHz)
+{
+	assert (policy != kGMUpdatePolicy_FixedRate || rateHz > 0.f);
+
+	m_updateSchedule.m_policy = policy;
+	m_updateSchedule.m_interval = (rateHz > 0.f) ? (1.f / rateHz) : 0.f;
+}
@@ -9,6 +9,16 @@
 // impossible (or trickier at least) to accidentally register your game mechanism instance with the wrong name. [TF]
 #define REGISTER_GAME_MECHANISM(classType) CGameMechanismBase((this == (classType *) NULL) ? NULL : (# classType))
 
+// How the manager schedules a mechanism's Update. Every frame and fixed rate mechanisms always run when due, background
+// mechanisms only get the part of the frame budget (g_mechanismMgrBudget) that's left, longest waiting first.
+enum EGameMechanismUpdatePolicy
+{
+	kGMUpdatePolicy_EveryFrame,
+	kGMUpdatePolicy_FixedRate,      // dt passed to Update is the time since the previous update
+	kGMUpdatePolicy_Background,     // dt passed to Update is the time since the previous update
+	kGMUpdatePolicy_Idle,           // not updated at all until the policy changes
+};
+
 class CGameMechanismBase
 {
 	public:
@@ -18,6 +28,21 @@ class CGameMechanismBase
 		CGameMechanismBase * m_prevMechanism;
 	};
 
+	struct SUpdateSchedule
+	{
+		EGameMechanismUpdatePolicy m_policy;
+		float m_interval;               // fixed rate only
+		float m_timeSinceUpdate;
+		int m_lastUpdateFrame;
+
+		// timing stats, reported by the g_mechanismMgrStats command
+		float m_lastCostMs;
+		float m_avgCostMs;
+		float m_peakCostMs;
+		uint32 m_numUpdates;
+		uint32 m_numDeferred;           // frames a due background update didn't fit into the budget
+	};
+
 	CGameMechanismBase(const char * className);
 	virtual ~CGameMechanismBase();
 	virtual void Update(float dt) = 0;
@@ -28,6 +53,14 @@ class CGameMechanismBase
 		return & m_linkedListPointers;
 	}
 
+	ILINE SUpdateSchedule * GetUpdateSchedule()
+	{
+		return & m_updateSchedule;
+	}
+
+	// rateHz is only used by kGMUpdatePolicy_FixedRate
+	void SetUpdatePolicy(EGameMechanismUpdatePolicy policy, float rateHz = 0.f);
+
 	ILINE const char * GetName()
 	{
 		return m_className;
@@ -35,6 +68,7 @@ class CGameMechanismBase
 
 	private:
 	SLinkedListPointers m_linkedListPointers;
+	SUpdateSchedule m_updateSchedule;
 	const char * m_className;
 };
 
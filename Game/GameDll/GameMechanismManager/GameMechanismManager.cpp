@@ -46,19 +46,32 @@ class CGameMechanismIterator
 
 CGameMechanismIterator * CGameMechanismIterator::s_firstIterator = NULL;
 
+#if !defined(_RELEASE)
+static void CmdMechanismManagerStats(IConsoleCmdArgs * pArgs)
+{
+	CGameMechanismManager::GetInstance()->LogStats();
+}
+#endif
+
 CGameMechanismManager::CGameMechanismManager()
 {
 	m_firstMechanism = NULL;
+	m_updatingMechanism = NULL;
+	m_frameCounter = 0;
+	m_cvarBudgetMs = 1.f;
+
+	IConsole * console = GetISystem()->GetIConsole();
+	assert (console);
+
+	console->Register("g_mechanismMgrBudget", & m_cvarBudgetMs, m_cvarBudgetMs, 0, "MECHANISM MANAGER: Milliseconds per frame shared by background mechanisms (at least one is updated every frame)");
 
 #if !defined(_RELEASE)
 	m_cvarWatchEnabled = false;
 	m_cvarLogEnabled = false;
 
-	IConsole * console = GetISystem()->GetIConsole();
-	assert (console);
-
 	console->Register("g_mechanismMgrWatch", & m_cvarWatchEnabled, m_cvarWatchEnabled, 0, "MECHANISM MANAGER: On-screen watches enabled");
 	console->Register("g_mechanismMgrLog", & m_cvarLogEnabled, m_cvarLogEnabled, 0, "MECHANISM MANAGER: Log messages enabled");
+	console->AddCommand("g_mechanismMgrStats", CmdMechanismManagerStats, 0, "MECHANISM MANAGER: Logs the update policy and update costs of every mechanism");
 #endif
 
 	MechanismManagerLog ("Manager created");
@@ -78,12 +91,15 @@ CGameMechanismManager::~CGameMechanismManager()
 
 	MechanismManagerLog ("No game mechanisms remaining; game mechanism manager destroyed");
 
-#if !defined(_RELEASE)
 	IConsole * console = GetISystem()->GetIConsole();
 	assert (console);
 
+	console->UnregisterVariable("g_mechanismMgrBudget", true);
+
+#if !defined(_RELEASE)
 	console->UnregisterVariable("g_mechanismMgrWatch", true);
 	console->UnregisterVariable("g_mechanismMgrLog", true);
+	console->RemoveCommand("g_mechanismMgrStats");
 #endif
 
 	assert (s_instance == this);
@@ -110,6 +126,11 @@ void CGameMechanismManager::UnregisterMechanism(CGameMechanismBase * removeThis)
 {
 	assert (removeThis);
 
+	if (m_updatingMechanism == removeThis)
+	{
+		m_updatingMechanism = NULL;
+	}
+
 	for (CGameMechanismIterator * eachIterator = CGameMechanismIterator::s_firstIterator; eachIterator; eachIterator = eachIterator->m_nextIterator)
 	{
 		if (eachIterator->m_nextMechanism == removeThis)
@@ -142,14 +163,131 @@ void CGameMechanismManager::UnregisterMechanism(CGameMechanismBase * removeThis)
 	}
 }
 
+float CGameMechanismManager::UpdateMechanism(CGameMechanismBase * mechanism)
+{
+	CGameMechanismBase::SUpdateSchedule * schedule = mechanism->GetUpdateSchedule();
+	const float dt = schedule->m_timeSinceUpdate;
+
+	schedule->m_timeSinceUpdate = 0.f;
+	schedule->m_lastUpdateFrame = m_frameCounter;
+
+	MechanismManagerWatch ("Updating %s", mechanism->GetName());
+
+	m_updatingMechanism = mechanism;
+	const CTimeValue startTime = gEnv->pTimer->GetAsyncTime();
+	mechanism->Update(dt);
+	const float costMs = (gEnv->pTimer->GetAsyncTime() - startTime).GetMilliSeconds();
+
+	// A mechanism may delete itself from its own Update; its schedule is gone with it then
+	if (m_updatingMechanism)
+	{
+		schedule->m_lastCostMs = costMs;
+		schedule->m_avgCostMs = schedule->m_numUpdates ? (schedule->m_avgCostMs + (costMs - schedule->m_avgCostMs) * 0.1f) : costMs;
+		schedule->m_peakCostMs = max(schedule->m_peakCostMs, costMs);
+		++ schedule->m_numUpdates;
+		m_updatingMechanism = NULL;
+	}
+
+	return costMs;
+}
+
 void CGameMechanismManager::Update(float dt)
 {
+	++ m_frameCounter;
+
+	float budgetLeftMs = m_cvarBudgetMs;
+
+	// Every frame and fixed rate mechanisms run whenever they're due, whatever it costs
+	{
+		CGameMechanismIterator iter(m_firstMechanism);
+
+		while (CGameMechanismBase * eachMechanism = iter.GetNext())
+		{
+			CGameMechanismBase::SUpdateSchedule * schedule = eachMechanism->GetUpdateSchedule();
+
+			if (schedule->m_policy == kGMUpdatePolicy_Idle)
+			{
+				schedule->m_timeSinceUpdate = 0.f;
+				continue;
+			}
+
+			schedule->m_timeSinceUpdate += dt;
+
+			if (schedule->m_policy == kGMUpdatePolicy_EveryFrame || (schedule->m_policy == kGMUpdatePolicy_FixedRate && schedule->m_timeSinceUpdate >= schedule->m_interval))
+			{
+				budgetLeftMs -= UpdateMechanism(eachMechanism);
+			}
+		}
+	}
+
+	// Background mechanisms share what's left, longest waiting first. The longest waiting one is always updated so
+	// none of them starves when the due updates alone blow the budget
+	int numBackgroundUpdates = 0;
+
+	do
+	{
+		CGameMechanismBase * longestWaiting = NULL;
+		CGameMechanismIterator iter(m_firstMechanism);
+
+		while (CGameMechanismBase * eachMechanism = iter.GetNext())
+		{
+			CGameMechanismBase::SUpdateSchedule * schedule = eachMechanism->GetUpdateSchedule();
+
+			if (schedule->m_policy == kGMUpdatePolicy_Background && schedule->m_lastUpdateFrame != m_frameCounter)
+			{
+				if (longestWaiting == NULL || schedule->m_timeSinceUpdate > longestWaiting->GetUpdateSchedule()->m_timeSinceUpdate)
+				{
+					longestWaiting = eachMechanism;
+				}
+			}
+		}
+
+		if (longestWaiting == NULL)
+		{
+			break;
+		}
+
+		budgetLeftMs -= UpdateMechanism(longestWaiting);
+		++ numBackgroundUpdates;
+	}
+	while (budgetLeftMs > 0.f);
+
+	int numDeferred = 0;
+
+	{
+		CGameMechanismIterator iter(m_firstMechanism);
+
+		while (CGameMechanismBase * eachMechanism = iter.GetNext())
+		{
+			CGameMechanismBase::SUpdateSchedule * schedule = eachMechanism->GetUpdateSchedule();
+
+			if (schedule->m_policy == kGMUpdatePolicy_Background && schedule->m_lastUpdateFrame != m_frameCounter)
+			{
+				++ schedule->m_numDeferred;
+				++ numDeferred;
+			}
+		}
+	}
+
+	MechanismManagerWatch ("Budget %.2fms, %.2fms left, %d background updates, %d deferred", m_cvarBudgetMs, budgetLeftMs, numBackgroundUpdates, numDeferred);
+}
+
+void CGameMechanismManager::LogStats()
+{
+	static const char * s_policyNames[] = {"every frame", "fixed rate", "background", "idle"};
+
+	CryLogAlways("[CGameMechanismManager] %d frames, background budget %.2fms:", m_frameCounter, m_cvarBudgetMs);
+
 	CGameMechanismIterator iter(m_firstMechanism);
 
 	while (CGameMechanismBase * eachMechanism = iter.GetNext())
 	{
-		MechanismManagerWatch ("Updating %s", eachMechanism->GetName());
-		eachMechanism->Update(dt);
+		const CGameMechanismBase::SUpdateSchedule * schedule = eachMechanism->GetUpdateSchedule();
+		const float rateHz = (schedule->m_policy == kGMUpdatePolicy_FixedRate && schedule->m_interval > 0.f) ? (1.f / schedule->m_interval) : 0.f;
+
+		CryLogAlways("    %-28s %-12s %6.1fHz %8u updates %8u deferred  last %.3fms  avg %.3fms  peak %.3fms",
+			eachMechanism->GetName(), s_policyNames[schedule->m_policy], rateHz, schedule->m_numUpdates, schedule->m_numDeferred,
+			schedule->m_lastCostMs, schedule->m_avgCostMs, schedule->m_peakCostMs);
 	}
 }
 
@@ -14,6 +14,7 @@ class CGameMechanismManager
 	void Inform(EGameMechanismEvent gmEvent, const SGameMechanismEventData * data = NULL);
 	void RegisterMechanism(CGameMechanismBase * mechanism);
 	void UnregisterMechanism(CGameMechanismBase * mechanism);
+	void LogStats();
 
 	static ILINE CGameMechanismManager * GetInstance()
 	{
@@ -22,8 +23,13 @@ class CGameMechanismManager
 	}
 
 	private:
+	float UpdateMechanism(CGameMechanismBase * mechanism);
+
 	static CGameMechanismManager * s_instance;
 	CGameMechanismBase * m_firstMechanism;
+	CGameMechanismBase * m_updatingMechanism;
+	int m_frameCounter;
+	float m_cvarBudgetMs;
 
 #if !defined(_RELEASE)
 	int m_cvarWatchEnabled;
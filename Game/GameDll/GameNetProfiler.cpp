@@ -0,0 +1,606 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Game side network bandwidth profiler.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "GameNetProfiler.h"
+
+#if GAME_NET_PROFILER_ENABLED
+
+#include <ICryMiniGUI.h>
+#include <IPerfHud.h>
+#include <PoolAllocator.h>
+#include "GameCVars.h"
+
+namespace
+{
+	CGameNetProfiler*	s_pProfiler = NULL;
+
+	// outermost counting serializer of the NetSerialize running on this thread
+	THREADLOCAL ISerialize* s_pActiveSerialize = NULL;
+
+	const int kWidgetFieldRows = 3;		// fields shown under each aspect row
+
+	template <class T>
+	ILINE uint32 GetRawBits(const T&) { return sizeof(T) * 8; }
+	ILINE uint32 GetRawBits(const bool&) { return 1; }
+	ILINE uint32 GetRawBits(const SSerializeString& value) { return (static_cast<uint32>(value.length()) + 1) * 8; }
+}
+
+bool CGameNetProfiler::s_bCollecting = false;
+
+//------------------------------------------------------------------------
+// Forwards everything to the wrapped serializer (if any) and counts the
+// estimated size of each value by name
+//------------------------------------------------------------------------
+class CGameNetProfiler::CProfileSerialize : public ISerialize
+{
+public:
+	enum
+	{
+		k_maxFields = 64,
+		k_maxNameLength = 32,
+	};
+
+	struct SField
+	{
+		uint32	crc;
+		uint32	bits;
+		uint32	count;
+		char		szName[k_maxNameLength];
+	};
+
+	CProfileSerialize(ISerialize* pInner, ISerialize* pOuter)
+		: m_pInner(pInner)
+		, m_pOuter(pOuter)
+		, m_numFields(0)
+		, m_totalBits(0)
+	{
+	}
+
+	static void* operator new(size_t size);
+	static void operator delete(void* p);
+
+	ILINE ISerialize* GetOuter() const { return m_pOuter; }
+	ILINE int GetFieldCount() const { return m_numFields; }
+	ILINE const SField& GetField(int i) const { return m_fields[i]; }
+	ILINE uint32 GetTotalBits() const { return m_totalBits; }
+
+	// ISerialize
+	virtual void ReadStringValue( const char * name, SSerializeString &curValue, uint32 policy )
+	{
+		if (m_pInner)
+			m_pInner->ReadStringValue(name, curValue, policy);
+		Count(name, GetRawBits(curValue));
+	}
+
+	virtual void WriteStringValue( const char * name, SSerializeString& buffer, uint32 policy )
+	{
+		if (m_pInner)
+			m_pInner->WriteStringValue(name, buffer, policy);
+		Count(name, GetRawBits(buffer));
+	}
+
+	virtual void Update( ISerializeUpdateFunction * pUpdate )
+	{
+		if (m_pInner)
+			m_pInner->Update(pUpdate);
+	}
+
+	virtual void FlagPartialRead()
+	{
+		if (m_pInner)
+			m_pInner->FlagPartialRead();
+	}
+
+	virtual void BeginGroup( const char * szName )
+	{
+		if (m_pInner)
+			m_pInner->BeginGroup(szName);
+	}
+
+	virtual bool BeginOptionalGroup( const char * szName, bool condition )
+	{
+		Count(szName, 1);
+		return m_pInner ? m_pInner->BeginOptionalGroup(szName, condition) : condition;
+	}
+
+	virtual void EndGroup()
+	{
+		if (m_pInner)
+			m_pInner->EndGroup();
+	}
+
+	virtual bool IsReading() const { return m_pInner ? m_pInner->IsReading() : false; }
+	virtual bool ShouldCommitValues() const { return m_pInner ? m_pInner->ShouldCommitValues() : true; }
+	virtual ESerializationTarget GetSerializationTarget() const { return m_pInner ? m_pInner->GetSerializationTarget() : eST_Network; }
+	virtual bool Ok() const { return m_pInner ? m_pInner->Ok() : true; }
+
+#define SERIALIZATION_TYPE(T) \
+	virtual void Value( const char * name, T& x, uint32 policy ) \
+	{ \
+		if (m_pInner) \
+			m_pInner->Value(name, x, policy); \
+		Count(name, GetRawBits(x)); \
+	}
+#include "SerializationTypes.h"
+#undef SERIALIZATION_TYPE
+
+#define SERIALIZATION_TYPE(T) \
+	virtual void ValueWithDefault( const char * name, T& x, const T& defaultValue ) \
+	{ \
+		if (m_pInner) \
+			m_pInner->ValueWithDefault(name, x, defaultValue); \
+		Count(name, GetRawBits(x)); \
+	}
+#include "SerializationTypes.h"
+SERIALIZATION_TYPE(SSerializeString)
+#undef SERIALIZATION_TYPE
+	//~ISerialize
+
+private:
+	void Count(const char* szName, uint32 bits)
+	{
+		m_totalBits += bits;
+
+		// names can be built on the stack by the caller, so they are identified by crc and copied
+		const char* szKey = szName ? szName : "";
+		const uint32 crc = gEnv->pSystem->GetCrc32Gen()->GetCRC32(szKey);
+
+		for (int i = m_numFields - 1; i >= 0; --i)
+		{
+			if (m_fields[i].crc == crc)
+			{
+				m_fields[i].bits += bits;
+				++m_fields[i].count;
+				return;
+			}
+		}
+
+		// out of slots: everything else goes to the last one
+		SField& field = m_fields[min(m_numFields, (int)k_maxFields - 1)];
+		if (m_numFields < k_maxFields)
+		{
+			field.crc = crc;
+			field.bits = 0;
+			field.count = 0;
+			strncpy(field.szName, (m_numFields < k_maxFields - 1) ? szKey : "<other>", k_maxNameLength - 1);
+			field.szName[k_maxNameLength - 1] = 0;
+			++m_numFields;
+		}
+
+		field.bits += bits;
+		++field.count;
+	}
+
+	ISerialize*	m_pInner;
+	ISerialize*	m_pOuter;
+	int					m_numFields;
+	uint32			m_totalBits;
+	SField			m_fields[k_maxFields];
+};
+
+typedef stl::PoolAllocator<sizeof(CGameNetProfiler::CProfileSerialize), stl::PoolAllocatorSynchronizationMultithreaded> TProfileSerializeAlloc;
+static TProfileSerializeAlloc s_profileSerializeAlloc;
+
+//------------------------------------------------------------------------
+void* CGameNetProfiler::CProfileSerialize::operator new(size_t size)
+{
+	return s_profileSerializeAlloc.Allocate();
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::CProfileSerialize::operator delete(void* p)
+{
+	if (p)
+		s_profileSerializeAlloc.Deallocate(p);
+}
+
+//------------------------------------------------------------------------
+// PerfHUD table with the aspects and RMIs using most bandwidth
+//------------------------------------------------------------------------
+class CGameNetProfiler::CDebugWidget : public ICryPerfHUDWidget
+{
+public:
+	enum EColumn
+	{
+		eC_Name = 0,
+		eC_Direction,
+		eC_BitsPerSecond,
+		eC_CountPerSecond,
+		eC_AverageBits,
+	};
+
+	virtual void Reset() {}
+	virtual void LoadBudgets(XmlNodeRef perfXML) {}
+	virtual void SaveStats(XmlNodeRef statsXML) {}
+
+	CDebugWidget(minigui::IMiniCtrl* pParentMenu, ICryPerfHUD* pPerfHud, CGameNetProfiler& profiler)
+		: m_profiler(profiler)
+		, m_pTable(NULL)
+	{
+		m_pTable = pPerfHud->CreateTableMenuItem(pParentMenu, "Net Profile");
+		CRY_ASSERT(m_pTable);
+
+		m_pTable->AddColumn("Class/Aspect/Field or RMI");
+		m_pTable->AddColumn("Dir");
+		m_pTable->AddColumn("Bits/s");
+		m_pTable->AddColumn("Calls/s");
+		m_pTable->AddColumn("Avg bits");
+
+		pPerfHud->AddWidget(this);
+	}
+
+	void Update()
+	{
+		m_pTable->ClearTable();
+
+		if (!s_bCollecting)
+		{
+			AddRow(Col_DimGray, "g_netProfile is 0", "", SCounter());
+			return;
+		}
+
+		const int maxRows = max(g_pGameCVars->g_netProfileMaxRows, 1);
+
+		CryAutoCriticalSection lock(m_profiler.m_lock);
+
+		m_sortedAspects.clear();
+		for (TAspectMap::const_iterator it = m_profiler.m_aspects.begin(); it != m_profiler.m_aspects.end(); ++it)
+			m_sortedAspects.push_back(&(*it));
+		std::sort(m_sortedAspects.begin(), m_sortedAspects.end(), &CGameNetProfiler::SortAspectsByRate);
+
+		CryFixedStringT<128> text;
+
+		const int numAspects = min((int)m_sortedAspects.size(), maxRows);
+		for (int i = 0; i < numAspects; ++i)
+		{
+			const SAspectKey& key = m_sortedAspects[i]->first;
+			const SAspectStats& stats = m_sortedAspects[i]->second;
+
+			text.Format("%s/%s", stats.className.c_str(), GetAspectName(key.aspect));
+			AddRow(Col_White, text.c_str(), key.reading ? "in" : "out", stats.counter);
+
+			m_sortedFields.clear();
+			for (TFieldMap::const_iterator itField = stats.fields.begin(); itField != stats.fields.end(); ++itField)
+				m_sortedFields.push_back(&itField->second);
+			std::sort(m_sortedFields.begin(), m_sortedFields.end(), &CGameNetProfiler::SortFieldsByRate);
+
+			const int numFields = min((int)m_sortedFields.size(), kWidgetFieldRows);
+			for (int j = 0; j < numFields; ++j)
+			{
+				text.Format("  %s", m_sortedFields[j]->name.c_str());
+				AddRow(Col_CadetBlue, text.c_str(), "", m_sortedFields[j]->counter);
+			}
+		}
+
+		m_sortedRMIs.clear();
+		for (TRMIMap::const_iterator it = m_profiler.m_rmis.begin(); it != m_profiler.m_rmis.end(); ++it)
+			m_sortedRMIs.push_back(&it->second);
+		std::sort(m_sortedRMIs.begin(), m_sortedRMIs.end(), &CGameNetProfiler::SortRMIsByRate);
+
+		const int numRMIs = min((int)m_sortedRMIs.size(), maxRows);
+		for (int i = 0; i < numRMIs; ++i)
+			AddRow(Col_LightBlue, m_sortedRMIs[i]->name.c_str(), "in", m_sortedRMIs[i]->counter);
+	}
+
+	bool ShouldUpdate()
+	{
+		return !m_pTable->IsHidden();
+	}
+
+	void Enable(int mode)
+	{
+		m_pTable->Hide(false);
+	}
+
+	void Disable()
+	{
+		m_pTable->Hide(true);
+	}
+
+private:
+	void AddRow(const ColorB& color, const char* szName, const char* szDirection, const SCounter& counter)
+	{
+		m_pTable->AddData(eC_Name, color, "%s", szName);
+		m_pTable->AddData(eC_Direction, color, "%s", szDirection);
+		m_pTable->AddData(eC_BitsPerSecond, color, "%.0f", counter.bitsPerSecond);
+		m_pTable->AddData(eC_CountPerSecond, color, "%.1f", counter.countPerSecond);
+		m_pTable->AddData(eC_AverageBits, color, "%.1f", counter.totalCount ? (float)counter.totalBits / (float)counter.totalCount : 0.0f);
+	}
+
+	CGameNetProfiler&					m_profiler;
+	minigui::IMiniTable*			m_pTable;
+
+	// kept around to avoid allocating every update
+	std::vector<const TAspectMap::value_type*>	m_sortedAspects;
+	std::vector<const SFieldStats*>							m_sortedFields;
+	std::vector<const SRMIStats*>								m_sortedRMIs;
+};
+
+//------------------------------------------------------------------------
+CGameNetProfiler::SCounter::SCounter()
+: totalBits(0)
+, totalCount(0)
+, windowBits(0)
+, windowCount(0)
+, bitsPerSecond(0.0f)
+, countPerSecond(0.0f)
+{
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::SCounter::Add(uint32 bits, uint32 count)
+{
+	totalBits += bits;
+	totalCount += count;
+	windowBits += bits;
+	windowCount += count;
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::SCounter::CloseWindow(float invWindowTime)
+{
+	bitsPerSecond = (float)windowBits * invWindowTime;
+	countPerSecond = (float)windowCount * invWindowTime;
+	windowBits = 0;
+	windowCount = 0;
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::CSerializeScope::Begin(IEntity* pEntity, uint32 aspect)
+{
+	ISerialize* pInner = GetImpl(m_ser);
+	if ((pInner == s_pActiveSerialize) || (m_ser.GetSerializationTarget() != eST_Network))
+		return;
+
+	uint8 aspectIdx = 0;
+	while ((aspectIdx < NUM_ASPECTS - 1) && !(aspect & BIT(aspectIdx)))
+		++aspectIdx;
+
+	CProfileSerialize* pSerialize = new CProfileSerialize(pInner, s_pActiveSerialize);
+	m_pEntityClass = pEntity->GetClass();
+	m_aspectIdx = aspectIdx;
+	m_pSerialize = pSerialize;
+	m_ser = TSerialize(pSerialize);
+
+	s_pActiveSerialize = pSerialize;
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::CSerializeScope::End()
+{
+	CProfileSerialize* pSerialize = static_cast<CProfileSerialize*>(m_pSerialize);
+
+	s_pActiveSerialize = pSerialize->GetOuter();
+	m_ser = m_original;
+
+	if (s_pProfiler)
+		s_pProfiler->Commit(*pSerialize, m_pEntityClass, m_aspectIdx);
+
+	delete pSerialize;
+}
+
+//------------------------------------------------------------------------
+CGameNetProfiler::CGameNetProfiler()
+: m_windowTime(0.0f)
+, m_pWidget(NULL)
+{
+	CRY_ASSERT(!s_pProfiler);
+	s_pProfiler = this;
+
+	ICryPerfHUD* pPerfHUD = gEnv->pSystem->GetPerfHUD();
+	if (pPerfHUD)
+	{
+		minigui::IMiniCtrl* pGameMenu = pPerfHUD->GetMenu("Game");
+		if (!pGameMenu)
+			pGameMenu = pPerfHUD->CreateMenu("Game");
+
+		m_pWidget = new CDebugWidget(pGameMenu, pPerfHUD, *this);
+	}
+}
+
+//------------------------------------------------------------------------
+CGameNetProfiler::~CGameNetProfiler()
+{
+	if (m_pWidget)
+		gEnv->pSystem->GetPerfHUD()->RemoveWidget(m_pWidget);
+
+	s_bCollecting = false;
+	s_pProfiler = NULL;
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::Update(float frameTime)
+{
+	s_bCollecting = (g_pGameCVars->g_netProfile != 0);
+	if (!s_bCollecting)
+		return;
+
+	m_windowTime += frameTime;
+	if (m_windowTime < 1.0f)
+		return;
+
+	const float invWindowTime = 1.0f / m_windowTime;
+	m_windowTime = 0.0f;
+
+	CryAutoCriticalSection lock(m_lock);
+
+	for (TAspectMap::iterator it = m_aspects.begin(); it != m_aspects.end(); ++it)
+	{
+		SAspectStats& stats = it->second;
+		stats.counter.CloseWindow(invWindowTime);
+
+		for (TFieldMap::iterator itField = stats.fields.begin(); itField != stats.fields.end(); ++itField)
+			itField->second.counter.CloseWindow(invWindowTime);
+	}
+
+	for (TRMIMap::iterator it = m_rmis.begin(); it != m_rmis.end(); ++it)
+		it->second.counter.CloseWindow(invWindowTime);
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::Reset()
+{
+	CryAutoCriticalSection lock(m_lock);
+
+	m_aspects.clear();
+	m_rmis.clear();
+	m_windowTime = 0.0f;
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::Commit(const CProfileSerialize& serialize, const IEntityClass* pClass, uint8 aspect)
+{
+	CryAutoCriticalSection lock(m_lock);
+
+	SAspectStats& stats = m_aspects[SAspectKey(pClass, aspect, serialize.IsReading())];
+	if (stats.className.empty())
+		stats.className = pClass->GetName();
+
+	stats.counter.Add(serialize.GetTotalBits(), 1);
+
+	const int numFields = serialize.GetFieldCount();
+	for (int i = 0; i < numFields; ++i)
+	{
+		const CProfileSerialize::SField& field = serialize.GetField(i);
+
+		SFieldStats& fieldStats = stats.fields[field.crc];
+		if (fieldStats.name.empty())
+			fieldStats.name = field.szName;
+
+		fieldStats.counter.Add(field.bits, field.count);
+	}
+}
+
+//------------------------------------------------------------------------
+ISerialize* CGameNetProfiler::BeginMeasure()
+{
+	return new CProfileSerialize(NULL, NULL);
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::EndMeasure(ISerialize* pSerialize, const char* szName)
+{
+	CProfileSerialize* pProfileSerialize = static_cast<CProfileSerialize*>(pSerialize);
+
+	if (s_pProfiler)
+		s_pProfiler->CommitRMI(szName, pProfileSerialize->GetTotalBits());
+
+	delete pProfileSerialize;
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::CommitRMI(const char* szName, uint32 bits)
+{
+	CryAutoCriticalSection lock(m_lock);
+
+	SRMIStats& stats = m_rmis[szName];
+	if (stats.name.empty())
+		stats.name = szName;
+
+	stats.counter.Add(bits, 1);
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::Dump(const char* szFileName) const
+{
+	ICryPak* pCryPak = gEnv->pCryPak;
+
+	FILE* pFile = pCryPak->FOpen(szFileName, "wt");
+	if (!pFile)
+	{
+		GameWarning("Failed to open '%s' to dump the net profile", szFileName);
+		return;
+	}
+
+	CryAutoCriticalSection lock(m_lock);
+
+	pCryPak->FPrintf(pFile, "Type,Class,Aspect,Direction,Field,BitsPerSecond,CallsPerSecond,TotalBits,TotalCalls\n");
+
+	for (TAspectMap::const_iterator it = m_aspects.begin(); it != m_aspects.end(); ++it)
+	{
+		const SAspectKey& key = it->first;
+		const SAspectStats& stats = it->second;
+		const char* szDirection = key.reading ? "in" : "out";
+		const char* szAspect = GetAspectName(key.aspect);
+
+		pCryPak->FPrintf(pFile, "aspect,%s,%s,%s,,%.1f,%.1f,%" PRIu64 ",%u\n", stats.className.c_str(), szAspect, szDirection,
+			stats.counter.bitsPerSecond, stats.counter.countPerSecond, stats.counter.totalBits, stats.counter.totalCount);
+
+		for (TFieldMap::const_iterator itField = stats.fields.begin(); itField != stats.fields.end(); ++itField)
+		{
+			const SFieldStats& field = itField->second;
+			pCryPak->FPrintf(pFile, "field,%s,%s,%s,%s,%.1f,%.1f,%" PRIu64 ",%u\n", stats.className.c_str(), szAspect, szDirection, field.name.c_str(),
+				field.counter.bitsPerSecond, field.counter.countPerSecond, field.counter.totalBits, field.counter.totalCount);
+		}
+	}
+
+	for (TRMIMap::const_iterator it = m_rmis.begin(); it != m_rmis.end(); ++it)
+	{
+		const SRMIStats& stats = it->second;
+		pCryPak->FPrintf(pFile, "rmi,,,in,%s,%.1f,%.1f,%" PRIu64 ",%u\n", stats.name.c_str(),
+			stats.counter.bitsPerSecond, stats.counter.countPerSecond, stats.counter.totalBits, stats.counter.totalCount);
+	}
+
+	pCryPak->FClose(pFile);
+
+	CryLogAlways("Net profile written to '%s' (%d aspects, %d RMIs)", szFileName, (int)m_aspects.size(), (int)m_rmis.size());
+}
+
+//------------------------------------------------------------------------
+void CGameNetProfiler::GetMemoryStatistics(ICrySizer* s) const
+{
+	CryAutoCriticalSection lock(m_lock);
+
+	s->AddObject(this, sizeof(*this));
+	s->AddContainer(m_aspects);
+	s->AddContainer(m_rmis);
+	for (TAspectMap::const_iterator it = m_aspects.begin(); it != m_aspects.end(); ++it)
+		s->AddContainer(it->second.fields);
+}
+
+//------------------------------------------------------------------------
+bool CGameNetProfiler::SortAspectsByRate(const TAspectMap::value_type* pA, const TAspectMap::value_type* pB)
+{
+	return pA->second.counter.bitsPerSecond > pB->second.counter.bitsPerSecond;
+}
+
+//------------------------------------------------------------------------
+bool CGameNetProfiler::SortFieldsByRate(const SFieldStats* pA, const SFieldStats* pB)
+{
+	return pA->counter.bitsPerSecond > pB->counter.bitsPerSecond;
+}
+
+//------------------------------------------------------------------------
+bool CGameNetProfiler::SortRMIsByRate(const SRMIStats* pA, const SRMIStats* pB)
+{
+	return pA->counter.countPerSecond > pB->counter.countPerSecond;
+}
+
+//------------------------------------------------------------------------
+const char* CGameNetProfiler::GetAspectName(uint8 aspect)
+{
+	static const char* s_aspectNames[] =
+	{
+		"Aspect0", "Script", "Aspect2", "Physics",
+		"ClientStatic", "ServerStatic", "ClientDynamic", "ServerDynamic",
+		"ClientA", "ServerA", "ClientB", "ServerB",
+		"ClientC", "ServerC", "ClientD", "ClientE",
+		"ClientF", "ClientG", "ClientH", "ClientI",
+		"ClientJ", "ServerD", "ClientK", "Aspect23",
+		"Aspect24", "Aspect25", "Aspect26", "Aspect27",
+		"Aspect28", "Aspect29", "Aspect30", "Aspect31",
+	};
+
+	return (aspect < sizeof(s_aspectNames) / sizeof(s_aspectNames[0])) ? s_aspectNames[aspect] : "?";
+}
+
+#endif //GAME_NET_PROFILER_ENABLED
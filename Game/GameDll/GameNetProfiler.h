@@ -0,0 +1,198 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Game side network bandwidth profiler. While g_netProfile is set the
+NetSerialize calls of game objects are routed through a counting
+serializer, gathering bits per (entity class, aspect, field) and how many
+RMIs of each type are handled, per second and in total.
+
+Bits are estimated from the raw value types (a float is 32 bits, a bool
+1 bit, a string its length), the compression policies applied by the
+network layer aren't visible from here: use the numbers to rank the
+bandwidth hogs rather than as exact wire sizes.
+
+The stats are shown in the "Game" PerfHUD menu and g_netProfileDump
+writes them to a CSV file.
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __GAMENETPROFILER_H__
+#define __GAMENETPROFILER_H__
+
+#pragma once
+
+#include <VectorMap.h>
+
+#ifndef _RELEASE
+	#define GAME_NET_PROFILER_ENABLED 1
+#endif
+
+#if GAME_NET_PROFILER_ENABLED
+
+class CGameNetProfiler
+{
+public:
+	class CProfileSerialize;
+
+	// Routes ser through the counting serializer for the lifetime of the scope,
+	// nested scopes (CPlayer calling CActor::NetSerialize) count into the outermost one
+	class CSerializeScope
+	{
+	public:
+		ILINE CSerializeScope(TSerialize& ser, IEntity* pEntity, uint32 aspect)
+			: m_ser(ser)
+			, m_original(ser)
+			, m_pSerialize(NULL)
+			, m_pEntityClass(NULL)
+			, m_aspectIdx(0)
+		{
+			if (s_bCollecting && pEntity)
+				Begin(pEntity, aspect);
+		}
+
+		ILINE ~CSerializeScope()
+		{
+			if (m_pSerialize)
+				End();
+		}
+
+	private:
+		void Begin(IEntity* pEntity, uint32 aspect);
+		void End();
+
+		TSerialize&					m_ser;
+		TSerialize					m_original;
+		ISerialize*					m_pSerialize;
+		const IEntityClass*	m_pEntityClass;
+		uint8								m_aspectIdx;
+	};
+
+	CGameNetProfiler();
+	~CGameNetProfiler();
+
+	void	Update(float frameTime);
+	void	Reset();
+
+	// writes every counter to a CSV file
+	void	Dump(const char* szFileName) const;
+
+	void	GetMemoryStatistics(ICrySizer* s) const;
+
+	// counts a handled RMI, the params are serialized into the counting serializer to estimate their size
+	template <class T>
+	static ILINE void CountRMI(const char* szName, const T& params)
+	{
+		if (s_bCollecting)
+		{
+			T paramsCopy(params);
+			ISerialize* pSerialize = BeginMeasure();
+			paramsCopy.SerializeWith(TSerialize(pSerialize));
+			EndMeasure(pSerialize, szName);
+		}
+	}
+
+private:
+	class CDebugWidget;
+
+	struct SCounter
+	{
+		SCounter();
+
+		void	Add(uint32 bits, uint32 count);
+		void	CloseWindow(float invWindowTime);
+
+		uint64	totalBits;
+		uint32	totalCount;
+		uint32	windowBits;
+		uint32	windowCount;
+		float		bitsPerSecond;
+		float		countPerSecond;
+	};
+
+	struct SFieldStats
+	{
+		string		name;
+		SCounter	counter;
+	};
+
+	typedef VectorMap<uint32, SFieldStats> TFieldMap;		// keyed by name crc
+
+	struct SAspectKey
+	{
+		SAspectKey(const IEntityClass* _pClass, uint8 _aspect, bool _reading) : pClass(_pClass), aspect(_aspect), reading(_reading) {}
+
+		bool operator<(const SAspectKey& other) const
+		{
+			if (pClass != other.pClass)
+				return pClass < other.pClass;
+			if (aspect != other.aspect)
+				return aspect < other.aspect;
+			return reading < other.reading;
+		}
+
+		const IEntityClass*	pClass;
+		uint8								aspect;		// aspect index, not the bit
+		bool								reading;
+	};
+
+	struct SAspectStats
+	{
+		string		className;
+		SCounter	counter;
+		TFieldMap	fields;
+	};
+
+	typedef std::map<SAspectKey, SAspectStats> TAspectMap;
+
+	struct SRMIStats
+	{
+		string		name;
+		SCounter	counter;
+	};
+
+	typedef std::map<const char*, SRMIStats> TRMIMap;		// keyed by the literal built by GAME_NET_PROFILE_RMI
+
+	static ISerialize*	BeginMeasure();
+	static void					EndMeasure(ISerialize* pSerialize, const char* szName);
+
+	void	Commit(const CProfileSerialize& serialize, const IEntityClass* pClass, uint8 aspect);
+	void	CommitRMI(const char* szName, uint32 bits);
+
+	static const char*	GetAspectName(uint8 aspect);
+
+	static bool	SortAspectsByRate(const TAspectMap::value_type* pA, const TAspectMap::value_type* pB);
+	static bool	SortFieldsByRate(const SFieldStats* pA, const SFieldStats* pB);
+	static bool	SortRMIsByRate(const SRMIStats* pA, const SRMIStats* pB);
+
+	static bool	s_bCollecting;
+
+	mutable CryCriticalSection	m_lock;
+	TAspectMap		m_aspects;
+	TRMIMap				m_rmis;
+	float					m_windowTime;
+
+	CDebugWidget*	m_pWidget;
+};
+
+#define GAME_NET_PROFILE_JOIN(a, b)								a##b
+#define GAME_NET_PROFILE_NAME(a, b)								GAME_NET_PROFILE_JOIN(a, b)
+
+// first statement of a NetSerialize/Serialize, ser is swapped with the counting serializer while profiling
+#define GAME_NET_PROFILE_SERIALIZE(ser, pEntity, aspect) \
+	CGameNetProfiler::CSerializeScope GAME_NET_PROFILE_NAME(netProfileScope, __LINE__)(ser, pEntity, aspect)
+
+// first statement of an RMI handler
+#define GAME_NET_PROFILE_RMI(cls, name) \
+	CGameNetProfiler::CountRMI("RMI:" #cls ":" #name, params)
+
+#else
+
+#define GAME_NET_PROFILE_SERIALIZE(ser, pEntity, aspect)
+#define GAME_NET_PROFILE_RMI(cls, name)
+
+#endif //GAME_NET_PROFILER_ENABLED
+
+#endif //__GAMENETPROFILER_H__
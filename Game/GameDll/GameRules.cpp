@@ -13,6 +13,7 @@
 #include "StdAfx.h"
 #include "ScriptBind_GameRules.h"
 #include "GameRules.h"
+#include "GameNetProfiler.h"
 #include "Game.h"
 #include "GameCVars.h"
 #include "Actor.h"
@@ -2724,7 +2725,21 @@ int CGameRules::RegisterHitMaterial(const char *materialName)
 	ISurfaceType *pSurfaceType=m_pMaterialManager->GetSurfaceTypeByName(materialName);
 	if (pSurfaceType)
 	{
-		m_hitMaterials.insert(THitMaterialMap::value_type(++m_hitMaterialIdGen, pSurfaceType->GetId()));
+		const int surfaceId=pSurfaceType->GetId();
+		if (surfaceId<0)
+			return 0;
+
+		++m_hitMaterialIdGen;
+		m_hitMaterials.resize(m_hitMaterialIdGen+1, 0);
+		m_hitMaterials[m_hitMaterialIdGen]=surfaceId;
+
+		if (surfaceId>=(int)m_surfaceHitMaterials.size())
+			m_surfaceHitMaterials.resize(surfaceId+1, 0);
+
+		// first registration of a surface wins, as with the old id ordered map lookup
+		if (!m_surfaceHitMaterials[surfaceId])
+			m_surfaceHitMaterials[surfaceId]=m_hitMaterialIdGen;
+
 		return m_hitMaterialIdGen;
 	}
 	return 0;
@@ -2737,25 +2752,14 @@ int CGameRules::GetHitMaterialId(const char *materialName) const
 	if (!pSurfaceType)
 		return 0;
 
-	int id=pSurfaceType->GetId();
-
-	for (THitMaterialMap::const_iterator it=m_hitMaterials.begin(); it!=m_hitMaterials.end(); ++it)
-	{
-		if (it->second==id)
-			return it->first;
-	}
-
-	return 0;
+	return GetHitMaterialIdFromSurfaceId(pSurfaceType->GetId());
 }
 
 //------------------------------------------------------------------------
 int CGameRules::GetHitMaterialIdFromSurfaceId(int surfaceId) const
 {
-	for (THitMaterialMap::const_iterator it=m_hitMaterials.begin(); it!=m_hitMaterials.end(); ++it)
-	{
-		if (it->second==surfaceId)
-			return it->first;
-	}
+	if ((unsigned int)surfaceId<m_surfaceHitMaterials.size())
+		return m_surfaceHitMaterials[surfaceId];
 
 	return 0;
 }
@@ -2763,11 +2767,10 @@ int CGameRules::GetHitMaterialIdFromSurfaceId(int surfaceId) const
 //------------------------------------------------------------------------
 ISurfaceType *CGameRules::GetHitMaterial(int id) const
 {
-	THitMaterialMap::const_iterator it=m_hitMaterials.find(id);
-	if (it==m_hitMaterials.end())
+	if (id<=0 || id>=(int)m_hitMaterials.size())
 		return 0;
 
-	ISurfaceType *pSurfaceType=m_pMaterialManager->GetSurfaceType(it->second);
+	ISurfaceType *pSurfaceType=m_pMaterialManager->GetSurfaceType(m_hitMaterials[id]);
 	
 	return pSurfaceType;
 }
@@ -2775,7 +2778,8 @@ ISurfaceType *CGameRules::GetHitMaterial(int id) const
 //------------------------------------------------------------------------
 void CGameRules::ResetHitMaterials()
 {
-	m_hitMaterials.clear();
+	stl::free_container(m_hitMaterials);
+	stl::free_container(m_surfaceHitMaterials);
 	m_hitMaterialIdGen=0;
 }
 
@@ -2785,36 +2789,41 @@ int CGameRules::RegisterHitType(const char *type)
 	if (int id=GetHitTypeId(type))
 		return id;
 
-	m_hitTypes.insert(THitTypeMap::value_type(++m_hitTypeIdGen, type));
+	++m_hitTypeIdGen;
+	m_hitTypes.resize(m_hitTypeIdGen+1);
+	m_hitTypes[m_hitTypeIdGen]=type;
+	m_hitTypeIds.insert(THitTypeIdMap::value_type(m_hitTypes[m_hitTypeIdGen], m_hitTypeIdGen));
+
 	return m_hitTypeIdGen;
 }
 
 //------------------------------------------------------------------------
 int CGameRules::GetHitTypeId(const char *type) const
 {
-	for (THitTypeMap::const_iterator it=m_hitTypes.begin(); it!=m_hitTypes.end(); ++it)
-	{
-		if (it->second==type)
-			return it->first;
-	}
+	if (!type)
+		return 0;
 
-	return 0;
+	THitTypeIdMap::const_iterator it=m_hitTypeIds.find(CONST_TEMP_STRING(type));
+	if (it==m_hitTypeIds.end())
+		return 0;
+
+	return it->second;
 }
 
 //------------------------------------------------------------------------
 const char *CGameRules::GetHitType(int id) const
 {
-	THitTypeMap::const_iterator it=m_hitTypes.find(id);
-	if (it==m_hitTypes.end())
+	if (id<=0 || id>=(int)m_hitTypes.size())
 		return 0;
 
-	return it->second.c_str();
+	return m_hitTypes[id].c_str();
 }
 
 //------------------------------------------------------------------------
 void CGameRules::ResetHitTypes()
 {
-	m_hitTypes.clear();
+	stl::free_container(m_hitTypes);
+	m_hitTypeIds.clear();
 	m_hitTypeIdGen=0;
 }
 
@@ -4111,7 +4120,9 @@ void CGameRules::GetMemoryUsage(ICrySizer * s) const
 	s->AddContainer(m_teamdefaultspawns);
 	s->AddContainer(m_playerteams);
 	s->AddContainer(m_hitMaterials);
+	s->AddContainer(m_surfaceHitMaterials);
 	s->AddContainer(m_hitTypes);
+	s->AddObject(m_hitTypeIds);
 	s->AddContainer(m_respawndata);
 	s->AddContainer(m_respawns);
 	s->AddContainer(m_removals);
@@ -4130,7 +4141,7 @@ void CGameRules::GetMemoryUsage(ICrySizer * s) const
 	for (TPlayerTeamIdMap::const_iterator iter = m_playerteams.begin(); iter != m_playerteams.end(); ++iter)
 		s->AddContainer(iter->second);
 	for (THitTypeMap::const_iterator iter = m_hitTypes.begin(); iter != m_hitTypes.end(); ++iter)
-		s->Add(iter->second);
+		s->Add(*iter);
 	for (TTeamObjectiveMap::const_iterator iter = m_objectives.begin(); iter != m_objectives.end(); ++iter)
 		s->AddContainer(iter->second);
 	for (TSpawnGroupMap::const_iterator iter = m_spawnGroups.begin(); iter != m_spawnGroups.end(); ++iter)
@@ -4139,6 +4150,7 @@ void CGameRules::GetMemoryUsage(ICrySizer * s) const
 
 bool CGameRules::NetSerialize( TSerialize ser, EEntityAspects aspect, uint8 profile, int flags )
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 		switch (aspect)
 		{
 		case eEA_GameServerDynamic:
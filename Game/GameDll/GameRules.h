@@ -1010,8 +1010,11 @@ public:
 	typedef std::map<int, EntityId>				TChannelTeamIdMap;
 	typedef std::map<string, int>					TTeamIdMap;
 
-	typedef std::map<int, int>						THitMaterialMap;
-	typedef std::map<int, string>					THitTypeMap;
+	// hit materials and hit types are indexed directly by their id (ids are handed out sequentially from 1)
+	typedef std::vector<int>							THitMaterialMap;
+	typedef std::vector<int>							TSurfaceHitMaterialMap;
+	typedef std::vector<string>						THitTypeMap;
+	typedef stl::hash_map<string, int, stl::hash_strcmp<string> >	THitTypeIdMap;
 
 #ifndef OLD_VOICE_SYSTEM_DEPRECATED
 	typedef std::map<int, _smart_ptr<IVoiceGroup> >		TTeamIdVoiceGroupMap;
@@ -1160,10 +1163,12 @@ protected:
 	TChannelTeamIdMap		m_channelteams;
 	int									m_teamIdGen;
 
-	THitMaterialMap			m_hitMaterials;
+	THitMaterialMap			m_hitMaterials;				// hit material id -> surface id
+	TSurfaceHitMaterialMap	m_surfaceHitMaterials;	// surface id -> hit material id
 	int									m_hitMaterialIdGen;
 
-	THitTypeMap					m_hitTypes;
+	THitTypeMap					m_hitTypes;						// hit type id -> name
+	THitTypeIdMap				m_hitTypeIds;					// name -> hit type id
 	int									m_hitTypeIdGen;
 
 	SmartScriptTable		m_scriptHitInfo;
@@ -11,6 +11,7 @@ History:
 
 *************************************************************************/
 #include "StdAfx.h"
+#include "GameNetProfiler.h"
 #include "ScriptBind_GameRules.h"
 #include "GameRules.h"
 #include "Game.h"
@@ -764,6 +765,7 @@ void CGameRules::ProcessExplosionMaterialFX(const ExplosionInfo &explosionInfo)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, SvRequestRename)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvRequestRename);
 	CActor *pActor = GetActorByEntityId(params.entityId);
 	if (!pActor)
 		return true;
@@ -776,6 +778,7 @@ IMPLEMENT_RMI(CGameRules, SvRequestRename)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClRenameEntity)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClRenameEntity);
 	IEntity *pEntity=gEnv->pEntitySystem->GetEntity(params.entityId);
 	if (pEntity)
 	{
@@ -801,6 +804,7 @@ IMPLEMENT_RMI(CGameRules, ClRenameEntity)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, SvRequestChatMessage)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvRequestChatMessage);
 	SendChatMessage((EChatMessageType)params.type, params.sourceId, params.targetId, params.msg.c_str());
 
 	return true;
@@ -809,6 +813,7 @@ IMPLEMENT_RMI(CGameRules, SvRequestChatMessage)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClChatMessage)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClChatMessage);
 	OnChatMessage((EChatMessageType)params.type, params.sourceId, params.targetId, params.msg.c_str(), params.onlyTeam);
 
 	return true;
@@ -817,6 +822,7 @@ IMPLEMENT_RMI(CGameRules, ClChatMessage)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClForbiddenAreaWarning)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClForbiddenAreaWarning);
 	return true;
 }
 
@@ -825,6 +831,7 @@ IMPLEMENT_RMI(CGameRules, ClForbiddenAreaWarning)
 
 IMPLEMENT_RMI(CGameRules, SvRequestRadioMessage)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvRequestRadioMessage);
 	SendRadioMessage(params.sourceId,params.msg);
 
 	return true;
@@ -834,6 +841,7 @@ IMPLEMENT_RMI(CGameRules, SvRequestRadioMessage)
 
 IMPLEMENT_RMI(CGameRules, ClRadioMessage)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClRadioMessage);
 	OnRadioMessage(params.sourceId,params.msg);
 	return true;
 }
@@ -841,6 +849,7 @@ IMPLEMENT_RMI(CGameRules, ClRadioMessage)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, SvRequestChangeTeam)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvRequestChangeTeam);
 	CActor *pActor = GetActorByEntityId(params.entityId);
 	if (!pActor)
 		return true;
@@ -853,6 +862,7 @@ IMPLEMENT_RMI(CGameRules, SvRequestChangeTeam)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, SvRequestSpectatorMode)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvRequestSpectatorMode);
 	CActor *pActor = GetActorByEntityId(params.entityId);
 	if (!pActor)
 		return true;
@@ -865,6 +875,7 @@ IMPLEMENT_RMI(CGameRules, SvRequestSpectatorMode)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetTeam)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetTeam);
 	if (!params.entityId) // ignore these for now
 		return true;
 
@@ -913,6 +924,7 @@ IMPLEMENT_RMI(CGameRules, ClSetTeam)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClTextMessage)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClTextMessage);
 	OnTextMessage((ETextMessageType)params.type, params.msg.c_str(), 
 		params.params[0].empty()?0:params.params[0].c_str(),
 		params.params[1].empty()?0:params.params[1].c_str(),
@@ -926,6 +938,7 @@ IMPLEMENT_RMI(CGameRules, ClTextMessage)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, SvRequestSimpleHit)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvRequestSimpleHit);
 	ServerSimpleHit(params);
 
 	return true;
@@ -934,6 +947,7 @@ IMPLEMENT_RMI(CGameRules, SvRequestSimpleHit)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, SvRequestHit)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvRequestHit);
 	HitInfo info(params);
 	info.remote=true;
 
@@ -945,6 +959,7 @@ IMPLEMENT_RMI(CGameRules, SvRequestHit)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClExplosion)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClExplosion);
 	ClientExplosion(params);
 
 	return true;
@@ -953,6 +968,7 @@ IMPLEMENT_RMI(CGameRules, ClExplosion)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClFreezeEntity)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClFreezeEntity);
 	//IEntity *pEntity=gEnv->pEntitySystem->GetEntity(params.entityId);
 
 	//CryLogAlways("ClFreezeEntity: %s %s", pEntity?pEntity->GetName():"<<null>>", params.freeze?"true":"false");
@@ -965,6 +981,7 @@ IMPLEMENT_RMI(CGameRules, ClFreezeEntity)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClShatterEntity)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClShatterEntity);
 	ShatterEntity(params.entityId, params.pos, params.impulse);
 
 	return true;
@@ -973,6 +990,7 @@ IMPLEMENT_RMI(CGameRules, ClShatterEntity)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetGameTime)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetGameTime);
 	m_endTime = params.endTime;
 
 	return true;
@@ -981,6 +999,7 @@ IMPLEMENT_RMI(CGameRules, ClSetGameTime)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetRoundTime)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetRoundTime);
 	m_roundEndTime = params.endTime;
 
 	return true;
@@ -989,6 +1008,7 @@ IMPLEMENT_RMI(CGameRules, ClSetRoundTime)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetPreRoundTime)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetPreRoundTime);
 	m_preRoundEndTime = params.endTime;
 
 	return true;
@@ -997,6 +1017,7 @@ IMPLEMENT_RMI(CGameRules, ClSetPreRoundTime)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetReviveCycleTime)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetReviveCycleTime);
 	m_reviveCycleEndTime = params.endTime;
 
 	return true;
@@ -1005,6 +1026,7 @@ IMPLEMENT_RMI(CGameRules, ClSetReviveCycleTime)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetGameStartTimer)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetGameStartTimer);
 	m_gameStartTime = params.endTime;
 
 	return true;
@@ -1013,6 +1035,7 @@ IMPLEMENT_RMI(CGameRules, ClSetGameStartTimer)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClTaggedEntity)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClTaggedEntity);
 	if (!params.entityId)
 		return true;
 
@@ -1032,12 +1055,14 @@ IMPLEMENT_RMI(CGameRules, ClTaggedEntity)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClTempRadarEntity)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClTempRadarEntity);
 	return true;
 }
 
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClAddSpawnGroup)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClAddSpawnGroup);
 	AddSpawnGroup(params.entityId);
 
 	return true;
@@ -1046,6 +1071,7 @@ IMPLEMENT_RMI(CGameRules, ClAddSpawnGroup)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClRemoveSpawnGroup)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClRemoveSpawnGroup);
 	RemoveSpawnGroup(params.entityId);
 
 	return true;
@@ -1054,6 +1080,7 @@ IMPLEMENT_RMI(CGameRules, ClRemoveSpawnGroup)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClAddMinimapEntity)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClAddMinimapEntity);
 	AddMinimapEntity(params.entityId, params.type, params.lifetime);
 
 	return true;
@@ -1062,6 +1089,7 @@ IMPLEMENT_RMI(CGameRules, ClAddMinimapEntity)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClRemoveMinimapEntity)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClRemoveMinimapEntity);
 	RemoveMinimapEntity(params.entityId);
 
 	return true;
@@ -1070,6 +1098,7 @@ IMPLEMENT_RMI(CGameRules, ClRemoveMinimapEntity)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClResetMinimap)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClResetMinimap);
 	ResetMinimap();
 
 	return true;
@@ -1079,36 +1108,42 @@ IMPLEMENT_RMI(CGameRules, ClResetMinimap)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetObjective)
 {	
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetObjective);
 	return true;
 }
 
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetObjectiveStatus)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetObjectiveStatus);
 	return true;
 }
 
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClSetObjectiveEntity)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClSetObjectiveEntity);
 	return true;
 }
 
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClResetObjectives)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClResetObjectives);
 	return true;
 }
 
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClHitIndicator)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClHitIndicator);
 	return true;
 }
 
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CGameRules, ClDamageIndicator)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClDamageIndicator);
 	Vec3 dir(ZERO);
 	bool vehicle=false;
 
@@ -1129,6 +1164,7 @@ IMPLEMENT_RMI(CGameRules, ClDamageIndicator)
 
 IMPLEMENT_RMI(CGameRules, SvVote)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvVote);
 	CActor* pActor = GetActorByChannelId(m_pGameFramework->GetGameChannelId(pNetChannel));
 	if(pActor)
 		Vote(pActor, true);
@@ -1137,6 +1173,7 @@ IMPLEMENT_RMI(CGameRules, SvVote)
 
 IMPLEMENT_RMI(CGameRules, SvVoteNo)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvVoteNo);
 	CActor* pActor = GetActorByChannelId(m_pGameFramework->GetGameChannelId(pNetChannel));
 	if(pActor)
 		Vote(pActor, false);
@@ -1145,6 +1182,7 @@ IMPLEMENT_RMI(CGameRules, SvVoteNo)
 
 IMPLEMENT_RMI(CGameRules, SvStartVoting)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, SvStartVoting);
   CActor* pActor = GetActorByChannelId(m_pGameFramework->GetGameChannelId(pNetChannel));
   if(pActor)
     StartVoting(pActor,params.vote_type,params.entityId,params.param);
@@ -1153,12 +1191,14 @@ IMPLEMENT_RMI(CGameRules, SvStartVoting)
 
 IMPLEMENT_RMI(CGameRules, ClVotingStatus)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClVotingStatus);
 	return true;
 }
 
 
 IMPLEMENT_RMI(CGameRules, ClEnteredGame)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClEnteredGame);
 	if(!gEnv->bServer && m_pGameFramework->GetClientActor())
 	{
 		CActor* pActor = GetActorByChannelId(m_pGameFramework->GetClientActor()->GetChannelId());
@@ -1176,12 +1216,14 @@ IMPLEMENT_RMI(CGameRules, ClEnteredGame)
 
 IMPLEMENT_RMI(CGameRules, ClPlayerJoined)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClPlayerJoined);
 	NOTIFY_UI_MP( PlayerJoined(params.entityId, params.name) );
 	return true;
 }
 
 IMPLEMENT_RMI(CGameRules, ClPlayerLeft)
 {
+	GAME_NET_PROFILE_RMI(CGameRules, ClPlayerLeft);
 	NOTIFY_UI_MP( PlayerLeft(params.entityId, params.name) );
 	return true;
 }
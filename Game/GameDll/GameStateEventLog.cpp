@@ -0,0 +1,217 @@
+////////////////////////////////////////////////////////////////////////////
+//
+//  Crytek Engine Source File.
+//  Copyright (C), Crytek Studios, 2002.
+// -------------------------------------------------------------------------
+//  File name:   GameStateEventLog.cpp
+//  Version:     v1.00
+//  Compilers:   Visual Studio.NET
+//  Description: Binary gameplay event log used by CGameStateRecorder
+// -------------------------------------------------------------------------
+//  History:
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "StdAfx.h"
+#include "GameStateEventLog.h"
+
+////////////////////////////////////////////////////////////////////////////
+CGameStateEventLog::CGameStateEventLog()
+: m_writeIdx(0)
+, m_readIdx(0)
+, m_bQuit(false)
+, m_bLaunched(false)
+, m_pFile(NULL)
+, m_recordCount(0)
+, m_droppedCount(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+CGameStateEventLog::~CGameStateEventLog()
+{
+	Close();
+}
+
+////////////////////////////////////////////////////////////////////////////
+bool CGameStateEventLog::Open(const char* fileName)
+{
+	Close();
+
+	m_pFile = gEnv->pCryPak->FOpen(fileName, "wb");
+	if (!m_pFile)
+	{
+		GameWarning("GameStateEventLog: unable to open '%s' for writing", fileName);
+		return false;
+	}
+
+	m_writeIdx = 0;
+	m_readIdx = 0;
+	m_recordCount = 0;
+	m_droppedCount = 0;
+	m_bQuit = false;
+	m_classIds.clear();
+	m_classNames.clear();
+
+	// placeholder, rewritten with the final counts on Close()
+	WriteHeader();
+
+	m_dataReady.Reset();
+	Start();
+	m_bLaunched = true;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateEventLog::Close()
+{
+	if (!m_pFile)
+		return;
+
+	// the thread may not be running yet, but it will be by the time it's joined
+	if (m_bLaunched)
+	{
+		m_bQuit = true;
+		m_dataReady.Set();
+		WaitForThread();
+		Stop();
+		m_bLaunched = false;
+	}
+
+	// anything appended after the thread's last pass
+	Flush();
+
+	const int nameCount = m_classNames.size();
+	for (int i = 0; i < nameCount; ++i)
+	{
+		const string& name = m_classNames[i];
+		uint16 length = (uint16)name.length();
+		gEnv->pCryPak->FWrite(&length, sizeof(length), 1, m_pFile);
+		gEnv->pCryPak->FWrite(name.c_str(), 1, length, m_pFile);
+	}
+
+	gEnv->pCryPak->FSeek(m_pFile, 0, SEEK_SET);
+	WriteHeader();
+
+	gEnv->pCryPak->FClose(m_pFile);
+	m_pFile = NULL;
+
+	CryLog("GameStateEventLog: %u records written, %u dropped", m_recordCount, m_droppedCount);
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateEventLog::WriteHeader()
+{
+	SGameStateEventLogHeader header;
+	header.magic = SGameStateEventLogHeader::eMagic;
+	header.version = SGameStateEventLogHeader::eVersion;
+	header.recordSize = sizeof(SGameStateEventRecord);
+	header.recordCount = m_recordCount;
+	header.nameCount = m_classNames.size();
+	header.droppedCount = m_droppedCount;
+
+	gEnv->pCryPak->FWrite(&header, sizeof(header), 1, m_pFile);
+}
+
+////////////////////////////////////////////////////////////////////////////
+uint16 CGameStateEventLog::GetClassId(const char* className)
+{
+	if (!className || !className[0])
+		return eInvalidClassId;
+
+	TClassIdMap::const_iterator it = m_classIds.find(CONST_TEMP_STRING(className));
+	if (it != m_classIds.end())
+		return it->second;
+
+	if (m_classNames.size() >= eInvalidClassId)
+		return eInvalidClassId;
+
+	uint16 classId = (uint16)m_classNames.size();
+	m_classNames.push_back(className);
+	m_classIds.insert(TClassIdMap::value_type(m_classNames.back(), classId));
+
+	return classId;
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateEventLog::Append(int frame, EntityId entityId, uint8 eventType, const char* className, float value)
+{
+	if (!m_pFile)
+		return;
+
+	const uint32 writeIdx = m_writeIdx;
+	const uint32 pending = writeIdx - m_readIdx;
+	if (pending >= eRingSize)
+	{
+		// the flush thread can't keep up, rather lose a record than stall the frame
+		++m_droppedCount;
+		return;
+	}
+
+	SGameStateEventRecord& record = m_ring[writeIdx & eRingMask];
+	record.frame = frame;
+	record.entityId = entityId;
+	record.classId = GetClassId(className);
+	record.eventType = eventType;
+	record.padding = 0;
+	record.value = value;
+
+	MEMORY_RW_REORDERING_BARRIER;
+	m_writeIdx = writeIdx + 1;
+
+	if (pending + 1 == eFlushThreshold)
+		m_dataReady.Set();
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateEventLog::Flush()
+{
+	const uint32 readIdx = m_readIdx;
+	const uint32 writeIdx = m_writeIdx;
+	MEMORY_RW_REORDERING_BARRIER;
+
+	uint32 count = writeIdx - readIdx;
+	if (!count)
+		return;
+
+	// the pending range can wrap around the end of the ring
+	const uint32 start = readIdx & eRingMask;
+	const uint32 firstChunk = min(count, (uint32)eRingSize - start);
+	gEnv->pCryPak->FWrite(&m_ring[start], sizeof(SGameStateEventRecord), firstChunk, m_pFile);
+	if (firstChunk < count)
+		gEnv->pCryPak->FWrite(&m_ring[0], sizeof(SGameStateEventRecord), count - firstChunk, m_pFile);
+
+	m_recordCount += count;
+
+	MEMORY_RW_REORDERING_BARRIER;
+	m_readIdx = writeIdx;
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateEventLog::Run()
+{
+	CryThreadSetName(-1, "GameStateEventLog");
+
+	while (!m_bQuit)
+	{
+		m_dataReady.Wait(100);
+		m_dataReady.Reset();
+		Flush();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateEventLog::Cancel()
+{
+	m_bQuit = true;
+	m_dataReady.Set();
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateEventLog::GetMemoryStatistics(ICrySizer* s) const
+{
+	s->Add(*this);
+	s->AddObject(m_classIds);
+	s->AddContainer(m_classNames);
+}
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////
+//
+//  Crytek Engine Source File.
+//  Copyright (C), Crytek Studios, 2002.
+// -------------------------------------------------------------------------
+//  File name:   GameStateEventLog.h
+//  Version:     v1.00
+//  Compilers:   Visual Studio.NET
+//  Description: Binary gameplay event log used by CGameStateRecorder.
+//							 Fixed size records are appended to a single producer / single
+//							 consumer ring buffer on the main thread and flushed to disk
+//							 by a background thread. Validation runs offline on the file.
+//
+//							 File layout:
+//								SGameStateEventLogHeader
+//								SGameStateEventRecord[header.recordCount]
+//								header.nameCount x { uint16 length; char name[length]; }
+// -------------------------------------------------------------------------
+//  History:
+//
+////////////////////////////////////////////////////////////////////////////
+#ifndef __GAMESTATEEVENTLOG_H__
+#define __GAMESTATEEVENTLOG_H__
+
+#pragma once
+
+#include <CryThread.h>
+
+struct SGameStateEventLogHeader
+{
+	enum
+	{
+		eMagic = 0x4C455347,	// 'GSEL'
+		eVersion = 1,
+	};
+
+	uint32 magic;
+	uint32 version;
+	uint32 recordSize;
+	uint32 recordCount;
+	uint32 nameCount;
+	uint32 droppedCount;
+};
+
+struct SGameStateEventRecord
+{
+	int32			frame;
+	EntityId	entityId;
+	uint16		classId;		// index into the name table, 0xffff if none
+	uint8			eventType;
+	uint8			padding;
+	float			value;
+};
+
+class CGameStateEventLog : public CrySimpleThread<>
+{
+public:
+	enum { eInvalidClassId = 0xffff };
+
+	CGameStateEventLog();
+	virtual ~CGameStateEventLog();
+
+	bool	Open(const char* fileName);
+	void	Close();
+	bool	IsOpen() const { return m_pFile != NULL; }
+
+	// main thread only
+	void	Append(int frame, EntityId entityId, uint8 eventType, const char* className, float value);
+	uint16 GetClassId(const char* className);
+
+	uint32 GetRecordCount() const { return m_recordCount; }
+	uint32 GetDroppedCount() const { return m_droppedCount; }
+
+	void	GetMemoryStatistics(ICrySizer* s) const;
+
+	// CrySimpleThread
+	virtual void Run();
+	virtual void Cancel();
+
+private:
+	enum
+	{
+		eRingSize = 8192,								// must be a power of two
+		eRingMask = eRingSize - 1,
+		eFlushThreshold = eRingSize / 4,
+	};
+
+	typedef stl::hash_map<string, uint16, stl::hash_strcmp<string> > TClassIdMap;
+	typedef std::vector<string> TClassNames;
+
+	void	Flush();
+	void	WriteHeader();
+
+	SGameStateEventRecord	m_ring[eRingSize];
+	volatile uint32				m_writeIdx;		// only written by the producer
+	volatile uint32				m_readIdx;		// only written by the flush thread
+	volatile bool					m_bQuit;
+	bool									m_bLaunched;	// set on Start(), IsStarted() only turns true once the thread runs
+	CryEvent							m_dataReady;
+
+	FILE*									m_pFile;
+	uint32								m_recordCount;
+	uint32								m_droppedCount;
+
+	TClassIdMap						m_classIds;
+	TClassNames						m_classNames;
+};
+
+#endif
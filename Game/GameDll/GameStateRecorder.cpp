@@ -19,6 +19,7 @@
 #include "IGameFramework.h"
 #include "IActorSystem.h"
 #include "GameStateRecorder.h"
+#include "GameStateEventLog.h"
 #include "CryAction.h"
 #include "Player.h"
 #include "Item.h"
@@ -75,10 +76,12 @@ CGameStateRecorder::CGameStateRecorder()
 	m_bLogWarning = true;
 	m_currentFrame = 0;
 	m_pSingleActor = NULL;
+	m_pEventLog = NULL;
 	//m_pRecordGameEventFtor = new RecordGameEventFtor(this);
 	m_demo_actorInfo = REGISTER_STRING( "demo_actor_info","player",0,"name of actor which game state info is displayed" );
 	m_demo_actorFilter = REGISTER_STRING( "demo_actor_filter","player",0,"name of actor which game state is recorded ('player','all',<entity name>" );
 	REGISTER_CVAR2( "demo_force_game_state",&m_demo_forceGameState,2,0,"Forces game state values into game while playing timedemo: only health and suit energy (1) or all (2)" );
+	REGISTER_CVAR2( "demo_game_state_binary_log",&m_demo_binaryLog,0,0,"When recording, appends game state events to a binary log (TestResults/GameStateEvents.bin) for offline validation instead of tracking them in game" );
 
 }
 
@@ -98,7 +101,10 @@ void CGameStateRecorder::Release()
 		pConsole->UnregisterVariable( "demo_force_game_state", true );
 		pConsole->UnregisterVariable( "demo_actor_info", true );
 		pConsole->UnregisterVariable( "demo_actor_filter", true );
+		pConsole->UnregisterVariable( "demo_game_state_binary_log", true );
 	}
+	CloseEventLog();
+	SAFE_DELETE(m_pEventLog);
 	delete this;
 }
 
@@ -115,6 +121,9 @@ void CGameStateRecorder::Enable(bool bEnable, bool bRecording)
 	{
 		gEnv->pGame->GetIGameFramework()->GetIGameplayRecorder()->RegisterListener(this);
 
+		if(m_demo_binaryLog)
+			OpenEventLog();
+
 		//CActor *pActor = static_cast<CActor *>(gEnv->pGame->GetIGameFramework()->GetClientActor());
 		//if(pActor && !pActor->GetSpectatorMode() && pActor->IsPlayer() && ((CPlayer*)pActor)->GetNanoSuit())
 			//((CPlayer*)pActor)->GetNanoSuit()->AddListener(this);
@@ -124,6 +133,8 @@ void CGameStateRecorder::Enable(bool bEnable, bool bRecording)
 	{
 		gEnv->pGame->GetIGameFramework()->GetIGameplayRecorder()->UnregisterListener(this);
 
+		CloseEventLog();
+
 		//CActor *pActor = static_cast<CActor *>(gEnv->pGame->GetIGameFramework()->GetClientActor());
 		//if(pActor && !pActor->GetSpectatorMode() && pActor->IsPlayer() && ((CPlayer*)pActor)->GetNanoSuit())
 			//((CPlayer*)pActor)->GetNanoSuit()->RemoveListener(this);
@@ -133,6 +144,35 @@ void CGameStateRecorder::Enable(bool bEnable, bool bRecording)
 		StartSession();
 }
 
+////////////////////////////////////////////////////////////////////////////
+void CGameStateRecorder::OpenEventLog()
+{
+	if(!m_pEventLog)
+		m_pEventLog = new CGameStateEventLog();
+
+	m_pEventLog->Open("%USER%/TestResults/GameStateEvents.bin");
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateRecorder::CloseEventLog()
+{
+	if(m_pEventLog)
+		m_pEventLog->Close();
+}
+
+////////////////////////////////////////////////////////////////////////////
+bool CGameStateRecorder::IsEventLogActive() const
+{
+	return m_bRecording && m_pEventLog && m_pEventLog->IsOpen();
+}
+
+////////////////////////////////////////////////////////////////////////////
+void CGameStateRecorder::LogBinaryEvent(IEntity *pEntity, const GameplayEvent &event, const char* className)
+{
+	const int frame = gEnv->pRenderer ? gEnv->pRenderer->GetFrameID(false) : 0;
+	m_pEventLog->Append(frame, pEntity->GetId(), event.event, className, event.value);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////
 void CGameStateRecorder::AddActorToStats(const CActor* pActor)
@@ -815,6 +855,7 @@ void CGameStateRecorder::OnGameplayEvent(IEntity *pEntity, const GameplayEvent &
 		GameWarning("TimeDemo:GameState::OnGamePlayEvent: Entity not found");
 		return;
 	}
+
 	CActor *pActor = (CActor*)(gEnv->pGame->GetIGameFramework()->GetIActorSystem()->GetActor(id));
 	if(!pActor)
 	{
@@ -827,6 +868,32 @@ void CGameStateRecorder::OnGameplayEvent(IEntity *pEntity, const GameplayEvent &
 	uint8 eType = event.event;
 
 	bool bPlayer = (pActor->IsPlayer() && m_mode);
+
+	if(IsEventLogActive())
+	{
+		// binary mode: no inventory book-keeping or name matching here, the recorded
+		// stream is validated offline. Listeners still get every filtered event
+		if(bPlayer || m_mode==GPM_AllActors)
+		{
+			const char* className = event.description;
+			switch(eType)
+			{
+				case eGE_ItemPickedUp:
+				case eGE_ItemDropped:
+				case eGE_ItemSelected:
+				case eGE_WeaponFireModeChanged:
+				case eGE_EntityGrabbed:
+					if(IEntity* pExtraEntity = gEnv->pEntitySystem->GetEntity(EntityId(event.extra)))
+						className = pExtraEntity->GetClass()->GetName();
+					break;
+			}
+			LogBinaryEvent(pEntity,event,className);
+
+			event2.description = className;
+			SendGamePlayEvent(pEntity,event2);
+		}
+		return;
+	}
 	if(bPlayer || m_mode==GPM_AllActors)
 	{
 		//items
@@ -1009,7 +1076,9 @@ void CGameStateRecorder::SendGamePlayEvent(IEntity *pEntity, const GameplayEvent
 	for(TListeners::iterator it = m_listeners.begin(), itEnd = m_listeners.end(); it!=itEnd; ++it)
 		(*it)->OnGameplayEvent(pEntity,event);
 
-	OnRecordedGameplayEvent(pEntity,event,0,true); //updates actor game state during recording
+	// the binary log records the event itself in OnGameplayEvent
+	if(!IsEventLogActive())
+		OnRecordedGameplayEvent(pEntity,event,0,true); //updates actor game state during recording
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -1019,6 +1088,8 @@ void CGameStateRecorder::GetMemoryStatistics(ICrySizer * s)
 	s->Add(*this);
 	s->AddContainer(m_listeners);
 	s->AddContainer(m_GameStates);
+	if(m_pEventLog)
+		m_pEventLog->GetMemoryStatistics(s);
 }
 
 ////////////////////////////////////////////////////////////////////////////
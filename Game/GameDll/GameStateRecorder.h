@@ -25,6 +25,8 @@
 #include "Actor.h"
 #include "ITestSystem.h"
 
+class CGameStateEventLog;
+
 #define MAX_FIRE_MODES 10
 #define TItemName const char*
 /*
@@ -194,6 +196,11 @@ private:
 	void AddActorToStats(const CActor* pActor);
 	void StartSession();
 
+	void OpenEventLog();
+	void CloseEventLog();
+	bool IsEventLogActive() const;
+	void LogBinaryEvent(IEntity *pEntity, const GameplayEvent &event, const char* className);
+
 	/*template <class EventHandlerFunc>*/ void CheckInventory(CActor* pActor, IItem *pItem);//, EventHandlerFunc eventHandler);
 
 	typedef std::vector<IGameplayListener*> TListeners;
@@ -219,7 +226,10 @@ private:
 	int m_demo_forceGameState;
 	ICVar* m_demo_actorInfo;
 	ICVar* m_demo_actorFilter;
+	int m_demo_binaryLog;
 	bool m_bEnable;
+
+	CGameStateEventLog* m_pEventLog; // binary recording mode, see demo_game_state_binary_log
 };
 
 #endif
@@ -11,27 +11,49 @@ History:
 #include "StdAfx.h"
 
 #include "ColorGradientManager.h"
+#include "GameCVars.h"
 
 namespace Graphics
 {
 	CColorGradientManager::CColorGradientManager()
+	: m_chartUseCounter(0)
 	{
 	}
 
+	CColorGradientManager::~CColorGradientManager()
+	{
+		Reset();
+	}
+
 	void CColorGradientManager::Reset()
 	{
 		stl::free_container(m_colorGradientsToLoad);
+		stl::free_container(m_currentGradients);
+
+		if (m_charts.empty())
+		{
+			return;
+		}
+
+		GetColorGradingController().SetLayers(0, 0);
 
-		for (std::vector<LoadedColorGradient>::iterator it = m_currentGradients.begin(), itEnd = m_currentGradients.end(); it != itEnd; ++ it)
+		for (TCharts::iterator it = m_charts.begin(), itEnd = m_charts.end(); it != itEnd; ++ it)
 		{
-			LoadedColorGradient& cg = *it;
-			if (cg.m_layer.m_texID >= 0)
+			SChart& chart = *it;
+			if (chart.pStream)
+			{
+				// clear first, aborting may call back into StreamOnComplete
+				IReadStreamPtr pStream = chart.pStream;
+				chart.pStream = NULL;
+				pStream->Abort();
+			}
+			if (chart.texID >= 0)
 			{
-				GetColorGradingController().UnloadColorChart(cg.m_layer.m_texID);
+				GetColorGradingController().UnloadColorChart(chart.texID);
 			}
 		}
 
-		stl::free_container(m_currentGradients);
+		stl::free_container(m_charts);
 	}
 
 	void CColorGradientManager::Serialize(TSerialize serializer)
@@ -79,7 +101,8 @@ namespace Graphics
 					serializer.Value("FilePath", filePath);
 					serializer.Value("BlendAmount", blendAmount);
 					serializer.Value("FadeInTime", fadeInTimeInSeconds);
-					const int textureID = GetColorGradingController().LoadColorChart(filePath);
+					// loading a save may block, the chart is needed right away
+					const int textureID = AcquireChart(RequestChart(filePath));
 					LoadedColorGradient gradient(filePath, SColorChartLayer(textureID, blendAmount), fadeInTimeInSeconds);
 
 					// Optional
@@ -102,14 +125,23 @@ namespace Graphics
 			m_currentGradients[currentGradientIndex].FreezeMaximumBlendAmount();
 		}
 
+		RequestChart(filePath);
+
 		m_colorGradientsToLoad.push_back(LoadingColorGradient(filePath, fadeInTimeInSeconds));
 	}
 
+	void CColorGradientManager::PrefetchColorGradient(const string& filePath)
+	{
+		const int chartIndex = RequestChart(filePath);
+		m_charts[chartIndex].lastUse = ++m_chartUseCounter;
+	}
+
 	void CColorGradientManager::UpdateForThisFrame(const float frameTimeInSeconds)
 	{
 		RemoveZeroWeightedLayers();
 		
 		LoadGradients();
+		LoadPrefetchedCharts();
 
 		FadeInLastLayer(frameTimeInSeconds);
 		FadeOutCurrentLayers();
@@ -150,7 +182,7 @@ namespace Graphics
 		{
 			if (currentGradient->m_layer.m_blendAmount == 0.0f)
 			{
-				GetColorGradingController().UnloadColorChart(currentGradient->m_layer.m_texID);
+				ReleaseChart(currentGradient->m_layer.m_texID);
 
 				currentGradient = m_currentGradients.erase(currentGradient);
 			}
@@ -179,16 +211,195 @@ namespace Graphics
 
 	void CColorGradientManager::LoadGradients()
 	{
+		// gradients start in trigger order, a chart still streaming holds back the ones queued after it
 		const unsigned int numGradientsToLoad = (int) m_colorGradientsToLoad.size();
-		m_currentGradients.reserve(numGradientsToLoad +  m_currentGradients.size());
-		for (unsigned int index = 0; index < numGradientsToLoad; ++index)
+		unsigned int numLoaded = 0;
+		for (; numLoaded < numGradientsToLoad; ++numLoaded)
+		{
+			const LoadingColorGradient& gradient = m_colorGradientsToLoad[numLoaded];
+
+			const int chartIndex = RequestChart(gradient.m_filePath);
+			if (!IsChartResident(chartIndex))
+			{
+				break;
+			}
+
+			const int textureID = AcquireChart(chartIndex);
+			m_currentGradients.push_back(LoadedColorGradient(gradient.m_filePath, SColorChartLayer(textureID, 1.0f), gradient.m_fadeInTimeInSeconds));
+		}
+
+		m_colorGradientsToLoad.erase(m_colorGradientsToLoad.begin(), m_colorGradientsToLoad.begin() + numLoaded);
+	}
+
+	void CColorGradientManager::LoadPrefetchedCharts()
+	{
+		// one texture creation per frame for charts nobody is waiting on yet
+		for (TCharts::iterator it = m_charts.begin(), itEnd = m_charts.end(); it != itEnd; ++ it)
+		{
+			SChart& chart = *it;
+			if (chart.state == eCS_Streamed)
+			{
+				chart.texID = GetColorGradingController().LoadColorChart(chart.filePath.c_str());
+				chart.state = eCS_Loaded;
+				break;
+			}
+		}
+	}
+
+	int CColorGradientManager::FindChart(const string& filePath) const
+	{
+		const int numCharts = (int)m_charts.size();
+		for (int i = 0; i < numCharts; ++i)
+		{
+			if (!stricmp(m_charts[i].filePath.c_str(), filePath.c_str()))
+			{
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	int CColorGradientManager::RequestChart(const string& filePath)
+	{
+		const int existing = FindChart(filePath);
+		if (existing >= 0)
+		{
+			return existing;
+		}
+
+		const int chartIndex = (int)m_charts.size();
+		m_charts.push_back(SChart(filePath));
+
+		// read the file ahead so the texture creation doesn't wait on the disk
+		StreamReadParams params;
+		params.ePriority = estpUrgent;
+
+		IReadStreamPtr pStream = gEnv->pSystem->GetStreamEngine()->StartRead(eStreamTaskTypeTexture, filePath.c_str(), this, &params);
+
+		// the read may have completed inside StartRead already
+		SChart& chart = m_charts[chartIndex];
+		if (chart.state == eCS_Streaming)
+		{
+			if (pStream)
+			{
+				chart.pStream = pStream;
+			}
+			else
+			{
+				chart.state = eCS_Streamed;
+			}
+		}
+
+		return chartIndex;
+	}
+
+	bool CColorGradientManager::IsChartResident(int chartIndex) const
+	{
+		return m_charts[chartIndex].state != eCS_Streaming;
+	}
+
+	int CColorGradientManager::AcquireChart(int chartIndex)
+	{
+		SChart& chart = m_charts[chartIndex];
+
+		if (chart.state != eCS_Loaded)
+		{
+			if (chart.pStream)
+			{
+				IReadStreamPtr pStream = chart.pStream;
+				chart.pStream = NULL;
+				pStream->Abort();
+			}
+
+			chart.texID = GetColorGradingController().LoadColorChart(chart.filePath.c_str());
+			chart.state = eCS_Loaded;
+		}
+
+		++chart.refCount;
+		chart.lastUse = ++m_chartUseCounter;
+
+		return chart.texID;
+	}
+
+	void CColorGradientManager::ReleaseChart(int texID)
+	{
+		for (TCharts::iterator it = m_charts.begin(), itEnd = m_charts.end(); it != itEnd; ++ it)
 		{
-			LoadedColorGradient loadedGradient = m_colorGradientsToLoad[index].Load(GetColorGradingController());
-			
-			m_currentGradients.push_back(loadedGradient);
+			SChart& chart = *it;
+			if (chart.state == eCS_Loaded && chart.texID == texID && chart.refCount > 0)
+			{
+				--chart.refCount;
+				chart.lastUse = ++m_chartUseCounter;
+				break;
+			}
 		}
 
-		m_colorGradientsToLoad.clear();
+		TrimCache();
+	}
+
+	void CColorGradientManager::TrimCache()
+	{
+		const int maxUnused = max(g_pGameCVars->g_colorGradientCacheSize, 0);
+
+		for (;;)
+		{
+			int numUnused = 0;
+			int oldest = -1;
+
+			const int numCharts = (int)m_charts.size();
+			for (int i = 0; i < numCharts; ++i)
+			{
+				const SChart& chart = m_charts[i];
+				if (chart.refCount == 0 && chart.state == eCS_Loaded && !IsChartQueued(chart))
+				{
+					++numUnused;
+					if (oldest < 0 || chart.lastUse < m_charts[oldest].lastUse)
+					{
+						oldest = i;
+					}
+				}
+			}
+
+			if (numUnused <= maxUnused)
+			{
+				return;
+			}
+
+			if (m_charts[oldest].texID >= 0)
+			{
+				GetColorGradingController().UnloadColorChart(m_charts[oldest].texID);
+			}
+			m_charts.erase(m_charts.begin() + oldest);
+		}
+	}
+
+	bool CColorGradientManager::IsChartQueued(const SChart& chart) const
+	{
+		for (std::vector<LoadingColorGradient>::const_iterator it = m_colorGradientsToLoad.begin(), itEnd = m_colorGradientsToLoad.end(); it != itEnd; ++ it)
+		{
+			if (!stricmp(it->m_filePath.c_str(), chart.filePath.c_str()))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void CColorGradientManager::StreamOnComplete(IReadStream* pStream, unsigned nError)
+	{
+		for (TCharts::iterator it = m_charts.begin(), itEnd = m_charts.end(); it != itEnd; ++ it)
+		{
+			SChart& chart = *it;
+			if (chart.state == eCS_Streaming && (chart.pStream == pStream || !chart.pStream))
+			{
+				// on error the chart is still loaded, the renderer reports the missing file
+				chart.state = eCS_Streamed;
+				chart.pStream = NULL;
+				break;
+			}
+		}
 	}
 
 	IColorGradingController& CColorGradientManager::GetColorGradingController()
@@ -239,11 +450,4 @@ namespace Graphics
 
 	}
 
-	Graphics::CColorGradientManager::LoadedColorGradient CColorGradientManager::LoadingColorGradient::Load(IColorGradingController& colorGradingController) const
-	{
-		const int textureID = colorGradingController.LoadColorChart(m_filePath);
-
-		return LoadedColorGradient(m_filePath, SColorChartLayer(textureID, 1.0f), m_fadeInTimeInSeconds);
-	}
-
 }
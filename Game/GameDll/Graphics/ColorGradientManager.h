@@ -12,31 +12,73 @@ History:
 #define COLOR_GRADIENT_MANAGER_H_INCLUDED
 
 #include <IColorGradingController.h>
+#include <IStreamEngine.h>
 
 
 
 namespace Graphics
 {
-    class CColorGradientManager
+    class CColorGradientManager : public IStreamCallback
     {
     public:
         CColorGradientManager();
+		~CColorGradientManager();
 
+		// The chart is streamed in first, the fade starts once it is resident
 		void TriggerFadingColorGradient(const string& filePath, const float fadeInTimeInSeconds);
+		// Streams and loads the chart into the cache without using it
+		void PrefetchColorGradient(const string& filePath);
 
 		void UpdateForThisFrame(const float frameTimeInSeconds);
 		void Reset();
 		void Serialize(TSerialize serializer);
 
+		// IStreamCallback
+		virtual void StreamOnComplete(IReadStream* pStream, unsigned nError);
+		// ~IStreamCallback
+
 	private:
 		void FadeInLastLayer(const float frameTimeInSeconds);
 		void FadeOutCurrentLayers();
 		void RemoveZeroWeightedLayers();
 		void SetLayersForThisFrame();
 		void LoadGradients();
+		void LoadPrefetchedCharts();
 
 		IColorGradingController& GetColorGradingController();
 
+		// Chart cache, charts are looked up by file path and ref counted by the
+		// layers using them. Unreferenced charts stay loaded up to
+		// g_colorGradientCacheSize, least recently used ones are unloaded first.
+		enum EChartState
+		{
+			eCS_Streaming,
+			eCS_Streamed,
+			eCS_Loaded,
+		};
+
+		struct SChart
+		{
+			SChart(const string& _filePath) : filePath(_filePath), texID(-1), refCount(0), lastUse(0), state(eCS_Streaming) {}
+
+			string filePath;
+			IReadStreamPtr pStream;
+			int texID;
+			int refCount;
+			uint32 lastUse;
+			EChartState state;
+		};
+
+		typedef std::vector<SChart> TCharts;
+
+		int FindChart(const string& filePath) const;
+		int RequestChart(const string& filePath);
+		bool IsChartResident(int chartIndex) const;
+		bool IsChartQueued(const SChart& chart) const;
+		int AcquireChart(int chartIndex);
+		void ReleaseChart(int texID);
+		void TrimCache();
+
 	private:
 
 		class LoadedColorGradient
@@ -62,8 +104,6 @@ namespace Graphics
 		public:
 			LoadingColorGradient(const string& filePath, const float fadeInTimeInSeconds);
 
-			LoadedColorGradient Load(IColorGradingController& colorGradingController) const;
-
 		public:
 			string m_filePath;
 			float m_fadeInTimeInSeconds;
@@ -73,6 +113,8 @@ namespace Graphics
 
 		std::vector<LoadingColorGradient> m_colorGradientsToLoad;
 		std::vector<LoadedColorGradient> m_currentGradients;
+		TCharts m_charts;
+		uint32 m_chartUseCounter;
     };
 }
 
@@ -12,6 +12,7 @@ History:
 *************************************************************************/
 #include "StdAfx.h"
 #include "GunTurret.h"
+#include "GameNetProfiler.h"
 
 #include <Cry_GeoOverlap.h>
 #include <IActorSystem.h>
@@ -137,6 +138,7 @@ void CGunTurret::PostInit(IGameObject * pGameObject)
 //------------------------------------------------------------------------
 bool CGunTurret::NetSerialize( TSerialize ser, EEntityAspects aspect, uint8 profile, int flags )
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	// call base class
 	if (!CWeapon::NetSerialize(ser, aspect, profile, flags))
 		return false;
@@ -14,6 +14,7 @@
 
 #include "StdAfx.h"
 #include "UIEntityDynTexTag.h"
+#include "GameCVars.h"
 
 ////////////////////////////////////////////////////////////////////////////
 void CUIEntityDynTexTag::InitEventSystem()
@@ -76,37 +77,86 @@ void CUIEntityDynTexTag::UpdateView(const SViewParams &viewParams)
 {
 	static const Quat rot90Deg = Quat::CreateRotationXYZ( Ang3(gf_PI * 0.5f, 0, 0) );
 	const Vec3 vSafeVec = viewParams.rotation.GetColumn1();
+	const Vec3 vFaceingPos = viewParams.position - vSafeVec * 1000.f;
 
-	for (TTags::iterator it = m_Tags.begin(); it != m_Tags.end(); ++it)
+	CCamera camera = GetISystem()->GetViewCamera();
+	camera.SetMatrix( Matrix34(viewParams.rotation, viewParams.position) );
+
+	const float maxDist = g_pGameCVars->hud_dynTexTag_maxDistance;
+	const float maxDistSq = maxDist > 0 ? sqr(maxDist) : FLT_MAX;
+
+	// gather: advance the offset lerp of every tag, cull before touching the tag entity
+	m_ViewBatch.Clear();
+	const int numTags = (int)m_Tags.size();
+	for (int i = 0; i < numTags; ++i)
 	{
-		IEntity* pOwner = gEnv->pEntitySystem->GetEntity(it->OwnerId);
-		IEntity* pTagEntity = gEnv->pEntitySystem->GetEntity(it->TagEntityId);
-		if (pOwner && pTagEntity)
+		STagInfo& tag = m_Tags[i];
+		if (!tag.pOwner)
+			tag.pOwner = gEnv->pEntitySystem->GetEntity(tag.OwnerId);
+		if (!tag.pOwner || !tag.pTagEntity)
+			continue;
+
+		const Vec3 offset = tag.fLerp < 1 ? Vec3::CreateLerp(tag.vOffset, tag.vNewOffset, tag.fLerp) : tag.vOffset;
+		if (tag.fLerp < 1)
 		{
-			const Vec3 offset = it->fLerp < 1 ? Vec3::CreateLerp(it->vOffset, it->vNewOffset, it->fLerp) : it->vOffset;
-			const Vec3& vPos = pOwner->GetWorldPos();
-			const Vec3 vFaceingPos = viewParams.position - vSafeVec * 1000.f;
-			const Vec3 vDir = (vPos - vFaceingPos).GetNormalizedSafe(vSafeVec);
-			const Vec3 vOffsetX = vDir.Cross(Vec3Constants<float>::fVec3_OneZ).GetNormalized() * offset.x;
-			const Vec3 vOffsetY = vDir * offset.y;
-			const Vec3 vOffsetZ = Vec3(0, 0, offset.z);
-			const Vec3 vOffset = vOffsetX + vOffsetY + vOffsetZ;
+			assert(tag.fSpeed > 0);
+			tag.fLerp += viewParams.frameTime * tag.fSpeed;
+			tag.vOffset = offset;
+		}
 
+		const Vec3& vPos = tag.pOwner->GetWorldPos();
 
-			const Vec3 vNewPos = vPos + vOffset;
-			const Vec3 vNewDir = (vNewPos - vFaceingPos).GetNormalizedSafe(vSafeVec);
+		const bool bDistanceHidden = vPos.GetSquaredDistance(viewParams.position) > maxDistSq;
+		if (bDistanceHidden != tag.bDistanceHidden)
+		{
+			tag.pTagEntity->Hide(bDistanceHidden);
+			tag.bDistanceHidden = bDistanceHidden;
+		}
+		if (bDistanceHidden)
+			continue;
 
-			const Quat qTagRot = Quat::CreateRotationVDir(vNewDir) * rot90Deg; // rotate 90 degrees around X-Axis
-			pTagEntity->SetPos(vNewPos);
-			pTagEntity->SetRotation(qTagRot);
+		if (!camera.IsSphereVisible_F( Sphere(vPos, offset.GetLength() + 1.f) ))
+			continue;
 
-			if (it->fLerp < 1)
-			{
-				assert(it->fSpeed > 0);
-				it->fLerp += viewParams.frameTime * it->fSpeed;
-				it->vOffset = offset;
-			}
-		}
+		m_ViewBatch.tagIdx.push_back(i);
+		m_ViewBatch.ownerPos.push_back(vPos);
+		m_ViewBatch.offset.push_back(offset);
+	}
+
+	// compute the facing transforms of the visible tags
+	const int numVisible = (int)m_ViewBatch.tagIdx.size();
+	m_ViewBatch.newPos.resize(numVisible);
+	m_ViewBatch.newDir.resize(numVisible);
+	for (int i = 0; i < numVisible; ++i)
+	{
+		const Vec3& vPos = m_ViewBatch.ownerPos[i];
+		const Vec3& offset = m_ViewBatch.offset[i];
+
+		const Vec3 vDir = (vPos - vFaceingPos).GetNormalizedSafe(vSafeVec);
+		const Vec3 vOffsetX = vDir.Cross(Vec3Constants<float>::fVec3_OneZ).GetNormalized() * offset.x;
+		const Vec3 vOffsetY = vDir * offset.y;
+		const Vec3 vOffsetZ = Vec3(0, 0, offset.z);
+
+		const Vec3 vNewPos = vPos + vOffsetX + vOffsetY + vOffsetZ;
+		m_ViewBatch.newPos[i] = vNewPos;
+		m_ViewBatch.newDir[i] = (vNewPos - vFaceingPos).GetNormalizedSafe(vSafeVec);
+	}
+
+	// write back the transforms that changed
+	for (int i = 0; i < numVisible; ++i)
+	{
+		STagInfo& tag = m_Tags[m_ViewBatch.tagIdx[i]];
+
+		const Vec3& vNewPos = m_ViewBatch.newPos[i];
+		const Quat qTagRot = Quat::CreateRotationVDir(m_ViewBatch.newDir[i]) * rot90Deg; // rotate 90 degrees around X-Axis
+
+		if (tag.bWritten && IsEquivalent(vNewPos, tag.vLastPos, 0.001f) && qTagRot.IsEquivalent(tag.qLastRot, 0.0001f))
+			continue;
+
+		tag.pTagEntity->SetPosRotScale(vNewPos, qTagRot, tag.vScale);
+		tag.vLastPos = vNewPos;
+		tag.qLastRot = qTagRot;
+		tag.bWritten = true;
 	}
 }
 
@@ -139,7 +189,19 @@ void CUIEntityDynTexTag::OnInstanceDestroyed( IUIElement* pSender, IUIElement* p
 void CUIEntityDynTexTag::OnEntityEvent( IEntity *pEntity,SEntityEvent &event )
 {
 	assert(event.event == ENTITY_EVENT_DONE);
-	RemoveAllEntityTags( pEntity->GetId(), false );
+
+	// tag entity removed from outside, keep the tag until its owner or the UI removes it
+	const EntityId entityId = pEntity->GetId();
+	for (TTags::iterator it = m_Tags.begin(); it != m_Tags.end(); ++it)
+	{
+		if (it->TagEntityId == entityId)
+		{
+			it->pTagEntity = NULL;
+			return;
+		}
+	}
+
+	RemoveAllEntityTags( entityId, false );
 }
 
 
@@ -178,7 +240,8 @@ void CUIEntityDynTexTag::OnAddTaggedEntity( EntityId entityId, const char* uiEle
 			pElement->RemoveEventListener(this); // first remove to avoid assert if already registered!
 			pElement->AddEventListener(this, "CUIEntityDynTexTag");
 			gEnv->pEntitySystem->AddEntityEventListener(entityId, ENTITY_EVENT_DONE, this);
-			m_Tags.push_back( STagInfo(entityId, pTagEntity->GetId(), idx, offset, pElement->GetInstance((uint)entityId)) );
+			gEnv->pEntitySystem->AddEntityEventListener(pTagEntity->GetId(), ENTITY_EVENT_DONE, this);
+			m_Tags.push_back( STagInfo(entityId, pTagEntity, idx, offset, pElement->GetInstance((uint)entityId)) );
 		}
 	}
 }
@@ -212,9 +275,7 @@ void CUIEntityDynTexTag::OnRemoveTaggedEntity( EntityId entityId, const string&
 	{
 		if (it->OwnerId == entityId && it->Idx == idx)
 		{
-			gEnv->pEntitySystem->RemoveEntity(it->TagEntityId);
-			if (it->pInstance)
-				it->pInstance->DestroyThis();
+			ReleaseTag(*it);
 			m_Tags.erase(it);
 			break;
 		}
@@ -236,9 +297,7 @@ void CUIEntityDynTexTag::RemoveAllEntityTags( EntityId entityId, bool bUnregiste
 	{
 		if (it->OwnerId == entityId)
 		{
-			gEnv->pEntitySystem->RemoveEntity(it->TagEntityId);
-			if (it->pInstance)
-				it->pInstance->DestroyThis();
+			ReleaseTag(*it);
 			it = m_Tags.erase(it);
 		}
 		else
@@ -255,14 +314,21 @@ void CUIEntityDynTexTag::ClearAllTags()
 {
 	for (TTags::const_iterator it = m_Tags.begin(); it != m_Tags.end(); ++it)
 	{
-		gEnv->pEntitySystem->RemoveEntity(it->TagEntityId);
-		if (it->pInstance)
-			it->pInstance->DestroyThis();
+		ReleaseTag(*it);
 		gEnv->pEntitySystem->RemoveEntityEventListener(it->OwnerId, ENTITY_EVENT_DONE, this);
 	}
 	m_Tags.clear();
 }
 
+////////////////////////////////////////////////////////////////////////////
+void CUIEntityDynTexTag::ReleaseTag( const STagInfo& tag )
+{
+	gEnv->pEntitySystem->RemoveEntityEventListener(tag.TagEntityId, ENTITY_EVENT_DONE, this);
+	gEnv->pEntitySystem->RemoveEntity(tag.TagEntityId);
+	if (tag.pInstance)
+		tag.pInstance->DestroyThis();
+}
+
 ////////////////////////////////////////////////////////////////////////////
 bool CUIEntityDynTexTag::HasEntityTag( EntityId entityId ) const
 {
@@ -55,26 +55,53 @@ private:
 	void ClearAllTags();
 	inline bool HasEntityTag( EntityId entityId ) const;
 
+	struct STagInfo;
+	void ReleaseTag( const STagInfo& tag );
+
 private:
 	SUIEventReceiverDispatcher<CUIEntityDynTexTag> s_EventDispatcher;
 	IUIEventSystem* m_pUIOFct;
 
 	struct STagInfo
 	{
-		STagInfo(EntityId ownerId, EntityId tagEntityId, const string& idx, const Vec3& offset, IUIElement* pInst) : OwnerId(ownerId), TagEntityId(tagEntityId), Idx(idx), vOffset(offset), vNewOffset(offset), pInstance(pInst), fLerp(2), fSpeed(0) {}
+		STagInfo(EntityId ownerId, IEntity* pTagEnt, const string& idx, const Vec3& offset, IUIElement* pInst) 
+			: OwnerId(ownerId), TagEntityId(pTagEnt->GetId()), pOwner(gEnv->pEntitySystem->GetEntity(ownerId)), pTagEntity(pTagEnt), Idx(idx), vOffset(offset), vNewOffset(offset), pInstance(pInst), fLerp(2), fSpeed(0)
+			, vLastPos(ZERO), qLastRot(IDENTITY), vScale(pTagEnt->GetScale()), bWritten(false), bDistanceHidden(false) {}
 
 		EntityId OwnerId;
 		EntityId TagEntityId;
+		IEntity* pOwner;      // the tags are removed on its ENTITY_EVENT_DONE
+		IEntity* pTagEntity;  // cleared on ENTITY_EVENT_DONE
 		string Idx;
 		Vec3 vOffset;
 		Vec3 vNewOffset;
 		IUIElement* pInstance;
 		float fLerp;
 		float fSpeed;
+
+		// last transform written to the tag entity
+		Vec3 vLastPos;
+		Quat qLastRot;
+		Vec3 vScale;
+		bool bWritten;
+		bool bDistanceHidden;
 	};
 
 	typedef std::vector< STagInfo > TTags;
 	TTags m_Tags;
+
+	// per view update, one entry per tag that passed the culling
+	struct SViewBatch
+	{
+		void Clear() { tagIdx.clear(); ownerPos.clear(); offset.clear(); newPos.clear(); newDir.clear(); }
+
+		std::vector<int> tagIdx;
+		std::vector<Vec3> ownerPos;
+		std::vector<Vec3> offset;
+		std::vector<Vec3> newPos;
+		std::vector<Vec3> newDir;
+	};
+	SViewBatch m_ViewBatch;
 };
 
 #endif // __UIEntityDynTexTag_H__
@@ -73,15 +73,20 @@ struct CHitDeathReactions::SPredFindValidReaction : public std::unary_function<b
 
 		if (!bSuccess)
 		{
-			if (g_pGameCVars->g_hitDeathReactions_useLuaDefaultFunctions)
+			// the validation tables are only loaded if the lua default functions were on when the profile was created
+			if (g_pGameCVars->g_hitDeathReactions_useLuaDefaultFunctions && validationParams.validationParamsScriptTable)
 			{
 				HSCRIPTFUNCTION validationFunc = NULL;
 				if (m_owner.m_pSelfTable->GetValue(DEFAULT_VALIDATION_FUNCTION, validationFunc))
 				{
-					ScriptTablePtr scriptHitInfo(m_owner.m_pScriptSystem);
-					g_pGame->GetGameRules()->CreateScriptHitInfo(scriptHitInfo, m_hitInfo);
-
-					bSuccess = Script::CallReturn(m_owner.m_pScriptSystem, validationFunc, m_owner.m_pSelfTable, validationParams.validationParamsScriptTable, scriptHitInfo, m_fCausedDamage, bResult);
+					// The script hit info is built once per hit and shared by all the validations
+					if (!m_scriptHitInfo)
+					{
+						m_scriptHitInfo.Create(m_owner.m_pScriptSystem);
+						g_pGame->GetGameRules()->CreateScriptHitInfo(m_scriptHitInfo, m_hitInfo);
+					}
+
+					bSuccess = Script::CallReturn(m_owner.m_pScriptSystem, validationFunc, m_owner.m_pSelfTable, validationParams.validationParamsScriptTable, m_scriptHitInfo, m_fCausedDamage, bResult);
 					m_owner.m_pScriptSystem->ReleaseFunc(validationFunc);
 				}
 				else
@@ -102,6 +107,7 @@ private:
 	const CHitDeathReactions& m_owner;
 	const HitInfo&						m_hitInfo;
 	float											m_fCausedDamage;
+	mutable ScriptTablePtr		m_scriptHitInfo;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -350,12 +356,12 @@ bool CHitDeathReactions::OnHit(const HitInfo& hitInfo, float fCausedDamage/* = 0
 		m_pseudoRandom.seed(gEnv->bNoRandomSeed?0:uSeed);
 
 		// Choose proper hit reaction
-		ReactionsContainer::const_iterator itBestFit = std::find_if(m_pHitReactions->begin(), m_pHitReactions->end(), SPredFindValidReaction(*this, hitInfo, fCausedDamage));
+		const SReactionParams* pBestFit = FindValidReaction(*m_pHitReactions, m_pHitReactionsIndex.get(), hitInfo, fCausedDamage);
 
 		// If found a fit, execute it
-		if (itBestFit != m_pHitReactions->end())
+		if (pBestFit)
 		{
-			bSuccess = StartHitReaction(hitInfo, *itBestFit);
+			bSuccess = StartHitReaction(hitInfo, *pBestFit);
 		}	
 	}
 
@@ -578,10 +584,6 @@ bool CHitDeathReactions::IsValidReaction(const HitInfo& hitInfo, const SReaction
 			return false;
 	}
 
-	// Check probability
-	IF_UNLIKELY ((validationParams.fProbability != 1.0f) && (GetRandomProbability() > validationParams.fProbability))
-		return false;
-
 	// Check stance
 	const SReactionParams::StanceContainer& allowedStances = validationParams.allowedStances;
 	CRY_ASSERT_TRACE(allowedStances.empty() || (m_actor.GetStance() != STANCE_NULL), ("%s's current stance is NULL! This actor state is probably incoherent!", m_actor.GetEntity()->GetName()));
@@ -607,9 +609,60 @@ bool CHitDeathReactions::IsValidReaction(const HitInfo& hitInfo, const SReaction
 	IF_UNLIKELY (validationParams.bAllowOnlyWhenUsingMountedItems && (pActorStats->mountedWeaponID == 0))
 		return false;
 
+	// Check probability. Kept last so only reactions passing every other check consume random numbers, which is
+	// what allows the decision index to discard candidates without changing the random sequence
+	IF_UNLIKELY ((validationParams.fProbability != 1.0f) && (GetRandomProbability() > validationParams.fProbability))
+		return false;
+
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+const SReactionParams* CHitDeathReactions::FindValidReaction(const ReactionsContainer& reactions, const CHitDeathReactionsIndex* pIndex, const HitInfo& hitInfo, float fCausedDamage) const
+{
+	SPredFindValidReaction predFindValidReaction(*this, hitInfo, fCausedDamage);
+
+	// The index prefilters with the C++ validation criteria. With the Lua default functions those criteria aren't the ones
+	// that decide, so every reaction is evaluated in order (entries with a custom validation function are always candidates)
+	if (!pIndex || !pIndex->IsEnabled() || !g_pGameCVars->g_hitDeathReactions_useDecisionIndex || 
+		g_pGameCVars->g_hitDeathReactions_useLuaDefaultFunctions)
+	{
+		ReactionsContainer::const_iterator itBestFit = std::find_if(reactions.begin(), reactions.end(), predFindValidReaction);
+		return (itBestFit != reactions.end()) ? &(*itBestFit) : NULL;
+	}
+
+	CRY_ASSERT(pIndex->GetEntryCount() >= static_cast<int>(reactions.size()));
+
+	// Candidates are the entries whose part, hit type, projectile, weapon and stance criteria accept this hit. Only 
+	// those get fully validated (and only those can end up calling script functions)
+	uint32 candidates[CHitDeathReactionsIndex::eMaxWords];
+	pIndex->GetCandidates(hitInfo, m_actor.GetStance(), candidates);
+
+	const SActorStats* pActorStats = m_actor.GetActorStats();
+	CRY_ASSERT(pActorStats);
+	const float fSpeed = pActorStats->speedFlat;
+
+	for (int iEntry = pIndex->GetNextCandidate(candidates, 0); iEntry >= 0; iEntry = pIndex->GetNextCandidate(candidates, iEntry + 1))
+	{
+		const CHitDeathReactionsIndex::SEntry& entry = pIndex->GetEntry(iEntry);
+		const SReactionParams& reactionParams = reactions[entry.reactionIdx];
+
+		if (entry.validationIdx < 0)
+			return &reactionParams;
+
+		if (!entry.bCustomValidation && 
+			((entry.fMinimumSpeedAllowed > fSpeed) || (fSpeed > entry.fMaximumSpeedAllowed) || 
+			 (entry.fMinimumDamageAllowed > hitInfo.damage) || (hitInfo.damage > entry.fMaximumDamageAllowed)))
+			continue;
+
+		if (predFindValidReaction.EvaluateValidationParams(reactionParams.validationParams[entry.validationIdx], reactionParams))
+			return &reactionParams;
+	}
+
+	return NULL;
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 bool CHitDeathReactions::StartHitReaction(const HitInfo& hitInfo, const SReactionParams& reactionParams)
@@ -660,10 +713,11 @@ bool CHitDeathReactions::StartReaction(EReactionType reactionType, const HitInfo
 	else
 	{
 		const char* szDefaultReactionFnc = (reactionType == eRT_Hit) ? DEFAULT_HIT_REACTION_FUNCTION : DEFAULT_KILL_REACTION_FUNCTION;
-		bSuccess = g_pGameCVars->g_hitDeathReactions_useLuaDefaultFunctions ? Script::CallMethod(m_pSelfTable, szDefaultReactionFnc, reactionParams.reactionScriptTable) : false;
+		const bool bUseLuaDefaultFunction = g_pGameCVars->g_hitDeathReactions_useLuaDefaultFunctions && reactionParams.reactionScriptTable;
+		bSuccess = bUseLuaDefaultFunction ? Script::CallMethod(m_pSelfTable, szDefaultReactionFnc, reactionParams.reactionScriptTable) : false;
 		if (!bSuccess)
 		{
-			CRY_ASSERT_MESSAGE(!g_pGameCVars->g_hitDeathReactions_useLuaDefaultFunctions, "Can't run default hit reaction lua method. Check HitDeathReactions.lua");
+			CRY_ASSERT_MESSAGE(!bUseLuaDefaultFunction, "Can't run default hit reaction lua method. Check HitDeathReactions.lua");
 
 			// Default execution
 			bSuccess = (reactionType == eRT_Hit) ? ExecuteHitReaction(reactionParams) : ExecuteDeathReaction(reactionParams);
@@ -1059,12 +1113,12 @@ bool CHitDeathReactions::OnKill(const HitInfo& hitInfo)
 	m_pseudoRandom.seed(gEnv->bNoRandomSeed?0:uSeed);
 
 	// Choose proper death reaction
-	ReactionsContainer::const_iterator itBestFit = std::find_if(m_pDeathReactions->begin(), m_pDeathReactions->end(), SPredFindValidReaction(*this, hitInfo));
+	const SReactionParams* pBestFit = FindValidReaction(*m_pDeathReactions, m_pDeathReactionsIndex.get(), hitInfo, 0.0f);
 
 	// If found a fit, execute it
-	if (itBestFit != m_pDeathReactions->end())
+	if (pBestFit)
 	{
-		bSuccess = StartDeathReaction(hitInfo, *itBestFit);
+		bSuccess = StartDeathReaction(hitInfo, *pBestFit);
 	}
 	
 	return bSuccess;
@@ -1313,6 +1367,7 @@ bool CHitDeathReactions::ExecuteReactionCommon(const SReactionParams& reactionPa
 		{
 			const SReactionParams::SReactionAnim& reactionAnim = *reactionParams.reactionAnim;
 			int animID = reactionAnim.GetNextReactionAnimId(pAnimSet);
+			g_pGame->GetHitDeathReactionsSystem().OnReactionAnimStarted(m_profileId, animID >= 0);
 			if (animID >= 0)
 			{
 				bSuccess = StartReactionAnimByID(animID, false, 0.1f, 0, reactionAnim.iLayer, reactionAnim.animFlags, reactionAnim.bAdditive ? 1.0f : 0.0f, 1.0f, reactionAnim.bNoAnimCamera);
@@ -1432,7 +1487,7 @@ void CHitDeathReactions::LoadData(SmartScriptTable pSelfTable, bool bForceReload
 
 		// Invalidate the cached profile Id so it gets re-calculated again in HitDeathReactionsSystem
 		m_profileId = INVALID_PROFILE_ID;
-		m_profileId = g_pGame->GetHitDeathReactionsSystem().GetReactionParamsForActor(m_actor, m_pHitReactions, m_pDeathReactions, m_pCollisionReactions, m_pHitDeathReactionsConfig);
+		m_profileId = g_pGame->GetHitDeathReactionsSystem().GetReactionParamsForActor(m_actor, m_pHitReactions, m_pDeathReactions, m_pCollisionReactions, m_pHitDeathReactionsConfig, m_pHitReactionsIndex, m_pDeathReactionsIndex);
 		CRY_ASSERT(m_pHitReactions && m_pDeathReactions && m_pCollisionReactions && m_pHitDeathReactionsConfig);
 	}
 	else
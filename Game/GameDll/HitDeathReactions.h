@@ -13,6 +13,7 @@ History:
 #define __HIT_DEATH_REACTIONS_H
 
 #include "HitDeathReactionsDefs.h"
+#include "HitDeathReactionsIndex.h"
 #include "IntersectionTestQueue.h"
 #include "GameCVars.h"
 #include "Actor.h"										// CActor::KillParams
@@ -177,6 +178,7 @@ private:
 
 	// Private methods
 	bool										OnKill(const HitInfo& hitInfo);
+	const SReactionParams*	FindValidReaction(const ReactionsContainer& reactions, const CHitDeathReactionsIndex* pIndex, const HitInfo& hitInfo, float fCausedDamage) const;
 
 	void										ClearState();
 
@@ -239,6 +241,9 @@ private:
 	ReactionsContainerConstPtr			m_pHitReactions;
 	ReactionsContainerConstPtr			m_pCollisionReactions;
 
+	CHitDeathReactionsIndexConstPtr	m_pHitReactionsIndex;
+	CHitDeathReactionsIndexConstPtr	m_pDeathReactionsIndex;
+
 	SHitDeathReactionsConfigConstPtr	m_pHitDeathReactionsConfig;
 
 	ProfileId												m_profileId; // Cached profile id
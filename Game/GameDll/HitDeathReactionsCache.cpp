@@ -0,0 +1,450 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Binary cache of the hit/death reactions data files
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "HitDeathReactionsCache.h"
+#include "HitDeathReactionsSystem.h"
+
+namespace
+{
+	const uint32 CACHE_FILE_MAGIC = 0x43524448;		// "HDRC", also rejects blobs written with the other byte order
+	const uint32 CACHE_FILE_VERSION = 2;					// bump when SReactionsFileData or the way it's read from script changes
+	const char CACHE_FOLDER[] = "%USER%/HitDeathReactionsCache";
+
+	//////////////////////////////////////////////////////////////////////////
+	class CBlobWriter
+	{
+	public:
+		template <typename T>
+		void Write(const T& value)
+		{
+			const uint8* pValue = reinterpret_cast<const uint8*>(&value);
+			m_data.insert(m_data.end(), pValue, pValue + sizeof(T));
+		}
+
+		template <typename T>
+		void WriteArray(const std::vector<T>& values)
+		{
+			Write(static_cast<uint32>(values.size()));
+			if (!values.empty())
+			{
+				const uint8* pValues = reinterpret_cast<const uint8*>(&values[0]);
+				m_data.insert(m_data.end(), pValues, pValues + sizeof(T) * values.size());
+			}
+		}
+
+		void WriteString(const string& value)
+		{
+			Write(static_cast<uint32>(value.length()));
+			m_data.insert(m_data.end(), value.c_str(), value.c_str() + value.length());
+		}
+
+		void WriteNames(const SReactionsFileData::NameContainer& names)
+		{
+			Write(static_cast<uint32>(names.size()));
+			for (SReactionsFileData::NameContainer::const_iterator it = names.begin(), itEnd = names.end(); it != itEnd; ++it)
+				WriteString(*it);
+		}
+
+		const std::vector<uint8>& GetData() const { return m_data; }
+
+	private:
+		std::vector<uint8>	m_data;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Once a read goes past the end of the blob every following read fails
+	class CBlobReader
+	{
+	public:
+		CBlobReader(const uint8* pData, uint32 size) : m_pData(pData), m_size(size), m_offset(0), m_bOk(true) {}
+
+		template <typename T>
+		bool Read(T& value)
+		{
+			if (!CanRead(sizeof(T)))
+				return false;
+
+			memcpy(&value, m_pData + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+			return true;
+		}
+
+		template <typename T>
+		bool ReadArray(std::vector<T>& values)
+		{
+			uint32 count = 0;
+			if (!Read(count) || !CanRead(count) || !CanRead(count * sizeof(T)))
+				return false;
+
+			values.resize(count);
+			if (count)
+			{
+				memcpy(&values[0], m_pData + m_offset, count * sizeof(T));
+				m_offset += count * sizeof(T);
+			}
+			return true;
+		}
+
+		bool ReadString(string& value)
+		{
+			uint32 length = 0;
+			if (!Read(length) || !CanRead(length))
+				return false;
+
+			value.assign(reinterpret_cast<const char*>(m_pData + m_offset), length);
+			m_offset += length;
+			return true;
+		}
+
+		bool ReadNames(SReactionsFileData::NameContainer& names)
+		{
+			uint32 count = 0;
+			if (!ReadCount(count))
+				return false;
+
+			names.resize(count);
+			for (uint32 i = 0; i < count; ++i)
+				ReadString(names[i]);
+
+			return m_bOk;
+		}
+
+		// element counts are at least one byte each, which bounds the allocations on corrupted blobs
+		bool ReadCount(uint32& count)
+		{
+			return Read(count) && CanRead(count);
+		}
+
+		ILINE bool IsOk() const { return m_bOk; }
+		ILINE bool IsAtEnd() const { return m_bOk && (m_offset == m_size); }
+
+	private:
+		bool CanRead(uint32 bytes)
+		{
+			m_bOk = m_bOk && (bytes <= m_size - m_offset);
+			return m_bOk;
+		}
+
+		const uint8*	m_pData;
+		uint32				m_size;
+		uint32				m_offset;
+		bool					m_bOk;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	void WriteValidation(CBlobWriter& writer, const SReactionsFileData::SValidation& validation)
+	{
+		writer.WriteString(validation.sCustomValidationFunc);
+		writer.Write(validation.fMinimumSpeedAllowed);
+		writer.Write(validation.fMaximumSpeedAllowed);
+		writer.Write(validation.fMinimumDamageAllowed);
+		writer.Write(validation.fMaximumDamageAllowed);
+		writer.Write(validation.fMinimumDistance);
+		writer.Write(validation.fMaximumDistance);
+		writer.Write(validation.fProbability);
+		writer.Write(validation.destructibleEvent);
+		writer.Write(validation.sourceIndex);
+		writer.Write(validation.shotOrigin);
+		writer.Write(validation.movementDir);
+		writer.Write(validation.bAllowOnlyWhenUsingMountedItems);
+		writer.Write(validation.bHasStances);
+		writer.WriteArray(validation.stances);
+		writer.WriteArray(validation.healthThresholds);
+		writer.WriteNames(validation.partNames);
+		writer.WriteNames(validation.hitTypeNames);
+		writer.WriteNames(validation.projectileClassNames);
+		writer.WriteNames(validation.weaponClassNames);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	bool ReadValidation(CBlobReader& reader, SReactionsFileData::SValidation& validation)
+	{
+		reader.ReadString(validation.sCustomValidationFunc);
+		reader.Read(validation.fMinimumSpeedAllowed);
+		reader.Read(validation.fMaximumSpeedAllowed);
+		reader.Read(validation.fMinimumDamageAllowed);
+		reader.Read(validation.fMaximumDamageAllowed);
+		reader.Read(validation.fMinimumDistance);
+		reader.Read(validation.fMaximumDistance);
+		reader.Read(validation.fProbability);
+		reader.Read(validation.destructibleEvent);
+		reader.Read(validation.sourceIndex);
+		reader.Read(validation.shotOrigin);
+		reader.Read(validation.movementDir);
+		reader.Read(validation.bAllowOnlyWhenUsingMountedItems);
+		reader.Read(validation.bHasStances);
+		reader.ReadArray(validation.stances);
+		reader.ReadArray(validation.healthThresholds);
+		reader.ReadNames(validation.partNames);
+		reader.ReadNames(validation.hitTypeNames);
+		reader.ReadNames(validation.projectileClassNames);
+		reader.ReadNames(validation.weaponClassNames);
+
+		return reader.IsOk();
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	void WriteReaction(CBlobWriter& writer, const SReactionsFileData::SReaction& reaction)
+	{
+		writer.Write(static_cast<uint32>(reaction.validations.size()));
+		for (SReactionsFileData::ValidationContainer::const_iterator it = reaction.validations.begin(), itEnd = reaction.validations.end(); it != itEnd; ++it)
+			WriteValidation(writer, *it);
+
+		writer.WriteString(reaction.sCustomExecutionFunc);
+		writer.WriteString(reaction.sCustomAISignal);
+		writer.WriteString(reaction.sAGInputValue);
+		writer.WriteNames(reaction.variationNames);
+		writer.WriteNames(reaction.variationValues);
+		writer.WriteNames(reaction.animNames);
+		writer.Write(reaction.endVelocity);
+		writer.Write(reaction.orientationSnapAngle);
+		writer.Write(reaction.fOverrideTransTimeToAG);
+		writer.Write(reaction.iAnimLayer);
+		writer.Write(reaction.flags);
+		writer.Write(reaction.reactionOnCollision);
+		writer.Write(reaction.bPauseAI);
+		writer.Write(reaction.bAdditive);
+		writer.Write(reaction.bNoAnimCamera);
+		writer.WriteString(reaction.sTableName);
+		writer.Write(reaction.iTableIndex);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	bool ReadReaction(CBlobReader& reader, SReactionsFileData::SReaction& reaction)
+	{
+		uint32 numValidations = 0;
+		if (!reader.ReadCount(numValidations))
+			return false;
+
+		reaction.validations.resize(numValidations);
+		for (uint32 i = 0; i < numValidations; ++i)
+		{
+			if (!ReadValidation(reader, reaction.validations[i]))
+				return false;
+		}
+
+		reader.ReadString(reaction.sCustomExecutionFunc);
+		reader.ReadString(reaction.sCustomAISignal);
+		reader.ReadString(reaction.sAGInputValue);
+		reader.ReadNames(reaction.variationNames);
+		reader.ReadNames(reaction.variationValues);
+		reader.ReadNames(reaction.animNames);
+		reader.Read(reaction.endVelocity);
+		reader.Read(reaction.orientationSnapAngle);
+		reader.Read(reaction.fOverrideTransTimeToAG);
+		reader.Read(reaction.iAnimLayer);
+		reader.Read(reaction.flags);
+		reader.Read(reaction.reactionOnCollision);
+		reader.Read(reaction.bPauseAI);
+		reader.Read(reaction.bAdditive);
+		reader.Read(reaction.bNoAnimCamera);
+		reader.ReadString(reaction.sTableName);
+		reader.Read(reaction.iTableIndex);
+
+		return reader.IsOk() && (reaction.variationNames.size() == reaction.variationValues.size());
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Chains the crc of the file contents to contentHash
+	bool HashFileContents(const char* szFile, uint32& contentHash)
+	{
+		ICryPak* pCryPak = gEnv->pCryPak;
+
+		FILE* pFile = pCryPak->FOpen(szFile, "rb");
+		if (!pFile)
+			return false;
+
+		bool bRead = false;
+
+		const size_t fileSize = pCryPak->FGetSize(pFile);
+		if (fileSize > 0)
+		{
+			std::vector<char> contents(fileSize);
+			if (pCryPak->FReadRawAll(&contents[0], fileSize, pFile) == fileSize)
+			{
+				contentHash = gEnv->pSystem->GetCrc32Gen()->GetCRC32(&contents[0], static_cast<int>(fileSize), contentHash);
+				bRead = true;
+			}
+		}
+
+		pCryPak->FClose(pFile);
+
+		return bRead;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+SReactionsFileData::SValidation::SValidation() : fMinimumSpeedAllowed(0.0f), fMaximumSpeedAllowed(FLT_MAX),
+fMinimumDamageAllowed(0.0f), fMaximumDamageAllowed(FLT_MAX), fMinimumDistance(0.0f), fMaximumDistance(0.0f), fProbability(1.0f),
+destructibleEvent(0), sourceIndex(0), shotOrigin(eCD_Invalid), movementDir(eCD_Invalid), bAllowOnlyWhenUsingMountedItems(false), bHasStances(false)
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+SReactionsFileData::SReaction::SReaction() : endVelocity(ZERO), orientationSnapAngle(0.0f), fOverrideTransTimeToAG(-1.0f), iAnimLayer(0),
+flags(0), reactionOnCollision(NO_COLLISION_REACTION), bPauseAI(true), bAdditive(false), bNoAnimCamera(false), iTableIndex(0)
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void SReactionsFileData::Reset()
+{
+	for (int i = 0; i < eRL_Count; ++i)
+		stl::free_container(reactions[i]);
+
+	config = SHitDeathReactionsConfig();
+	sCollisionBone.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+uint32 CHitDeathReactionsCache::GetContentHash(const char* szReactionsDataFile)
+{
+	// The script table of a data file is built by the lua loader from the data file and its definition file
+	const char* dependencies[] = { HIT_DEATH_REACTIONS_SCRIPT_FILE, REACTIONS_DEFINITION_FILE, szReactionsDataFile };
+
+	uint32 contentHash = gEnv->pSystem->GetCrc32Gen()->GetCRC32(reinterpret_cast<const char*>(&CACHE_FILE_VERSION), sizeof(CACHE_FILE_VERSION), 0xffffffff);
+	for (int i = 0; i < sizeof(dependencies) / sizeof(dependencies[0]); ++i)
+	{
+		if (!HashFileContents(dependencies[i], contentHash))
+		{
+			CHitDeathReactionsSystem::Warning("Couldn't read %s, reactions cache disabled for %s", dependencies[i], szReactionsDataFile);
+			return 0;
+		}
+	}
+
+	// 0 means no hash
+	return contentHash ? contentHash : 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsCache::GetCacheFilePath(const char* szReactionsDataFile, CryPathString& sCacheFilePath)
+{
+	// Data file paths are unified already, their crc is the profile id too
+	sCacheFilePath.Format("%s/%08x.bin", CACHE_FOLDER, gEnv->pSystem->GetCrc32Gen()->GetCRC32(szReactionsDataFile));
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+bool CHitDeathReactionsCache::Load(const char* szReactionsDataFile, uint32 contentHash, SReactionsFileData& data)
+{
+	CryPathString sCacheFilePath;
+	GetCacheFilePath(szReactionsDataFile, sCacheFilePath);
+
+	ICryPak* pCryPak = gEnv->pCryPak;
+
+	FILE* pFile = pCryPak->FOpen(sCacheFilePath.c_str(), "rb");
+	if (!pFile)
+		return false;
+
+	std::vector<uint8> blob(pCryPak->FGetSize(pFile));
+	const bool bRead = !blob.empty() && (pCryPak->FReadRawAll(&blob[0], blob.size(), pFile) == blob.size());
+	pCryPak->FClose(pFile);
+
+	if (!bRead)
+		return false;
+
+	CBlobReader reader(&blob[0], static_cast<uint32>(blob.size()));
+
+	uint32 magic = 0;
+	uint32 version = 0;
+	uint32 blobContentHash = 0;
+	string sBlobDataFile;
+	reader.Read(magic);
+	reader.Read(version);
+	reader.Read(blobContentHash);
+	reader.ReadString(sBlobDataFile);
+
+	// A different content hash means the data file has been edited since the blob was written
+	if (!reader.IsOk() || (magic != CACHE_FILE_MAGIC) || (version != CACHE_FILE_VERSION) ||
+		(blobContentHash != contentHash) || (sBlobDataFile.compare(szReactionsDataFile) != 0))
+		return false;
+
+	data.Reset();
+	for (int i = 0; i < SReactionsFileData::eRL_Count; ++i)
+	{
+		uint32 numReactions = 0;
+		if (!reader.ReadCount(numReactions))
+			break;
+
+		SReactionsFileData::ReactionContainer& reactions = data.reactions[i];
+		reactions.resize(numReactions);
+		for (uint32 j = 0; (j < numReactions) && reader.IsOk(); ++j)
+			ReadReaction(reader, reactions[j]);
+	}
+
+	reader.Read(data.config);
+	reader.ReadString(data.sCollisionBone);
+
+	if (!reader.IsAtEnd())
+	{
+		CHitDeathReactionsSystem::Warning("Corrupted reactions cache %s for %s, it will be rebuilt", sCacheFilePath.c_str(), szReactionsDataFile);
+		data.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+bool CHitDeathReactionsCache::Save(const char* szReactionsDataFile, uint32 contentHash, const SReactionsFileData& data)
+{
+	CBlobWriter writer;
+	writer.Write(CACHE_FILE_MAGIC);
+	writer.Write(CACHE_FILE_VERSION);
+	writer.Write(contentHash);
+	writer.WriteString(szReactionsDataFile);
+
+	for (int i = 0; i < SReactionsFileData::eRL_Count; ++i)
+	{
+		const SReactionsFileData::ReactionContainer& reactions = data.reactions[i];
+
+		writer.Write(static_cast<uint32>(reactions.size()));
+		for (SReactionsFileData::ReactionContainer::const_iterator it = reactions.begin(), itEnd = reactions.end(); it != itEnd; ++it)
+			WriteReaction(writer, *it);
+	}
+
+	writer.Write(data.config);
+	writer.WriteString(data.sCollisionBone);
+
+	CryPathString sCacheFilePath;
+	GetCacheFilePath(szReactionsDataFile, sCacheFilePath);
+
+	ICryPak* pCryPak = gEnv->pCryPak;
+	pCryPak->MakeDir(CACHE_FOLDER);
+
+	FILE* pFile = pCryPak->FOpen(sCacheFilePath.c_str(), "wb");
+	if (!pFile)
+	{
+		CHitDeathReactionsSystem::Warning("Couldn't open reactions cache %s for writing", sCacheFilePath.c_str());
+		return false;
+	}
+
+	const std::vector<uint8>& blob = writer.GetData();
+	const bool bWritten = pCryPak->FWrite(&blob[0], 1, blob.size(), pFile) == blob.size();
+	pCryPak->FClose(pFile);
+
+	if (!bWritten)
+	{
+		// don't leave a truncated blob around
+		pCryPak->RemoveFile(sCacheFilePath.c_str());
+		CHitDeathReactionsSystem::Warning("Couldn't write reactions cache %s", sCacheFilePath.c_str());
+	}
+
+	return bWritten;
+}
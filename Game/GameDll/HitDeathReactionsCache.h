@@ -0,0 +1,115 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Binary cache of the hit/death reactions data files. The reactions parsed
+from a data file's script table are kept in an actor independent form
+(bone, hit type, class and animation names are stored as strings and
+resolved for every profile) and saved to a versioned blob keyed by the
+data file path and a hash of the format version, the data file, its
+definition file and the script that loads them, so editing any of them
+invalidates the blob. When the blob is valid the data file is only parsed
+if lua functions need the reaction tables, and the cached reactions are
+bound to them by their key on the reactions table.
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#pragma once
+#ifndef __HIT_DEATH_REACTIONS_CACHE_H
+#define __HIT_DEATH_REACTIONS_CACHE_H
+
+#include "HitDeathReactionsDefs.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Actor independent contents of a reactions data file
+//////////////////////////////////////////////////////////////////////////
+struct SReactionsFileData
+{
+	typedef std::vector<string>	NameContainer;
+
+	struct SValidation
+	{
+		SValidation();
+
+		string							sCustomValidationFunc;
+		float								fMinimumSpeedAllowed;
+		float								fMaximumSpeedAllowed;
+		float								fMinimumDamageAllowed;
+		float								fMaximumDamageAllowed;
+		float								fMinimumDistance;
+		float								fMaximumDistance;
+		float								fProbability;
+		uint32							destructibleEvent;
+		int									sourceIndex;				// 0 if read from the reaction table itself, otherwise 1-based index on its validation section
+		int8								shotOrigin;
+		int8								movementDir;
+		bool								bAllowOnlyWhenUsingMountedItems;
+		bool								bHasStances;				// stance names on the script table need to be converted to ids when binding it
+		std::vector<int>		stances;
+		std::vector<float>	healthThresholds;		// as authored: fraction of the max health if <= 1, absolute health otherwise
+		NameContainer				partNames;
+		NameContainer				hitTypeNames;
+		NameContainer				projectileClassNames;
+		NameContainer				weaponClassNames;
+	};
+	typedef std::vector<SValidation> ValidationContainer;
+
+	struct SReaction
+	{
+		SReaction();
+
+		ValidationContainer	validations;
+		string							sCustomExecutionFunc;
+		string							sCustomAISignal;
+		string							sAGInputValue;
+		NameContainer				variationNames;
+		NameContainer				variationValues;
+		NameContainer				animNames;					// variants already expanded
+		Vec3								endVelocity;
+		float								orientationSnapAngle;
+		float								fOverrideTransTimeToAG;
+		int									iAnimLayer;
+		uint8								flags;
+		uint8								reactionOnCollision;
+		bool								bPauseAI;
+		bool								bAdditive;
+		bool								bNoAnimCamera;
+		string							sTableName;					// key of the reaction table on its reactions table, empty if it's an array entry
+		int									iTableIndex;				// 1-based key of the reaction table if it's an array entry
+	};
+	typedef std::vector<SReaction> ReactionContainer;
+
+	enum EReactionList
+	{
+		eRL_Death = 0,
+		eRL_Collision,
+		eRL_Hit,
+
+		eRL_Count
+	};
+
+	void Reset();
+
+	ReactionContainer					reactions[eRL_Count];
+	SHitDeathReactionsConfig	config;								// iCollisionBoneId is resolved for every profile from sCollisionBone
+	string										sCollisionBone;				// empty if the data file doesn't set it
+};
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+class CHitDeathReactionsCache
+{
+public:
+	// crc of the format version and the contents of the data file and the files it's loaded with, 0 if any couldn't be read
+	static uint32	GetContentHash(const char* szReactionsDataFile);
+
+	static bool		Load(const char* szReactionsDataFile, uint32 contentHash, SReactionsFileData& data);
+	static bool		Save(const char* szReactionsDataFile, uint32 contentHash, const SReactionsFileData& data);
+
+private:
+	static void		GetCacheFilePath(const char* szReactionsDataFile, CryPathString& sCacheFilePath);
+};
+
+#endif // __HIT_DEATH_REACTIONS_CACHE_H
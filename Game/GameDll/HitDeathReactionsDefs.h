@@ -64,6 +64,8 @@ namespace
 	const unsigned char NO_COLLISION_REACTION = 0;
 	const uint32 DEFAULT_REACTION_ANIM_FLAGS = CA_FORCE_SKELETON_UPDATE | CA_DISABLE_MULTILAYER | CA_REPEAT_LAST_KEY | CA_ALLOW_ANIM_RESTART | CA_FORCE_TRANSITION_TO_ANIM;
 	const char HIT_DEATH_REACTIONS_SCRIPT_TABLE[] = "HitDeathReactions";
+	const char HIT_DEATH_REACTIONS_SCRIPT_FILE[] = "Scripts/GameRules/HitDeathReactions.lua";
+	const char REACTIONS_DEFINITION_FILE[] = "Libs/HitDeathReactionsData/HitDeathReactionsDefinition.xml"; // definition LoadXMLData reads the data files with
 }
 
 //////////////////////////////////////////////////////////////////////////
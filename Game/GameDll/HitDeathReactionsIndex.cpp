@@ -0,0 +1,252 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Compiled decision index over a reactions container
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "HitDeathReactionsIndex.h"
+#include "HitDeathReactionsSystem.h"
+
+#include <IGameRulesSystem.h>
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+CHitDeathReactionsIndex::CHitDeathReactionsIndex() : m_anyStanceOffset(0), m_numWords(0), m_bEnabled(false)
+{
+	memset(m_stanceOffsets, 0, sizeof(m_stanceOffsets));
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsIndex::Compile(const ReactionsContainer& reactions)
+{
+	stl::free_container(m_entries);
+	stl::free_container(m_bits);
+	for (int i = 0; i < eC_Count; ++i)
+		m_idCriteria[i] = SIdCriteria();
+	m_numWords = 0;
+	m_bEnabled = false;
+
+	// Flatten the validation params, keeping the container order
+	const int numReactions = static_cast<int>(reactions.size());
+	for (int iReaction = 0; iReaction < numReactions; ++iReaction)
+	{
+		const SReactionParams::ValidationParamsList& validationParams = reactions[iReaction].validationParams;
+
+		SEntry entry;
+		entry.reactionIdx = static_cast<uint16>(iReaction);
+		entry.fMinimumSpeedAllowed = entry.fMinimumDamageAllowed = -FLT_MAX;
+		entry.fMaximumSpeedAllowed = entry.fMaximumDamageAllowed = FLT_MAX;
+		entry.validationIdx = -1;
+		entry.bCustomValidation = false;
+
+		if (validationParams.empty())
+		{
+			m_entries.push_back(entry);
+			continue;
+		}
+
+		const int numValidations = static_cast<int>(validationParams.size());
+		for (int iValidation = 0; iValidation < numValidations; ++iValidation)
+		{
+			const SReactionParams::SValidationParams& validation = validationParams[iValidation];
+
+			entry.validationIdx = static_cast<int16>(iValidation);
+			entry.bCustomValidation = !validation.sCustomValidationFunc.empty();
+			entry.fMinimumSpeedAllowed = validation.fMinimumSpeedAllowed;
+			entry.fMaximumSpeedAllowed = validation.fMaximumSpeedAllowed;
+			entry.fMinimumDamageAllowed = validation.fMinimumDamageAllowed;
+			entry.fMaximumDamageAllowed = validation.fMaximumDamageAllowed;
+
+			m_entries.push_back(entry);
+		}
+	}
+
+	const int numEntries = static_cast<int>(m_entries.size());
+	if (numEntries == 0)
+		return;
+
+	if (numEntries > eMaxEntries)
+	{
+		CHitDeathReactionsSystem::Warning("Too many validation entries (%d, max %d) to index, reactions will be evaluated linearly", numEntries, eMaxEntries);
+		stl::free_container(m_entries);
+		return;
+	}
+
+	m_numWords = (numEntries + 31) >> 5;
+
+	for (int i = 0; i < eC_Count; ++i)
+		m_idCriteria[i].anyOffset = AllocBits();
+	for (int i = 0; i < STANCE_LAST; ++i)
+		m_stanceOffsets[i] = AllocBits();
+	m_anyStanceOffset = AllocBits();
+
+	for (int iEntry = 0; iEntry < numEntries; ++iEntry)
+	{
+		const SEntry& entry = m_entries[iEntry];
+
+		if ((entry.validationIdx < 0) || entry.bCustomValidation)
+		{
+			// Always a candidate
+			for (int i = 0; i < eC_Count; ++i)
+				AddIdCriteria(m_idCriteria[i], NULL, iEntry);
+			SetBit(m_anyStanceOffset, iEntry);
+			continue;
+		}
+
+		const SReactionParams::SValidationParams& validation = reactions[entry.reactionIdx].validationParams[entry.validationIdx];
+
+		AddIdCriteria(m_idCriteria[eC_Part], &validation.allowedPartIds, iEntry);
+		AddIdCriteria(m_idCriteria[eC_HitType], &validation.allowedHitTypes, iEntry);
+		AddIdCriteria(m_idCriteria[eC_Projectile], &validation.allowedProjectiles, iEntry);
+		AddIdCriteria(m_idCriteria[eC_Weapon], &validation.allowedWeapons, iEntry);
+
+		if (validation.allowedStances.empty())
+		{
+			SetBit(m_anyStanceOffset, iEntry);
+		}
+		else
+		{
+			SReactionParams::StanceContainer::const_iterator itEnd = validation.allowedStances.end();
+			for (SReactionParams::StanceContainer::const_iterator it = validation.allowedStances.begin(); it != itEnd; ++it)
+			{
+				const EStance stance = *it;
+				if ((stance >= 0) && (stance < STANCE_LAST))
+					SetBit(m_stanceOffsets[stance], iEntry);
+			}
+		}
+	}
+
+	BitStorage(m_bits).swap(m_bits);
+	m_bEnabled = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+uint32 CHitDeathReactionsIndex::AllocBits()
+{
+	const uint32 offset = static_cast<uint32>(m_bits.size());
+	m_bits.resize(offset + m_numWords, 0);
+	return offset;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsIndex::SetBit(uint32 offset, int iEntry)
+{
+	m_bits[offset + (iEntry >> 5)] |= BIT(iEntry & 31);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+uint32 CHitDeathReactionsIndex::GetIdBits(SIdCriteria& criteria, int id)
+{
+	IdBitsContainer::iterator it = std::lower_bound(criteria.ids.begin(), criteria.ids.end(), IdBitsPair(id, 0));
+	if ((it != criteria.ids.end()) && (it->first == id))
+		return it->second;
+
+	const uint32 offset = AllocBits();
+	criteria.ids.insert(it, IdBitsPair(id, offset));
+	return offset;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsIndex::AddIdCriteria(SIdCriteria& criteria, const SReactionParams::IdContainer* pAllowedIds, int iEntry)
+{
+	// An empty set means any id is allowed
+	if (!pAllowedIds || pAllowedIds->empty())
+	{
+		SetBit(criteria.anyOffset, iEntry);
+		return;
+	}
+
+	SReactionParams::IdContainer::const_iterator itEnd = pAllowedIds->end();
+	for (SReactionParams::IdContainer::const_iterator it = pAllowedIds->begin(); it != itEnd; ++it)
+	{
+		SetBit(GetIdBits(criteria, *it), iEntry);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+const uint32* CHitDeathReactionsIndex::FindIdBits(const SIdCriteria& criteria, int id) const
+{
+	IdBitsContainer::const_iterator it = std::lower_bound(criteria.ids.begin(), criteria.ids.end(), IdBitsPair(id, 0));
+	if ((it != criteria.ids.end()) && (it->first == id))
+		return &m_bits[it->second];
+
+	return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsIndex::GetCandidates(const HitInfo& hitInfo, EStance stance, uint32* candidates) const
+{
+	CRY_ASSERT(m_bEnabled);
+
+	const int ids[eC_Count] = { hitInfo.partId, hitInfo.type, hitInfo.projectileClassId, hitInfo.weaponClassId };
+
+	const uint32* pAnyBits[eC_Count];
+	const uint32* pIdBits[eC_Count];
+	for (int i = 0; i < eC_Count; ++i)
+	{
+		pAnyBits[i] = &m_bits[m_idCriteria[i].anyOffset];
+		pIdBits[i] = FindIdBits(m_idCriteria[i], ids[i]);
+	}
+
+	const uint32* pAnyStanceBits = &m_bits[m_anyStanceOffset];
+	const uint32* pStanceBits = ((stance >= 0) && (stance < STANCE_LAST)) ? &m_bits[m_stanceOffsets[stance]] : NULL;
+
+	for (int iWord = 0; iWord < m_numWords; ++iWord)
+	{
+		uint32 word = pAnyStanceBits[iWord] | (pStanceBits ? pStanceBits[iWord] : 0);
+
+		for (int i = 0; i < eC_Count; ++i)
+			word &= pAnyBits[i][iWord] | (pIdBits[i] ? pIdBits[i][iWord] : 0);
+
+		candidates[iWord] = word;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+int CHitDeathReactionsIndex::GetNextCandidate(const uint32* candidates, int iEntry) const
+{
+	for (int iWord = iEntry >> 5; iWord < m_numWords; ++iWord)
+	{
+		uint32 word = candidates[iWord];
+		if (iWord == (iEntry >> 5))
+			word &= ~0u << (iEntry & 31);
+
+		if (word)
+		{
+			int iBit = 0;
+			while (!(word & 1))
+			{
+				word >>= 1;
+				++iBit;
+			}
+
+			return (iWord << 5) + iBit;
+		}
+	}
+
+	return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsIndex::GetMemoryUsage(ICrySizer * s) const
+{
+	s->AddObject(this, sizeof(*this));
+	s->AddContainer(m_entries);
+	s->AddContainer(m_bits);
+	for (int i = 0; i < eC_Count; ++i)
+		s->AddContainer(m_idCriteria[i].ids);
+}
@@ -0,0 +1,104 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Compiled decision index over a reactions container. Every validation
+params entry of the container becomes a bit; for each discrete criteria
+(hit part, hit type, projectile, weapon, stance) a bitset per allowed value
+plus a bitset of entries accepting any value are built at load. The
+candidates for a hit are the intersection of those bitsets, in the same
+order as the container, so only entries that can possibly pass are fully
+validated. Entries with custom validation functions are always candidates.
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#pragma once
+#ifndef __HIT_DEATH_REACTIONS_INDEX_H
+#define __HIT_DEATH_REACTIONS_INDEX_H
+
+#include "HitDeathReactionsDefs.h"
+
+struct HitInfo;
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+class CHitDeathReactionsIndex
+{
+public:
+	enum
+	{
+		eMaxWords = 16,								// containers with more entries than eMaxWords * 32 aren't indexed
+		eMaxEntries = eMaxWords * 32,
+	};
+
+	struct SEntry
+	{
+		float		fMinimumSpeedAllowed;
+		float		fMaximumSpeedAllowed;
+		float		fMinimumDamageAllowed;
+		float		fMaximumDamageAllowed;
+		uint16	reactionIdx;
+		int16		validationIdx;					// -1 for reactions without validation params (always valid)
+		bool		bCustomValidation;			// needs the custom validation function, static criteria don't apply
+	};
+
+	CHitDeathReactionsIndex();
+
+	void						Compile(const ReactionsContainer& reactions);
+
+	ILINE bool			IsEnabled() const { return m_bEnabled; }
+	ILINE int				GetWordCount() const { return m_numWords; }
+	ILINE int				GetEntryCount() const { return static_cast<int>(m_entries.size()); }
+	ILINE const SEntry& GetEntry(int iEntry) const { return m_entries[iEntry]; }
+
+	// fills candidates (GetWordCount() words) with the entries whose discrete criteria accept the hit
+	void						GetCandidates(const HitInfo& hitInfo, EStance stance, uint32* candidates) const;
+
+	// returns the first set entry >= iEntry or -1
+	int							GetNextCandidate(const uint32* candidates, int iEntry) const;
+
+	void						GetMemoryUsage(ICrySizer * s) const;
+
+private:
+	typedef std::vector<uint32>								BitStorage;
+	typedef std::pair<int, uint32>						IdBitsPair;		// id, offset into the bit storage
+	typedef std::vector<IdBitsPair>						IdBitsContainer;
+
+	struct SIdCriteria
+	{
+		SIdCriteria() : anyOffset(0) {}
+
+		IdBitsContainer	ids;					// sorted by id
+		uint32					anyOffset;		// entries accepting any id
+	};
+
+	enum ECriteria
+	{
+		eC_Part = 0,
+		eC_HitType,
+		eC_Projectile,
+		eC_Weapon,
+
+		eC_Count
+	};
+
+	uint32					AllocBits();
+	void						SetBit(uint32 offset, int iEntry);
+	uint32					GetIdBits(SIdCriteria& criteria, int id);
+	void						AddIdCriteria(SIdCriteria& criteria, const SReactionParams::IdContainer* pAllowedIds, int iEntry);
+	const uint32*		FindIdBits(const SIdCriteria& criteria, int id) const;
+
+	std::vector<SEntry>	m_entries;
+	BitStorage					m_bits;
+	SIdCriteria					m_idCriteria[eC_Count];
+	uint32							m_stanceOffsets[STANCE_LAST];
+	uint32							m_anyStanceOffset;
+	int									m_numWords;
+	bool								m_bEnabled;
+};
+
+DECLARE_BOOST_POINTERS(CHitDeathReactionsIndex);
+
+#endif // __HIT_DEATH_REACTIONS_INDEX_H
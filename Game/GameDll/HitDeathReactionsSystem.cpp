@@ -2,6 +2,7 @@
 
 #include "HitDeathReactionsSystem.h"
 #include "HitDeathReactions.h"
+#include "HitDeathReactionsCache.h"
 #include <NameCRCHelper.h>
 #include <ICryMiniGUI.h>
 #include <IPerfHud.h>
@@ -15,8 +16,6 @@
 // Unnamed namespace for constants
 namespace
 {
-	const char HIT_DEATH_REACTIONS_SCRIPT_FILE[] = "Scripts/GameRules/HitDeathReactions.lua";
-
 	const char REACTIONS_PRELOAD_LIST_FILE[]		= "Libs/HitDeathReactionsData/ReactionsPreloadList.xml";
 	const char REACTIONS_PRELOAD_LIST_FILE_MP[] = "Libs/HitDeathReactionsData/ReactionsPreloadListMP.xml";
 	const char PRELOAD_CHARACTER_FILE[] = "characterFile";
@@ -47,6 +46,9 @@ namespace
 	const char DEATH_REACTIONS_PARAMS[] = "DeathReactionParams";
 	const char COLLISION_REACTIONS_PARAMS[] = "CollisionReactionParams";
 
+	// order must match SReactionsFileData::EReactionList
+	const char* const REACTION_PARAMS_NAMES[SReactionsFileData::eRL_Count] = { DEATH_REACTIONS_PARAMS, COLLISION_REACTIONS_PARAMS, HIT_REACTIONS_PARAMS };
+
 	const char VALIDATION_SECTION[] = "ValidationSection";
 	const char VALIDATION_FUNC_PROPERTY[] = "validationFunc";
 	const char REACTION_FUNC_PROPERTY[] = "reactionFunc";
@@ -96,6 +98,7 @@ namespace
 
 	const float HYSTERESIS_REQUEST_TIMER_SECONDS = 0.5f;
 	const float HYSTERESIS_RELEASE_TIMER_SECONDS = 3.0f;
+	const float PREDICTIVE_STREAMING_UPDATE_SECONDS = 0.25f;
 }
 
 
@@ -128,6 +131,12 @@ void CHitDeathReactionsSystem::SReactionsProfile::GetMemoryUsage(ICrySizer * s)
 	if (!pHitDeathReactionsConfig.expired())
 		s->AddObject(pHitDeathReactionsConfig.lock().get());
 
+	if (!pHitReactionsIndex.expired())
+		s->AddObject(pHitReactionsIndex.lock().get());
+
+	if (!pDeathReactionsIndex.expired())
+		s->AddObject(pDeathReactionsIndex.lock().get());
+
 	s->AddContainer(entitiesUsingProfile);
 }
 
@@ -226,6 +235,8 @@ public:
 			m_pTable->AddColumn("Alive");
 			m_pTable->AddColumn("AI Enabled");
 			m_pTable->AddColumn("NotInPool");
+			m_pTable->AddColumn("Anims ready");
+			m_pTable->AddColumn("Anims stalled");
 		}
 		else
 		{
@@ -245,6 +256,24 @@ public:
 		else
 			m_pInfoBox->ClearEntries();
 
+		// Totals: reactions that found their anim streamed in vs. the ones that had to wait for it
+		const ColorB totalsColor = Col_White;
+		if (m_pTable)
+		{
+			m_pTable->AddData(SPredPrintStreamingStats::eSTC_Name, totalsColor, "Total (%u evicted)", m_hitDeathReactionsSystem.m_iEvictions);
+			m_pTable->AddData(SPredPrintStreamingStats::eSTC_Alive, totalsColor, "");
+			m_pTable->AddData(SPredPrintStreamingStats::eSTC_AIProxyEnabled, totalsColor, "");
+			m_pTable->AddData(SPredPrintStreamingStats::eSTC_OutOfEntityPool, totalsColor, "");
+			m_pTable->AddData(SPredPrintStreamingStats::eSTC_AnimHits, totalsColor, "%u", m_hitDeathReactionsSystem.m_iAnimHits);
+			m_pTable->AddData(SPredPrintStreamingStats::eSTC_AnimMisses, totalsColor, "%u", m_hitDeathReactionsSystem.m_iAnimMisses);
+		}
+		else
+		{
+			CryFixedStringT<128> text;
+			text.Format("Anims ready %u -- stalled %u -- evicted %u", m_hitDeathReactionsSystem.m_iAnimHits, m_hitDeathReactionsSystem.m_iAnimMisses, m_hitDeathReactionsSystem.m_iEvictions);
+			m_pInfoBox->AddEntry(text.c_str(), totalsColor, 12.0f);
+		}
+
 		std::for_each(m_hitDeathReactionsSystem.m_reactionProfiles.begin(), m_hitDeathReactionsSystem.m_reactionProfiles.end(), SPredPrintStreamingStats(*this));
 	}
 
@@ -296,7 +325,7 @@ private:
 				std::map<ProfileId, string>::const_iterator itFind = m_widget.m_hitDeathReactionsSystem.m_profileIdToReactionFileMap.find(profileId);
 				if (itFind != m_widget.m_hitDeathReactionsSystem.m_profileIdToReactionFileMap.end())
 				{
-					const bool bNewStreamingPolicy = (m_widget.m_hitDeathReactionsSystem.GetStreamingPolicy() == SCVars::eHDRSP_ActorsAliveAndNotInPool);
+					const bool bNewStreamingPolicy = m_widget.m_hitDeathReactionsSystem.TracksEntitiesUsingProfile();
 
 					// Print profile name
 					const bool bEntitiesLockingAnims = !bNewStreamingPolicy || (profile.iRefCount > 0);
@@ -312,9 +341,12 @@ private:
 						m_widget.m_pTable->AddData(eSTC_Alive, textColor, "");
 						m_widget.m_pTable->AddData(eSTC_AIProxyEnabled, textColor, "");
 						m_widget.m_pTable->AddData(eSTC_OutOfEntityPool, textColor, "");
+						m_widget.m_pTable->AddData(eSTC_AnimHits, textColor, "%u", profile.iAnimHits);
+						m_widget.m_pTable->AddData(eSTC_AnimMisses, textColor, "%u", profile.iAnimMisses);
 					}
 					else
 					{
+						text.append(CryFixedStringT<64>().Format(" -- Anims ready[%u] stalled[%u]", profile.iAnimHits, profile.iAnimMisses).c_str());
 						m_widget.m_pInfoBox->AddEntry(text.c_str(), textColor, fTextSize);
 					}
 
@@ -351,6 +383,8 @@ private:
 									m_widget.m_pTable->AddData(eSTC_Alive, bAliveCorrect ? textColor : Col_Red, bAlive ? YES : NO);
 									m_widget.m_pTable->AddData(eSTC_AIProxyEnabled, bAIEnabledCorrect ? textColor : Col_Red, bAIEnabled ? YES : NO);
 									m_widget.m_pTable->AddData(eSTC_OutOfEntityPool, bNotInPoolCorrect ? textColor : Col_Red, bNotInPool ? YES : NO);
+									m_widget.m_pTable->AddData(eSTC_AnimHits, textColor, "");
+									m_widget.m_pTable->AddData(eSTC_AnimMisses, textColor, "");
 								}
 								else
 								{
@@ -365,15 +399,17 @@ private:
 			}
 		}
 
-	private:
 		enum EStatsTableColumn
 		{
 			eSTC_Name = 0,
 			eSTC_Alive,
 			eSTC_AIProxyEnabled,
 			eSTC_OutOfEntityPool,
+			eSTC_AnimHits,
+			eSTC_AnimMisses,
 		};
 
+	private:
 		CHitDeathReactionsDebugWidget& m_widget;
 	};
 
@@ -453,7 +489,8 @@ void CHitDeathReactionsSystem::Warning(const char* szFormat, ...)
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-CHitDeathReactionsSystem::CHitDeathReactionsSystem() : m_streamingEnabled(g_pGameCVars->g_hitDeathReactions_streaming)
+CHitDeathReactionsSystem::CHitDeathReactionsSystem() : m_streamingEnabled(g_pGameCVars->g_hitDeathReactions_streaming),
+	m_fPredictiveStreamingTimer(0.0f), m_iAnimHits(0), m_iAnimMisses(0), m_iEvictions(0)
 {
 	m_failSafeProfile.pHitReactions.reset(new ReactionsContainer);
 	m_failSafeProfile.pDeathReactions.reset(new ReactionsContainer);
@@ -499,6 +536,10 @@ void CHitDeathReactionsSystem::OnToggleGameMode()
 void CHitDeathReactionsSystem::Reset()
 {
 	stl::free_container(m_reactionProfiles);
+	stl::free_container(m_prefetchCandidates);
+
+	m_fPredictiveStreamingTimer = 0.0f;
+	m_iAnimHits = m_iAnimMisses = m_iEvictions = 0;
 
 #ifndef _RELEASE
 	stl::free_container(m_profileIdToReactionFileMap);
@@ -507,7 +548,7 @@ void CHitDeathReactionsSystem::Reset()
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-ProfileId CHitDeathReactionsSystem::GetReactionParamsForActor(const CActor& actor, ReactionsContainerConstPtr& pHitReactions, ReactionsContainerConstPtr& pDeathReactions, ReactionsContainerConstPtr& pCollisionReactions, SHitDeathReactionsConfigConstPtr& pHitDeathReactionsConfig)
+ProfileId CHitDeathReactionsSystem::GetReactionParamsForActor(const CActor& actor, ReactionsContainerConstPtr& pHitReactions, ReactionsContainerConstPtr& pDeathReactions, ReactionsContainerConstPtr& pCollisionReactions, SHitDeathReactionsConfigConstPtr& pHitDeathReactionsConfig, CHitDeathReactionsIndexConstPtr& pHitReactionsIndex, CHitDeathReactionsIndexConstPtr& pDeathReactionsIndex)
 {
 	bool bSuccess = false;
 
@@ -520,12 +561,14 @@ ProfileId CHitDeathReactionsSystem::GetReactionParamsForActor(const CActor& acto
 			const SReactionsProfile& sharedReactions = itFind->second;
 			if (sharedReactions.IsValid())
 			{
-				actor.GetEntity()->GetScriptTable()->SetValue(ACTOR_HIT_DEATH_REACTIONS_PARAMS, sharedReactions.pHitAndDeathReactionsTable);
+				SetActorReactionsScriptTable(actor, sharedReactions.pHitAndDeathReactionsTable);
 
 				pHitReactions = sharedReactions.pHitReactions.lock();
 				pDeathReactions = sharedReactions.pDeathReactions.lock();
 				pCollisionReactions = sharedReactions.pCollisionReactions.lock();
 				pHitDeathReactionsConfig = sharedReactions.pHitDeathReactionsConfig.lock();
+				pHitReactionsIndex = sharedReactions.pHitReactionsIndex.lock();
+				pDeathReactionsIndex = sharedReactions.pDeathReactionsIndex.lock();
 
 				bSuccess = true;
 				return profileId;
@@ -574,23 +617,34 @@ ProfileId CHitDeathReactionsSystem::GetReactionParamsForActor(const CActor& acto
 			ReactionsContainerPtr pNewDeathReactions(new ReactionsContainer);
 			ReactionsContainerPtr pNewCollisionReactions(new ReactionsContainer);
 			SHitDeathReactionsConfigPtr pNewHitDeathReactionsConfig(new SHitDeathReactionsConfig);
-
-			// Fill death and hit reactions params script table 
-			ScriptTablePtr hitAndDeathReactions = LoadReactionsScriptTable(actor);
-			if (hitAndDeathReactions)
+			CHitDeathReactionsIndexPtr pNewHitReactionsIndex(new CHitDeathReactionsIndex);
+			CHitDeathReactionsIndexPtr pNewDeathReactionsIndex(new CHitDeathReactionsIndex);
+
+			// Actor independent params, from the binary cache when it's up to date with the data file. The data file is
+			// only parsed into the death and hit reactions params script table if the cache can't be used or lua needs it
+			CryPathString sReactionsDataFile;
+			SReactionsFileData fileData;
+			ScriptTablePtr hitAndDeathReactions;
+			if (GetReactionsDataFile(actor, sReactionsDataFile) && LoadReactionsFileData(sReactionsDataFile.c_str(), fileData, hitAndDeathReactions))
 			{
-				// Parse and create hit and death reactions params
-				LoadHitDeathReactionsParams(actor, hitAndDeathReactions, pNewHitReactions, pNewDeathReactions, pNewCollisionReactions);
+				// Create hit and death reactions params
+				LoadHitDeathReactionsParams(actor, hitAndDeathReactions, fileData, pNewHitReactions, pNewDeathReactions, pNewCollisionReactions);
 
-				// Parse configuration struct
-				LoadHitDeathReactionsConfig(actor, hitAndDeathReactions, pNewHitDeathReactionsConfig);
+				// Compile the validation params into the decision indices used to select reactions
+				pNewHitReactionsIndex->Compile(*(pNewHitReactions.get()));
+				pNewDeathReactionsIndex->Compile(*(pNewDeathReactions.get()));
+
+				// Configuration struct
+				LoadHitDeathReactionsConfig(actor, fileData, pNewHitDeathReactionsConfig);
 
 				// Insert it on the pool
 				ProfilesContainersItem newProfile(profileId, SReactionsProfile(pNewHitReactions, pNewDeathReactions, pNewCollisionReactions, hitAndDeathReactions, pNewHitDeathReactionsConfig));
+				newProfile.second.pHitReactionsIndex = pNewHitReactionsIndex;
+				newProfile.second.pDeathReactionsIndex = pNewDeathReactionsIndex;
 				bSuccess = m_reactionProfiles.insert(newProfile).second;
 				CRY_ASSERT(bSuccess);
 
-				actor.GetEntity()->GetScriptTable()->SetValue(ACTOR_HIT_DEATH_REACTIONS_PARAMS, newProfile.second.pHitAndDeathReactionsTable);
+				SetActorReactionsScriptTable(actor, newProfile.second.pHitAndDeathReactionsTable);
 			}
 			else
 				Warning("Couldn't load the reactions table for actor %s", actor.GetEntity()->GetName());
@@ -600,6 +654,8 @@ ProfileId CHitDeathReactionsSystem::GetReactionParamsForActor(const CActor& acto
 			pDeathReactions = pNewDeathReactions;
 			pCollisionReactions = pNewCollisionReactions;
 			pHitDeathReactionsConfig = pNewHitDeathReactionsConfig;
+			pHitReactionsIndex = pNewHitReactionsIndex;
+			pDeathReactionsIndex = pNewDeathReactionsIndex;
 		}
 	}
 	else
@@ -611,6 +667,8 @@ ProfileId CHitDeathReactionsSystem::GetReactionParamsForActor(const CActor& acto
 		pDeathReactions = m_failSafeProfile.pDeathReactions;
 		pCollisionReactions = m_failSafeProfile.pCollisionReactions;
 		pHitDeathReactionsConfig = m_failSafeProfile.pHitDeathReactionsConfig;
+		pHitReactionsIndex.reset();
+		pDeathReactionsIndex.reset();
 	}
 
 	return bSuccess ? profileId : INVALID_PROFILE_ID;
@@ -620,7 +678,7 @@ ProfileId CHitDeathReactionsSystem::GetReactionParamsForActor(const CActor& acto
 //////////////////////////////////////////////////////////////////////////
 void CHitDeathReactionsSystem::RequestReactionAnimsForActor(const CActor& actor, uint32 requestFlags)
 {
-	if (GetStreamingPolicy() == SCVars::eHDRSP_ActorsAliveAndNotInPool)
+	if (TracksEntitiesUsingProfile())
 	{
 		ProfileId profileId = GetActorProfileId(actor);
 		if (profileId != INVALID_PROFILE_ID)
@@ -642,6 +700,10 @@ void CHitDeathReactionsSystem::RequestReactionAnimsForActor(const CActor& actor,
 					const bool bReactionAnimsWereLocked = FlagsValidateLocking(oldFlags);
 					itEnt->second = oldFlags | requestFlags;
 
+					// With predictive streaming the requests are driven from Update
+					if (GetStreamingPolicy() != SCVars::eHDRSP_ActorsAliveAndNotInPool)
+						return;
+
 					if (!bReactionAnimsWereLocked && FlagsValidateLocking(itEnt->second))
 					{
 						if (profile.iRefCount == 0)
@@ -676,7 +738,7 @@ void CHitDeathReactionsSystem::RequestReactionAnimsForActor(const CActor& actor,
 //////////////////////////////////////////////////////////////////////////
 void CHitDeathReactionsSystem::ReleaseReactionAnimsForActor(const CActor& actor, uint32 requestFlags)
 {
-	if (GetStreamingPolicy() == SCVars::eHDRSP_ActorsAliveAndNotInPool)
+	if (TracksEntitiesUsingProfile())
 	{
 		ProfileId profileId = GetActorProfileId(actor);
 		if (profileId != INVALID_PROFILE_ID)
@@ -695,7 +757,7 @@ void CHitDeathReactionsSystem::ReleaseReactionAnimsForActor(const CActor& actor,
 						const bool bReactionAnimsWereLocked = FlagsValidateLocking(oldFlags);
 						itEnt->second = oldFlags & ~requestFlags;
 
-						if (bReactionAnimsWereLocked && !FlagsValidateLocking(itEnt->second))
+						if ((GetStreamingPolicy() == SCVars::eHDRSP_ActorsAliveAndNotInPool) && bReactionAnimsWereLocked && !FlagsValidateLocking(itEnt->second))
 						{
 							CRY_ASSERT(profile.iRefCount > 0);
 
@@ -742,6 +804,7 @@ void CHitDeathReactionsSystem::Reload()
 
 	m_reactionProfiles.clear();
 	m_reactionsScriptTableCache.clear();
+	m_contentHashCache.clear();
 
 	m_streamingEnabled = g_pGameCVars->g_hitDeathReactions_streaming;
 }
@@ -752,12 +815,14 @@ void CHitDeathReactionsSystem::PreloadData()
 {
 	// Clear the existing cache ready for reload
 	stl::free_container(m_reactionsScriptTableCache);
+	stl::free_container(m_contentHashCache);
 
 	m_streamingEnabled = g_pGameCVars->g_hitDeathReactions_streaming;
 
 	const char *preloadList = gEnv->bMultiplayer ? REACTIONS_PRELOAD_LIST_FILE_MP : REACTIONS_PRELOAD_LIST_FILE;
 	// Cache the reaction params script tables from the XML data files which filepath is 
-	// specified on the preload list
+	// specified on the preload list. With the binary cache on, only the ones the cache can't
+	// replace are parsed, and the out of date blobs are rebuilt
 	XmlNodeRef xmlNode = GetISystem()->LoadXmlFromFile(preloadList);
 	if (xmlNode)
 	{
@@ -769,7 +834,15 @@ void CHitDeathReactionsSystem::PreloadData()
 			{
 				CryPathString sReactionsFile(pairElement->getAttr(PRELOAD_REACTIONS_FILE));
 				CryStringUtils::UnifyFilePath(sReactionsFile);
-				LoadReactionsScriptTable(sReactionsFile.c_str());
+
+				if (g_pGameCVars->g_hitDeathReactions_binaryCache)
+				{
+					SReactionsFileData fileData;
+					ScriptTablePtr pHitDeathReactionsTable;
+					LoadReactionsFileData(sReactionsFile.c_str(), fileData, pHitDeathReactionsTable);
+				}
+				else
+					LoadReactionsScriptTable(sReactionsFile.c_str());
 			}
 		}
 	}
@@ -955,7 +1028,7 @@ ProfileId CHitDeathReactionsSystem::GetActorProfileId(const CActor& actor) const
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-ScriptTablePtr CHitDeathReactionsSystem::LoadReactionsScriptTable(const CActor& actor) const
+bool CHitDeathReactionsSystem::GetReactionsDataFile(const CActor& actor, CryPathString& sReactionsDataFile) const
 {
 	ScriptTablePtr pActorScriptTable = actor.GetEntity()->GetScriptTable();
 	CRY_ASSERT(pActorScriptTable.GetPtr());
@@ -966,13 +1039,13 @@ ScriptTablePtr CHitDeathReactionsSystem::LoadReactionsScriptTable(const CActor&
 	const char* szReactionsDataFilePath = NULL;
 	if ((propertiesTable.type == ANY_TTABLE) && propertiesTable.table->GetValue(REACTIONS_DATA_FILE_PROPERTY, szReactionsDataFilePath))
 	{
-		CryPathString sReactionsDataFile(szReactionsDataFilePath);
+		sReactionsDataFile = szReactionsDataFilePath;
 		CryStringUtils::UnifyFilePath(sReactionsDataFile);
 
-		return LoadReactionsScriptTable(sReactionsDataFile.c_str());
+		return true;
 	}
 	else
-		return NULL;
+		return false;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1013,56 +1086,228 @@ ScriptTablePtr CHitDeathReactionsSystem::LoadReactionsScriptTable(const char* sz
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-bool CHitDeathReactionsSystem::LoadHitDeathReactionsParams(const CActor& actor, ScriptTablePtr pHitDeathReactionsTable, ReactionsContainerPtr pHitReactions, ReactionsContainerPtr pDeathReactions, ReactionsContainerPtr pCollisionReactions)
+void CHitDeathReactionsSystem::SetActorReactionsScriptTable(const CActor& actor, ScriptTablePtr pHitDeathReactionsTable) const
+{
+	IScriptTable* pActorScriptTable = actor.GetEntity()->GetScriptTable();
+	if (pHitDeathReactionsTable)
+		pActorScriptTable->SetValue(ACTOR_HIT_DEATH_REACTIONS_PARAMS, pHitDeathReactionsTable);
+	else
+		pActorScriptTable->SetToNull(ACTOR_HIT_DEATH_REACTIONS_PARAMS);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::LoadHitDeathReactionsParams(const CActor& actor, IScriptTable* pHitDeathReactionsTable, const SReactionsFileData& fileData, ReactionsContainerPtr pHitReactions, ReactionsContainerPtr pDeathReactions, ReactionsContainerPtr pCollisionReactions)
 {
-	CRY_ASSERT(pHitDeathReactionsTable.GetPtr());
 	CRY_ASSERT(pHitReactions.get());
 	CRY_ASSERT(pDeathReactions.get());
 	CRY_ASSERT(pCollisionReactions.get());
 
-	bool bSuccess = false;
-
 	// [*DavidR | 23/Feb/2010] CryShared pointer doesn't have and overload for unary operator *
-	LoadReactionsParams(actor, pHitDeathReactionsTable, DEATH_REACTIONS_PARAMS, true, 0, *(pDeathReactions.get()));
-	LoadReactionsParams(actor, pHitDeathReactionsTable, COLLISION_REACTIONS_PARAMS, true, pDeathReactions->size(), *(pCollisionReactions.get()));
-	LoadReactionsParams(actor, pHitDeathReactionsTable, HIT_REACTIONS_PARAMS, false, 0, *(pHitReactions.get()));
-	
-	bSuccess = true;
+	LoadReactionsParams(actor, pHitDeathReactionsTable, DEATH_REACTIONS_PARAMS, fileData.reactions[SReactionsFileData::eRL_Death], true, 0, *(pDeathReactions.get()));
+	LoadReactionsParams(actor, pHitDeathReactionsTable, COLLISION_REACTIONS_PARAMS, fileData.reactions[SReactionsFileData::eRL_Collision], true, pDeathReactions->size(), *(pCollisionReactions.get()));
+	LoadReactionsParams(actor, pHitDeathReactionsTable, HIT_REACTIONS_PARAMS, fileData.reactions[SReactionsFileData::eRL_Hit], false, 0, *(pHitReactions.get()));
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+bool CHitDeathReactionsSystem::LoadReactionsFileData(const char* szReactionsDataFile, SReactionsFileData& fileData, ScriptTablePtr& pHitDeathReactionsTable) const
+{
+	const uint32 contentHash = g_pGameCVars->g_hitDeathReactions_binaryCache ? GetContentHash(szReactionsDataFile) : 0;
+	if (contentHash && CHitDeathReactionsCache::Load(szReactionsDataFile, contentHash, fileData))
+	{
+		// Up to date blob, no need to parse the data file unless lua is going to use its tables
+		if (!NeedsReactionsScriptTable(fileData))
+			return true;
+
+		pHitDeathReactionsTable = LoadReactionsScriptTable(szReactionsDataFile);
+		if (!pHitDeathReactionsTable)
+			return false;
+
+		if (MatchesScriptTable(pHitDeathReactionsTable, fileData))
+			return true;
+
+		Warning("Reactions cache for %s doesn't match its script table, it will be rebuilt", szReactionsDataFile);
+		fileData.Reset();
+	}
+	else
+	{
+		pHitDeathReactionsTable = LoadReactionsScriptTable(szReactionsDataFile);
+		if (!pHitDeathReactionsTable)
+			return false;
+	}
+
+	for (int i = 0; i < SReactionsFileData::eRL_Count; ++i)
+		ReadReactionsFromScript(szReactionsDataFile, pHitDeathReactionsTable, REACTION_PARAMS_NAMES[i], fileData.reactions[i]);
 
-	return bSuccess;
+	ReadConfigFromScript(pHitDeathReactionsTable, fileData);
+
+	if (contentHash)
+	{
+		CHitDeathReactionsCache::Save(szReactionsDataFile, contentHash, fileData);
+
+		// Behave as the following loads will, which get the params from the blob
+		if (!NeedsReactionsScriptTable(fileData))
+			pHitDeathReactionsTable = NULL;
+	}
+
+	return true;
 }
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-bool CHitDeathReactionsSystem::LoadHitDeathReactionsConfig(const CActor& actor, ScriptTablePtr pHitDeathReactionsTable, SHitDeathReactionsConfigPtr pHitDeathReactionsConfig)
-{	
-	CRY_ASSERT(pHitDeathReactionsTable.GetPtr());
-	CRY_ASSERT(pHitDeathReactionsConfig.get());
+uint32 CHitDeathReactionsSystem::GetContentHash(const char* szReactionsDataFile) const
+{
+	FileToContentHashMap::const_iterator itFind = m_contentHashCache.find(CONST_TEMP_STRING(szReactionsDataFile));
+	if (itFind != m_contentHashCache.end())
+		return itFind->second;
 
-	bool bSuccess = false;
+	const uint32 contentHash = CHitDeathReactionsCache::GetContentHash(szReactionsDataFile);
+	m_contentHashCache.insert(std::make_pair(szReactionsDataFile, contentHash));
+
+	return contentHash;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+bool CHitDeathReactionsSystem::NeedsReactionsScriptTable(const SReactionsFileData& fileData) const
+{
+	// Default lua functions receive the reaction and validation tables
+	if (g_pGameCVars->g_hitDeathReactions_useLuaDefaultFunctions)
+		return true;
+
+	// So do the custom functions implemented in lua (the C++ ones don't need them)
+	SmartScriptTable pHitDeathReactionsScriptTable;
+	if (!gEnv->pScriptSystem->GetGlobalValue(HIT_DEATH_REACTIONS_SCRIPT_TABLE, pHitDeathReactionsScriptTable))
+		return false;
+
+	for (int i = 0; i < SReactionsFileData::eRL_Count; ++i)
+	{
+		const SReactionsFileData::ReactionContainer& fileReactions = fileData.reactions[i];
+		for (SReactionsFileData::ReactionContainer::const_iterator itReaction = fileReactions.begin(), itReactionEnd = fileReactions.end(); itReaction != itReactionEnd; ++itReaction)
+		{
+			if (!itReaction->sCustomExecutionFunc.empty() && (pHitDeathReactionsScriptTable->GetValueType(itReaction->sCustomExecutionFunc.c_str()) == svtFunction))
+				return true;
+
+			for (SReactionsFileData::ValidationContainer::const_iterator itValidation = itReaction->validations.begin(), itValidationEnd = itReaction->validations.end(); itValidation != itValidationEnd; ++itValidation)
+			{
+				if (!itValidation->sCustomValidationFunc.empty() && (pHitDeathReactionsScriptTable->GetValueType(itValidation->sCustomValidationFunc.c_str()) == svtFunction))
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+bool CHitDeathReactionsSystem::MatchesScriptTable(IScriptTable* pHitDeathReactionsTable, const SReactionsFileData& fileData) const
+{
+	for (int i = 0; i < SReactionsFileData::eRL_Count; ++i)
+	{
+		const SReactionsFileData::ReactionContainer& fileReactions = fileData.reactions[i];
+		if (GetReactionTablesCount(pHitDeathReactionsTable, REACTION_PARAMS_NAMES[i]) != static_cast<int>(fileReactions.size()))
+			return false;
+
+		if (fileReactions.empty())
+			continue;
+
+		ScriptTablePtr pReactionsTable;
+		pHitDeathReactionsTable->GetValue(REACTION_PARAMS_NAMES[i], pReactionsTable);
+
+		// every cached reaction needs to find its table under the key it was read from
+		for (SReactionsFileData::ReactionContainer::const_iterator it = fileReactions.begin(), itEnd = fileReactions.end(); it != itEnd; ++it)
+		{
+			ScriptTablePtr pReactionTable;
+			if (!GetReactionScriptTable(pReactionsTable, *it, pReactionTable))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+bool CHitDeathReactionsSystem::GetReactionScriptTable(IScriptTable* pReactionsTable, const SReactionsFileData::SReaction& fileReaction, ScriptTablePtr& pReactionTable) const
+{
+	return fileReaction.sTableName.empty() ? pReactionsTable->GetAt(fileReaction.iTableIndex, pReactionTable) : pReactionsTable->GetValue(fileReaction.sTableName.c_str(), pReactionTable);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+int CHitDeathReactionsSystem::GetReactionTablesCount(IScriptTable* pHitDeathReactionsTable, const char* szReactionParamsName) const
+{
+	int iCount = 0;
+
+	ScriptTablePtr pReactionsTable;
+	if (pHitDeathReactionsTable->GetValue(szReactionParamsName, pReactionsTable))
+	{
+		IScriptTable::Iterator it = pReactionsTable->BeginIteration();
+		for ( ; pReactionsTable->MoveNext(it); )
+			++iCount;
+		pReactionsTable->EndIteration(it);
+	}
+
+	return iCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::ReadReactionsFromScript(const char* szReactionsDataFile, IScriptTable* pHitDeathReactionsTable, const char* szReactionParamsName, SReactionsFileData::ReactionContainer& fileReactions) const
+{
+	ScriptTablePtr pReactionsTable;
+	if (pHitDeathReactionsTable->GetValue(szReactionParamsName, pReactionsTable))
+	{
+		IScriptTable::Iterator it = pReactionsTable->BeginIteration();
+
+		for ( ; pReactionsTable->MoveNext(it); )
+		{
+			CRY_ASSERT(it.value.type == ANY_TTABLE);
+
+			fileReactions.push_back(SReactionsFileData::SReaction());
+			SReactionsFileData::SReaction& fileReaction = fileReactions.back();
+			GetReactionParamsFromScript(szReactionsDataFile, it.value.table, fileReaction);
+
+			// Key the cached reaction is bound to its table by
+			if (it.key.type == ANY_TSTRING)
+				fileReaction.sTableName = it.key.str;
+			else
+				fileReaction.iTableIndex = static_cast<int>(it.key.number);
+		}
+		pReactionsTable->EndIteration(it);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::ReadConfigFromScript(IScriptTable* pHitDeathReactionsTable, SReactionsFileData& fileData) const
+{
+	SHitDeathReactionsConfig& config = fileData.config;
 
-	const char* szCollisionBone = NULL;
 	ScriptTablePtr pReactionsConfigTable;
 	if (pHitDeathReactionsTable->GetValue(HIT_DEATH_REACTIONS_CONFIG, pReactionsConfigTable))
 	{
 		// collision volume reference bone
-		if (pReactionsConfigTable->HaveValue(COLLISION_BONE_PROPERTY))
-			pReactionsConfigTable->GetValue(COLLISION_BONE_PROPERTY, szCollisionBone);
+		const char* szCollisionBone = NULL;
+		if (pReactionsConfigTable->HaveValue(COLLISION_BONE_PROPERTY) && pReactionsConfigTable->GetValue(COLLISION_BONE_PROPERTY, szCollisionBone) && szCollisionBone)
+			fileData.sCollisionBone = szCollisionBone;
 
 		// Collision volume radius
 		if (pReactionsConfigTable->HaveValue(COLLISION_RADIUS_PROPERTY))
-			pReactionsConfigTable->GetValue(COLLISION_RADIUS_PROPERTY, pHitDeathReactionsConfig->fCollisionRadius);
+			pReactionsConfigTable->GetValue(COLLISION_RADIUS_PROPERTY, config.fCollisionRadius);
 
 		// Collision volume vertical offset
 		if (pReactionsConfigTable->HaveValue(COLLISION_VERTICAL_OFFSET))
-			pReactionsConfigTable->GetValue(COLLISION_VERTICAL_OFFSET, pHitDeathReactionsConfig->fCollisionVerticalOffset);
+			pReactionsConfigTable->GetValue(COLLISION_VERTICAL_OFFSET, config.fCollisionVerticalOffset);
 
 		if (pReactionsConfigTable->HaveValue(COLL_MAX_HORZ_ANGLE_PROPERTY))
 		{
 			float fCollMaxHorzAngle = 20.0f;
 			pReactionsConfigTable->GetValue(COLL_MAX_HORZ_ANGLE_PROPERTY, fCollMaxHorzAngle);
 
-			pHitDeathReactionsConfig->fCollMaxHorzAngleSin = sin(DEG2RAD(cry_fabsf(fCollMaxHorzAngle)));
+			config.fCollMaxHorzAngleSin = sin(DEG2RAD(cry_fabsf(fCollMaxHorzAngle)));
 		}
 
 		if (pReactionsConfigTable->HaveValue(COLL_MAX_MOV_ANGLE_PROPERTY))
@@ -1070,15 +1315,26 @@ bool CHitDeathReactionsSystem::LoadHitDeathReactionsConfig(const CActor& actor,
 			float fCollMaxMovAngle = 45.0f;
 			pReactionsConfigTable->GetValue(COLL_MAX_MOV_ANGLE_PROPERTY, fCollMaxMovAngle);
 
-			pHitDeathReactionsConfig->fCollMaxMovAngleCos = cos(DEG2RAD(cry_fabsf(fCollMaxMovAngle)));
+			config.fCollMaxMovAngleCos = cos(DEG2RAD(cry_fabsf(fCollMaxMovAngle)));
 		}
 
 		if (pReactionsConfigTable->HaveValue(COLL_REACTION_START_DIST))
-			pReactionsConfigTable->GetValue(COLL_REACTION_START_DIST, pHitDeathReactionsConfig->fCollReactionStartDist);
+			pReactionsConfigTable->GetValue(COLL_REACTION_START_DIST, config.fCollReactionStartDist);
 
 		if (pReactionsConfigTable->HaveValue(MAX_REACTION_TIME_PROPERTY))
-			pReactionsConfigTable->GetValue(MAX_REACTION_TIME_PROPERTY, pHitDeathReactionsConfig->fMaximumReactionTime);
+			pReactionsConfigTable->GetValue(MAX_REACTION_TIME_PROPERTY, config.fMaximumReactionTime);
 	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::LoadHitDeathReactionsConfig(const CActor& actor, const SReactionsFileData& fileData, SHitDeathReactionsConfigPtr pHitDeathReactionsConfig)
+{	
+	CRY_ASSERT(pHitDeathReactionsConfig.get());
+
+	*pHitDeathReactionsConfig = fileData.config;
+
+	const char* szCollisionBone = !fileData.sCollisionBone.empty() ? fileData.sCollisionBone.c_str() : NULL;
 
 	ICharacterInstance* pMainChar = actor.GetEntity()->GetCharacter(0);
 	CRY_ASSERT(pMainChar);
@@ -1090,90 +1346,91 @@ bool CHitDeathReactionsSystem::LoadHitDeathReactionsConfig(const CActor& actor,
 		if ((pHitDeathReactionsConfig->iCollisionBoneId == -1) && szCollisionBone)
 			Warning("Error finding collision bone (%s) for character %s", szCollisionBone, actor.GetEntity()->GetName());
 	}
-
-	return bSuccess;
 }
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-void CHitDeathReactionsSystem::LoadReactionsParams(const CActor& actor, IScriptTable* pHitDeathReactionsTable, const char* szReactionParamsName, bool bDeathReactions, ReactionId baseReactionId, ReactionsContainer& reactions)
+void CHitDeathReactionsSystem::LoadReactionsParams(const CActor& actor, IScriptTable* pHitDeathReactionsTable, const char* szReactionParamsName, const SReactionsFileData::ReactionContainer& fileReactions, bool bDeathReactions, ReactionId baseReactionId, ReactionsContainer& reactions)
 {
-	// Store list of reaction descriptions
+	// The script tables are only there if lua functions are going to use them
 	ScriptTablePtr pReactionsTable;
-	if (pHitDeathReactionsTable->GetValue(szReactionParamsName, pReactionsTable))
-	{
-		IScriptTable::Iterator it = pReactionsTable->BeginIteration();
+	if (pHitDeathReactionsTable)
+		pHitDeathReactionsTable->GetValue(szReactionParamsName, pReactionsTable);
 
-		for ( ; pReactionsTable->MoveNext(it); )
-		{
-			CRY_ASSERT(it.value.type == ANY_TTABLE);
+	// Store list of reaction descriptions
+	reactions.reserve(fileReactions.size());
 
-			const ReactionId thisReactionId =  (ReactionId(reactions.size() + 1) + baseReactionId) * (bDeathReactions ? -1 : 1);
+	SReactionsFileData::ReactionContainer::const_iterator itEnd = fileReactions.end();
+	for (SReactionsFileData::ReactionContainer::const_iterator it = fileReactions.begin(); it != itEnd; ++it)
+	{
+		const ReactionId thisReactionId =  (ReactionId(reactions.size() + 1) + baseReactionId) * (bDeathReactions ? -1 : 1);
+		const SReactionsFileData::SReaction& fileReaction = *it;
 
-			SReactionParams reactionParams;
-			GetReactionParamsFromScript(actor, it.value.table, reactionParams, thisReactionId);
+		SReactionParams reactionParams;
+		ResolveReactionParams(actor, fileReaction, reactionParams);
+
+		// Bound by the key of the table the reaction was read from, not by its position
+		ScriptTablePtr pReactionTable;
+		if (pReactionsTable && GetReactionScriptTable(pReactionsTable, fileReaction, pReactionTable))
+		{
+			BindReactionScriptTables(pReactionTable, fileReaction, thisReactionId, reactionParams);
 
 			// On load, write the reactionId on the reaction script table
 			// [*DavidR | 23/Feb/2010] workaround: reactionId is the index (in the range [1..size]) of the reaction 
 			// on the container, negative if is a death reaction container, positive if is a hit reaction container, 0 is invalid
 			// Collision reactions ids follow death reactions ids (I hate me)
-			it.value.table->SetValue(REACTION_ID, thisReactionId);
-
-			reactions.push_back(reactionParams);
+			pReactionTable->SetValue(REACTION_ID, thisReactionId);
 		}
-		pReactionsTable->EndIteration(it);
-
-		// Shrink capacity excess
-		ReactionsContainer(reactions).swap(reactions);
 
+		reactions.push_back(reactionParams);
+	}
 
 #ifndef _RELEASE
-		// Log loaded anims, if needed
-		if (g_pGameCVars->g_hitDeathReactions_logReactionAnimsOnLoading)
+	// Log loaded anims, if needed
+	if (g_pGameCVars->g_hitDeathReactions_logReactionAnimsOnLoading)
+	{
+		const bool bLogFilePaths = g_pGameCVars->g_hitDeathReactions_logReactionAnimsOnLoading == SCVars::eHDRLRAT_LogFilePaths;
+
+		ICharacterInstance* pMainChar = actor.GetEntity()->GetCharacter(0);
+		CRY_ASSERT(pMainChar);
+		IAnimationSet* pAnimSet = pMainChar ? pMainChar->GetIAnimationSet() : NULL;
+		if (pAnimSet)
 		{
-			const bool bLogFilePaths = g_pGameCVars->g_hitDeathReactions_logReactionAnimsOnLoading == SCVars::eHDRLRAT_LogFilePaths;
+			// avoid logging the same anim several times in the same character/reaction-file
+			typedef VectorMap<uint32, const char*> animationsLogEntries;
+			animationsLogEntries usedReactionAnims;
 
-			ICharacterInstance* pMainChar = actor.GetEntity()->GetCharacter(0);
-			CRY_ASSERT(pMainChar);
-			IAnimationSet* pAnimSet = pMainChar ? pMainChar->GetIAnimationSet() : NULL;
-			if (pAnimSet)
+			ReactionsContainer::const_iterator itReactionsEnd = reactions.end();
+			for (ReactionsContainer::const_iterator itReactions = reactions.begin(); itReactions != itReactionsEnd; ++itReactions)
 			{
-				// avoid logging the same anim several times in the same character/reaction-file
-				typedef VectorMap<uint32, const char*> animationsLogEntries;
-				animationsLogEntries usedReactionAnims;
-
-				ReactionsContainer::const_iterator itReactionsEnd = reactions.end();
-				for (ReactionsContainer::const_iterator itReactions = reactions.begin(); itReactions != itReactionsEnd; ++itReactions)
+				const SReactionParams::SReactionAnim& reactionAnim = *itReactions->reactionAnim;
+				if (!reactionAnim.animCRCs.empty())
 				{
-					const SReactionParams::SReactionAnim& reactionAnim = *itReactions->reactionAnim;
-					if (!reactionAnim.animCRCs.empty())
+					SReactionParams::AnimCRCContainer::const_iterator iterEnd = reactionAnim.animCRCs.end();
+					for (SReactionParams::AnimCRCContainer::const_iterator iter = reactionAnim.animCRCs.begin(); iter != iterEnd; ++iter)
 					{
-						SReactionParams::AnimCRCContainer::const_iterator iterEnd = reactionAnim.animCRCs.end();
-						for (SReactionParams::AnimCRCContainer::const_iterator iter = reactionAnim.animCRCs.begin(); iter != iterEnd; ++iter)
-						{
-							uint32 animCRC = *iter;
-							const char* szAnim = bLogFilePaths ? pAnimSet->GetFilePathByID(pAnimSet->GetAnimIDByCRC(animCRC)) : pAnimSet->GetNameByAnimID(pAnimSet->GetAnimIDByCRC(animCRC));
-							usedReactionAnims.insert(animationsLogEntries::value_type(animCRC, szAnim));
-						}
+						uint32 animCRC = *iter;
+						const char* szAnim = bLogFilePaths ? pAnimSet->GetFilePathByID(pAnimSet->GetAnimIDByCRC(animCRC)) : pAnimSet->GetNameByAnimID(pAnimSet->GetAnimIDByCRC(animCRC));
+						usedReactionAnims.insert(animationsLogEntries::value_type(animCRC, szAnim));
 					}
 				}
+			}
 
-				if (!usedReactionAnims.empty())
-				{
-					CryLogAlways("* %s non-animation-graph-triggered animations:", szReactionParamsName);
+			if (!usedReactionAnims.empty())
+			{
+				CryLogAlways("* %s non-animation-graph-triggered animations:", szReactionParamsName);
 
-					// Print
-					animationsLogEntries::const_iterator itLogsEnd = usedReactionAnims.end();
-					for (animationsLogEntries::const_iterator itLogs = usedReactionAnims.begin(); itLogs != itLogsEnd; ++itLogs)
-					{
-						const char* szAnimName = itLogs->second;
-						CryLogAlways("--- %s", szAnimName);
-					}
+				// Print
+				animationsLogEntries::const_iterator itLogsEnd = usedReactionAnims.end();
+				for (animationsLogEntries::const_iterator itLogs = usedReactionAnims.begin(); itLogs != itLogsEnd; ++itLogs)
+				{
+					const char* szAnimName = itLogs->second;
+					CryLogAlways("--- %s", szAnimName);
 				}
 			}
 		}
-#endif
 	}
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1204,14 +1461,56 @@ void CHitDeathReactionsSystem::PreProcessStanceParams(SmartScriptTable pReaction
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-void CHitDeathReactionsSystem::GetReactionParamsFromScript(const CActor& actor, const ScriptTablePtr pScriptTable, SReactionParams& reactionParams, ReactionId reactionId) const
+void CHitDeathReactionsSystem::BindReactionScriptTables(IScriptTable* pReactionTable, const SReactionsFileData::SReaction& fileReaction, ReactionId reactionId, SReactionParams& reactionParams) const
 {
-	CRY_ASSERT(pScriptTable.GetPtr());
+	// Cache scriptTablePtr
+	reactionParams.reactionScriptTable = pReactionTable;
 
-	reactionParams.Reset();
+	ScriptTablePtr pValidationParamsArray;
 
-	// Cache scriptTablePtr
-	reactionParams.reactionScriptTable = pScriptTable;
+	const int iCount = static_cast<int>(reactionParams.validationParams.size());
+	for (int i = 0; i < iCount; ++i)
+	{
+		const SReactionsFileData::SValidation& fileValidation = fileReaction.validations[i];
+
+		ScriptTablePtr pValidationParamsTable;
+		if (fileValidation.sourceIndex == 0)
+		{
+			// Root validation params
+			pValidationParamsTable = pReactionTable;
+		}
+		else
+		{
+			// Child validation params
+			if (!pValidationParamsArray)
+				pReactionTable->GetValue(VALIDATION_SECTION, pValidationParamsArray);
+
+			if (pValidationParamsArray)
+				pValidationParamsArray->GetAt(fileValidation.sourceIndex, pValidationParamsTable);
+		}
+
+		if (!pValidationParamsTable)
+		{
+			Warning("Couldn't find the script table of validation %d on reaction %d", fileValidation.sourceIndex, reactionId);
+			continue;
+		}
+
+		// Scripts expect the stance ids on the table, as if it had been parsed
+		if (fileValidation.bHasStances)
+			PreProcessStanceParams(pValidationParamsTable);
+
+		pValidationParamsTable->SetValue(VALIDATION_ID, i);
+		pValidationParamsTable->SetValue(REACTION_ID, reactionId);
+
+		reactionParams.validationParams[i].validationParamsScriptTable = pValidationParamsTable;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::GetReactionParamsFromScript(const char* szReactionsDataFile, const ScriptTablePtr pScriptTable, SReactionsFileData::SReaction& reaction) const
+{
+	CRY_ASSERT(pScriptTable.GetPtr());
 
 	// Cache validation properties
 	{
@@ -1224,33 +1523,26 @@ void CHitDeathReactionsSystem::GetReactionParamsFromScript(const CActor& actor,
 			int iCount = pValidationParamsArray->Count();
 			if (iCount > 0)
 			{
-				reactionParams.validationParams.reserve(iCount);
+				reaction.validations.reserve(iCount);
 				for (int i = 0; i < iCount; ++i)
 				{
 					ScriptTablePtr pValidationParamsTable;
 					if (pValidationParamsArray->GetAt(i + 1, pValidationParamsTable)) 
 					{
-						SReactionParams::SValidationParams validationParams;
-						if (GetValidationParamsFromScript(pValidationParamsTable, validationParams, actor, reactionId))
-						{
-							validationParams.validationParamsScriptTable->SetValue(VALIDATION_ID, static_cast<int>(reactionParams.validationParams.size()));
-							reactionParams.validationParams.push_back(validationParams);
-						}
+						SReactionsFileData::SValidation validation;
+						validation.sourceIndex = i + 1;
+						if (GetValidationParamsFromScript(pValidationParamsTable, validation))
+							reaction.validations.push_back(validation);
 					}
 				}
 			}
 		}
 		else
 		{
-			reactionParams.validationParams.reserve(1);
-
 			// Root validation params
-			SReactionParams::SValidationParams validationParams;
-			if (GetValidationParamsFromScript(pScriptTable, validationParams, actor, reactionId))
-			{
-				validationParams.validationParamsScriptTable->SetValue(VALIDATION_ID, 0);
-				reactionParams.validationParams.push_back(validationParams);
-			}
+			SReactionsFileData::SValidation validation;
+			if (GetValidationParamsFromScript(pScriptTable, validation))
+				reaction.validations.push_back(validation);
 		}
 	}
 
@@ -1259,14 +1551,14 @@ void CHitDeathReactionsSystem::GetReactionParamsFromScript(const CActor& actor,
 	{
 		const char* szExecutionFunc = NULL;
 		if (pScriptTable->GetValue(REACTION_FUNC_PROPERTY, szExecutionFunc) && szExecutionFunc && (szExecutionFunc[0] != '\0'))
-			reactionParams.sCustomExecutionFunc = szExecutionFunc;
+			reaction.sCustomExecutionFunc = szExecutionFunc;
 	}
 
 	if (pScriptTable->HaveValue(AISIGNAL_PROPERTY))
 	{
 		const char* szSignal = NULL;
 		if (pScriptTable->GetValue(AISIGNAL_PROPERTY, szSignal) && szSignal && (szSignal[0] != '\0'))
-			reactionParams.sCustomAISignal = szSignal;
+			reaction.sCustomAISignal = szSignal;
 	}
 
 	if (pScriptTable->HaveValue(REACTION_ON_COLLISION_PROPERTY) || 
@@ -1278,7 +1570,7 @@ void CHitDeathReactionsSystem::GetReactionParamsFromScript(const CActor& actor,
 		if (!pScriptTable->GetValue(REACTION_ON_COLLISION_PROPERTY, reactionOnCollision))
 			pScriptTable->GetValue(RAGDOLL_ON_COLLISION_PROPERTY, bRagdollOnCollision);
 
-		reactionParams.reactionOnCollision = bRagdollOnCollision ? 1 : reactionOnCollision;
+		reaction.reactionOnCollision = bRagdollOnCollision ? 1 : reactionOnCollision;
 	}
 
 	if (pScriptTable->HaveValue(COLLISION_CHECK_INTERSECTION_WITH_GROUND))
@@ -1289,32 +1581,32 @@ void CHitDeathReactionsSystem::GetReactionParamsFromScript(const CActor& actor,
 
 		if(bCollisionCheckIntersectionWithGround)
 		{
-			reactionParams.flags |= SReactionParams::CollisionCheckIntersectionWithGround;
+			reaction.flags |= SReactionParams::CollisionCheckIntersectionWithGround;
 		}
 	}
 
 	if (pScriptTable->HaveValue(PAUSE_AI_PROPERTY))
 	{
-		pScriptTable->GetValue(PAUSE_AI_PROPERTY, reactionParams.bPauseAI);
+		pScriptTable->GetValue(PAUSE_AI_PROPERTY, reaction.bPauseAI);
 	}
 
 	if (pScriptTable->HaveValue(NO_RAGDOLL_ON_END_PROPERTY))
 	{
 		bool bNoRagdollOnEnd = false;
 		pScriptTable->GetValue(NO_RAGDOLL_ON_END_PROPERTY, bNoRagdollOnEnd);
-		reactionParams.flags |= static_cast<int>(bNoRagdollOnEnd) * SReactionParams::NoRagdollOnEnd;
+		reaction.flags |= static_cast<int>(bNoRagdollOnEnd) * SReactionParams::NoRagdollOnEnd;
 	}
 
 	if (pScriptTable->HaveValue(REACTION_FINISHES_AIMING_PROPERTY))
 	{
 		bool bReactionFinishesAiming = false;
 		pScriptTable->GetValue(REACTION_FINISHES_AIMING_PROPERTY, bReactionFinishesAiming);
-		reactionParams.flags |= static_cast<int>(!bReactionFinishesAiming) * SReactionParams::ReactionFinishesNotAiming;
+		reaction.flags |= static_cast<int>(!bReactionFinishesAiming) * SReactionParams::ReactionFinishesNotAiming;
 	}
 
 	if (pScriptTable->HaveValue(END_VELOCITY_PROPERTY))
 	{
-		pScriptTable->GetValue(END_VELOCITY_PROPERTY, reactionParams.endVelocity);
+		pScriptTable->GetValue(END_VELOCITY_PROPERTY, reaction.endVelocity);
 	}
 
 	if (pScriptTable->HaveValue(AG_REACTION_TABLE)) 
@@ -1328,12 +1620,12 @@ void CHitDeathReactionsSystem::GetReactionParamsFromScript(const CActor& actor,
 			{
 				const char* szAGInputValue = NULL;
 				if (pReactionProperty->GetValue(AG_INPUT_VALUE_PROPERTY, szAGInputValue) && szAGInputValue && (szAGInputValue[0] != '\0'))
-					reactionParams.agReaction.sAGInputValue = szAGInputValue;
+					reaction.sAGInputValue = szAGInputValue;
 			}
 
 			if (pReactionProperty->HaveValue(VARIATIONS_ARRAY))
 			{
-				if (!reactionParams.agReaction.sAGInputValue.empty())
+				if (!reaction.sAGInputValue.empty())
 				{
 					ScriptTablePtr pVariationsArray;
 					pReactionProperty->GetValue(VARIATIONS_ARRAY, pVariationsArray);
@@ -1348,8 +1640,8 @@ void CHitDeathReactionsSystem::GetReactionParamsFromScript(const CActor& actor,
 							const char* szVariationValue = NULL;
 							if (pVariation->GetValue(VARIATION_NAME, szVariationName) && pVariation->GetValue(VARIATION_VALUE, szVariationValue))
 							{
-								SReactionParams::SAnimGraphReaction::SVariationData variationData(szVariationName, szVariationValue);
-								reactionParams.agReaction.variations.push_back(variationData);
+								reaction.variationNames.push_back(szVariationName);
+								reaction.variationValues.push_back(szVariationValue);
 							}
 						}
 					}
@@ -1362,68 +1654,48 @@ void CHitDeathReactionsSystem::GetReactionParamsFromScript(const CActor& actor,
 			Warning("Error reading %s property. Expected a table", AG_REACTION_TABLE);
 	}
 
-	reactionParams.reactionAnim.reset(new SReactionParams::SReactionAnim);
-	GetReactionAnimParamsFromScript(actor, pScriptTable, *reactionParams.reactionAnim);
+	GetReactionAnimParamsFromScript(pScriptTable, reaction);
 
 	if (pScriptTable->HaveValue(SNAP_ORIENTATION_ANGLE))
 	{
 		int angle = 0;
 		pScriptTable->GetValue(SNAP_ORIENTATION_ANGLE, angle);
-		reactionParams.orientationSnapAngle = DEG2RAD(static_cast<float>(angle));
-		reactionParams.flags |= SReactionParams::OrientateToHitDir;
+		reaction.orientationSnapAngle = DEG2RAD(static_cast<float>(angle));
+		reaction.flags |= SReactionParams::OrientateToHitDir;
 	}
 
 	// Orientate to movement dir has priority over orientation to movement dir
 	if (pScriptTable->HaveValue(SNAP_TO_MOVEMENT_DIR))
 	{
 #ifndef _RELEASE
-		if (reactionParams.flags & SReactionParams::OrientateToHitDir)
+		if (reaction.flags & SReactionParams::OrientateToHitDir)
 		{
-			ScriptTablePtr pActorScriptTable = actor.GetEntity()->GetScriptTable();
-			CRY_ASSERT(pActorScriptTable.GetPtr());
-
-			ScriptAnyValue propertiesTable;
-			pActorScriptTable->GetValueAny(ACTOR_PROPERTIES_TABLE, propertiesTable);
-
-			const char* szReactionsDataFilePath = NULL;
-			if ((propertiesTable.type == ANY_TTABLE) && propertiesTable.table->GetValue(REACTIONS_DATA_FILE_PROPERTY, szReactionsDataFilePath))
-			{
-				Warning("Both %s and %s properties were used in a reaction. Only %s will have any effect! While reading %s", SNAP_ORIENTATION_ANGLE, SNAP_TO_MOVEMENT_DIR, SNAP_TO_MOVEMENT_DIR, szReactionsDataFilePath);
-			}
-			else
-			{
-				Warning("Both %s and %s properties were used in a reaction. Only %s will have any effect!", SNAP_ORIENTATION_ANGLE, SNAP_TO_MOVEMENT_DIR, SNAP_TO_MOVEMENT_DIR);
-			}
+			Warning("Both %s and %s properties were used in a reaction. Only %s will have any effect! While reading %s", SNAP_ORIENTATION_ANGLE, SNAP_TO_MOVEMENT_DIR, SNAP_TO_MOVEMENT_DIR, szReactionsDataFile);
 		}
 #endif
 
 		int angle = 0;
 		pScriptTable->GetValue(SNAP_TO_MOVEMENT_DIR, angle);
-		reactionParams.orientationSnapAngle = DEG2RAD(static_cast<float>(angle));
-		reactionParams.flags &= ~SReactionParams::OrientateToHitDir;
-		reactionParams.flags |= SReactionParams::OrientateToMovementDir;
+		reaction.orientationSnapAngle = DEG2RAD(static_cast<float>(angle));
+		reaction.flags &= ~SReactionParams::OrientateToHitDir;
+		reaction.flags |= SReactionParams::OrientateToMovementDir;
 	}
 }
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-bool CHitDeathReactionsSystem::GetValidationParamsFromScript(const ScriptTablePtr pScriptTable, SReactionParams::SValidationParams &validationParams, const CActor &actor, ReactionId reactionId) const
+bool CHitDeathReactionsSystem::GetValidationParamsFromScript(const ScriptTablePtr pScriptTable, SReactionsFileData::SValidation& validation) const
 {
 	PreProcessStanceParams(pScriptTable);
 
 	bool bHadValidationParams = false;
 
-	validationParams.Reset();
-
-	// Cache scriptTablePtr
-	validationParams.validationParamsScriptTable = pScriptTable;
-
 	if (pScriptTable->HaveValue(VALIDATION_FUNC_PROPERTY))
 	{
 		const char* szValidationFunc = NULL;
 		if (pScriptTable->GetValue(VALIDATION_FUNC_PROPERTY, szValidationFunc) && szValidationFunc && (szValidationFunc[0] != '\0'))
 		{
-			validationParams.sCustomValidationFunc = szValidationFunc;
+			validation.sCustomValidationFunc = szValidationFunc;
 
 			bHadValidationParams = true;
 		}
@@ -1431,28 +1703,28 @@ bool CHitDeathReactionsSystem::GetValidationParamsFromScript(const ScriptTablePt
 
 	if (pScriptTable->HaveValue(MINIMUM_SPEED_PROPERTY)) 
 	{
-		pScriptTable->GetValue(MINIMUM_SPEED_PROPERTY, validationParams.fMinimumSpeedAllowed);
+		pScriptTable->GetValue(MINIMUM_SPEED_PROPERTY, validation.fMinimumSpeedAllowed);
 
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(MAXIMUM_SPEED_PROPERTY)) 
 	{
-		pScriptTable->GetValue(MAXIMUM_SPEED_PROPERTY, validationParams.fMaximumSpeedAllowed);
+		pScriptTable->GetValue(MAXIMUM_SPEED_PROPERTY, validation.fMaximumSpeedAllowed);
 
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(MINIMUM_DAMAGE_PROPERTY)) 
 	{
-		pScriptTable->GetValue(MINIMUM_DAMAGE_PROPERTY, validationParams.fMinimumDamageAllowed);
+		pScriptTable->GetValue(MINIMUM_DAMAGE_PROPERTY, validation.fMinimumDamageAllowed);
 
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(MAXIMUM_DAMAGE_PROPERTY)) 
 	{
-		pScriptTable->GetValue(MAXIMUM_DAMAGE_PROPERTY, validationParams.fMaximumDamageAllowed);
+		pScriptTable->GetValue(MAXIMUM_DAMAGE_PROPERTY, validation.fMaximumDamageAllowed);
 
 		bHadValidationParams = true;
 	}
@@ -1467,60 +1739,34 @@ bool CHitDeathReactionsSystem::GetValidationParamsFromScript(const ScriptTablePt
 		{
 			bHadValidationParams = true;
 
-			validationParams.healthThresholds.reserve(iCount);
-
-			// const float fActorMaxHealth = actor.GetMaxHealth();
-			// [*DavidR | 8/Nov/2010] Unfortunately, on initialization maxHealth hasn't been set yet, since it's set on 
-			// the ScriptPRoxy initialization(which always happens last), from OnInit methods. We need to obtain it from the script
-			ScriptTablePtr pActorScriptTable = actor.GetEntity()->GetScriptTable();
-			CRY_ASSERT(pActorScriptTable.GetPtr());
-
-			float fActorMaxHealth = actor.GetMaxHealth();
-			ScriptTablePtr propertiesTable;
-			ScriptTablePtr propertiesDamageTable;
-			if (pActorScriptTable->GetValue(ACTOR_PROPERTIES_TABLE, propertiesTable) && 
-				propertiesTable->GetValue(ACTOR_PROPERTIES_DAMAGE_TABLE, propertiesDamageTable)) 
-				propertiesDamageTable->GetValue(ACTOR_PROPERTIES_DAMAGE_MAXHEALTH, fActorMaxHealth);
-
+			// Kept as authored, they depend on the max health of the actor using the profile
+			validation.healthThresholds.reserve(iCount);
 			for (int i = 0; i < iCount; ++i)
 			{
 				float fThreshold = -1.0f;
 				if (pHealthThresholdsArray->GetAt(i + 1, fThreshold))
-				{
-					Limit(fThreshold, 0.0f, fActorMaxHealth);
-
-					// If the specified value is lower or equal to 1.0f then it's a decimal percentage ([0.0, 1.0])
-					// If is greater then is an absolute health value. Specifying an absolute value of 1.0 makes no sense
-					// since it's impossible to have less health than 1 without being dead
-					if (fThreshold <= 1.0f)
-					{
-						fThreshold *= fActorMaxHealth;
-					}
-
-					if (fThreshold > 0.0f)
-						validationParams.healthThresholds.insert(fThreshold);
-				}
+					validation.healthThresholds.push_back(fThreshold);
 			}
 		}
 	}
 
 	if (pScriptTable->HaveValue(MINIMUM_DISTANCE_PROPERTY))
 	{
-		pScriptTable->GetValue(MINIMUM_DISTANCE_PROPERTY, validationParams.fMinimumDistance);
+		pScriptTable->GetValue(MINIMUM_DISTANCE_PROPERTY, validation.fMinimumDistance);
 
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(MAXIMUM_DISTANCE_PROPERTY))
 	{
-		pScriptTable->GetValue(MAXIMUM_DISTANCE_PROPERTY, validationParams.fMaximumDistance);
+		pScriptTable->GetValue(MAXIMUM_DISTANCE_PROPERTY, validation.fMaximumDistance);
 
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(ALLOWED_PARTS_ARRAY))
 	{
-		FillAllowedPartIds(actor, pScriptTable, validationParams);
+		GetNamesFromScript(pScriptTable, ALLOWED_PARTS_ARRAY, validation.partNames);
 		bHadValidationParams = true;
 	}
 
@@ -1529,7 +1775,7 @@ bool CHitDeathReactionsSystem::GetValidationParamsFromScript(const ScriptTablePt
 		const char* szMovementDirection = NULL;
 		pScriptTable->GetValue(MOVEMENT_DIRECTION_PROPERTY, szMovementDirection);
 
-		validationParams.movementDir = GetCardinalDirectionFromString(szMovementDirection);
+		validation.movementDir = static_cast<int8>(GetCardinalDirectionFromString(szMovementDirection));
 
 		bHadValidationParams = true;
 	}
@@ -1539,15 +1785,15 @@ bool CHitDeathReactionsSystem::GetValidationParamsFromScript(const ScriptTablePt
 		const char* szShotOrigin = NULL;
 		pScriptTable->GetValue(SHOT_ORIGIN_PROPERTY, szShotOrigin);
 
-		validationParams.shotOrigin = GetCardinalDirectionFromString(szShotOrigin);
+		validation.shotOrigin = static_cast<int8>(GetCardinalDirectionFromString(szShotOrigin));
 
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(PROBABILITY_PERCENT_PROPERTY))
 	{
-		pScriptTable->GetValue(PROBABILITY_PERCENT_PROPERTY, validationParams.fProbability);
-		Limit(validationParams.fProbability, 0.0f, 1.0f);
+		pScriptTable->GetValue(PROBABILITY_PERCENT_PROPERTY, validation.fProbability);
+		Limit(validation.fProbability, 0.0f, 1.0f);
 
 		bHadValidationParams = true;
 	}
@@ -1558,76 +1804,41 @@ bool CHitDeathReactionsSystem::GetValidationParamsFromScript(const ScriptTablePt
 		pScriptTable->GetValue(ALLOWED_STANCES_ARRAY, pAllowedStancesArray);
 
 		int iCount = pAllowedStancesArray->Count();
+		validation.stances.reserve(iCount);
 		for (int i = 0; i < iCount; ++i)
 		{
 			int iStance = -1;
 			pAllowedStancesArray->GetAt(i + 1, iStance);
 			CRY_ASSERT(iStance != -1);
 
-			validationParams.allowedStances.insert(static_cast<EStance>(iStance));
+			validation.stances.push_back(iStance);
 		}
 
+		validation.bHasStances = true;
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(ALLOWED_HIT_TYPES_ARRAY))
 	{
-		ScriptTablePtr pAllowedHitTypesArray;
-		pScriptTable->GetValue(ALLOWED_HIT_TYPES_ARRAY, pAllowedHitTypesArray);
-
-		int iCount = pAllowedHitTypesArray->Count();
-		for (int i = 0; i < iCount; ++i)
-		{
-			const char* szHitType = NULL;
-			pAllowedHitTypesArray->GetAt(i + 1, szHitType);
-
-			validationParams.allowedHitTypes.insert(g_pGame->GetGameRules()->GetHitTypeId(szHitType));
-		}
-
+		GetNamesFromScript(pScriptTable, ALLOWED_HIT_TYPES_ARRAY, validation.hitTypeNames);
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(ALLOWED_PROJECTILES_ARRAY))
 	{
-		ScriptTablePtr pAllowedProjectilesArray;
-		pScriptTable->GetValue(ALLOWED_PROJECTILES_ARRAY, pAllowedProjectilesArray);
-
-		int iCount = pAllowedProjectilesArray->Count();
-		for (int i = 0; i < iCount; ++i)
-		{
-			const char* szProjClass = NULL;
-			pAllowedProjectilesArray->GetAt(i + 1, szProjClass);
-
-			uint16 uProjClassId = 0;
-			if (g_pGame->GetIGameFramework()->GetNetworkSafeClassId(uProjClassId, szProjClass))
-				validationParams.allowedProjectiles.insert(uProjClassId);
-		}
-
+		GetNamesFromScript(pScriptTable, ALLOWED_PROJECTILES_ARRAY, validation.projectileClassNames);
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(ALLOWED_WEAPONS_ARRAY))
 	{
-		ScriptTablePtr pAllowedWeapons;
-		pScriptTable->GetValue(ALLOWED_WEAPONS_ARRAY, pAllowedWeapons);
-
-		int iCount = pAllowedWeapons->Count();
-		for (int i = 0; i < iCount; ++i)
-		{
-			const char* szWeaponClass = NULL;
-			pAllowedWeapons->GetAt(i + 1, szWeaponClass);
-
-			uint16 uProjClassId = 0;
-			if (g_pGame->GetIGameFramework()->GetNetworkSafeClassId(uProjClassId, szWeaponClass))
-				validationParams.allowedWeapons.insert(uProjClassId);
-		}
-
+		GetNamesFromScript(pScriptTable, ALLOWED_WEAPONS_ARRAY, validation.weaponClassNames);
 		bHadValidationParams = true;
 	}
 
 	if (pScriptTable->HaveValue(ONLY_IF_USING_MOUNTED_ITEM_PROPERTY))
 	{
-		pScriptTable->GetValue(ONLY_IF_USING_MOUNTED_ITEM_PROPERTY, validationParams.bAllowOnlyWhenUsingMountedItems);
+		pScriptTable->GetValue(ONLY_IF_USING_MOUNTED_ITEM_PROPERTY, validation.bAllowOnlyWhenUsingMountedItems);
 		bHadValidationParams = true;
 	}
 
@@ -1637,165 +1848,281 @@ bool CHitDeathReactionsSystem::GetValidationParamsFromScript(const ScriptTablePt
 		if (pScriptTable->GetValue(DESTRUCTIBLE_EVENT_PROPERTY, szDestructibleEvent) && szDestructibleEvent && (szDestructibleEvent[0] != '\0'))
 		{
 			const Crc32Gen* pCRC32 = gEnv->pSystem->GetCrc32Gen();
-			validationParams.destructibleEvent = pCRC32->GetCRC32Lowercase(szDestructibleEvent);
+			validation.destructibleEvent = pCRC32->GetCRC32Lowercase(szDestructibleEvent);
 		}
 
 		bHadValidationParams = true;
 	}
 
-	if (bHadValidationParams)
-		validationParams.validationParamsScriptTable->SetValue(REACTION_ID, reactionId);
-
 	return bHadValidationParams;
 }
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-void CHitDeathReactionsSystem::GetReactionAnimParamsFromScript(const CActor& actor, ScriptTablePtr pScriptTable, SReactionParams::SReactionAnim& reactionAnim) const
+void CHitDeathReactionsSystem::GetReactionAnimParamsFromScript(ScriptTablePtr pScriptTable, SReactionsFileData::SReaction& reaction) const
 {
-	ICharacterInstance* pMainChar = actor.GetEntity()->GetCharacter(0);
-	CRY_ASSERT(pMainChar);
-	IAnimationSet* pAnimSet = pMainChar ? pMainChar->GetIAnimationSet() : NULL;
-	if (pAnimSet)
+	if (pScriptTable->HaveValue(REACTION_ANIM_NAME_PROPERTY))
+	{
+		// Kept for backwards compatibility and to help keeping the reactions as simple as possible
+		const char* szAnimName = NULL;
+		if (pScriptTable->GetValue(REACTION_ANIM_NAME_PROPERTY, szAnimName) && szAnimName)
+			reaction.animNames.push_back(szAnimName);
+	}
+
+	if (pScriptTable->HaveValue(REACTION_ANIM_PROPERTY)) 
 	{
-		if (pScriptTable->HaveValue(REACTION_ANIM_NAME_PROPERTY))
+		ScriptAnyValue reactionAnimTable;
+		if (pScriptTable->GetValueAny(REACTION_ANIM_PROPERTY, reactionAnimTable) && (reactionAnimTable.type == ANY_TTABLE))
 		{
-			// Kept for backwards compatibility and to help keeping the reactions as simple as possible
-			const char* szAnimName = NULL;
-			if (pScriptTable->GetValue(REACTION_ANIM_NAME_PROPERTY, szAnimName))
+			ScriptTablePtr pReactionAnimTable(reactionAnimTable.table);
+
+			// Additive anim?
+			if (pReactionAnimTable->HaveValue(REACTION_ANIM_ADDITIVE_ANIM))
 			{
-				int iAnimID = pAnimSet->GetAnimIDByName(szAnimName);
-				if (iAnimID >= 0)
-				{
-					uint32 animCRC = NameCRCHelper::GetCRC(szAnimName);
-					reactionAnim.animCRCs.push_back(animCRC);
-				}
-				else
-				{
-					AnimIDError(szAnimName);
-				}
+				pReactionAnimTable->GetValue(REACTION_ANIM_ADDITIVE_ANIM, reaction.bAdditive);
 			}
-		}
 
-		if (pScriptTable->HaveValue(REACTION_ANIM_PROPERTY)) 
-		{
-			ScriptAnyValue reactionAnimTable;
-			if (pScriptTable->GetValueAny(REACTION_ANIM_PROPERTY, reactionAnimTable) && (reactionAnimTable.type == ANY_TTABLE))
+			// Animation layer
+			if (pReactionAnimTable->HaveValue(REACTION_ANIM_LAYER))
 			{
-				ScriptTablePtr pReactionAnimTable(reactionAnimTable.table);
-
-				// Additive anim?
-				if (pReactionAnimTable->HaveValue(REACTION_ANIM_ADDITIVE_ANIM))
-				{
-					pReactionAnimTable->GetValue(REACTION_ANIM_ADDITIVE_ANIM, reactionAnim.bAdditive);
-				}
+				pReactionAnimTable->GetValue(REACTION_ANIM_LAYER, reaction.iAnimLayer);
+			}
 
-				// Animation layer
-				if (pReactionAnimTable->HaveValue(REACTION_ANIM_LAYER))
-				{
-					pReactionAnimTable->GetValue(REACTION_ANIM_LAYER, reactionAnim.iLayer);
-				}
+			// Used for overriding the transition time the animation on the current AG state is going to use when resumed
+			if (pReactionAnimTable->HaveValue(REACTION_ANIM_OVERRIDE_TRANS_TIME_TO_AG))
+			{
+				pReactionAnimTable->GetValue(REACTION_ANIM_OVERRIDE_TRANS_TIME_TO_AG, reaction.fOverrideTransTimeToAG);
+			}
 
-				// Used for overriding the transition time the animation on the current AG state is going to use when resumed
-				if (pReactionAnimTable->HaveValue(REACTION_ANIM_OVERRIDE_TRANS_TIME_TO_AG))
-				{
-					pReactionAnimTable->GetValue(REACTION_ANIM_OVERRIDE_TRANS_TIME_TO_AG, reactionAnim.fOverrideTransTimeToAG);
-				}
+			// Flag to force no anim-controlled camera on 1st person players
+			if (pReactionAnimTable->HaveValue(REACTION_ANIM_NO_ANIM_CAMERA))
+			{
+				pReactionAnimTable->GetValue(REACTION_ANIM_NO_ANIM_CAMERA, reaction.bNoAnimCamera);
+			}
 
-				// Flag to force no anim-controlled camera on 1st person players
-				if (pReactionAnimTable->HaveValue(REACTION_ANIM_NO_ANIM_CAMERA))
-				{
-					pReactionAnimTable->GetValue(REACTION_ANIM_NO_ANIM_CAMERA, reactionAnim.bNoAnimCamera);
-				}
+			// List of animations and their variation
+			if (pReactionAnimTable->HaveValue(ANIM_NAME_ARRAY)) 
+			{
+				ScriptTablePtr pAnimationArray;
+				pReactionAnimTable->GetValue(ANIM_NAME_ARRAY, pAnimationArray);
 
-				// List of animations and their variation
-				if (pReactionAnimTable->HaveValue(ANIM_NAME_ARRAY)) 
+				int iCount = pAnimationArray->Count();
+				for (int i = 0; i < iCount; ++i)
 				{
-					ScriptTablePtr pAnimationArray;
-					pReactionAnimTable->GetValue(ANIM_NAME_ARRAY, pAnimationArray);
-
-					int iCount = pAnimationArray->Count();
-					for (int i = 0; i < iCount; ++i)
+					ScriptTablePtr pAnimation;
+					if (pAnimationArray->GetAt(i + 1, pAnimation))
 					{
-						ScriptTablePtr pAnimation;
-						if (pAnimationArray->GetAt(i + 1, pAnimation))
+						const char* szReactionAnim = NULL;
+						if (pAnimation->GetValue(ANIM_NAME_PROPERTY, szReactionAnim) && szReactionAnim && (szReactionAnim[0] != '\0'))
 						{
-							const char* szReactionAnim = NULL;
-							if (pAnimation->GetValue(ANIM_NAME_PROPERTY, szReactionAnim) && szReactionAnim && (szReactionAnim[0] != '\0'))
+							int variants = 0;
+							if (pAnimation->GetValue(ANIM_VARIANTS_PROPERTY, variants))
 							{
-								int variants = 0;
-								if (pAnimation->GetValue(ANIM_VARIANTS_PROPERTY, variants))
-								{
-									//--- Load in all variants
-									CryPathString variantName;
-
-									for (int k = 0; k < variants; k++)
-									{
-										variantName.FormatFast("%s%d", szReactionAnim, k + 1);
-
-										int animID = pAnimSet->GetAnimIDByName(variantName);
-										if (animID >= 0)
-										{
-											uint32 animCRC = NameCRCHelper::GetCRC(variantName);
-											reactionAnim.animCRCs.push_back(animCRC);
-										}
-										else
-										{
-											AnimIDError(variantName);
-										}
-									}
-								}
-								else
+								//--- Load in all variants
+								CryPathString variantName;
+
+								for (int k = 0; k < variants; k++)
 								{
-									//--- Load in the single animation
-									int iAnimID = pAnimSet->GetAnimIDByName(szReactionAnim);
-									if (iAnimID >= 0)
-									{
-										uint32 animCRC = NameCRCHelper::GetCRC(szReactionAnim);
-										reactionAnim.animCRCs.push_back(animCRC);
-									}
-									else
-									{
-										AnimIDError(szReactionAnim);
-									}
+									variantName.FormatFast("%s%d", szReactionAnim, k + 1);
+									reaction.animNames.push_back(variantName.c_str());
 								}
 							}
+							else
+							{
+								//--- Load in the single animation
+								reaction.animNames.push_back(szReactionAnim);
+							}
 						}
 					}
+				}
+			}
+		}
+	}
+}
 
-					// Shrink capacity excess
-					SReactionParams::AnimCRCContainer(reactionAnim.animCRCs).swap(reactionAnim.animCRCs);
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::GetNamesFromScript(const ScriptTablePtr pScriptTable, const char* szArrayName, SReactionsFileData::NameContainer& names) const
+{
+	ScriptTablePtr pNamesArray;
+	pScriptTable->GetValue(szArrayName, pNamesArray);
 
-					// Shuffle IDs
-					SRandomGeneratorFunct randomFunctor(m_pseudoRandom);
-					std::random_shuffle(reactionAnim.animCRCs.begin(), reactionAnim.animCRCs.end(), randomFunctor);
-				}
+	int iCount = pNamesArray ? pNamesArray->Count() : 0;
+	names.reserve(iCount);
+	for (int i = 0; i < iCount; ++i)
+	{
+		const char* szName = NULL;
+		if (pNamesArray->GetAt(i + 1, szName) && szName)
+			names.push_back(szName);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::ResolveReactionParams(const CActor& actor, const SReactionsFileData::SReaction& fileReaction, SReactionParams& reactionParams) const
+{
+	reactionParams.Reset();
+
+	// Validation properties
+	const int iCount = static_cast<int>(fileReaction.validations.size());
+	reactionParams.validationParams.resize(iCount);
+	for (int i = 0; i < iCount; ++i)
+		ResolveValidationParams(actor, fileReaction.validations[i], reactionParams.validationParams[i]);
+
+	// Execution properties
+	reactionParams.sCustomExecutionFunc = fileReaction.sCustomExecutionFunc;
+	reactionParams.sCustomAISignal = fileReaction.sCustomAISignal;
+	reactionParams.reactionOnCollision = fileReaction.reactionOnCollision;
+	reactionParams.flags = fileReaction.flags;
+	reactionParams.bPauseAI = fileReaction.bPauseAI;
+	reactionParams.endVelocity = fileReaction.endVelocity;
+	reactionParams.orientationSnapAngle = fileReaction.orientationSnapAngle;
+
+	reactionParams.agReaction.sAGInputValue = fileReaction.sAGInputValue;
+	const int iVariations = static_cast<int>(fileReaction.variationNames.size());
+	reactionParams.agReaction.variations.reserve(iVariations);
+	for (int i = 0; i < iVariations; ++i)
+	{
+		SReactionParams::SAnimGraphReaction::SVariationData variationData(fileReaction.variationNames[i].c_str(), fileReaction.variationValues[i].c_str());
+		reactionParams.agReaction.variations.push_back(variationData);
+	}
+
+	reactionParams.reactionAnim.reset(new SReactionParams::SReactionAnim);
+	ResolveReactionAnimParams(actor, fileReaction, *reactionParams.reactionAnim);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::ResolveValidationParams(const CActor& actor, const SReactionsFileData::SValidation& fileValidation, SReactionParams::SValidationParams& validationParams) const
+{
+	validationParams.Reset();
+
+	validationParams.sCustomValidationFunc = fileValidation.sCustomValidationFunc;
+	validationParams.fMinimumSpeedAllowed = fileValidation.fMinimumSpeedAllowed;
+	validationParams.fMaximumSpeedAllowed = fileValidation.fMaximumSpeedAllowed;
+	validationParams.fMinimumDamageAllowed = fileValidation.fMinimumDamageAllowed;
+	validationParams.fMaximumDamageAllowed = fileValidation.fMaximumDamageAllowed;
+	validationParams.fMinimumDistance = fileValidation.fMinimumDistance;
+	validationParams.fMaximumDistance = fileValidation.fMaximumDistance;
+	validationParams.fProbability = fileValidation.fProbability;
+	validationParams.destructibleEvent = fileValidation.destructibleEvent;
+	validationParams.shotOrigin = static_cast<ECardinalDirection>(fileValidation.shotOrigin);
+	validationParams.movementDir = static_cast<ECardinalDirection>(fileValidation.movementDir);
+	validationParams.bAllowOnlyWhenUsingMountedItems = fileValidation.bAllowOnlyWhenUsingMountedItems;
+
+	for (std::vector<int>::const_iterator it = fileValidation.stances.begin(), itEnd = fileValidation.stances.end(); it != itEnd; ++it)
+		validationParams.allowedStances.insert(static_cast<EStance>(*it));
+
+	if (!fileValidation.healthThresholds.empty())
+	{
+		// const float fActorMaxHealth = actor.GetMaxHealth();
+		// [*DavidR | 8/Nov/2010] Unfortunately, on initialization maxHealth hasn't been set yet, since it's set on 
+		// the ScriptPRoxy initialization(which always happens last), from OnInit methods. We need to obtain it from the script
+		ScriptTablePtr pActorScriptTable = actor.GetEntity()->GetScriptTable();
+		CRY_ASSERT(pActorScriptTable.GetPtr());
+
+		float fActorMaxHealth = actor.GetMaxHealth();
+		ScriptTablePtr propertiesTable;
+		ScriptTablePtr propertiesDamageTable;
+		if (pActorScriptTable->GetValue(ACTOR_PROPERTIES_TABLE, propertiesTable) && 
+			propertiesTable->GetValue(ACTOR_PROPERTIES_DAMAGE_TABLE, propertiesDamageTable)) 
+			propertiesDamageTable->GetValue(ACTOR_PROPERTIES_DAMAGE_MAXHEALTH, fActorMaxHealth);
+
+		validationParams.healthThresholds.reserve(fileValidation.healthThresholds.size());
+		for (std::vector<float>::const_iterator it = fileValidation.healthThresholds.begin(), itEnd = fileValidation.healthThresholds.end(); it != itEnd; ++it)
+		{
+			float fThreshold = *it;
+			Limit(fThreshold, 0.0f, fActorMaxHealth);
+
+			// If the specified value is lower or equal to 1.0f then it's a decimal percentage ([0.0, 1.0])
+			// If is greater then is an absolute health value. Specifying an absolute value of 1.0 makes no sense
+			// since it's impossible to have less health than 1 without being dead
+			if (fThreshold <= 1.0f)
+			{
+				fThreshold *= fActorMaxHealth;
 			}
+
+			if (fThreshold > 0.0f)
+				validationParams.healthThresholds.insert(fThreshold);
 		}
+	}
+
+	if (!fileValidation.partNames.empty())
+		FillAllowedPartIds(actor, fileValidation.partNames, validationParams);
+
+	CGameRules* pGameRules = g_pGame->GetGameRules();
+	for (SReactionsFileData::NameContainer::const_iterator it = fileValidation.hitTypeNames.begin(), itEnd = fileValidation.hitTypeNames.end(); it != itEnd; ++it)
+		validationParams.allowedHitTypes.insert(pGameRules->GetHitTypeId(it->c_str()));
+
+	IGameFramework* pGameFramework = g_pGame->GetIGameFramework();
+	for (SReactionsFileData::NameContainer::const_iterator it = fileValidation.projectileClassNames.begin(), itEnd = fileValidation.projectileClassNames.end(); it != itEnd; ++it)
+	{
+		uint16 uProjClassId = 0;
+		if (pGameFramework->GetNetworkSafeClassId(uProjClassId, it->c_str()))
+			validationParams.allowedProjectiles.insert(uProjClassId);
+	}
+
+	for (SReactionsFileData::NameContainer::const_iterator it = fileValidation.weaponClassNames.begin(), itEnd = fileValidation.weaponClassNames.end(); it != itEnd; ++it)
+	{
+		uint16 uWeaponClassId = 0;
+		if (pGameFramework->GetNetworkSafeClassId(uWeaponClassId, it->c_str()))
+			validationParams.allowedWeapons.insert(uWeaponClassId);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::ResolveReactionAnimParams(const CActor& actor, const SReactionsFileData::SReaction& fileReaction, SReactionParams::SReactionAnim& reactionAnim) const
+{
+	ICharacterInstance* pMainChar = actor.GetEntity()->GetCharacter(0);
+	CRY_ASSERT(pMainChar);
+	IAnimationSet* pAnimSet = pMainChar ? pMainChar->GetIAnimationSet() : NULL;
+	if (pAnimSet)
+	{
+		reactionAnim.bAdditive = fileReaction.bAdditive;
+		reactionAnim.iLayer = fileReaction.iAnimLayer;
+		reactionAnim.fOverrideTransTimeToAG = fileReaction.fOverrideTransTimeToAG;
+		reactionAnim.bNoAnimCamera = fileReaction.bNoAnimCamera;
+
+		reactionAnim.animCRCs.reserve(fileReaction.animNames.size());
+		for (SReactionsFileData::NameContainer::const_iterator it = fileReaction.animNames.begin(), itEnd = fileReaction.animNames.end(); it != itEnd; ++it)
+		{
+			const char* szAnimName = it->c_str();
+
+			int iAnimID = pAnimSet->GetAnimIDByName(szAnimName);
+			if (iAnimID >= 0)
+			{
+				uint32 animCRC = NameCRCHelper::GetCRC(szAnimName);
+				reactionAnim.animCRCs.push_back(animCRC);
+			}
+			else
+			{
+				AnimIDError(szAnimName);
+			}
+		}
+
+		// Shuffle IDs
+		SRandomGeneratorFunct randomFunctor(m_pseudoRandom);
+		std::random_shuffle(reactionAnim.animCRCs.begin(), reactionAnim.animCRCs.end(), randomFunctor);
 
 		// Request loading of first asset of this set on creation
-		if (GetStreamingPolicy() != SCVars::eHDRSP_ActorsAliveAndNotInPool)		
+		if (!TracksEntitiesUsingProfile())
 			reactionAnim.RequestNextAnim(pAnimSet);
 	}
 }
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
-void CHitDeathReactionsSystem::FillAllowedPartIds(const CActor& actor, const ScriptTablePtr pScriptTable, SReactionParams::SValidationParams& validationParams) const
+void CHitDeathReactionsSystem::FillAllowedPartIds(const CActor& actor, const SReactionsFileData::NameContainer& partNames, SReactionParams::SValidationParams& validationParams) const
 {
-	ScriptTablePtr pAllowedPartArray;
-	pScriptTable->GetValue(ALLOWED_PARTS_ARRAY, pAllowedPartArray);
-
 	ICharacterInstance* pMainChar = actor.GetEntity()->GetCharacter(0);
 	CRY_ASSERT(pMainChar);
 	ISkeletonPose* pSkeletonPose = pMainChar ? pMainChar->GetISkeletonPose() : NULL;
 	if (pSkeletonPose)
 	{
-		int iCount = pAllowedPartArray->Count();
-		for (int i = 0; i < iCount; ++i)
+		for (SReactionsFileData::NameContainer::const_iterator it = partNames.begin(), itEnd = partNames.end(); it != itEnd; ++it)
 		{
-			const char* szPartName = NULL;
-			pAllowedPartArray->GetAt(i + 1, szPartName);
+			const char* szPartName = it->c_str();
 
 			int iPartId = pSkeletonPose->GetJointIDByName(szPartName);
 
@@ -1864,30 +2191,7 @@ void CHitDeathReactionsSystem::OnRequestAnimsTimer(void* pUserData, IGameFramewo
 		CRY_ASSERT(profile.iRefCount > 0);
 		if (profile.IsValid() && (profile.iRefCount > 0))
 		{
-			// Seed the random generator with the key obtained for this reaction params instance. It will be used
-			// for the request of the reaction anims (we need to randomly select one variation on reactions using
-			// more than one animation), it's sure it will be the same across the network
-			g_pGame->GetHitDeathReactionsSystem().GetRandomGenerator().seed(gEnv->bNoRandomSeed ? 0 : profileId);
-
-			// Lock reaction anims
-			SPredRequestAnims requestPredicate(true, profile.entitiesUsingProfile.begin()->first);
-			std::for_each(profile.pHitReactions.lock()->begin(), profile.pHitReactions.lock()->end(), requestPredicate);
-			std::for_each(profile.pDeathReactions.lock()->begin(), profile.pDeathReactions.lock()->end(), requestPredicate);
-			std::for_each(profile.pCollisionReactions.lock()->begin(), profile.pCollisionReactions.lock()->end(), requestPredicate);
-
-#ifndef _RELEASE
-			if (g_pGameCVars->g_hitDeathReactions_debug)
-			{
-				std::map<ProfileId, string>::const_iterator it = m_profileIdToReactionFileMap.find(profileId);
-				CRY_ASSERT(it != m_profileIdToReactionFileMap.end());
-				if (it != m_profileIdToReactionFileMap.end())
-				{
-					CryStackStringT<char, 128> debugText;
-					debugText.Format("[HitDeathReactionsSystem] REQUEST of animations for profile %s", it->second.c_str());
-					CryLogAlways(debugText.c_str());
-				}
-			}
-#endif
+			RequestProfileAnims(profileId, profile);
 		}
 	}
 }
@@ -1908,25 +2212,241 @@ void CHitDeathReactionsSystem::OnReleaseAnimsTimer(void* pUserData, IGameFramewo
 		CRY_ASSERT(profile.iRefCount == 0);
 		if (profile.IsValid() && (profile.iRefCount == 0))
 		{
-			// UnLock reaction anims
-			SPredRequestAnims releasePredicate(false, 0);
-			std::for_each(profile.pHitReactions.lock()->begin(), profile.pHitReactions.lock()->end(), releasePredicate);
-			std::for_each(profile.pDeathReactions.lock()->begin(), profile.pDeathReactions.lock()->end(), releasePredicate);
-			std::for_each(profile.pCollisionReactions.lock()->begin(), profile.pCollisionReactions.lock()->end(), releasePredicate);
+			ReleaseProfileAnims(profileId, profile);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::RequestProfileAnims(ProfileId profileId, SReactionsProfile& profile)
+{
+	CRY_ASSERT(profile.IsValid() && !profile.entitiesUsingProfile.empty());
+
+	// Seed the random generator with the key obtained for this reaction params instance. It will be used
+	// for the request of the reaction anims (we need to randomly select one variation on reactions using
+	// more than one animation), it's sure it will be the same across the network
+	g_pGame->GetHitDeathReactionsSystem().GetRandomGenerator().seed(gEnv->bNoRandomSeed ? 0 : profileId);
+
+	// Lock reaction anims
+	SPredRequestAnims requestPredicate(true, profile.entitiesUsingProfile.begin()->first);
+	std::for_each(profile.pHitReactions.lock()->begin(), profile.pHitReactions.lock()->end(), requestPredicate);
+	std::for_each(profile.pDeathReactions.lock()->begin(), profile.pDeathReactions.lock()->end(), requestPredicate);
+	std::for_each(profile.pCollisionReactions.lock()->begin(), profile.pCollisionReactions.lock()->end(), requestPredicate);
+
+	profile.bAnimsRequested = true;
 
 #ifndef _RELEASE
-			if (g_pGameCVars->g_hitDeathReactions_debug)
+	if (g_pGameCVars->g_hitDeathReactions_debug)
+	{
+		std::map<ProfileId, string>::const_iterator it = m_profileIdToReactionFileMap.find(profileId);
+		CRY_ASSERT(it != m_profileIdToReactionFileMap.end());
+		if (it != m_profileIdToReactionFileMap.end())
+		{
+			CryStackStringT<char, 128> debugText;
+			debugText.Format("[HitDeathReactionsSystem] REQUEST of animations for profile %s", it->second.c_str());
+			CryLogAlways(debugText.c_str());
+		}
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::ReleaseProfileAnims(ProfileId profileId, SReactionsProfile& profile)
+{
+	CRY_ASSERT(profile.IsValid());
+
+	// UnLock reaction anims
+	SPredRequestAnims releasePredicate(false, 0);
+	std::for_each(profile.pHitReactions.lock()->begin(), profile.pHitReactions.lock()->end(), releasePredicate);
+	std::for_each(profile.pDeathReactions.lock()->begin(), profile.pDeathReactions.lock()->end(), releasePredicate);
+	std::for_each(profile.pCollisionReactions.lock()->begin(), profile.pCollisionReactions.lock()->end(), releasePredicate);
+
+	profile.bAnimsRequested = false;
+
+#ifndef _RELEASE
+	if (g_pGameCVars->g_hitDeathReactions_debug)
+	{
+		std::map<ProfileId, string>::const_iterator it = m_profileIdToReactionFileMap.find(profileId);
+		CRY_ASSERT(it != m_profileIdToReactionFileMap.end());
+		if (it != m_profileIdToReactionFileMap.end())
+		{
+			CryStackStringT<char, 128> debugText;
+			debugText.Format("[HitDeathReactionsSystem] RELEASE of animations for profile %s", it->second.c_str());
+			CryLogAlways(debugText.c_str());
+		}
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::OnReactionAnimStarted(ProfileId profileId, bool bAnimReady)
+{
+	// A miss means the reaction had to wait for (or skip) its animation
+	bAnimReady ? ++m_iAnimHits : ++m_iAnimMisses;
+
+	ProfilesContainer::iterator itFind = m_reactionProfiles.find(profileId);
+	if (itFind != m_reactionProfiles.end())
+	{
+		SReactionsProfile& profile = itFind->second;
+		bAnimReady ? ++profile.iAnimHits : ++profile.iAnimMisses;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::Update(float fFrameTime)
+{
+	if (GetStreamingPolicy() != SCVars::eHDRSP_Predictive)
+		return;
+
+	m_fPredictiveStreamingTimer -= fFrameTime;
+	if (m_fPredictiveStreamingTimer > 0.0f)
+		return;
+
+	m_fPredictiveStreamingTimer = PREDICTIVE_STREAMING_UPDATE_SECONDS;
+
+	UpdatePredictiveStreaming();
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+void CHitDeathReactionsSystem::UpdatePredictiveStreaming()
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
+
+	IActor* pClientActor = g_pGame->GetIGameFramework()->GetClientActor();
+	if (!pClientActor)
+		return;
+
+	const Vec3 vClientPos = pClientActor->GetEntity()->GetWorldPos();
+	const EntityId aimedEntityId = static_cast<CActor*>(pClientActor)->GetCurrentTargetEntityId();
+	const float fPrefetchDistanceSq = sqr(g_pGameCVars->g_hitDeathReactions_prefetchDistance);
+	const float fCurrentTime = gEnv->pTimer->GetCurrTime();
+
+	m_prefetchCandidates.clear();
+
+	// Rank the profiles by how soon one of their actors is likely to get hit. Actors sharing a profile share
+	// its anims, so the profile just keeps the count of interested actors
+	ProfilesContainer::iterator itEnd = m_reactionProfiles.end();
+	for (ProfilesContainer::iterator it = m_reactionProfiles.begin(); it != itEnd; ++it)
+	{
+		SReactionsProfile& profile = it->second;
+		if (!profile.IsValid())
+			continue;
+
+		int iInterestedActors = 0;
+		float fPriority = FLT_MAX;
+
+		SReactionsProfile::entitiesUsingProfileContainer::const_iterator itEntEnd = profile.entitiesUsingProfile.end();
+		for (SReactionsProfile::entitiesUsingProfileContainer::const_iterator itEnt = profile.entitiesUsingProfile.begin(); itEnt != itEntEnd; ++itEnt)
+		{
+			if (!FlagsValidateLocking(itEnt->second))
+				continue;
+
+			if (itEnt->first == aimedEntityId)
 			{
-				std::map<ProfileId, string>::const_iterator it = m_profileIdToReactionFileMap.find(profileId);
-				CRY_ASSERT(it != m_profileIdToReactionFileMap.end());
-				if (it != m_profileIdToReactionFileMap.end())
+				++iInterestedActors;
+				fPriority = 0.0f;
+				continue;
+			}
+
+			const IEntity* pEntity = gEnv->pEntitySystem->GetEntity(itEnt->first);
+			if (pEntity)
+			{
+				const float fDistanceSq = vClientPos.GetSquaredDistance(pEntity->GetWorldPos());
+				if (fDistanceSq < fPrefetchDistanceSq)
 				{
-					CryStackStringT<char, 128> debugText;
-					debugText.Format("[HitDeathReactionsSystem] RELEASE of animations for profile %s", it->second.c_str());
-					CryLogAlways(debugText.c_str());
+					++iInterestedActors;
+					fPriority = min(fPriority, sqrt_tpl(fDistanceSq));
 				}
 			}
-#endif
+		}
+
+		profile.iRefCount = iInterestedActors;
+		profile.fPrefetchPriority = fPriority;
+
+		if (iInterestedActors > 0)
+		{
+			profile.fLastInterestTime = fCurrentTime;
+			m_prefetchCandidates.push_back(std::make_pair(fPriority, it->first));
+		}
+		else if (profile.bAnimsRequested)
+		{
+			// Keep them for a while (same hysteresis as the other policy) if there's room left in the budget
+			if ((fCurrentTime - profile.fLastInterestTime) < HYSTERESIS_RELEASE_TIMER_SECONDS)
+				m_prefetchCandidates.push_back(std::make_pair(FLT_MAX, it->first));
+			else
+				ReleaseProfileAnims(it->first, profile);
 		}
 	}
+
+	std::sort(m_prefetchCandidates.begin(), m_prefetchCandidates.end());
+
+	// The most relevant profiles get the memory first, the rest are evicted
+	const uint32 memoryBudget = static_cast<uint32>(max(0, g_pGameCVars->g_hitDeathReactions_prefetchMemoryBudget)) * 1024;
+	uint32 usedMemory = 0;
+
+	PrefetchCandidates::const_iterator itCandidatesEnd = m_prefetchCandidates.end();
+	for (PrefetchCandidates::const_iterator itCandidate = m_prefetchCandidates.begin(); itCandidate != itCandidatesEnd; ++itCandidate)
+	{
+		const ProfileId profileId = itCandidate->second;
+		SReactionsProfile& profile = m_reactionProfiles[profileId];
+
+		if (profile.prefetchMemorySize == 0)
+			profile.prefetchMemorySize = EstimateProfileAnimsMemory(profile);
+
+		if ((usedMemory + profile.prefetchMemorySize) <= memoryBudget)
+		{
+			usedMemory += profile.prefetchMemorySize;
+
+			if (!profile.bAnimsRequested)
+				RequestProfileAnims(profileId, profile);
+		}
+		else if (profile.bAnimsRequested)
+		{
+			ReleaseProfileAnims(profileId, profile);
+			++m_iEvictions;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+uint32 CHitDeathReactionsSystem::EstimateProfileAnimsMemory(const SReactionsProfile& profile) const
+{
+	const IEntity* pEntity = !profile.entitiesUsingProfile.empty() ? gEnv->pEntitySystem->GetEntity(profile.entitiesUsingProfile.begin()->first) : NULL;
+	ICharacterInstance* pCharInst = pEntity ? pEntity->GetCharacter(0) : NULL;
+	const IAnimationSet* pAnimSet = pCharInst ? pCharInst->GetIAnimationSet() : NULL;
+	if (!pAnimSet)
+		return 0;
+
+	// Only one variation per reaction is locked at a time. Take the biggest one to stay on the safe side
+	uint32 memorySize = 0;
+
+	const ReactionsContainerConstPtr containers[] = { profile.pHitReactions.lock(), profile.pDeathReactions.lock(), profile.pCollisionReactions.lock() };
+	for (int i = 0; i < sizeof(containers) / sizeof(containers[0]); ++i)
+	{
+		ReactionsContainer::const_iterator itEnd = containers[i]->end();
+		for (ReactionsContainer::const_iterator it = containers[i]->begin(); it != itEnd; ++it)
+		{
+			uint32 reactionAnimSize = 0;
+
+			const SReactionParams::AnimCRCContainer& animCRCs = it->reactionAnim->animCRCs;
+			SReactionParams::AnimCRCContainer::const_iterator itAnimEnd = animCRCs.end();
+			for (SReactionParams::AnimCRCContainer::const_iterator itAnim = animCRCs.begin(); itAnim != itAnimEnd; ++itAnim)
+			{
+				const int animID = pAnimSet->GetAnimIDByCRC(*itAnim);
+				if (animID >= 0)
+					reactionAnimSize = max(reactionAnimSize, pAnimSet->GetAnimationSize(animID));
+			}
+
+			memorySize += reactionAnimSize;
+		}
+	}
+
+	// Never 0, that's "unknown"
+	return max(memorySize, 1U);
 }
@@ -14,6 +14,8 @@ History:
 #define __HIT_DEATH_REACTIONS_SYSTEM_H
 
 #include "HitDeathReactionsDefs.h"
+#include "HitDeathReactionsIndex.h"
+#include "HitDeathReactionsCache.h"
 #include "CustomReactionFunctions.h"
 #include <VectorMap.h>
 
@@ -34,9 +36,12 @@ public:
 	void																	OnToggleGameMode();
 	void																	Reset();
 
-	ProfileId															GetReactionParamsForActor(const CActor& actor, ReactionsContainerConstPtr& pHitReactions, ReactionsContainerConstPtr& pDeathReactions, ReactionsContainerConstPtr& pCollisionReactions, SHitDeathReactionsConfigConstPtr& pHitDeathReactionsConfig);
+	ProfileId															GetReactionParamsForActor(const CActor& actor, ReactionsContainerConstPtr& pHitReactions, ReactionsContainerConstPtr& pDeathReactions, ReactionsContainerConstPtr& pCollisionReactions, SHitDeathReactionsConfigConstPtr& pHitDeathReactionsConfig, CHitDeathReactionsIndexConstPtr& pHitReactionsIndex, CHitDeathReactionsIndexConstPtr& pDeathReactionsIndex);
 	void																	RequestReactionAnimsForActor(const CActor& actor, uint32 requestFlags);
 	void																	ReleaseReactionAnimsForActor(const CActor& actor, uint32 requestFlags);
+	void																	OnReactionAnimStarted(ProfileId profileId, bool bAnimReady);
+
+	void																	Update(float fFrameTime);
 
 	void																	Reload();
 	void																	PreloadData();
@@ -58,9 +63,10 @@ private:
 	{
 		typedef std::map<EntityId, uint32> entitiesUsingProfileContainer;
 
-		SReactionsProfile() : timerId(0), iRefCount(0) {}
+		SReactionsProfile() : timerId(0), iRefCount(0), fLastInterestTime(0.0f), fPrefetchPriority(FLT_MAX), prefetchMemorySize(0), iAnimHits(0), iAnimMisses(0), bAnimsRequested(false) {}
 		SReactionsProfile(ReactionsContainerConstPtr pHitReactions, ReactionsContainerConstPtr pDeathReactions, ReactionsContainerConstPtr pCollisionReactions, ScriptTablePtr pHitAndDeathReactionsTable, SHitDeathReactionsConfigConstPtr	pHitDeathReactionsConfig) : 
-		pHitReactions(pHitReactions), pDeathReactions(pDeathReactions), pCollisionReactions(pCollisionReactions), pHitAndDeathReactionsTable(pHitAndDeathReactionsTable), pHitDeathReactionsConfig(pHitDeathReactionsConfig), timerId(0), iRefCount(0) {}
+		pHitReactions(pHitReactions), pDeathReactions(pDeathReactions), pCollisionReactions(pCollisionReactions), pHitAndDeathReactionsTable(pHitAndDeathReactionsTable), pHitDeathReactionsConfig(pHitDeathReactionsConfig), timerId(0), iRefCount(0),
+		fLastInterestTime(0.0f), fPrefetchPriority(FLT_MAX), prefetchMemorySize(0), iAnimHits(0), iAnimMisses(0), bAnimsRequested(false) {}
 		~SReactionsProfile();
 
 		void				GetMemoryUsage(ICrySizer * s) const;
@@ -74,10 +80,21 @@ private:
 
 		SHitDeathReactionsConfigConstWeakPtr	pHitDeathReactionsConfig;
 
+		CHitDeathReactionsIndexConstWeakPtr		pHitReactionsIndex;
+		CHitDeathReactionsIndexConstWeakPtr		pDeathReactionsIndex;
+
 		entitiesUsingProfileContainer					entitiesUsingProfile;
 		int																		iRefCount;
 
 		IGameFramework::TimerID								timerId;
+
+		// Predictive streaming
+		float																	fLastInterestTime;	// last time an actor using the profile was in combat range or aimed at
+		float																	fPrefetchPriority;	// distance of the closest interested actor, 0 if aimed at
+		uint32																prefetchMemorySize;	// estimated size of the locked reaction anims, 0 if unknown
+		uint32																iAnimHits;					// reaction anims already streamed in when the reaction started
+		uint32																iAnimMisses;				// reaction anims that weren't
+		bool																	bAnimsRequested;
 	};
 
 	struct SFailSafeProfile
@@ -98,30 +115,55 @@ private:
 	typedef ProfilesContainer::value_type										ProfilesContainersItem;
 
 	typedef VectorMap<string, ScriptTablePtr>								FileToScriptTableMap;
+	typedef VectorMap<string, uint32>												FileToContentHashMap;
 
 
 	// Private methods
 	void								ExecuteHitDeathReactionsScripts(bool bForceReload);
 	ProfileId						GetActorProfileId(const CActor& actor) const;
-	ScriptTablePtr			LoadReactionsScriptTable(const CActor& actor) const;
+	bool								GetReactionsDataFile(const CActor& actor, CryPathString& sReactionsDataFile) const;
 	ScriptTablePtr			LoadReactionsScriptTable(const char* szReactionsDataFile) const;
-	bool								LoadHitDeathReactionsParams(const CActor& actor, ScriptTablePtr pHitDeathReactionsTable, ReactionsContainerPtr pHitReactions, ReactionsContainerPtr pDeathReactions, ReactionsContainerPtr pCollisionReactions);
-	bool								LoadHitDeathReactionsConfig(const CActor& actor, ScriptTablePtr pHitDeathReactionsTable, SHitDeathReactionsConfigPtr pHitDeathReactionsConfig);
-	void								LoadReactionsParams(const CActor& actor, IScriptTable* pHitDeathReactionsTable, const char* szReactionParamsName, bool bDeathReactions, ReactionId baseReactionId, ReactionsContainer& reactions);
-
-	void								GetReactionParamsFromScript(const CActor& actor, const ScriptTablePtr pScriptTable, SReactionParams& reactionParams, ReactionId reactionId) const;
-	bool								GetValidationParamsFromScript( const ScriptTablePtr pScriptTable, SReactionParams::SValidationParams& validationParams, const CActor& actor, ReactionId reactionId) const;
-	void								GetReactionAnimParamsFromScript(const CActor& actor, ScriptTablePtr pScriptTable, SReactionParams::SReactionAnim& reactionAnim) const;
+	void								SetActorReactionsScriptTable(const CActor& actor, ScriptTablePtr pHitDeathReactionsTable) const;
+	void								LoadHitDeathReactionsParams(const CActor& actor, IScriptTable* pHitDeathReactionsTable, const SReactionsFileData& fileData, ReactionsContainerPtr pHitReactions, ReactionsContainerPtr pDeathReactions, ReactionsContainerPtr pCollisionReactions);
+	void								LoadHitDeathReactionsConfig(const CActor& actor, const SReactionsFileData& fileData, SHitDeathReactionsConfigPtr pHitDeathReactionsConfig);
+	void								LoadReactionsParams(const CActor& actor, IScriptTable* pHitDeathReactionsTable, const char* szReactionParamsName, const SReactionsFileData::ReactionContainer& fileReactions, bool bDeathReactions, ReactionId baseReactionId, ReactionsContainer& reactions);
+
+	// Actor independent params, from the binary cache or parsed from the script table. pHitDeathReactionsTable is only
+	// loaded if the cache is missing or out of date, or if lua functions are going to need the reaction tables
+	bool								LoadReactionsFileData(const char* szReactionsDataFile, SReactionsFileData& fileData, ScriptTablePtr& pHitDeathReactionsTable) const;
+	uint32							GetContentHash(const char* szReactionsDataFile) const;
+	bool								NeedsReactionsScriptTable(const SReactionsFileData& fileData) const;
+	bool								MatchesScriptTable(IScriptTable* pHitDeathReactionsTable, const SReactionsFileData& fileData) const;
+	bool								GetReactionScriptTable(IScriptTable* pReactionsTable, const SReactionsFileData::SReaction& fileReaction, ScriptTablePtr& pReactionTable) const;
+	int									GetReactionTablesCount(IScriptTable* pHitDeathReactionsTable, const char* szReactionParamsName) const;
+	void								ReadReactionsFromScript(const char* szReactionsDataFile, IScriptTable* pHitDeathReactionsTable, const char* szReactionParamsName, SReactionsFileData::ReactionContainer& fileReactions) const;
+	void								ReadConfigFromScript(IScriptTable* pHitDeathReactionsTable, SReactionsFileData& fileData) const;
+	void								GetReactionParamsFromScript(const char* szReactionsDataFile, const ScriptTablePtr pScriptTable, SReactionsFileData::SReaction& reaction) const;
+	bool								GetValidationParamsFromScript(const ScriptTablePtr pScriptTable, SReactionsFileData::SValidation& validation) const;
+	void								GetReactionAnimParamsFromScript(ScriptTablePtr pScriptTable, SReactionsFileData::SReaction& reaction) const;
+	void								GetNamesFromScript(const ScriptTablePtr pScriptTable, const char* szArrayName, SReactionsFileData::NameContainer& names) const;
+
+	// Actor dependent params (bone, hit type, class and anim ids)
+	void								ResolveReactionParams(const CActor& actor, const SReactionsFileData::SReaction& fileReaction, SReactionParams& reactionParams) const;
+	void								ResolveValidationParams(const CActor& actor, const SReactionsFileData::SValidation& fileValidation, SReactionParams::SValidationParams& validationParams) const;
+	void								ResolveReactionAnimParams(const CActor& actor, const SReactionsFileData::SReaction& fileReaction, SReactionParams::SReactionAnim& reactionAnim) const;
+	void								BindReactionScriptTables(IScriptTable* pReactionTable, const SReactionsFileData::SReaction& fileReaction, ReactionId reactionId, SReactionParams& reactionParams) const;
 	ILINE	uint8					GetStreamingPolicy() const { return m_streamingEnabled; }
 
 	void								PreProcessStanceParams(SmartScriptTable pReactionTable) const;
-	void								FillAllowedPartIds(const CActor& actor, const ScriptTablePtr pScriptTable, SReactionParams::SValidationParams& validationParams) const;
+	void								FillAllowedPartIds(const CActor& actor, const SReactionsFileData::NameContainer& partNames, SReactionParams::SValidationParams& validationParams) const;
 	ECardinalDirection	GetCardinalDirectionFromString(const char* szCardinalDirection) const;
 
 	ILINE bool					FlagsValidateLocking(uint32 flags) const { return flags == ((eRRF_Alive | eRRF_AIEnabled) | (!gEnv->bMultiplayer * eRRF_OutFromPool)); }
+	ILINE bool					TracksEntitiesUsingProfile() const { return (GetStreamingPolicy() == SCVars::eHDRSP_ActorsAliveAndNotInPool) || (GetStreamingPolicy() == SCVars::eHDRSP_Predictive); }
 	void								OnRequestAnimsTimer(void* pUserData, IGameFramework::TimerID handler);
 	void								OnReleaseAnimsTimer(void* pUserData, IGameFramework::TimerID handler);
 
+	void								RequestProfileAnims(ProfileId profileId, SReactionsProfile& profile);
+	void								ReleaseProfileAnims(ProfileId profileId, SReactionsProfile& profile);
+	uint32							EstimateProfileAnimsMemory(const SReactionsProfile& profile) const;
+	void								UpdatePredictiveStreaming();
+
 
 	ProfilesContainer 							m_reactionProfiles;
 	SFailSafeProfile								m_failSafeProfile;
@@ -129,11 +171,20 @@ private:
 	CCustomReactionFunctions				m_customReactionFunctions;
 
 	mutable FileToScriptTableMap		m_reactionsScriptTableCache;
+	mutable FileToContentHashMap		m_contentHashCache;			// data files are only hashed once per session
 
 	mutable CMTRand_int32						m_pseudoRandom;
 
 	uint8														m_streamingEnabled;
 
+	// Predictive streaming
+	typedef std::vector<std::pair<float, ProfileId> >	PrefetchCandidates;
+	PrefetchCandidates							m_prefetchCandidates;
+	float														m_fPredictiveStreamingTimer;
+	uint32													m_iAnimHits;
+	uint32													m_iAnimMisses;
+	uint32													m_iEvictions;
+
 #ifndef _RELEASE
 	std::map<ProfileId, string>			m_profileIdToReactionFileMap; // debug attribute
 
@@ -12,6 +12,7 @@ History:
 *************************************************************************/
 #include "StdAfx.h"
 #include "HomingMissile.h"
+#include "GameNetProfiler.h"
 #include "Actor.h"
 #include "Game.h"
 #include "GameCVars.h"
@@ -469,6 +470,7 @@ void CHomingMissile::SerializeDestination( TSerialize ser )
 
 bool CHomingMissile::NetSerialize(TSerialize ser, EEntityAspects aspect, uint8 profile, int flags)
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	if (aspect == eEA_GameServerDynamic)
 		SerializeDestination(ser);
 	return CRocket::NetSerialize(ser, aspect, profile, flags);
@@ -477,6 +479,7 @@ bool CHomingMissile::NetSerialize(TSerialize ser, EEntityAspects aspect, uint8 p
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CHomingMissile, SvRequestDestination)
 {
+	GAME_NET_PROFILE_RMI(CHomingMissile, SvRequestDestination);
 	SetDestination(params.pt);
 
 	return true;
@@ -8,10 +8,20 @@
 #include "IGameObject.h"
 // PLAYERPREDICTION
 #include "Network/SerializeDirHelper.h"
+#include "SerializeMovementHelper.h"
 // ~PLAYERPREDICTION
 
 struct SSerializedPlayerInput
 {
+	// PLAYERPREDICTION
+	enum EFlags
+	{
+		eF_Sprint	= BIT(0),
+		eF_LeanL	= BIT(1),
+		eF_LeanR	= BIT(2),
+	};
+	// ~PLAYERPREDICTION
+
 	uint8 stance;
 	uint8 bodystate;
 	Vec3 deltaMovement;
@@ -70,14 +80,23 @@ struct SSerializedPlayerInput
 		//ser.Value( "bodystate", bodystate, 'bdst');
 		// note: i'm not sure what some of these parameters mean, but i copied them from the defaults in serpolicy.h
 		// however, the rounding mode for this value must ensure that zero gets sent as a zero, not anything else, or things break rather badly
-		ser.Value( "deltaMovement", deltaMovement, 'dMov' );
+		//ser.Value( "deltaMovement", deltaMovement, 'dMov' );
+		SerializeMovementHelper(ser, deltaMovement, 'ui8');
 		//ser.Value( "lookDirection", lookDirection, 'dir0' );
 		SerializeDirHelper(ser, lookDirection, 'pYaw', 'pElv');
-		ser.Value( "sprint", sprint, 'bool' );
 		ser.Value( "position", position, 'wrld' );
 		ser.Value( "physcounter", physCounter, 'ui4');
-		ser.Value( "leanl", leanl, 'bool' );
-		ser.Value( "leanr", leanr, 'bool' );
+
+		uint8 flags = 0;
+		if (!ser.IsReading())
+			flags = (sprint ? eF_Sprint : 0) | (leanl ? eF_LeanL : 0) | (leanr ? eF_LeanR : 0);
+		ser.Value( "flags", flags, 'ui3' );
+		if (ser.IsReading())
+		{
+			sprint = (flags & eF_Sprint) != 0;
+			leanl = (flags & eF_LeanL) != 0;
+			leanr = (flags & eF_LeanR) != 0;
+		}
 		//ser.Value( "aiming", aiming, 'bool' );
 		//ser.Value( "usinglookik", usinglookik, 'bool' );
 		//ser.Value( "allowStrafing", allowStrafing, 'bool' );
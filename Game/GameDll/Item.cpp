@@ -12,6 +12,7 @@
 *************************************************************************/
 #include "StdAfx.h"
 #include "Item.h"
+#include "GameNetProfiler.h"
 #include "ItemSharedParams.h"
 #include "Game.h"
 #include "GameActions.h"
@@ -607,6 +608,7 @@ void CItem::ProcessEvent(SEntityEvent &event)
 //------------------------------------------------------------------------
 bool CItem::NetSerialize( TSerialize ser, EEntityAspects aspect, uint8 profile, int pflags )
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	if (aspect == eEA_Physics)
 	{
 		pe_type type = PE_NONE;
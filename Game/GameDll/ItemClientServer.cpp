@@ -11,6 +11,7 @@ History:
 
 *************************************************************************/
 #include "StdAfx.h"
+#include "GameNetProfiler.h"
 #include "Item.h"
 #include "ItemSharedParams.h"
 #include "Actor.h"
@@ -82,6 +83,7 @@ void CItem::PostInitClient(int channelId)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CItem, SvRequestAttachAccessory)
 {
+	GAME_NET_PROFILE_RMI(CItem, SvRequestAttachAccessory);
 	if (IInventory *pInventory=GetActorInventory(GetOwnerActor()))
 	{
 		if (pInventory->GetCountOfClass(params.accessory.c_str())>0)
@@ -99,6 +101,7 @@ IMPLEMENT_RMI(CItem, SvRequestAttachAccessory)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CItem, ClAttachAccessory)
 {
+	GAME_NET_PROFILE_RMI(CItem, ClAttachAccessory);
 	DoSwitchAccessory(params.accessory.c_str());
 
 	return true;
@@ -107,6 +110,7 @@ IMPLEMENT_RMI(CItem, ClAttachAccessory)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CItem, SvRequestEnterModify)
 {
+	GAME_NET_PROFILE_RMI(CItem, SvRequestEnterModify);
 	GetGameObject()->InvokeRMI(ClEnterModify(), params, eRMI_ToOtherClients, m_pGameFramework->GetGameChannelId(pNetChannel));
 
 	return true;
@@ -115,6 +119,7 @@ IMPLEMENT_RMI(CItem, SvRequestEnterModify)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CItem, SvRequestLeaveModify)
 {
+	GAME_NET_PROFILE_RMI(CItem, SvRequestLeaveModify);
 	GetGameObject()->InvokeRMI(ClLeaveModify(), params, eRMI_ToOtherClients, m_pGameFramework->GetGameChannelId(pNetChannel));
 
 	return true;
@@ -123,6 +128,7 @@ IMPLEMENT_RMI(CItem, SvRequestLeaveModify)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CItem, ClEnterModify)
 {
+	GAME_NET_PROFILE_RMI(CItem, ClEnterModify);
 	PlayAction(g_pItemStrings->enter_modify, 0, false, eIPAF_Default | eIPAF_RepeatLastFrame);
 
 	return true;
@@ -131,6 +137,7 @@ IMPLEMENT_RMI(CItem, ClEnterModify)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CItem, ClLeaveModify)
 {
+	GAME_NET_PROFILE_RMI(CItem, ClLeaveModify);
 	PlayAction(g_pItemStrings->leave_modify, 0);
 
 	return true;
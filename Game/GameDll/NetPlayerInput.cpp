@@ -50,7 +50,11 @@ CNetPlayerInput::CNetPlayerInput( CPlayer * pPlayer )
 	m_passedNetPos(true),
 	m_passedPredictionPos(true),
 	m_newInterpolation(false),
-	m_blockedTime(0.0f)
+	m_blockedTime(0.0f),
+	m_numNetSamples(0),
+	m_lastNetSample(0),
+	m_netArrivalInterval(0.0f),
+	m_netArrivalJitter(0.0f)
 {
 	m_breadCrumb.Set(0.0f, 0.0f, 0.0f);
 	m_predictedPosition.Set(0.0f, 0.0f, 0.0f);
@@ -75,6 +79,11 @@ static volatile float k_staticSpeed									= 0.1f;
 static const float k_minDistStatic = 0.1f;
 static const float k_minDistMoving = 0.001f;
 
+static const float k_maxNetSampleInterval						= 1.0f;		// longer gaps between samples are idle time, not jitter
+static const float k_netJitterSmoothing							= 0.125f;
+static const float k_netJitterDelayScale						= 2.0f;		// playback delay in measured jitters
+static const float k_maxExtrapolateAccel						= 20.0f;
+
 void CNetPlayerInput::InitialiseInterpolation(f32 netPosDist, const Vec3 &desPosOffset, const Vec3 &desiredVelocity, const CTimeValue	&curTime)
 {
 	m_newInterpolation = false;
@@ -163,6 +172,98 @@ void CNetPlayerInput::UpdateErrorSnap(const Vec3 &entPos, const Vec3 &desiredPos
 	}
 }
 
+void CNetPlayerInput::AddNetSample(const Vec3 &position, const Vec3 &velocity, const CTimeValue &time)
+{
+	if (m_numNetSamples > 0)
+	{
+		const SNetSample& last = GetNetSample(0);
+
+		//--- Teleports and respawns start a new trajectory
+		if (last.position.GetSquaredDistance(position) > sqr(k_maxInterpolateDist))
+		{
+			m_numNetSamples = 0;
+		}
+		else
+		{
+			const float interval = time.GetDifferenceInSeconds(last.time);
+			if (interval < k_maxNetSampleInterval)
+			{
+				const float deviation = cry_fabsf(interval - m_netArrivalInterval);
+				m_netArrivalInterval += (interval - m_netArrivalInterval) * k_netJitterSmoothing;
+				m_netArrivalJitter += (deviation - m_netArrivalJitter) * k_netJitterSmoothing;
+			}
+
+			//--- Several updates in the same frame, keep the latest
+			if (interval <= 0.0f)
+			{
+				--m_numNetSamples;
+				m_lastNetSample = (m_lastNetSample + k_maxNetSamples - 1) % k_maxNetSamples;
+			}
+		}
+	}
+
+	m_lastNetSample = (m_lastNetSample + 1) % k_maxNetSamples;
+	m_numNetSamples = min(m_numNetSamples + 1, (int)k_maxNetSamples);
+
+	SNetSample& sample = m_netSamples[m_lastNetSample];
+	sample.time = time;
+	sample.position = position;
+	sample.velocity = velocity;
+}
+
+float CNetPlayerInput::GetNetPlaybackDelay() const
+{
+	return min(m_netArrivalJitter * k_netJitterDelayScale, g_pGameCVars->pl_netJitterBufferMaxDelay);
+}
+
+Vec3 CNetPlayerInput::SampleNetTrajectory(const CTimeValue &time) const
+{
+	//--- Newest sample not after the requested time
+	int age = 0;
+	while ((age < m_numNetSamples) && (GetNetSample(age).time > time))
+	{
+		++age;
+	}
+
+	if (age == m_numNetSamples)
+	{
+		return GetNetSample(m_numNetSamples - 1).position;
+	}
+
+	if (age > 0)
+	{
+		//--- Between two samples, their velocities are the tangents
+		const SNetSample& s0 = GetNetSample(age);
+		const SNetSample& s1 = GetNetSample(age - 1);
+		const float span = s1.time.GetDifferenceInSeconds(s0.time);
+		const float s = clamp_tpl(time.GetDifferenceInSeconds(s0.time) / span, 0.0f, 1.0f);
+		return HermiteInterpolate(s, s0.position, s0.velocity * span, s1.position, s1.velocity * span);
+	}
+
+	//--- Past the last sample, extrapolate along a segment ending where the player would be after the max
+	//--- predict time if it kept its acceleration, which keeps the velocity continuous across new samples
+	const SNetSample& last = GetNetSample(0);
+	Vec3 accel(ZERO);
+	if (m_numNetSamples > 1)
+	{
+		const SNetSample& prev = GetNetSample(1);
+		const float span = last.time.GetDifferenceInSeconds(prev.time);
+		accel = (last.velocity - prev.velocity) / span;
+		const float accelLenSq = accel.GetLengthSquared();
+		if (accelLenSq > sqr(k_maxExtrapolateAccel))
+		{
+			accel *= k_maxExtrapolateAccel * isqrt_tpl(accelLenSq);
+		}
+	}
+
+	const float horizon = k_maxPredictTime;
+	const Vec3 endVelocity = last.velocity + (accel * horizon);
+	const Vec3 endPosition = last.position + ((last.velocity + endVelocity) * (0.5f * horizon));
+	const float s = min(time.GetDifferenceInSeconds(last.time), horizon) / horizon;
+
+	return HermiteInterpolate(s, last.position, last.velocity * horizon, endPosition, endVelocity * horizon);
+}
+
 void CNetPlayerInput::UpdateInterpolation()
 {
 	Vec3 desiredPosition = m_curInput.position;
@@ -183,7 +284,15 @@ void CNetPlayerInput::UpdateInterpolation()
 
 	float dt = curTime.GetDifferenceInSeconds(m_netLastUpdate) + k_lerpTargetTime;
 	dt = min(dt, k_maxPredictTime);
-	m_predictedPosition = desiredPosition + (desiredVelocity * dt);
+	if (g_pGameCVars->pl_netJitterBuffer && (m_numNetSamples > 0))
+	{
+		//--- Play the buffered samples back delayed by the measured jitter, so late updates still interpolate
+		m_predictedPosition = SampleNetTrajectory(curTime + CTimeValue(k_lerpTargetTime - GetNetPlaybackDelay()));
+	}
+	else
+	{
+		m_predictedPosition = desiredPosition + (desiredVelocity * dt);
+	}
 
 	Vec3 predOffset = m_predictedPosition - entPos;
 	float predDist = predOffset.GetLength2D();
@@ -213,6 +322,7 @@ void CNetPlayerInput::UpdateInterpolation()
 		CryWatch("BlockTime: (%f) PredictTime (%f) LastNetTime (%f) CurTime (%f)", m_blockedTime, dt, m_netLastUpdate.GetSeconds(), curTime.GetSeconds());
 		CryWatch("Lerp Speed: (%f) Passed pred pos (%d) Passed net pos (%d)", m_netLerpSpeed, m_passedPredictionPos, m_passedNetPos);
 		CryWatch("InputSpeed: (%f, %f, %f) ", desiredVelocity.x, desiredVelocity.y, desiredVelocity.z);
+		CryWatch("JitterBuffer: Samples (%d) Interval (%f) Jitter (%f) Delay (%f)", m_numNetSamples, m_netArrivalInterval, m_netArrivalJitter, GetNetPlaybackDelay());
 
 		IRenderAuxGeom* pRender = gEnv->pRenderer->GetIRenderAuxGeom();
 
@@ -383,9 +493,20 @@ void CNetPlayerInput::PostUpdate()
 
 void CNetPlayerInput::SetState( const SSerializedPlayerInput& input )
 {
+	// PLAYERPREDICTION
+	const bool newSample = !HasReceivedUpdate() || (input.position != m_curInput.position) || (input.deltaMovement != m_curInput.deltaMovement);
+	// ~PLAYERPREDICTION
+
 	DoSetState(input);
 
 	m_lastUpdate = gEnv->pTimer->GetCurrTime();
+
+	// PLAYERPREDICTION
+	if (newSample)
+	{
+		AddNetSample(input.position, input.deltaMovement * g_pGameCVars->pl_netSerialiseMaxSpeed, gEnv->pTimer->GetFrameStartTime());
+	}
+	// ~PLAYERPREDICTION
 }
 
 void CNetPlayerInput::GetState( SSerializedPlayerInput& input )
@@ -64,6 +64,20 @@ protected:
 	void InitialiseInterpolation(f32 netPosDist, const Vec3 &desPosOffset, const Vec3 &desiredVelocity, const CTimeValue	&curTime);
 	void UpdateErrorSnap(const Vec3 &entPos, const Vec3 &desiredPos, f32 netPosDist, const Vec3 &desPosOffset, const CTimeValue &curTime);
 
+	// Jitter buffer
+	struct SNetSample
+	{
+		CTimeValue	time;				// local receive time
+		Vec3				position;
+		Vec3				velocity;
+	};
+	enum { k_maxNetSamples = 8 };
+
+	void AddNetSample(const Vec3 &position, const Vec3 &velocity, const CTimeValue &time);
+	Vec3 SampleNetTrajectory(const CTimeValue &time) const;
+	float GetNetPlaybackDelay() const;
+	ILINE const SNetSample& GetNetSample(int age) const { return m_netSamples[(m_lastNetSample + k_maxNetSamples - age) % k_maxNetSamples]; }
+
 
 	CTimeValue m_lastUpdate;
 
@@ -83,6 +97,12 @@ protected:
 	Vec3				m_breadCrumb;
 	CTimeValue	m_nextBCTime;     	 
 	float				m_blockedTime;
+
+	SNetSample	m_netSamples[k_maxNetSamples];	// ring, newest at m_lastNetSample
+	int					m_numNetSamples;
+	int					m_lastNetSample;
+	float				m_netArrivalInterval;		// smoothed time between samples
+	float				m_netArrivalJitter;			// smoothed deviation from it
 	// ~PLAYERPREDICTION
 };
 
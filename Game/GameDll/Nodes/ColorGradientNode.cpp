@@ -77,4 +77,44 @@ IFlowNodePtr CFlowNode_ColorGradient::Clone( SActivationInfo * pActInfo )
 		return new CFlowNode_ColorGradient(pActInfo);
 }
 
+const SInputPortConfig CFlowNode_ColorGradientPrefetch::inputPorts[] =
+{
+	InputPortConfig_Void("Prefetch", _HELP("Starts streaming the Color Chart into the cache.")),
+	InputPortConfig<string>("tex_TexturePath", _HELP("Path to the Color Chart texture.")),
+	InputPortConfig<bool>("OnLevelLoad", true, _HELP("Also prefetch while the level loads.")),
+	{0},
+};
+
+CFlowNode_ColorGradientPrefetch::CFlowNode_ColorGradientPrefetch(SActivationInfo* activationInformation)
+{
+}
+
+void CFlowNode_ColorGradientPrefetch::GetConfiguration(SFlowNodeConfig& config)
+{
+	config.pInputPorts = inputPorts;
+	config.sDescription = _HELP("Loads a Color Chart ahead of use so a later ColorGradient trigger fades in without waiting for it.");
+	config.SetCategory(EFLN_ADVANCED);
+}
+
+void CFlowNode_ColorGradientPrefetch::ProcessEvent(EFlowEvent event, SActivationInfo* activationInformation)
+{
+	const bool precache = event == IFlowNode::eFE_PrecacheResources && GetPortBool(activationInformation, eInputPorts_OnLevelLoad);
+	const bool activate = event == IFlowNode::eFE_Activate && IsPortActive(activationInformation, eInputPorts_Prefetch);
+
+	if (precache || activate)
+	{
+		const string texturePath = GetPortString(activationInformation, eInputPorts_TexturePath);
+		if (!texturePath.empty())
+		{
+			g_pGame->GetColorGradientManager().PrefetchColorGradient(texturePath);
+		}
+	}
+}
+
+void CFlowNode_ColorGradientPrefetch::GetMemoryUsage(ICrySizer* sizer) const
+{
+	sizer->Add(*this);
+}
+
 REGISTER_FLOW_NODE("Image:ColorGradient", CFlowNode_ColorGradient);
+REGISTER_FLOW_NODE("Image:ColorGradientPrefetch", CFlowNode_ColorGradientPrefetch);
@@ -44,4 +44,24 @@ private:
 	ITexture *m_pTexture;
 };
 
+class CFlowNode_ColorGradientPrefetch : public CFlowBaseNode<eNCT_Singleton>
+{
+public:
+	static const SInputPortConfig inputPorts[];
+
+	CFlowNode_ColorGradientPrefetch( SActivationInfo* activationInformation);
+
+	virtual void GetConfiguration(SFlowNodeConfig& config);
+	virtual void ProcessEvent(EFlowEvent event, SActivationInfo* activationInformation);
+	virtual void GetMemoryUsage(ICrySizer* sizer) const;
+
+	enum EInputPorts
+	{
+		eInputPorts_Prefetch,
+		eInputPorts_TexturePath,
+		eInputPorts_OnLevelLoad,
+		eInputPorts_Count,
+	};
+};
+
 #endif 
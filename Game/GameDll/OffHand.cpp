@@ -14,6 +14,7 @@ History:
 
 #include "StdAfx.h"
 #include "OffHand.h"
+#include "GameNetProfiler.h"
 #include "Actor.h"
 #include "Throw.h"
 #include "GameRules.h"
@@ -357,6 +358,7 @@ void COffHand::FullSerialize(TSerialize ser)
 //============================================================
 bool COffHand::NetSerialize(TSerialize ser, EEntityAspects aspect, uint8 profile, int flags)
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	return true;
 }
 
@@ -15,6 +15,7 @@ History:
 #include "GameCVars.h"
 #include "GameActions.h"
 #include "Player.h"
+#include "GameNetProfiler.h"
 #include "PlayerView.h"
 #include "GameUtils.h"
 
@@ -23,6 +24,7 @@ History:
 #include "OffHand.h"
 #include "Fists.h"
 #include "GameRules.h"
+#include "WaterQueryCache.h"
 
 #include "Camera/CameraManager.h"
 #include "Camera/CameraView.h"
@@ -820,42 +822,49 @@ void CPlayer::Update(SEntityUpdateContext& ctx, int updateSlot)
 		ChangeParachuteState(0);		
 		}
 
+	// the update LOD only throttles the cosmetic part (breathing, sprint sounds, first person effects),
+	// the stats feed the movement code and are updated every frame
+	const SActorUpdateLodState& lodState = GetUpdateLodState();
 	if (!m_stats.isRagDoll && GetHealth()>0 && !m_stats.isFrozen)
 	{
 		//		UpdateAsLiveAndMobile(ctx); // Callback for inherited CPlayer classes
 		UpdateStats(frameTime);
-		UpdateBreathing(frameTime);
 
-		if(m_stats.bSprinting)
+		if (lodState.detailedUpdate)
 		{
-			if(!m_sprintTimer)
-				m_sprintTimer = gEnv->pTimer->GetFrameStartTime().GetSeconds();
-			else if((m_stats.inWaterTimer <= 0.0f) && m_stance == STANCE_STAND && !m_sounds[ESound_Run] && (gEnv->pTimer->GetFrameStartTime().GetSeconds() - m_sprintTimer > 3.0f))
-				PlaySound(ESound_Run);
-			else if(m_sounds[ESound_Run] && ((m_stats.headUnderWaterTimer > 0.0f) || m_stance == STANCE_PRONE || m_stance == STANCE_CROUCH))
+			UpdateBreathing(lodState.GetDetailedFrameTime(frameTime));
+
+			if(m_stats.bSprinting)
 			{
-				PlaySound(ESound_Run, false);
-				m_sprintTimer = 0.0f;
-			}
+				if(!m_sprintTimer)
+					m_sprintTimer = gEnv->pTimer->GetFrameStartTime().GetSeconds();
+				else if((m_stats.inWaterTimer <= 0.0f) && m_stance == STANCE_STAND && !m_sounds[ESound_Run] && (gEnv->pTimer->GetFrameStartTime().GetSeconds() - m_sprintTimer > 3.0f))
+					PlaySound(ESound_Run);
+				else if(m_sounds[ESound_Run] && ((m_stats.headUnderWaterTimer > 0.0f) || m_stance == STANCE_PRONE || m_stance == STANCE_CROUCH))
+				{
+					PlaySound(ESound_Run, false);
+					m_sprintTimer = 0.0f;
+				}
 
-			// Report super sprint to AI system.
-			m_bSpeedSprint = false;			
-		}
-		else 
-		{
-			if(m_sounds[ESound_Run])
+				// Report super sprint to AI system.
+				m_bSpeedSprint = false;			
+			}
+			else 
 			{
-				PlaySound(ESound_Run, false);
-				PlaySound(ESound_StopRun);
+				if(m_sounds[ESound_Run])
+				{
+					PlaySound(ESound_Run, false);
+					PlaySound(ESound_StopRun);
+				}
+				m_sprintTimer = 0.0f;
+				m_bSpeedSprint = false;
 			}
-			m_sprintTimer = 0.0f;
-			m_bSpeedSprint = false;
-		}
 	
-		if(client)
-		{
-			UpdateFirstPersonFists();
-			UpdateFirstPersonEffects(frameTime);
+			if(client)
+			{
+				UpdateFirstPersonFists();
+				UpdateFirstPersonEffects(frameTime);
+			}
 		}
 
 		UpdateParachute(frameTime);
@@ -1488,8 +1497,12 @@ void CPlayer::SetIK( const SActorFrameMovementParams& frameMovementParams )
 	if (!pCharacter)
 		return;
 
+	// the IK is applied every frame, reduced LOD frames just reuse the targets of the last detailed update
+	const bool updateTargets = GetUpdateLodState().detailedUpdate;
+
 	SMovementState curMovementState;
-	m_pMovementController->GetMovementState(curMovementState);
+	if (updateTargets)
+		m_pMovementController->GetMovementState(curMovementState);
 
 	pGraph->SetInput( m_inputUsingLookIK, int(frameMovementParams.lookIK || frameMovementParams.aimIK) );
 
@@ -1502,7 +1515,10 @@ void CPlayer::SetIK( const SActorFrameMovementParams& frameMovementParams )
 	if (!lookEnabled || IsClient() || !GetLinkedVehicle())
 	{
 			// Normal case
-			m_lookAim.UpdateLook( this, pCharacter, lookEnabled, GetLookFOV(m_params), frameMovementParams.lookTarget );
+			if (updateTargets)
+				m_IKLookTarget = frameMovementParams.lookTarget;
+
+			m_lookAim.UpdateLook( this, pCharacter, lookEnabled, GetLookFOV(m_params), m_IKLookTarget );
 	}
 	else
 	{
@@ -1517,22 +1533,24 @@ void CPlayer::SetIK( const SActorFrameMovementParams& frameMovementParams )
 			lookIKBlends[4] = 0.7f;		// head 
 
 			// look in 'vehicleviewdir' (NOTE: this code should probably be somewhere else, including the vehicleViewDir concept)
-			Vec3 target = curMovementState.eyePosition + 5.0f * m_vehicleViewDir;
+			if (updateTargets)
+				m_IKLookTarget = curMovementState.eyePosition + 5.0f * m_vehicleViewDir;
 
-			m_lookAim.UpdateLook( this, pCharacter, true, GetLookFOV(m_params), target, lookIKBlends );
+			m_lookAim.UpdateLook( this, pCharacter, true, GetLookFOV(m_params), m_IKLookTarget, lookIKBlends );
 	}
 
 	// -----------------------------------
 	// AIMING 
 	// -----------------------------------
-	Vec3 aimTarget = !frameMovementParams.aimTarget.IsZero() ? frameMovementParams.aimTarget: curMovementState.eyePosition + curMovementState.aimDirection * 5.0f;;
+	if (updateTargets)
+		m_IKAimTarget = !frameMovementParams.aimTarget.IsZero() ? frameMovementParams.aimTarget: curMovementState.eyePosition + curMovementState.aimDirection * 5.0f;
 	bool aimEnabled = m_pAnimatedCharacter->IsAimIkAllowed();
 
 	const int32 aimIKLayer = GetAimIKLayer(m_params);
 	pGraph->SetInput( m_inputAiming, aimEnabled ? 1 : 0 );
 
 	ISkeletonPose * pSkeletonPose = pCharacter->GetISkeletonPose();
-	pSkeletonPose->SetAimIK( aimEnabled, aimTarget);
+	pSkeletonPose->SetAimIK( aimEnabled, m_IKAimTarget);
 
 	const float AIMIK_FADEOUT_TIME = 0.25f;
 	pSkeletonPose->SetAimIKFadeOutTime(AIMIK_FADEOUT_TIME);
@@ -2081,24 +2099,21 @@ void CPlayer::SetStats(SmartScriptTable &rTable)
 }
 
 //fill the status table for the scripts
-void CPlayer::UpdateScriptStats(SmartScriptTable &rTable)
+void CPlayer::UpdateScriptStats(CActorScriptStats &stats)
 {
 	FUNCTION_PROFILER(gEnv->pSystem, PROFILE_GAME);
 
-	CActor::UpdateScriptStats(rTable);
-
-	CScriptSetGetChain stats(rTable);
+	CActor::UpdateScriptStats(stats);
 
-	m_stats.isFrozen.SetDirtyValue(stats, "isFrozen");
+	stats.Set(eASS_IsFrozen,m_stats.isFrozen.Value());
 	//stats.SetValue("isWalkingOnWater",m_stats.isWalkingOnWater);
 	
 	//stats.SetValue("shakeAmount",m_stats.shakeAmount);	
-	m_stats.followCharacterHead.SetDirtyValue(stats, "followCharacterHead");
-	m_stats.firstPersonBody.SetDirtyValue(stats, "firstPersonBody");
-	m_stats.isOnLadder.SetDirtyValue(stats, "isOnLadder");
+	stats.Set(eASS_FollowCharacterHead,(int)m_stats.followCharacterHead.Value());
+	stats.Set(eASS_FirstPersonBody,(int)m_stats.firstPersonBody.Value());
+	stats.Set(eASS_IsOnLadder,m_stats.isOnLadder.Value());
 	
-	stats.SetValue("gravityBoots",GravityBootsOn());
-	m_stats.inFreefall.SetDirtyValue(stats, "inFreeFall");
+	stats.Set(eASS_GravityBoots,GravityBootsOn());
 }
 
 //------------------------------------------------------------------------
@@ -2152,8 +2167,9 @@ void CPlayer::UpdateSwimStats(float frameTime)
 	}
 
 	Vec3 referencePos = GetEntity()->GetWorldPos() + GetEntity()->GetWorldRotation() * localReferencePos;
-	float worldWaterLevel = gEnv->p3DEngine->GetWaterLevel(&referencePos);
-	float worldBottomLevel = gEnv->p3DEngine->GetBottomLevel (referencePos, 10.0f);
+	CWaterQueryCache& waterQueryCache = g_pGame->GetWaterQueryCache();
+	float worldWaterLevel = waterQueryCache.GetWaterLevel(referencePos);
+	float worldBottomLevel = waterQueryCache.GetBottomLevel(referencePos, 10.0f);
 	m_stats.worldWaterLevelDelta = CLAMP(worldWaterLevel - m_stats.worldWaterLevel, -0.5f, +0.5f); // In case worldWaterLevel is reset or wrong, preventing huge deltas.
 	m_stats.worldWaterLevel = worldWaterLevel;
 	float playerWaterLevel = -WATER_LEVEL_UNKNOWN;
@@ -3166,6 +3182,8 @@ void CPlayer::Revive( bool fromInit )
 
 	m_feetWpos[0] = ZERO;
 	m_feetWpos[1] = ZERO;
+	m_IKLookTarget = ZERO;
+	m_IKAimTarget = ZERO;
 	m_lastAnimContPos = ZERO;
 
 	m_angleOffset.Set(0,0,0);
@@ -4058,6 +4076,7 @@ bool CPlayer::SetAspectProfile(EEntityAspects aspect, uint8 profile )
 
 bool CPlayer::NetSerialize( TSerialize ser, EEntityAspects aspect, uint8 profile, int flags )
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	if (!CActor::NetSerialize(ser, aspect, profile, flags))
 		return false;
 // PLAYERPREDICTION
@@ -4653,6 +4672,10 @@ void CPlayer::ProcessIKLegs(ICharacterInstance *pCharacter,float frameTime)
 	if (GetGameObject()->IsProbablyDistant() && !GetGameObject()->IsProbablyVisible())
 		return;
 
+	// the ground raycasts only run on detailed updates, m_feetWpos keeps the last hits in between
+	if (!GetUpdateLodState().detailedUpdate)
+		return;
+
 	static bool bOnce = true;
 	static int nDrawIK = 0;
 	static int nNoIK = 0;
@@ -5573,6 +5596,7 @@ void CPlayer::LeaveLadder(ELadderActionType reason)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, SvRequestGrabOnLadder)
 		{
+	GAME_NET_PROFILE_RMI(CPlayer, SvRequestGrabOnLadder);
 	if(IsLadderUsable() && m_stats.ladderTop.IsEquivalent(params.topPos) && m_stats.ladderBottom.IsEquivalent(params.bottomPos))
 		{
 		GrabOnLadder(static_cast<ELadderActionType>(params.reason));
@@ -5583,6 +5607,7 @@ IMPLEMENT_RMI(CPlayer, SvRequestGrabOnLadder)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, SvRequestLeaveLadder)
 {
+	GAME_NET_PROFILE_RMI(CPlayer, SvRequestLeaveLadder);
 	if(m_stats.isOnLadder)
 		{
 		if(m_stats.ladderTop.IsEquivalent(params.topPos) && m_stats.ladderBottom.IsEquivalent(params.bottomPos))
@@ -5597,6 +5622,7 @@ IMPLEMENT_RMI(CPlayer, SvRequestLeaveLadder)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, ClGrabOnLadder)
 	{
+	GAME_NET_PROFILE_RMI(CPlayer, ClGrabOnLadder);
 	// other players should always be attached to the ladder they are told to
 	if(!IsClient())
 		{
@@ -5616,6 +5642,7 @@ IMPLEMENT_RMI(CPlayer, ClGrabOnLadder)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, ClLeaveLadder)
 {
+	GAME_NET_PROFILE_RMI(CPlayer, ClLeaveLadder);
 	// probably not worth checking the positions here - just get off the ladder whatever.
 	if(m_stats.isOnLadder)
 	{
@@ -6237,6 +6264,7 @@ bool CPlayer::IsSprinting()
 
 IMPLEMENT_RMI(CPlayer, ClAnimGraphTransition)
 	{
+	GAME_NET_PROFILE_RMI(CPlayer, ClAnimGraphTransition);
 	if (m_pAnimatedCharacter)
 		{
 		if (IAnimationGraphState* pAGState = m_pAnimatedCharacter->GetAnimationGraphState())
@@ -6248,6 +6276,7 @@ IMPLEMENT_RMI(CPlayer, ClAnimGraphTransition)
 
 IMPLEMENT_RMI(CPlayer, ClAnimGraphInput)
 {
+	GAME_NET_PROFILE_RMI(CPlayer, ClAnimGraphInput);
 	if (m_pAnimatedCharacter)
 {
 		if (IAnimationGraphState* pAGState = m_pAnimatedCharacter->GetAnimationGraphState())
@@ -6266,6 +6295,7 @@ IMPLEMENT_RMI(CPlayer, ClAnimGraphInput)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, SvRequestUnfreeze)
 	{
+	GAME_NET_PROFILE_RMI(CPlayer, SvRequestUnfreeze);
 	if (params.delta>0.0f && params.delta <=1.0f && GetHealth()>0)
 		{
 		SetFrozenAmount(m_frozenAmount-params.delta);
@@ -6282,6 +6312,7 @@ IMPLEMENT_RMI(CPlayer, SvRequestUnfreeze)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, SvRequestHitAssistance)
 			{
+	GAME_NET_PROFILE_RMI(CPlayer, SvRequestHitAssistance);
 	m_bHasAssistance=params.assistance;
 	return true;
 			}
@@ -6289,12 +6320,14 @@ IMPLEMENT_RMI(CPlayer, SvRequestHitAssistance)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, ClEMP)
 		{
+	GAME_NET_PROFILE_RMI(CPlayer, ClEMP);
 	return true;
 }
 
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, ClJump)
 {
+	GAME_NET_PROFILE_RMI(CPlayer, ClJump);
 	if (params.strengthJump)
 {
 		if (CPlayerMovementController *pPMC=static_cast<CPlayerMovementController *>(GetMovementController()))
@@ -6311,6 +6344,7 @@ IMPLEMENT_RMI(CPlayer, ClJump)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, SvRequestJump)
 {
+	GAME_NET_PROFILE_RMI(CPlayer, SvRequestJump);
 	GetGameObject()->InvokeRMI(ClJump(), params, eRMI_ToOtherClients|eRMI_NoLocalCalls, m_pGameFramework->GetGameChannelId(pNetChannel));
 	GetGameObject()->Pulse('bang');
 
@@ -6333,6 +6367,7 @@ IMPLEMENT_RMI(CPlayer, SvRequestJump)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CPlayer, SvRequestParachute)
 {
+	GAME_NET_PROFILE_RMI(CPlayer, SvRequestParachute);
 	if (!IsClient() && m_parachuteEnabled && (m_stats.inFreefall.Value()==1))
 	{
 		ChangeParachuteState(3);
@@ -6800,7 +6835,7 @@ void CPlayer::ExecuteFootStep( ICharacterInstance* pCharacter, const float frame
 			CryFixedStringT<16> sEffectWater = "water_shallow";
 
 			bool usingWaterEffectId = false;
-			const float feetWaterLevel = gEnv->p3DEngine->GetWaterLevel(&params.pos);
+			const float feetWaterLevel = g_pGame->GetWaterQueryCache().GetWaterLevel(params.pos);
 
 			if (feetWaterLevel != WATER_LEVEL_UNKNOWN)
 			{
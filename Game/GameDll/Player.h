@@ -630,7 +630,7 @@ public:
 
 	//set/get actor status
 	virtual void SetStats(SmartScriptTable &rTable);
-	virtual void UpdateScriptStats(SmartScriptTable &rTable);
+	virtual void UpdateScriptStats(CActorScriptStats &stats);
 	virtual void UpdateStats(float frameTime);
 	virtual void UpdateSwimStats(float frameTime);
 	virtual void UpdateUWBreathing(float frameTime, Vec3 worldBreathPos);
@@ -988,6 +988,8 @@ protected:
 	bool m_bRagDollHead;
 
 	CLookAim_Helper	m_lookAim;
+	Vec3 m_IKLookTarget;	// look/aim targets of the last detailed update, reapplied on reduced LOD frames
+	Vec3 m_IKAimTarget;
 
 	// animation graph input ids
 	IAnimationGraph::InputID m_inputAction;
@@ -14,6 +14,7 @@ History:
 #include "Game.h"
 #include "GameCVars.h"
 #include "Projectile.h"
+#include "GameNetProfiler.h"
 #include "Bullet.h"
 #include "WeaponSystem.h"
 #include "ISerialize.h"
@@ -184,6 +185,7 @@ bool CProjectile::SetAspectProfile( EEntityAspects aspect, uint8 profile )
 //------------------------------------------------------------------------
 bool CProjectile::NetSerialize(TSerialize ser, EEntityAspects aspect, uint8 profile, int pflags)
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	if (aspect == eEA_Physics)
 	{
 		pe_type type = PE_NONE;
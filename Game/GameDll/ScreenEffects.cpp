@@ -18,7 +18,9 @@ CScreenEffects::CScreenEffects(IActor *owner) :
 m_ownerActor(owner), 
 m_curUniqueID(0), 
 m_enableBlends(true), 
-m_updatecoords(false)
+m_updatecoords(false),
+m_coordsXparam(CPostEffectParams::InvalidHandle),
+m_coordsYparam(CPostEffectParams::InvalidHandle)
 {
 }
 
@@ -33,32 +35,34 @@ void CScreenEffects::Update(float frameTime)
 {
 	if (!m_enableBlends)
 		return;
-	std::map<int, CBlendGroup*>::iterator it = m_blends.begin();
-	while (it != m_blends.end())
+
+	const int numGroups = (int)m_blends.size();
+	for (int i = 0; i < numGroups; ++i)
 	{
-		CBlendGroup *curGroup = (CBlendGroup *)it->second;
-		bool found = m_enabledGroups.find(it->first) != m_enabledGroups.end();
-		if (curGroup && (!found || (found && m_enabledGroups[it->first])))
+		CBlendGroup *curGroup = m_blends[i];
+		if (curGroup && curGroup->HasJobs() && IsGroupEnabled(i))
 		{
-			if (curGroup->HasJobs())
-			{
-				curGroup->Update(frameTime);
-			}
+			curGroup->Update(frameTime);
 		}
-		it++;
 	}
 
 }
 
 void CScreenEffects::PostUpdate(float frameTime)
 {
-	if (m_updatecoords && m_ownerActor->IsClient())
+	if (!m_ownerActor->IsClient())
+		return;
+
+	if (m_updatecoords)
 	{
 		Vec3 screenspace;
 		gEnv->pRenderer->ProjectToScreen(m_coords3d.x, m_coords3d.y, m_coords3d.z, &screenspace.x, &screenspace.y, &screenspace.z);
-		gEnv->p3DEngine->SetPostEffectParam(m_coordsXname, screenspace.x/100.0f);
-		gEnv->p3DEngine->SetPostEffectParam(m_coordsYname, screenspace.y/100.0f);
+		CPostEffectParams::Set(m_coordsXparam, screenspace.x/100.0f);
+		CPostEffectParams::Set(m_coordsYparam, screenspace.y/100.0f);
 	}
+
+	// All blended post effect values of this frame go to the engine here
+	CPostEffectParams::Submit();
 }
 
 //---------------------------------
@@ -73,8 +77,7 @@ void CScreenEffects::StartBlend(IBlendedEffect *effect, IBlendType *blendType, f
 	if(!effect || !blendType)
 		return;
 
-	bool found = m_enabledGroups.find(blendGroup) != m_enabledGroups.end();
-	if (!m_enableBlends || (found && !m_enabledGroups[blendGroup]))
+	if (!m_enableBlends || blendGroup < 0 || !IsGroupEnabled(blendGroup))
 	{
 		if (effect)
 			effect->Release();
@@ -83,19 +86,17 @@ void CScreenEffects::StartBlend(IBlendedEffect *effect, IBlendType *blendType, f
 		return;
 	}
 
-	CBlendGroup *group = 0;
-	if (m_blends.count(blendGroup) == 0)
+	if (blendGroup >= (int)m_blends.size())
+		m_blends.resize(blendGroup + 1, 0);
+
+	CBlendGroup *group = m_blends[blendGroup];
+	if (!group)
 	{
 		group = new CBlendGroup();
 		m_blends[blendGroup] = group;
 	}
-	else
-	{
-		group = m_blends[blendGroup];
-	}
 
-	if (group)
-		group->AddJob(blendType,effect,speed);
+	group->AddJob(blendType,effect,speed);
 
 }
 
@@ -128,31 +129,18 @@ void CScreenEffects::CamShake(Vec3 shiftShake, Vec3 rotateShake, float freq, flo
 //---------------------------------
 bool CScreenEffects::HasJobs(int blendGroup)
 {
-	if (m_blends.count(blendGroup) == 0)
-	{
-		return false;
-	}
-	else
-	{
-		CBlendGroup *group = m_blends[blendGroup];
-		if (group)
-			return (group->HasJobs());
-	}
-	return false;
-	
+	CBlendGroup *group = GetBlendGroup(blendGroup);
+	return group && group->HasJobs();
+
 }
 
 //---------------------------------
 void CScreenEffects::ClearBlendGroup(int blendGroup, bool resetScreen)
 {
-	if (m_blends.count(blendGroup) != 0)
+	if (CBlendGroup *group = GetBlendGroup(blendGroup))
 	{
-		CBlendGroup *group = m_blends[blendGroup];
-		if (group)
-		{
-			delete group;
-			m_blends.erase(m_blends.find(blendGroup));
-		}
+		delete group;
+		m_blends[blendGroup] = 0;
 	}
 	if (resetScreen)
 		ResetScreen();
@@ -162,15 +150,9 @@ void CScreenEffects::ClearBlendGroup(int blendGroup, bool resetScreen)
 //---------------------------------
 void CScreenEffects::ClearAllBlendGroups(bool resetScreen)
 {
-	std::map<int, CBlendGroup* >::iterator it = m_blends.begin();
-	while (it != m_blends.end())
+	for (TBlendGroups::iterator it = m_blends.begin(); it != m_blends.end(); ++it)
 	{
-		CBlendGroup *cur = (CBlendGroup *)it->second;
-		if (cur)
-		{
-			delete cur;
-		}
-		it++;
+		delete *it;
 	}
 	m_blends.clear();
 	if (resetScreen)
@@ -180,13 +162,9 @@ void CScreenEffects::ClearAllBlendGroups(bool resetScreen)
 //---------------------------------
 void CScreenEffects::ResetBlendGroup(int blendGroup, bool resetScreen)
 {
-	if (m_blends.count(blendGroup) != 0)
+	if (CBlendGroup *group = GetBlendGroup(blendGroup))
 	{
-		CBlendGroup *group = m_blends[blendGroup];
-		if (group)
-		{
-			group->Reset();
-		}
+		group->Reset();
 	}
 	if (resetScreen)
 		ResetScreen();
@@ -195,15 +173,12 @@ void CScreenEffects::ResetBlendGroup(int blendGroup, bool resetScreen)
 //---------------------------------
 void CScreenEffects::ResetAllBlendGroups(bool resetScreen)
 {
-	std::map<int, CBlendGroup* >::iterator it = m_blends.begin();
-	while (it != m_blends.end())
+	for (TBlendGroups::iterator it = m_blends.begin(); it != m_blends.end(); ++it)
 	{
-		CBlendGroup *cur = (CBlendGroup *)it->second;
-		if (cur)
+		if (*it)
 		{
-			cur->Reset();
+			(*it)->Reset();
 		}
-		it++;
 	}
 
 	if (resetScreen)
@@ -215,17 +190,32 @@ void CScreenEffects::ResetScreen()
 {
 	if (m_ownerActor->IsClient())
 	{
-		gEnv->p3DEngine->SetPostEffectParam("FilterRadialBlurring_Amount", 0.0f);
-		gEnv->p3DEngine->SetPostEffectParam("Global_Saturation", 1.0f);
-		gEnv->p3DEngine->SetPostEffectParam("Global_Brightness", 1.0f);
-		gEnv->p3DEngine->SetPostEffectParam("Global_Contrast", 1.0f);
-		gEnv->p3DEngine->SetPostEffectParam("Global_ColorC", 0.0f);
-		gEnv->p3DEngine->SetPostEffectParam("Global_ColorM", 0.0f);
-		gEnv->p3DEngine->SetPostEffectParam("Global_ColorY", 0.0f);
-		gEnv->p3DEngine->SetPostEffectParam("Global_ColorK", 0.0f);
-		gEnv->p3DEngine->SetPostEffectParam("BloodSplats_Active", false);
-		gEnv->p3DEngine->SetPostEffectParam("BloodSplats_Type", false);
-		gEnv->p3DEngine->SetPostEffectParam("BloodSplats_Amount", 0.0f);
+		static const CPostEffectParams::THandle radialBlurAmount = CPostEffectParams::GetHandle("FilterRadialBlurring_Amount");
+		static const CPostEffectParams::THandle saturation = CPostEffectParams::GetHandle("Global_Saturation");
+		static const CPostEffectParams::THandle brightness = CPostEffectParams::GetHandle("Global_Brightness");
+		static const CPostEffectParams::THandle contrast = CPostEffectParams::GetHandle("Global_Contrast");
+		static const CPostEffectParams::THandle colorC = CPostEffectParams::GetHandle("Global_ColorC");
+		static const CPostEffectParams::THandle colorM = CPostEffectParams::GetHandle("Global_ColorM");
+		static const CPostEffectParams::THandle colorY = CPostEffectParams::GetHandle("Global_ColorY");
+		static const CPostEffectParams::THandle colorK = CPostEffectParams::GetHandle("Global_ColorK");
+		static const CPostEffectParams::THandle bloodSplatsActive = CPostEffectParams::GetHandle("BloodSplats_Active");
+		static const CPostEffectParams::THandle bloodSplatsType = CPostEffectParams::GetHandle("BloodSplats_Type");
+		static const CPostEffectParams::THandle bloodSplatsAmount = CPostEffectParams::GetHandle("BloodSplats_Amount");
+
+		CPostEffectParams::Set(radialBlurAmount, 0.0f);
+		CPostEffectParams::Set(saturation, 1.0f);
+		CPostEffectParams::Set(brightness, 1.0f);
+		CPostEffectParams::Set(contrast, 1.0f);
+		CPostEffectParams::Set(colorC, 0.0f);
+		CPostEffectParams::Set(colorM, 0.0f);
+		CPostEffectParams::Set(colorY, 0.0f);
+		CPostEffectParams::Set(colorK, 0.0f);
+		CPostEffectParams::Set(bloodSplatsActive, 0.0f);
+		CPostEffectParams::Set(bloodSplatsType, 0.0f);
+		CPostEffectParams::Set(bloodSplatsAmount, 0.0f);
+
+		// Resets can happen outside the update (death, serialization), don't wait for PostUpdate
+		CPostEffectParams::Submit();
 
 		if (m_ownerActor->IsPlayer())
 		{
@@ -238,15 +228,41 @@ void CScreenEffects::ResetScreen()
 
 void CScreenEffects::SetUpdateCoords(const char *coordsXname, const char *coordsYname, Vec3 pos)
 {
-	m_coordsXname = coordsXname;
-	m_coordsYname = coordsYname;
+	m_coordsXparam = CPostEffectParams::GetHandle(coordsXname);
+	m_coordsYparam = CPostEffectParams::GetHandle(coordsYname);
 	m_coords3d = pos;
 	m_updatecoords = true;
 }
 
 void CScreenEffects::EnableBlends(bool enable, int blendGroup)
 {
-	m_enabledGroups[blendGroup] = enable;
+	if (blendGroup < 0)
+		return;
+
+	const int word = blendGroup >> 5;
+	const uint32 bit = 1u << (blendGroup & 31);
+
+	if (word >= (int)m_disabledGroups.size())
+	{
+		if (enable)
+			return;
+		m_disabledGroups.resize(word + 1, 0);
+	}
+
+	if (enable)
+		m_disabledGroups[word] &= ~bit;
+	else
+		m_disabledGroups[word] |= bit;
+}
+
+//---------------------------------
+bool CScreenEffects::IsGroupEnabled(int blendGroup) const
+{
+	const int word = blendGroup >> 5;
+	if (word >= (int)m_disabledGroups.size())
+		return true;
+
+	return (m_disabledGroups[word] & (1u << (blendGroup & 31))) == 0;
 }
 
 //--------------------------------------------------------------
@@ -254,14 +270,12 @@ void CScreenEffects::GetMemoryUsage(ICrySizer * s) const
 {
 	s->Add(this);
 	s->AddContainer(m_blends);
-	s->AddContainer(m_enabledGroups);
+	s->AddContainer(m_disabledGroups);
 
-	std::map<int, CBlendGroup*>::const_iterator cit = m_blends.begin();
-	std::map<int, CBlendGroup*>::const_iterator end = m_blends.end();
-	while(cit!=end)
+	for (TBlendGroups::const_iterator cit = m_blends.begin(); cit != m_blends.end(); ++cit)
 	{
-		cit->second->GetMemoryUsage(s);
-		cit++;
+		if (*cit)
+			(*cit)->GetMemoryUsage(s);
 	}
 }
 
@@ -65,14 +65,20 @@ public:
 
 private:
 
-	// Maps blend group IDs to blend groups
-	std::map<int, CBlendGroup*> m_blends;
-	std::map<int, bool> m_enabledGroups;
+	CBlendGroup* GetBlendGroup(int blendGroup) const { return (blendGroup >= 0 && blendGroup < (int)m_blends.size()) ? m_blends[blendGroup] : 0; }
+	bool IsGroupEnabled(int blendGroup) const;
+
+	typedef std::vector<CBlendGroup*> TBlendGroups;
+
+	// Blend groups indexed by group ID
+	TBlendGroups m_blends;
+	// One bit per group ID, set when the group has been disabled
+	std::vector<uint32> m_disabledGroups;
 	int     m_curUniqueID;
 	bool    m_enableBlends;
 	bool    m_updatecoords;
-	string  m_coordsXname;
-	string  m_coordsYname;
+	CPostEffectParams::THandle m_coordsXparam;
+	CPostEffectParams::THandle m_coordsYparam;
 	Vec3    m_coords3d;
 	IActor* m_ownerActor;
 };
@@ -0,0 +1,86 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Quantized serialization of the player input movement vector: the
+direction is octahedral encoded into two bytes and the length sent as a
+byte, so standing still is always received as an exact zero.
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __SERIALIZE_MOVEMENT_HELPER_H__
+#define __SERIALIZE_MOVEMENT_HELPER_H__
+
+#pragma once
+
+// deltaMovement is the velocity scaled by pl_netSerialiseMaxSpeed, sprinting can go past 1
+static const float k_serializedMovementMaxLength = 2.0f;
+
+static inline float OctahedralSignNotZero( float v )
+{
+	return (float)__fsel(v, 1.0f, -1.0f);
+}
+
+static inline void OctahedralEncode( const Vec3& dir, uint8& u, uint8& v )
+{
+	const float l1 = fabs_tpl(dir.x) + fabs_tpl(dir.y) + fabs_tpl(dir.z);
+	float x = (l1 > 0.0f) ? dir.x / l1 : 0.0f;
+	float y = (l1 > 0.0f) ? dir.y / l1 : 0.0f;
+
+	// fold the lower hemisphere over the diagonals
+	if (dir.z < 0.0f)
+	{
+		const float fx = (1.0f - fabs_tpl(y)) * OctahedralSignNotZero(x);
+		const float fy = (1.0f - fabs_tpl(x)) * OctahedralSignNotZero(y);
+		x = fx;
+		y = fy;
+	}
+
+	u = (uint8)int_round(clamp_tpl(x * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f);
+	v = (uint8)int_round(clamp_tpl(y * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f);
+}
+
+static inline Vec3 OctahedralDecode( uint8 u, uint8 v )
+{
+	Vec3 dir((float)u * (2.0f / 255.0f) - 1.0f, (float)v * (2.0f / 255.0f) - 1.0f, 0.0f);
+	dir.z = 1.0f - fabs_tpl(dir.x) - fabs_tpl(dir.y);
+
+	if (dir.z < 0.0f)
+	{
+		const float fx = (1.0f - fabs_tpl(dir.y)) * OctahedralSignNotZero(dir.x);
+		const float fy = (1.0f - fabs_tpl(dir.x)) * OctahedralSignNotZero(dir.y);
+		dir.x = fx;
+		dir.y = fy;
+	}
+
+	return dir.GetNormalizedSafe(FORWARD_DIRECTION);
+}
+
+static inline void SerializeMovementHelper( TSerialize ser, Vec3& movement, int policy )
+{
+	uint8 u = 127, v = 127, length = 0;
+
+	if (!ser.IsReading())
+	{
+		const float fLength = movement.GetLength();
+		length = (uint8)int_round(clamp_tpl(fLength / k_serializedMovementMaxLength, 0.0f, 1.0f) * 255.0f);
+		if (length)
+			OctahedralEncode(movement / fLength, u, v);
+	}
+
+	ser.Value("moveDirU", u, policy);
+	ser.Value("moveDirV", v, policy);
+	ser.Value("moveLength", length, policy);
+
+	if (ser.IsReading())
+	{
+		if (length)
+			movement = OctahedralDecode(u, v) * ((float)length * (k_serializedMovementMaxLength / 255.0f));
+		else
+			movement.zero();
+	}
+}
+
+#endif //__SERIALIZE_MOVEMENT_HELPER_H__
@@ -36,17 +36,12 @@ void CServerGameTokenSynch::Reset()
 
 void CServerGameTokenSynch::ResetChannel(int channelId)
 {
-	TChannelQueueMap::iterator cit=m_queue.lower_bound(SChannelQueueEnt(channelId, 0));
-	while (cit != m_queue.end() && cit->first.channel == channelId)
-	{
-		TChannelQueueMap::iterator next = cit;
-		++next;
-		m_queue.erase(cit);
-		cit = next;
-	}
-
 	if (SChannel *pChannel = GetChannel(channelId))
 	{
+		// the client forgets the token names on reset
+		pChannel->dirty.clear();
+		pChannel->defined.clear();
+
 		if (pChannel->pNetChannel)
 			pChannel->pNetChannel->AddSendable( new CClientGameTokenSynch::CResetMsg(channelId), 1, &pChannel->lastOrderedMessage, &pChannel->lastOrderedMessage );
 	}
@@ -83,50 +78,96 @@ void CServerGameTokenSynch::AddToQueueFor(int channelId, TGameTokenName name)
 	if (!pChannel || !pChannel->pNetChannel || pChannel->local)
 		return;
 
-	SSendableHandle& msgHdl = m_queue[SChannelQueueEnt(channelId, name)];
+	pChannel->dirty.insert(GetTokenId(name));
+}
 
-	TGameTokenValue value; 
+//------------------------------------------------------------------------
+uint16 CServerGameTokenSynch::GetTokenId(const TGameTokenName &name)
+{
+	std::pair<TTokenIdMap::iterator, bool> result=m_tokenIds.insert(TTokenIdMap::value_type(name, (uint16)m_tokenNames.size()));
+	if (result.second)
+	{
+		assert(m_tokenNames.size()<0xffff);
+		m_tokenNames.push_back(name);
+	}
 
-	IGameToken *pToken=m_pGTS->FindToken(name.c_str());
-	assert(pToken);
-	if (!pToken)
-		return;
+	return result.first->second;
+}
 
-	bool ok=pToken->GetValue(value);
-	assert(ok);
-	if (!ok)
-		return;
+//------------------------------------------------------------------------
+void CServerGameTokenSynch::Update()
+{
+	for (TChannelMap::iterator it=m_channels.begin(); it!=m_channels.end(); ++it)
+	{
+		SChannel &channel=it->second;
+		if (channel.pNetChannel && !channel.local && !channel.dirty.empty())
+			SendBatch(it->first, channel);
+	}
+}
 
-	CClientGameTokenSynch::CSetMsg *pMsg=0;
+//------------------------------------------------------------------------
+void CServerGameTokenSynch::SendBatch(int channelId, SChannel &channel)
+{
+	CClientGameTokenSynch::CSetBatchMsg *pMsg=0;
 
-	switch (value.GetType())
+	for (VectorSet<uint16>::const_iterator it=channel.dirty.begin(); it!=channel.dirty.end(); ++it)
 	{
-	case eFDT_Int:
-		pMsg=new CClientGameTokenSynch::CSetIntMsg(channelId, name, value);
-		break;
-	case eFDT_Float:
-		pMsg=new CClientGameTokenSynch::CSetFloatMsg(channelId, name, value);
-		break;
-	case eFDT_EntityId:
-		pMsg=new CClientGameTokenSynch::CSetEntityIdMsg(channelId, name, value);
-		break;
-	case eFDT_Vec3:
-		pMsg=new CClientGameTokenSynch::CSetVec3Msg(channelId, name, value);
-		break;
-	case eFDT_String:
-		pMsg=new CClientGameTokenSynch::CSetStringMsg(channelId, name, value);
-		break;
-	case eFDT_Bool:
-		pMsg=new CClientGameTokenSynch::CSetBoolMsg(channelId, name, value);
-		break;
+		const uint16 id=*it;
+		const TGameTokenName &name=m_tokenNames[id];
+
+		IGameToken *pToken=m_pGTS->FindToken(name.c_str());
+		assert(pToken);
+		if (!pToken)
+			continue;
+
+		CClientGameTokenSynch::CSetBatchMsg::SEntry entry;
+		bool ok=pToken->GetValue(entry.value);
+		assert(ok);
+		if (!ok)
+			continue;
+
+		switch (entry.value.GetType())
+		{
+		case eFDT_Int:
+		case eFDT_Float:
+		case eFDT_EntityId:
+		case eFDT_Vec3:
+		case eFDT_String:
+		case eFDT_Bool:
+			break;
+		default:
+			assert(!"Invalid type!");
+			continue;
+		}
+
+		if (id>=channel.defined.size())
+			channel.defined.resize(id+1, false);
+
+		entry.id=id;
+		entry.define=!channel.defined[id];
+		if (entry.define)
+		{
+			entry.name=name;
+			channel.defined[id]=true;
+		}
+
+		if (!pMsg)
+			pMsg=new CClientGameTokenSynch::CSetBatchMsg(channelId);
+
+		pMsg->entries.push_back(entry);
+
+		// batches are reliable ordered, so a name is always defined before it's used
+		if (pMsg->entries.size()>=CClientGameTokenSynch::CSetBatchMsg::k_maxEntries)
+		{
+			channel.pNetChannel->AddSendable(pMsg, 1, &channel.lastOrderedMessage, &channel.lastOrderedMessage);
+			pMsg=0;
+		}
 	}
 
 	if (pMsg)
-		pChannel->pNetChannel->SubstituteSendable(pMsg, 1, &pChannel->lastOrderedMessage, &msgHdl);
-	else
-	{
-		assert(!"Invalid type!");
-	}
+		channel.pNetChannel->AddSendable(pMsg, 1, &channel.lastOrderedMessage, &channel.lastOrderedMessage);
+
+	channel.dirty.clear();
 }
 
 //------------------------------------------------------------------------
@@ -216,6 +257,7 @@ int CServerGameTokenSynch::GetChannelId(INetChannel *pNetChannel) const
 void CServerGameTokenSynch::GetMemoryUsage(ICrySizer * s) const
 {
 	SIZER_SUBCOMPONENT_NAME(s,"ServerGameTokenSynch");
-	//s->AddObject(m_queue);
-	//s->AddObject(m_channels);
+	s->AddContainer(m_tokenIds);
+	s->AddContainer(m_tokenNames);
+	s->AddContainer(m_channels);
 }
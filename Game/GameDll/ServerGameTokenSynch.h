@@ -24,6 +24,7 @@ History:
 #include "STLGlobalAllocator.h"
 
 #include <deque>
+#include <VectorSet.h>
 
 
 class CServerGameTokenSynch:
@@ -47,6 +48,9 @@ public:
 	virtual void Reset();
 	virtual void ResetChannel(int channelId);
 
+	// sends the tokens changed since the last call, one batch per channel
+	virtual void Update();
+
 	// these should only be called from the main thread
 	virtual void AddToQueue(TGameTokenName name);
 
@@ -68,10 +72,15 @@ public:
 
 		INetChannel				*pNetChannel;
 		SSendableHandle   lastOrderedMessage;
+		VectorSet<uint16>	dirty;					// token ids
+		std::vector<bool>	defined;				// token ids whose name was sent already
 		bool							local:1;
 		bool							onhold:1;
 
-		void GetMemoryUsage( ICrySizer *pSizer ) const { /*nothing*/ }
+		void GetMemoryUsage( ICrySizer *pSizer ) const
+		{
+			pSizer->AddContainer(dirty);
+		}
 	};
 
 	SChannel *GetChannel(int channelId);
@@ -79,28 +88,14 @@ public:
 	int GetChannelId(INetChannel *pNetChannel) const;
 
 protected:
-	struct SChannelQueueEnt
-	{
-		SChannelQueueEnt() {}
-		SChannelQueueEnt(int c, const TGameTokenName& k) : channel(c), name(k) {}
-		int channel;
-		TGameTokenName name;
-
-		bool operator<( const SChannelQueueEnt& rhs ) const
-		{
-			return rhs.channel < channel || (rhs.channel == channel && rhs.name < name);
-		}
-
-		void GetMemoryUsage( ICrySizer *pSizer ) const
-		{
-			pSizer->AddObject(name);
-		}
-	};
+	uint16 GetTokenId(const TGameTokenName &name);
+	void SendBatch(int channelId, SChannel &channel);
 
-	typedef std::map<SChannelQueueEnt, SSendableHandle>								TChannelQueueMap;
+	typedef std::map<TGameTokenName, uint16>													TTokenIdMap;
 	typedef std::map<int, SChannel, std::less<int>, stl::STLGlobalAllocator<std::pair<int, SChannel> > > TChannelMap;
 
-	TChannelQueueMap				m_queue;
+	TTokenIdMap							m_tokenIds;		// interned token names, ids are shared by all the channels
+	std::vector<TGameTokenName>	m_tokenNames;
 	TChannelMap							m_channels;
 
 	IGameTokenSystem *m_pGTS;
@@ -30,35 +30,11 @@ void CServerSynchedStorage::ResetChannel(int channelId)
 {
 	CryAutoCriticalSection lock(m_mutex);
 
-	TChannelQueueMap::iterator cit=m_channelQueue.lower_bound(SChannelQueueEnt(channelId, 0));
-	while (cit != m_channelQueue.end() && cit->first.channel == channelId)
-	{
-		TChannelQueueMap::iterator next = cit;
-		++next;
-		m_channelQueue.erase(cit);
-		cit = next;
-	}
-
-	TChannelQueueMap::iterator git=m_globalQueue.lower_bound(SChannelQueueEnt(channelId, 0));
-	while (git != m_globalQueue.end() && git->first.channel == channelId)
-	{
-		TChannelQueueMap::iterator next = git;
-		++next;
-		m_globalQueue.erase(git);
-		git = next;
-	}
-
-	TChannelEntityQueueMap::iterator eit=m_entityQueue.lower_bound(SChannelEntityQueueEnt(channelId, 0, 0));
-	while (eit != m_entityQueue.end() && eit->first.channel == channelId)
-	{
-		TChannelEntityQueueMap::iterator next = eit;
-		++next;
-		m_entityQueue.erase(eit);
-		eit = next;
-	}
-
 	if (SChannel *pChannel = GetChannel(channelId))
 	{
+		for (int i=0; i<CClientSynchedStorage::CSetDeltaMsg::eS_Count; ++i)
+			pChannel->dirty[i].clear();
+
 		if (pChannel->pNetChannel)
 			pChannel->pNetChannel->AddSendable( new CClientSynchedStorage::CResetMsg(channelId, this), 1, &pChannel->lastOrderedMessage, &pChannel->lastOrderedMessage );
 	}
@@ -92,156 +68,223 @@ void CServerSynchedStorage::AddToEntityQueue(EntityId entityId, TSynchedKey key)
 
 //------------------------------------------------------------------------
 void CServerSynchedStorage::AddToChannelQueue(int channelId, TSynchedKey key)
+{
+	MarkDirty(channelId, CClientSynchedStorage::CSetDeltaMsg::eS_Channel, 0, key);
+}
+
+//------------------------------------------------------------------------
+void CServerSynchedStorage::AddToGlobalQueueFor(int channelId, TSynchedKey key)
+{
+	MarkDirty(channelId, CClientSynchedStorage::CSetDeltaMsg::eS_Global, 0, key);
+}
+
+//------------------------------------------------------------------------
+void CServerSynchedStorage::AddToEntityQueueFor(int channelId, EntityId entityId, TSynchedKey key)
+{
+	MarkDirty(channelId, CClientSynchedStorage::CSetDeltaMsg::eS_Entity, entityId, key);
+}
+
+//------------------------------------------------------------------------
+void CServerSynchedStorage::MarkDirty(int channelId, CClientSynchedStorage::CSetDeltaMsg::EScope scope, EntityId entityId, TSynchedKey key)
 {
 	SChannel * pChannel = GetChannel(channelId);
 	assert(pChannel);
 	if (!pChannel || !pChannel->pNetChannel || pChannel->local)
 		return;
 
-	SSendableHandle& msgHdl = m_channelQueue[SChannelQueueEnt(channelId, key)];
+	CryAutoCriticalSection lock(m_mutex);
 
-	TSynchedValue value; 
-	bool ok=GetChannelValue(channelId, key, value);
-	assert(ok);
-	if (!ok)
-		return;
+	pChannel->dirty[scope].insert(TEntityKey(entityId, key));
+}
 
-	CClientSynchedStorage::CSetChannelMsg *pMsg=0;
+//------------------------------------------------------------------------
+void CServerSynchedStorage::Update()
+{
+	CryAutoCriticalSection lock(m_mutex);
 
-	switch (value.GetType())
+	for (TChannelMap::iterator it=m_channels.begin(); it!=m_channels.end(); ++it)
 	{
-	case eSVT_Bool:
-		pMsg=new CClientSynchedStorage::CSetChannelBoolMsg(channelId, this, key, value);
-		break;
-	case eSVT_Float:
-		pMsg=new CClientSynchedStorage::CSetChannelFloatMsg(channelId, this, key, value);
-		break;
-	case eSVT_Int:
-		pMsg=new CClientSynchedStorage::CSetChannelIntMsg(channelId, this, key, value);
-		break;
-	case eSVT_EntityId:
-		pMsg=new CClientSynchedStorage::CSetChannelEntityIdMsg(channelId, this, key, value);
-		break;
-	case eSVT_String:
-		pMsg=new CClientSynchedStorage::CSetChannelStringMsg(channelId, this, key, value);
-		break;
-	}
+		SChannel &channel=it->second;
+		if (!channel.pNetChannel || channel.local)
+			continue;
 
-	if (pMsg)
-		pChannel->pNetChannel->SubstituteSendable(pMsg, 1, &pChannel->lastOrderedMessage, &msgHdl);
-	else
-	{
-		assert(!"Invalid type!");
+		for (int i=0; i<CClientSynchedStorage::CSetDeltaMsg::eS_Count; ++i)
+			SendDeltas(it->first, channel, (CClientSynchedStorage::CSetDeltaMsg::EScope)i);
 	}
 }
 
 //------------------------------------------------------------------------
-void CServerSynchedStorage::AddToGlobalQueueFor(int channelId, TSynchedKey key)
+void CServerSynchedStorage::SendDeltas(int channelId, SChannel &channel, CClientSynchedStorage::CSetDeltaMsg::EScope scope)
 {
-	SChannel * pChannel = GetChannel(channelId);
-	assert(pChannel);
-	if (!pChannel || !pChannel->pNetChannel || pChannel->local)
+	TEntityKeySet &dirty=channel.dirty[scope];
+	if (dirty.empty())
 		return;
 
-	SSendableHandle& msgHdl = m_globalQueue[SChannelQueueEnt(channelId, key)];
-
-	TSynchedValue value; 
-	bool ok=GetGlobalValue(key, value);
-	assert(ok);
-	if (!ok)
-		return;
+	// delta messages are unordered, chaining them keeps a resent older delta from overwriting a newer one of the same key
+	SSendableHandle &lastDeltaMessage=channel.lastDeltaMessage[scope];
 
-	CClientSynchedStorage::CSetGlobalMsg *pMsg=0;
+	CClientSynchedStorage::CSetDeltaMsg *pMsg=0;
 
-	switch (value.GetType())
+	for (TEntityKeySet::const_iterator it=dirty.begin(); it!=dirty.end(); ++it)
 	{
-	case eSVT_Bool:
-		pMsg=new CClientSynchedStorage::CSetGlobalBoolMsg(channelId, this, key, value);
-		break;
-	case eSVT_Float:
-		pMsg=new CClientSynchedStorage::CSetGlobalFloatMsg(channelId, this, key, value);
-		break;
-	case eSVT_Int:
-		pMsg=new CClientSynchedStorage::CSetGlobalIntMsg(channelId, this, key, value);
-		break;
-	case eSVT_EntityId:
-		pMsg=new CClientSynchedStorage::CSetGlobalEntityIdMsg(channelId, this, key, value);
-		break;
-	case eSVT_String:
-		pMsg=new CClientSynchedStorage::CSetGlobalStringMsg(channelId, this, key, value);
-		break;
+		TSynchedValue value; 
+		bool ok=false;
+		switch (scope)
+		{
+		case CClientSynchedStorage::CSetDeltaMsg::eS_Global:
+			ok=GetGlobalValue(it->second, value);
+			break;
+		case CClientSynchedStorage::CSetDeltaMsg::eS_Channel:
+			ok=GetChannelValue(channelId, it->second, value);
+			break;
+		case CClientSynchedStorage::CSetDeltaMsg::eS_Entity:
+			ok=GetEntityValue(it->first, it->second, value);
+			break;
+		}
+
+		assert(ok);
+		if (!ok)
+			continue;
+
+		switch (value.GetType())
+		{
+		case eSVT_Bool:
+		case eSVT_Float:
+		case eSVT_Int:
+		case eSVT_EntityId:
+		case eSVT_String:
+			break;
+		default:
+			assert(!"Invalid type!");
+			continue;
+		}
+
+		if (!pMsg)
+			pMsg=new CClientSynchedStorage::CSetDeltaMsg(scope, channelId, this);
+
+		pMsg->AddEntry(it->first, it->second, value);
+
+		if (pMsg->IsFull())
+		{
+			const SSendableHandle afterHandles[]={ channel.lastOrderedMessage, lastDeltaMessage };
+			channel.pNetChannel->AddSendable(pMsg, 2, afterHandles, &lastDeltaMessage);
+			pMsg=0;
+		}
 	}
 
 	if (pMsg)
-		pChannel->pNetChannel->SubstituteSendable(pMsg, 1, &pChannel->lastOrderedMessage, &msgHdl);
-	else
 	{
-		assert(!"Invalid type!");
+		const SSendableHandle afterHandles[]={ channel.lastOrderedMessage, lastDeltaMessage };
+		channel.pNetChannel->AddSendable(pMsg, 2, afterHandles, &lastDeltaMessage);
 	}
+
+	dirty.clear();
 }
 
 //------------------------------------------------------------------------
-void CServerSynchedStorage::AddToEntityQueueFor(int channelId, EntityId entityId, TSynchedKey key)
+struct SEntitySnapshotOrder
 {
+	bool operator()(const CClientSynchedStorage::CSetSnapshotMsg::SEntry &lhs, const CClientSynchedStorage::CSetSnapshotMsg::SEntry &rhs) const
+	{
+		return lhs.entityId<rhs.entityId || (lhs.entityId==rhs.entityId && lhs.key<rhs.key);
+	}
+};
+
+//------------------------------------------------------------------------
+void CServerSynchedStorage::FullSynch(int channelId, bool reset)
+{
+	if (reset)
+		ResetChannel(channelId);
+
 	SChannel * pChannel = GetChannel(channelId);
-	assert(pChannel);
 	if (!pChannel || !pChannel->pNetChannel || pChannel->local)
 		return;
 
-	SSendableHandle& msgHdl = m_entityQueue[SChannelEntityQueueEnt(channelId, entityId, key)];
+	CClientSynchedStorage::CSetSnapshotMsg::TEntries values;
+	CClientSynchedStorage::CSetSnapshotMsg::TEntries entities;
 
-	TSynchedValue value; 
-	bool ok=GetEntityValue(entityId, key, value);
-	assert(ok);
-	if (!ok)
-		return;
+	for (int i=0; i<m_values.GetCapacity(); ++i)
+	{
+		const CSynchedValueTable::SSlot &slot=m_values.GetSlot(i);
+		if (!slot.used)
+			continue;
 
-	CClientSynchedStorage::CSetEntityMsg *pMsg=0;
+		CClientSynchedStorage::CSetSnapshotMsg::SEntry entry;
+		entry.entityId=0;
+		entry.key=slot.key;
+		entry.value=slot.value;
 
-	switch (value.GetType())
-	{
-	case eSVT_Bool:
-		pMsg=new CClientSynchedStorage::CSetEntityBoolMsg(channelId, this, entityId, key, value);
-		break;
-	case eSVT_Float:
-		pMsg=new CClientSynchedStorage::CSetEntityFloatMsg(channelId, this, entityId, key, value);
-		break;
-	case eSVT_Int:
-		pMsg=new CClientSynchedStorage::CSetEntityIntMsg(channelId, this, entityId, key, value);
-		break;
-	case eSVT_EntityId:
-		pMsg=new CClientSynchedStorage::CSetEntityEntityIdMsg(channelId, this, entityId, key, value);
-		break;
-	case eSVT_String:
-		pMsg=new CClientSynchedStorage::CSetEntityStringMsg(channelId, this, entityId, key, value);
-		break;
-	}
+		switch (slot.value.GetType())
+		{
+		case eSVT_Bool:
+		case eSVT_Float:
+		case eSVT_Int:
+		case eSVT_EntityId:
+		case eSVT_String:
+			break;
+		default:
+			assert(!"Invalid type!");
+			continue;
+		}
 
-	if (pMsg)
-		pChannel->pNetChannel->SubstituteSendable(pMsg, 1, &pChannel->lastOrderedMessage, &msgHdl);
-	else
-	{
-		assert(!"Invalid type!");
+		switch (slot.scope)
+		{
+		case CSynchedValueTable::eS_Global:
+			values.push_back(entry);
+			break;
+		case CSynchedValueTable::eS_Channel:
+			if (slot.owner==(uint32)channelId)
+				values.push_back(entry);
+			break;
+		case CSynchedValueTable::eS_Entity:
+			entry.entityId=slot.owner;
+			entities.push_back(entry);
+			break;
+		}
 	}
+
+	std::sort(entities.begin(), entities.end(), SEntitySnapshotOrder());
+
+	SendSnapshot(channelId, *pChannel, values, false);
+	SendSnapshot(channelId, *pChannel, entities, true);
 }
 
 //------------------------------------------------------------------------
-void CServerSynchedStorage::FullSynch(int channelId, bool reset)
+void CServerSynchedStorage::SendSnapshot(int channelId, SChannel &channel, const CClientSynchedStorage::CSetSnapshotMsg::TEntries &entries, bool entities)
 {
-	if (reset)
-		ResetChannel(channelId);
+	typedef CClientSynchedStorage::CSetSnapshotMsg TSnapshotMsg;
 
-	for (TStorage::iterator it=m_channelStorage.begin(); it!=m_channelStorage.end();++it)
-		AddToChannelQueue(channelId, it->first);
+	// chunks are split by their serialized size so each one fits in a packet,
+	// a single entry bigger than that still gets a chunk of its own
+	const int count=entries.size();
+	for (int first=0; first<count; )
+	{
+		uint32 bits=TSnapshotMsg::k_headerBits;
+		int last=first;
+		for (; last<count; ++last)
+		{
+			const bool newEntity=entities && ((last==first) || (entries[last].entityId!=entries[last-1].entityId));
+			const uint32 entryBits=TSnapshotMsg::GetEntryBits(entries[last], entities, newEntity);
+			if (last>first && bits+entryBits>TSnapshotMsg::k_maxPayloadBits)
+				break;
+			bits+=entryBits;
+		}
 
-	for (TStorage::iterator it=m_globalStorage.begin(); it!=m_globalStorage.end();++it)
-		AddToGlobalQueueFor(channelId, it->first);
+		TSnapshotMsg *pMsg=new TSnapshotMsg(entities, channelId, this);
+		pMsg->entries.assign(entries.begin()+first, entries.begin()+last);
+		first=last;
 
-	for (TEntityStorageMap::const_iterator eit=m_entityStorage.begin(); eit!=m_entityStorage.end();++eit)
-	{
-		const TStorage &storage=eit->second;
-		for (TStorage::const_iterator it=storage.begin();it!=storage.end();++it)
-			AddToEntityQueueFor(channelId, eit->first, it->first);
+		// values are ordered so the deltas queued after them can't be overwritten by older snapshot values,
+		// entity values don't hold the channel up until everything is spawned, so they are chained with the
+		// entity deltas instead
+		if (entities)
+		{
+			SSendableHandle &lastEntityMessage=channel.lastDeltaMessage[CClientSynchedStorage::CSetDeltaMsg::eS_Entity];
+			const SSendableHandle afterHandles[]={ channel.lastOrderedMessage, lastEntityMessage };
+			channel.pNetChannel->AddSendable(pMsg, 2, afterHandles, &lastEntityMessage);
+		}
+		else
+			channel.pNetChannel->AddSendable(pMsg, 1, &channel.lastOrderedMessage, &channel.lastOrderedMessage);
 	}
 }
 
@@ -308,51 +351,6 @@ void CServerSynchedStorage::OnClientEnteredGame(int channelId)
 		FullSynch(channelId, true);
 }
 
-//------------------------------------------------------------------------
-bool CServerSynchedStorage::OnSetGlobalMsgComplete(CClientSynchedStorage::CSetGlobalMsg *pMsg, int channelId, uint32 fromSeq, bool ack)
-{
-	CryAutoCriticalSection lock(m_mutex);
-
-	if (ack)
-		return true;
-	else
-	{
-		// got a nack, so reque
-		AddToGlobalQueueFor(channelId, pMsg->key);
-		return true;
-	}
-}
-
-//------------------------------------------------------------------------
-bool CServerSynchedStorage::OnSetChannelMsgComplete(CClientSynchedStorage::CSetChannelMsg *pMsg, int channelId, uint32 fromSeq, bool ack)
-{
-	CryAutoCriticalSection lock(m_mutex);
-
-	if (ack)
-		return true;
-	else
-	{
-		// got a nack, so reque
-		AddToChannelQueue(channelId, pMsg->key);
-		return true;
-	}
-}
-
-//------------------------------------------------------------------------
-bool CServerSynchedStorage::OnSetEntityMsgComplete(CClientSynchedStorage::CSetEntityMsg *pMsg, int channelId, uint32 fromSeq, bool ack)
-{
-	CryAutoCriticalSection lock(m_mutex);
-
-	if (ack)
-		return true;
-	else
-	{
-		// got a nack, so reque
-		AddToEntityQueueFor(channelId, pMsg->entityId, pMsg->key);
-		return true;
-	}
-}
-
 //------------------------------------------------------------------------
 CServerSynchedStorage::SChannel *CServerSynchedStorage::GetChannel(int channelId)
 {
@@ -384,9 +382,11 @@ void CServerSynchedStorage::GetMemoryUsage(ICrySizer * s) const
 {
 	SIZER_SUBCOMPONENT_NAME(s,"ServerSychedStorage");
 	s->Add(*this);
-	s->AddContainer(m_globalQueue);
-	s->AddContainer(m_entityQueue);
-	s->AddContainer(m_channelQueue);
 	s->AddContainer(m_channels);
+	for (TChannelMap::const_iterator it=m_channels.begin(); it!=m_channels.end(); ++it)
+	{
+		for (int i=0; i<CClientSynchedStorage::CSetDeltaMsg::eS_Count; ++i)
+			s->AddContainer(it->second.dirty[i]);
+	}
 	GetStorageMemoryStatistics(s);
 }
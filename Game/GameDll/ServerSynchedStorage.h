@@ -23,6 +23,7 @@ History:
 #include "ClientSynchedStorage.h"
 
 #include <deque>
+#include <VectorSet.h>
 
 
 class CServerSynchedStorage:
@@ -41,9 +42,8 @@ public:
 	virtual void Reset();
 	virtual void ResetChannel(int channelId);
 
-	virtual bool OnSetGlobalMsgComplete(CClientSynchedStorage::CSetGlobalMsg *pMsg, int channelId, uint32 fromSeq, bool ack);
-	virtual bool OnSetChannelMsgComplete(CClientSynchedStorage::CSetChannelMsg *pMsg, int channelId, uint32 fromSeq, bool ack);
-	virtual bool OnSetEntityMsgComplete(CClientSynchedStorage::CSetEntityMsg *pMsg, int channelId, uint32 fromSeq, bool ack);
+	// sends the values changed since the last call, one message per scope and channel
+	virtual void Update();
 
 	// these should only be called from the main thread
 	virtual void AddToGlobalQueue(TSynchedKey key);
@@ -63,6 +63,9 @@ public:
 	virtual void OnChannelChanged(int channelId, TSynchedKey key, const TSynchedValue &value);
 	virtual void OnEntityChanged(EntityId entityId, TSynchedKey key, const TSynchedValue &value);
 
+	typedef std::pair<EntityId, TSynchedKey>	TEntityKey;			// entity is 0 for global and channel values
+	typedef VectorSet<TEntityKey>							TEntityKeySet;
+
 	struct SChannel
 	{
 		SChannel()
@@ -71,6 +74,8 @@ public:
 		: local(isLocal), pNetChannel(_pNetChannel), onhold(false) {};
 		INetChannel *pNetChannel;
 		SSendableHandle     lastOrderedMessage;
+		SSendableHandle			lastDeltaMessage[CClientSynchedStorage::CSetDeltaMsg::eS_Count];	// deltas of a scope are chained, entity snapshots chain with the entity deltas
+		TEntityKeySet				dirty[CClientSynchedStorage::CSetDeltaMsg::eS_Count];
 		bool				local:1;
 		bool				onhold:1;
 	};
@@ -80,53 +85,12 @@ public:
 	int GetChannelId(INetChannel *pNetChannel) const;
 
 protected:
-	struct SChannelQueueEnt
-	{
-		SChannelQueueEnt() {}
-		SChannelQueueEnt(int c, TSynchedKey k) : channel(c), key(k) {}
-		int channel;
-		TSynchedKey key;
-
-		bool operator<( const SChannelQueueEnt& rhs ) const
-		{
-			return rhs.channel < channel || (rhs.channel == channel && rhs.key < key);
-		}
-	};
+	void MarkDirty(int channelId, CClientSynchedStorage::CSetDeltaMsg::EScope scope, EntityId entityId, TSynchedKey key);
+	void SendDeltas(int channelId, SChannel &channel, CClientSynchedStorage::CSetDeltaMsg::EScope scope);
+	void SendSnapshot(int channelId, SChannel &channel, const CClientSynchedStorage::CSetSnapshotMsg::TEntries &entries, bool entities);
 
-	struct SChannelEntityQueueEnt
-	{
-		SChannelEntityQueueEnt() {}
-		SChannelEntityQueueEnt(int c, EntityId e, TSynchedKey k) : channel(c), entity(e), key(k) {}
-		int channel;
-		EntityId entity;
-		TSynchedKey key;
-
-		bool operator<( const SChannelEntityQueueEnt& rhs ) const
-		{
-			if (channel < rhs.channel)
-				return true;
-			else if (channel > rhs.channel)
-				return false;
-			else if (key < rhs.key)
-				return true;
-			else if (key > rhs.key)
-				return false;
-			else if (entity < rhs.entity)
-				return true;
-			else if (entity > rhs.entity)
-				return false;
-			return false;
-		}
-	};
-
-	typedef std::map<SChannelQueueEnt, SSendableHandle>								TChannelQueueMap;
-	typedef std::map<SChannelEntityQueueEnt, SSendableHandle>					TChannelEntityQueueMap;
 	typedef std::map<int, SChannel>																		TChannelMap;
 
-	TChannelQueueMap				m_globalQueue;
-	TChannelEntityQueueMap	m_entityQueue;
-	TChannelQueueMap				m_channelQueue;
-
 	TChannelMap							m_channels;
 
 	CryCriticalSection      m_mutex;
@@ -257,10 +257,19 @@ void CShark::ResetValues()
 
 	m_animationSpeedAttack = m_animationSpeed = 1;
 
+	CancelProbes();
+}
+
+void CShark::CancelProbes()
+{
+	for(int i=0; i<eSP_Last; i++)
+		m_probes[i].Cancel();
 }
 
 CShark::~CShark()
 {
+	if (g_pGame)
+		g_pGame->GetAmbientCreatureScheduler().Unregister(this);
 
 	ICharacterInstance *pCharacter = GetEntity()->GetCharacter(0);
 	if(pCharacter)
@@ -310,6 +319,8 @@ bool CShark::Init( IGameObject * pGameObject )
 
 	Revive();
 
+	g_pGame->GetAmbientCreatureScheduler().Register(this, &m_ambientUpdate);
+
 	return true;
 }
 
@@ -364,7 +375,12 @@ void CShark::PrePhysicsUpdate()
 
 	if (!m_stats.isRagDoll && GetHealth()>0)
 	{	
-		UpdateStats(frameTime);
+		// between two ticks of the ambient creature scheduler the movement of the last tick is replayed
+		const bool tick = m_ambientUpdate.tick;
+		const float tickTime = m_ambientUpdate.GetTickTime(frameTime);
+
+		if (tick)
+			UpdateStats(tickTime);
 
 		if (m_pMovementController)
 		{
@@ -376,8 +392,8 @@ void CShark::PrePhysicsUpdate()
 		assert(m_moveRequest.velocity.IsValid());
 
 		//rotation processing
-		if (m_linkStats.CanRotate())
-			ProcessRotation(frameTime);
+		if (tick && m_linkStats.CanRotate())
+			ProcessRotation(tickTime);
 
 		assert(m_moveRequest.rotation.IsValid());
 		assert(m_moveRequest.velocity.IsValid());
@@ -385,7 +401,13 @@ void CShark::PrePhysicsUpdate()
 		//movement processing
 		if (m_linkStats.CanMove())
 		{
-			ProcessMovement(frameTime);
+			if (tick)
+			{
+				ProcessMovement(tickTime);
+				m_ambientUpdate.SetTickMovement(pEnt->GetRotation(), m_moveRequest);
+			}
+
+			m_ambientUpdate.GetFrameMovement(pEnt->GetRotation(), frameTime, m_moveRequest);
 
 			assert(m_moveRequest.rotation.IsValid());
 			assert(m_moveRequest.velocity.IsValid());
@@ -418,11 +440,14 @@ void CShark::Update(SEntityUpdateContext& ctx, int updateSlot)
 	if(frameTime == 0.f)
 		frameTime = 0.01f;
 
-	if(m_targetId)
+	// only an engaging shark is kept at full rate, reaching and escaping follow the distance to the view
+	m_ambientUpdate.threat = m_targetId && (m_state == S_Circling || m_state == S_FinalAttackAlign || m_state == S_FinalAttack || m_state == S_Attack);
+
+	if(m_targetId && m_ambientUpdate.tick)
 	{
 		IEntity* pTarget = gEnv->pEntitySystem->GetEntity(m_targetId);
 		if(pTarget)
-			UpdateStatus(frameTime,pTarget);
+			UpdateStatus(m_ambientUpdate.GetTickTime(frameTime),pTarget);
 	}
 
 	IEntity* pEnt = GetEntity();
@@ -622,7 +647,32 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 			int escapePointSize = m_EscapePoints.size();
 			const int numTriesRadialDirections = 8;
 
-			for(int i=0;i<2;i++)
+			// one direction is tried per ray, the result comes back on a later update
+			CAmbientCreatureProbe& probe = m_probes[eSP_Spawn];
+			SAmbientProbeResult result;
+			if (probe.ConsumeResult(result))
+			{
+				if (result.hit)
+				{
+					Vec3 hitDir(result.pt - result.origin);
+					if(hitDir.GetLengthSquared() > m_chosenEscapeDir.GetLengthSquared())
+					{
+						m_chosenEscapeDir = hitDir;
+						m_startPos = result.origin + hitDir*(result.dist - 4)/result.dist;
+					}
+				}
+				else
+				{
+					m_startPos = result.origin + result.dir;
+					SetStartPos(targetPos);
+					SetReaching(targetPos);
+					break;
+				}
+
+				m_tryCount++;
+			}
+
+			if (!probe.IsPending())
 			{
 				if(m_tryCount >= numTriesRadialDirections + escapePointSize)
 				{
@@ -636,10 +686,9 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 					SetReaching(targetPos);
 					break;
 				}
-				Vec3 currentStartPos;
 				if(m_tryCount < escapePointSize)
 				{
-					currentStartPos = m_EscapePoints[m_tryCount];
+					Vec3 currentStartPos(m_EscapePoints[m_tryCount]);
 					if(m_tryCount < escapePointSize -1 && currentStartPos.x==m_lastSpawnPoint.x && currentStartPos.y==m_lastSpawnPoint.y)
 					{
 						//low priority to last used spawn point - swap it with the last
@@ -654,31 +703,11 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 					if(m_tryCount == escapePointSize)
 						m_escapeDir = Vec3(70,0,0);
 					m_escapeDir = m_escapeDir.GetRotated(ZERO,Vec3Constants<float>::fVec3_OneZ,2 * gf_PI / float(numTriesRadialDirections));
-					currentStartPos = targetPos + m_escapeDir;
 				}
 				//find escape direction
 				static const int objTypes = ent_terrain|ent_static|ent_sleeping_rigid;  // |ent_rigid;
 				static const unsigned int flags = rwi_stop_at_pierceable|rwi_colltype_any;
-				ray_hit ray;
-				Vec3 startPos(myPos+Vec3(0,0,1));
-				if (gEnv->pPhysicalWorld->RayWorldIntersection(targetPos, m_escapeDir, objTypes, flags, &ray, 1))
-				{
-					Vec3 hitDir(ray.pt - targetPos);
-					if(hitDir.GetLengthSquared() > m_chosenEscapeDir.GetLengthSquared())
-					{
-						m_chosenEscapeDir = hitDir;
-						m_startPos = targetPos + hitDir*(ray.dist - 4)/ray.dist;
-					}
-				}
-				else
-				{
-					m_startPos = currentStartPos;
-					SetStartPos(targetPos);
-					SetReaching(targetPos);
-					break;
-				}
-
-				m_tryCount++;
+				probe.Queue(targetPos, m_escapeDir, objTypes, flags);
 			}
 			maxHeight = waterLevel - 1;
 			
@@ -693,21 +722,19 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 			bool force = false;
 			const int objTypes = ent_terrain|ent_static|ent_sleeping_rigid;//|ent_rigid;    
 			const unsigned int flags = rwi_stop_at_pierceable|rwi_colltype_any;
-			ray_hit ray;
 	
 			if(distTarget > m_params.minDistanceCircle * 3)
 			{	
-				// enough far, move directly towards target
-				if (!gEnv->pPhysicalWorld->RayWorldIntersection(myPos, targetDir*(distTarget - 3)/distTarget, objTypes, flags, &ray, 1))
+				// enough far, move directly towards target once the last ray found the way clear
+				CAmbientCreatureProbe& probe = m_probes[eSP_Path];
+				SAmbientProbeResult result;
+				if (probe.ConsumeResult(result) && !result.hit)
 				{
-					// skip drivable boats in collision check
-//					if(ray.pCollider)
-//					{
-//						IEntity* pColliderEntity = (IEntity*)ray.pCollider->GetForeignData(PHYS_FOREIGN_ID_ENTITY);
-//						if(!pColliderEntity || !pColliderEntity->GetAI() || pColliderEntity->GetAI()->GetAIType()!=AIOBJECT_VEHICLE)
-//					}
 					SetMoveTarget(moveTarget, force, m_params.minDistForUpdatingMoveTarget);
 				} // else keep previous moveTarget
+
+				if (!probe.IsPending())
+					probe.Queue(myPos, targetDir*(distTarget - 3)/distTarget, objTypes, flags);
 				break; 
 			}
 			else
@@ -731,17 +758,22 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 					dir = -dir;
 				}
 				const float thr = 1.2f;
-				if (gEnv->pPhysicalWorld->RayWorldIntersection(targetPos, dir* thr, objTypes, flags, &ray, 1))
+				CAmbientCreatureProbe& probe = m_probes[eSP_Side];
+				SAmbientProbeResult result;
+				if (probe.ConsumeResult(result) && result.hit)
 				{
-					Vec3 diff(ray.pt - targetPos);
-					float newRadius = ray.dist/thr - 2;
+					Vec3 diff(result.pt - result.origin);
+					float newRadius = result.dist/thr - 2;
 					if(m_circleRadius > newRadius)
 					{
 						m_circleRadius = newRadius;
 						force = true;
-						moveTarget = targetPos + diff*newRadius/ray.dist ;
+						moveTarget = targetPos + diff*newRadius/result.dist ;
 					}
 				}
+
+				if (!probe.IsPending())
+					probe.Queue(targetPos, dir* thr, objTypes, flags);
 			}
 			SetMoveTarget(moveTarget, force, m_params.minDistForUpdatingMoveTarget);
 
@@ -785,6 +817,25 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 				Vec3 moveTargetDir(m_moveTarget - myPos);
 				float moveDistTarget = moveTargetDir.GetLength();
 				bool force = false;
+				const float thr = 1.3f;
+
+				// shrink the circle where the rays queued on the last turn hit something
+				for(int i=eSP_Circle; i<eSP_Last; i++)
+				{
+					SAmbientProbeResult result;
+					if (m_probes[i].ConsumeResult(result) && result.hit)
+					{
+						float newRadius = result.dist/thr - 2;
+						if(m_circleRadius > newRadius)
+						{
+							m_circleRadius = newRadius;
+							force = true;
+						}
+					}
+				}
+				if(force && !m_circleDisplacement.IsZero())
+					m_circleDisplacement *= m_circleRadius/m_circleDisplacement.GetLength();
+
 				//Vec3 pos(targetPos + m_circleDisplacement);
 				if(!bTargetOnVehicle && m_remainingCirclingTime<=0 && targetDirN.Dot(pTarget->GetRotation().GetColumn1()) < -0.7f)
 				{
@@ -805,10 +856,8 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 					{
 						static const int objTypes = ent_terrain|ent_static|ent_sleeping_rigid|ent_rigid;    
 						static const unsigned int flags = rwi_stop_at_pierceable|rwi_colltype_any;
-						const float thr = 1.3f;
-						ray_hit ray;
 
-						// anticipate collision with current+next+next point
+						// anticipate collision with current+next+next point, the circle shrinks when the rays come back
 						Vec3 nextCircleDisplacement(m_circleDisplacement);
 
 						for(int i=0; i<3; i++)
@@ -816,16 +865,7 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 							if(i>0)
 								nextCircleDisplacement = nextCircleDisplacement.GetRotated(ZERO,Vec3Constants<float>::fVec3_OneZ,angle);
 							
-							if (gEnv->pPhysicalWorld->RayWorldIntersection(targetPos, nextCircleDisplacement* thr, objTypes, flags, &ray, 1))
-							{
-								Vec3 dir(ray.pt - targetPos);
-								float newRadius = ray.dist/thr - 2;
-								if(m_circleRadius > newRadius)
-								{
-									m_circleRadius = newRadius;
-									force = true;
-								}
-							}
+							m_probes[eSP_Circle + i].Queue(targetPos, nextCircleDisplacement* thr, objTypes, flags);
 						}
 						m_circleDisplacement *= m_circleRadius/m_circleDisplacement.GetLength() ;
 					}
@@ -887,9 +927,31 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 			{
 				int escapePointSize = m_EscapePoints.size();
 				const int numTriesRadialDirections = 8;
-				for(int i=0;i<2;i++)
+
+				// one direction is tried per ray, the result comes back on a later update
+				CAmbientCreatureProbe& probe = m_probes[eSP_Escape];
+				SAmbientProbeResult result;
+				if (probe.ConsumeResult(result))
+				{
+					if (result.hit)
+					{
+						Vec3 hitDir(result.pt - result.origin);
+						if(hitDir.GetLengthSquared() > m_chosenEscapeDir.GetLengthSquared())
+							m_chosenEscapeDir = hitDir;
+					}
+					else
+					{
+						m_chosenEscapeDir = result.dir;
+						m_moveTarget = myPos + m_chosenEscapeDir;
+						m_state = S_Escaping;
+						break;
+					}
+
+					m_tryCount++;
+				}
+
+				if (!probe.IsPending())
 				{
-					
 					if(m_tryCount >= numTriesRadialDirections + escapePointSize)
 					{
 						m_moveTarget = myPos + m_chosenEscapeDir;
@@ -907,23 +969,7 @@ void CShark::UpdateStatus(float frameTime, const IEntity* pTarget)
 					//find escape direction
 					static const int objTypes = ent_terrain|ent_static|ent_sleeping_rigid|ent_rigid;    
 					static const unsigned int flags = rwi_stop_at_pierceable|rwi_colltype_any;
-					ray_hit ray;
-					Vec3 startPos(myPos+Vec3(0,0,1));
-					if (gEnv->pPhysicalWorld->RayWorldIntersection(startPos, m_escapeDir, objTypes, flags, &ray, 1))
-					{
-						Vec3 hitDir(ray.pt - startPos);
-						if(hitDir.GetLengthSquared() > m_chosenEscapeDir.GetLengthSquared())
-							m_chosenEscapeDir = hitDir;
-					}
-					else
-					{
-						m_chosenEscapeDir = m_escapeDir;
-						m_moveTarget = myPos + m_chosenEscapeDir;
-						m_state = S_Escaping;
-						break;
-					}
-
-					m_tryCount++;
+					probe.Queue(myPos+Vec3(0,0,1), m_escapeDir, objTypes, flags);
 				}
 			}
 			break;
@@ -1102,6 +1148,7 @@ void CShark::GoAway()
 	m_state = S_PrepareEscape;
 	//m_escapeDir = Vec3(500,0,0);
 	m_tryCount =0;
+	CancelProbes();
 	m_chosenEscapeDir.zero();
 }
 
@@ -1744,9 +1791,9 @@ void CShark::SetStats(SmartScriptTable &rTable)
 }
 
 //fill the status table for the scripts
-void CShark::UpdateScriptStats(SmartScriptTable &rTable)
+void CShark::UpdateScriptStats(CActorScriptStats &stats)
 {
-	CActor::UpdateScriptStats(rTable);
+	CActor::UpdateScriptStats(stats);
 }
 
 void CShark::SetParams(SmartScriptTable &rTable,bool resetFirst)
@@ -1765,6 +1812,7 @@ void CShark::SetParams(SmartScriptTable &rTable,bool resetFirst)
 		m_startPos.zero();
 		m_state = S_Spawning;
 		m_chosenEscapeDir.zero();
+		CancelProbes();
 		FindEscapePoints();
 		rTable->GetValue("spawned",m_params.bSpawned);
 		return;
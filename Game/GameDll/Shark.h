@@ -19,6 +19,7 @@ History:
 #endif
 
 #include "Actor.h"
+#include "AmbientCreatureScheduler.h"
 
 
 //this might change
@@ -250,7 +251,7 @@ public:
 	virtual const SActorStats *GetActorStats() const { return &m_stats; };
 	virtual SActorParams *GetActorParams() { return &m_params; };
 	virtual void SetStats(SmartScriptTable &rTable);
-	virtual void UpdateScriptStats(SmartScriptTable &rTable);
+	virtual void UpdateScriptStats(CActorScriptStats &stats);
 	//set actor params
 	virtual void SetParams(SmartScriptTable &rTable,bool resetFirst);
 	virtual void PostPhysicalize();
@@ -341,9 +342,21 @@ protected:
 	void SetReaching(const Vec3& targetPos);
 	float GetDistHeadTarget(const Vec3& targetPos, const Vec3& targetDirN,float& dotMouth);
 	void ResetValues();
+	void CancelProbes();
 
 	typedef std::vector<Vec3> TPointList;
 
+	// environment rays, their results are used on the update after they come back
+	enum ESharkProbe
+	{
+		eSP_Spawn = 0,
+		eSP_Escape,
+		eSP_Path,
+		eSP_Side,
+		eSP_Circle,		// current and next two circling points
+		eSP_Last = eSP_Circle + 3
+	};
+
 	Quat		m_modelQuat;//the model rotation
 	Quat		m_modelAddQuat;
 	Vec3		m_modelOffset;
@@ -413,6 +426,9 @@ protected:
 	IAnimationGraph::InputID m_inputSpeed;
 	IAnimationGraph::InputID m_idSignalInput;
 
+	SAmbientCreatureUpdate m_ambientUpdate;
+	CAmbientCreatureProbe m_probes[eSP_Last];
+
 };
 
 
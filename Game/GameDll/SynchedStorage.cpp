@@ -15,15 +15,122 @@ History:
 #include <IEntitySystem.h>
 
 
+//------------------------------------------------------------------------
+uint32 CSynchedValueTable::Hash(uint8 scope, uint32 owner, TSynchedKey key)
+{
+	uint32 hash=owner*0x9e3779b1;
+	hash^=((uint32(key)<<8)|scope)*0x85ebca6b;
+	hash^=hash>>15;
+
+	return hash;
+}
+
+//------------------------------------------------------------------------
+int CSynchedValueTable::FindSlot(uint8 scope, uint32 owner, TSynchedKey key) const
+{
+	const uint32 mask=m_slots.size()-1;
+
+	uint32 index=Hash(scope, owner, key)&mask;
+	while (m_slots[index].used)
+	{
+		const SSlot &slot=m_slots[index];
+		if ((slot.key==key) && (slot.owner==owner) && (slot.scope==scope))
+			break;
+
+		index=(index+1)&mask;
+	}
+
+	return index;
+}
+
+//------------------------------------------------------------------------
+const TSynchedValue *CSynchedValueTable::Find(EScope scope, uint32 owner, TSynchedKey key) const
+{
+	if (m_slots.empty())
+		return 0;
+
+	const SSlot &slot=m_slots[FindSlot(scope, owner, key)];
+
+	return slot.used?&slot.value:0;
+}
+
+//------------------------------------------------------------------------
+TSynchedValue &CSynchedValueTable::Insert(EScope scope, uint32 owner, TSynchedKey key, bool &inserted)
+{
+	// keep the load under 3/4 so probe sequences stay short
+	if ((m_count+1)*4 > GetCapacity()*3)
+		Grow();
+
+	SSlot &slot=m_slots[FindSlot(scope, owner, key)];
+	inserted=!slot.used;
+	if (inserted)
+	{
+		slot.owner=owner;
+		slot.key=key;
+		slot.scope=scope;
+		slot.used=true;
+		++m_count;
+	}
+
+	return slot.value;
+}
+
+//------------------------------------------------------------------------
+void CSynchedValueTable::Grow()
+{
+	std::vector<SSlot> slots(max(64, GetCapacity()*2));
+	slots.swap(m_slots);
+
+	for (std::vector<SSlot>::const_iterator it=slots.begin(); it!=slots.end(); ++it)
+	{
+		if (it->used)
+			m_slots[FindSlot(it->scope, it->owner, it->key)]=*it;
+	}
+}
+
+//------------------------------------------------------------------------
+void CSynchedValueTable::Clear()
+{
+	for (std::vector<SSlot>::iterator it=m_slots.begin(); it!=m_slots.end(); ++it)
+		*it=SSlot();
+
+	m_count=0;
+}
+
+//------------------------------------------------------------------------
+void CSynchedValueTable::GetMemoryUsage(ICrySizer *s) const
+{
+	s->AddContainer(m_slots);
+	for (std::vector<SSlot>::const_iterator it=m_slots.begin(); it!=m_slots.end(); ++it)
+	{
+		if (it->used && (it->value.GetType()==eSVT_String))
+			s->Add(*it->value.GetPtr<string>());
+	}
+}
+
 //------------------------------------------------------------------------
 void CSynchedStorage::Reset()
 {
-	m_globalStorage.clear();
-	m_entityStorage.clear();
-	m_channelStorageMap.clear();
-	m_channelStorage.clear();
+	m_values.Clear();
 }
 
+//------------------------------------------------------------------------
+struct SSlotOrder
+{
+	SSlotOrder(const CSynchedValueTable &_values): values(_values) {};
+	bool operator()(int lhs, int rhs) const
+	{
+		const CSynchedValueTable::SSlot &l=values.GetSlot(lhs);
+		const CSynchedValueTable::SSlot &r=values.GetSlot(rhs);
+		if (l.scope!=r.scope)
+			return l.scope<r.scope;
+		if (l.owner!=r.owner)
+			return l.owner<r.owner;
+		return l.key<r.key;
+	}
+	const CSynchedValueTable &values;
+};
+
 //------------------------------------------------------------------------
 void CSynchedStorage::Dump()
 {
@@ -55,38 +162,56 @@ void CSynchedStorage::Dump()
 		}
 	};
 
+	std::vector<int> order;
+	order.reserve(m_values.GetCount());
+	for (int i=0; i<m_values.GetCapacity(); ++i)
+	{
+		if (m_values.GetSlot(i).used)
+			order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), SSlotOrder(m_values));
+
 	CryLogAlways("---------------------------");
 	CryLogAlways(" SYNCHED STORAGE DUMP");
 	CryLogAlways("---------------------------\n");
-	CryLogAlways("Globals:");
-
-	for (TStorage::const_iterator it=m_globalStorage.begin(); it!=m_globalStorage.end(); ++it)
-		ValueDumper(it->first, it->second);
-
-	CryLogAlways("---------------------------\n");
-	CryLogAlways("Local Channel:");
-	for (TStorage::const_iterator it=m_channelStorage.begin(); it!=m_channelStorage.end(); ++it)
-		ValueDumper(it->first, it->second);
 
-	if (gEnv->bServer)
+	int lastScope=-1;
+	uint32 lastOwner=0;
+	for (std::vector<int>::const_iterator it=order.begin(); it!=order.end(); ++it)
 	{
-		CryLogAlways("---------------------------\n");
-		for (TChannelStorageMap::const_iterator cit=m_channelStorageMap.begin(); cit!=m_channelStorageMap.end(); ++cit)
+		const CSynchedValueTable::SSlot &slot=m_values.GetSlot(*it);
+		if ((slot.scope!=lastScope) || (slot.owner!=lastOwner))
 		{
-			INetChannel *pNetChannel=m_pGameFramework->GetNetChannel(cit->first);
-			CryLogAlways("Channel %d (%s)", cit->first, pNetChannel?pNetChannel->GetName():"null");
-			for (TStorage::const_iterator it=cit->second.begin(); it!=cit->second.end(); ++it)
-				ValueDumper(it->first, it->second);
+			if (lastScope!=-1)
+				CryLogAlways("---------------------------\n");
+
+			switch (slot.scope)
+			{
+			case CSynchedValueTable::eS_Global:
+				CryLogAlways("Globals:");
+				break;
+			case CSynchedValueTable::eS_LocalChannel:
+				CryLogAlways("Local Channel:");
+				break;
+			case CSynchedValueTable::eS_Channel:
+				{
+					INetChannel *pNetChannel=m_pGameFramework->GetNetChannel(slot.owner);
+					CryLogAlways("Channel %d (%s)", slot.owner, pNetChannel?pNetChannel->GetName():"null");
+				}
+				break;
+			case CSynchedValueTable::eS_Entity:
+				{
+					IEntity *pEntity=gEnv->pEntitySystem->GetEntity(slot.owner);
+					CryLogAlways("Entity %.08d(%s)", slot.owner, pEntity?pEntity->GetName():"null");
+				}
+				break;
+			}
+
+			lastScope=slot.scope;
+			lastOwner=slot.owner;
 		}
-	}
 
-	CryLogAlways("---------------------------\n");
-	for (TEntityStorageMap::const_iterator eit=m_entityStorage.begin(); eit!=m_entityStorage.end(); ++eit)
-	{
-		IEntity *pEntity=gEnv->pEntitySystem->GetEntity(eit->first);
-		CryLogAlways("Entity %.08d(%s)", eit->first, pEntity?pEntity->GetName():"null");
-		for (TStorage::const_iterator it=eit->second.begin(); it!=eit->second.end(); ++it)
-			ValueDumper(it->first, it->second);
+		ValueDumper(slot.key, slot.value);
 	}
 }
 
@@ -136,6 +261,7 @@ void CSynchedStorage::SerializeValue(TSerialize ser, TSynchedKey &key, TSynchedV
 			if (ser.IsReading())
 				SetGlobalValue(key, e);
 		}
+		break;
 	case eSVT_String:
 		{
 			static string s;
@@ -199,6 +325,7 @@ void CSynchedStorage::SerializeEntityValue(TSerialize ser, EntityId id, TSynched
 			if (ser.IsReading())
 				SetEntityValue(id, key, e);
 		}
+		break;
 	case eSVT_String:
 		{
 			static string s;
@@ -217,61 +344,28 @@ void CSynchedStorage::SerializeEntityValue(TSerialize ser, EntityId id, TSynched
 }
 
 //------------------------------------------------------------------------
-CSynchedStorage::TStorage *CSynchedStorage::GetEntityStorage(EntityId id, bool create)
+bool CSynchedStorage::GetChannelOwner(int channelId, CSynchedValueTable::EScope &scope, uint32 &owner) const
 {
-	TEntityStorageMap::iterator it=m_entityStorage.find(id);
-	if (it!=m_entityStorage.end())
-		return &it->second;
-	else if (create)
+	INetChannel *pNetChannel=m_pGameFramework->GetNetChannel(channelId);
+	if ((!gEnv->bServer && !pNetChannel) || (gEnv->bServer && pNetChannel && pNetChannel->IsLocal()))
 	{
-		std::pair<TEntityStorageMap::iterator, bool> result=m_entityStorage.insert(
-			TEntityStorageMap::value_type(id, TStorage()));
-		return &result.first->second;
+		scope=CSynchedValueTable::eS_LocalChannel;
+		owner=0;
+		return true;
 	}
 
-	return 0;
-}
-
-//------------------------------------------------------------------------
-CSynchedStorage::TStorage *CSynchedStorage::GetChannelStorage(int channelId, bool create)
-{
-	TChannelStorageMap::iterator it=m_channelStorageMap.find(channelId);
-	if (it!=m_channelStorageMap.end())
-		return &it->second;
-	else
+	if (gEnv->bServer)
 	{
-		INetChannel *pNetChannel=m_pGameFramework->GetNetChannel(channelId);
-		if ((!gEnv->bServer && !pNetChannel) || (gEnv->bServer && pNetChannel->IsLocal()))
-			return &m_channelStorage;
-
-		if (gEnv->bServer && create)
-		{
-			std::pair<TChannelStorageMap::iterator, bool> result=m_channelStorageMap.insert(
-				TEntityStorageMap::value_type(channelId, TStorage()));
-			return &result.first->second;
-		}
+		scope=CSynchedValueTable::eS_Channel;
+		owner=channelId;
+		return true;
 	}
 
-	return 0;
-}
-
-
-static void AddStorageTo( const CSynchedStorage::TStorage& stor, ICrySizer * s )
-{
-	for (CSynchedStorage::TStorage::const_iterator iter = stor.begin(); iter != stor.end(); ++iter)
-	{
-		s->Add(iter->first);
-		int nSize = iter->second.GetMemorySize();
-		s->AddObject( ((const char*)(iter->first)+1),nSize );
-	}
+	return false;
 }
 
+//------------------------------------------------------------------------
 void CSynchedStorage::GetStorageMemoryStatistics(ICrySizer * s) const
 {
-	AddStorageTo(m_globalStorage, s);
-	for (TEntityStorageMap::const_iterator iter = m_entityStorage.begin(); iter != m_entityStorage.end(); ++iter)
-	{
-		s->Add(*iter);
-		AddStorageTo(iter->second, s);
-	}
+	m_values.GetMemoryUsage(s);
 }
@@ -50,45 +50,75 @@ typedef uint16																											TSynchedKey;
 typedef	CConfigurableVariant<TSynchedValueTypes, sizeof(void *)>		TSynchedValue;
 
 
+//------------------------------------------------------------------------
+// Open addressed table holding the values of every scope, keyed by scope, owner (channel or entity id) and key
+class CSynchedValueTable
+{
+public:
+	enum EScope
+	{
+		eS_Global = 0,
+		eS_LocalChannel,				// the local channel on the server, the own channel on clients
+		eS_Channel,
+		eS_Entity,
+	};
+
+	struct SSlot
+	{
+		SSlot(): owner(0), key(0), scope(0), used(false) {};
+
+		uint32					owner;
+		TSynchedKey			key;
+		uint8						scope;
+		bool						used;
+		TSynchedValue		value;
+	};
+
+	CSynchedValueTable(): m_count(0) {};
+
+	const TSynchedValue *Find(EScope scope, uint32 owner, TSynchedKey key) const;
+	TSynchedValue &Insert(EScope scope, uint32 owner, TSynchedKey key, bool &inserted);
+	void Clear();
+
+	ILINE int GetCount() const { return m_count; }
+	ILINE int GetCapacity() const { return (int)m_slots.size(); }
+	ILINE const SSlot &GetSlot(int index) const { return m_slots[index]; }
+
+	void GetMemoryUsage(ICrySizer *s) const;
+
+private:
+	static uint32 Hash(uint8 scope, uint32 owner, TSynchedKey key);
+
+	// slot holding the key, or the free slot its probe sequence ends at
+	int FindSlot(uint8 scope, uint32 owner, TSynchedKey key) const;
+	void Grow();
+
+	std::vector<SSlot>	m_slots;		// power of two sized, linear probing
+	int									m_count;
+};
+
+
 class CSynchedStorage : public INetMessageSink
 {
 public:
 	CSynchedStorage(): m_pGameFramework(0) {};
 	virtual ~CSynchedStorage() {};
 
-	typedef std::map<TSynchedKey, TSynchedValue>																							TStorage;
-	typedef std::map<EntityId, TStorage>																											TEntityStorageMap;
-	typedef std::map<int, TStorage>																														TChannelStorageMap;
-
 public:
 	template<typename ValueType>
 	void SetGlobalValue(TSynchedKey key, const ValueType &value)
 	{
 		TSynchedValue _value; _value.Set(value);
 
-		bool changed=true;
-		std::pair<TStorage::iterator, bool> result=m_globalStorage.insert(TStorage::value_type(key, _value));
-		if (!result.second)
-		{
-			if ((result.first->second.GetType()==_value.GetType()) && (*result.first->second.GetPtr<ValueType>()==value))
-				changed=false;
-			else
-				result.first->second=_value;
-		}
-
-		if (changed)
+		if (StoreValue(CSynchedValueTable::eS_Global, 0, key, _value, value))
 			OnGlobalChanged(key, _value);
 	}
 
 	void SetGlobalValue(TSynchedKey key, const TSynchedValue &value)
 	{
-		bool changed=true; // always true since we can't compare two TSynchedValue
-		std::pair<TStorage::iterator, bool> result=m_globalStorage.insert(TStorage::value_type(key, value));
-		if (!result.second)
-			result.first->second=value;
+		StoreValue(CSynchedValueTable::eS_Global, 0, key, value);
 
-		if (changed)
-			OnGlobalChanged(key, value);
+		OnGlobalChanged(key, value); // always changed since we can't compare two TSynchedValue
 	}
 
 	template<typename ValueType>
@@ -96,37 +126,25 @@ public:
 	{
 		TSynchedValue _value; _value.Set(value);
 
-		TStorage *pStorage=GetChannelStorage(channelId, true);
-		if (!pStorage)
+		CSynchedValueTable::EScope scope;
+		uint32 owner;
+		if (!GetChannelOwner(channelId, scope, owner))
 			return;
 
-		bool changed=true;
-		std::pair<TStorage::iterator, bool> result=pStorage->insert(TStorage::value_type(key, _value));
-		if (!result.second)
-		{
-			if ((result.first->second.GetType()==_value.GetType()) && (*result.first->second.GetPtr<ValueType>()==value))
-				changed=false;
-			else
-				result.first->second=_value;
-		}
-
-		if (changed)
+		if (StoreValue(scope, owner, key, _value, value))
 			OnChannelChanged(channelId, key, _value);
 	}
 
 	void SetChannelValue(int channelId, TSynchedKey key, const TSynchedValue &value)
 	{
-		TStorage *pStorage=GetChannelStorage(channelId, true);
-		if (!pStorage)
+		CSynchedValueTable::EScope scope;
+		uint32 owner;
+		if (!GetChannelOwner(channelId, scope, owner))
 			return;
 
-		bool changed=true; // always true since we can't compare two TSynchedValue
-		std::pair<TStorage::iterator, bool> result=pStorage->insert(TStorage::value_type(key, value));
-		if (!result.second)
-			result.first->second=value;
+		StoreValue(scope, owner, key, value);
 
-		if (changed)
-			OnChannelChanged(channelId, key, value);
+		OnChannelChanged(channelId, key, value); // always changed since we can't compare two TSynchedValue
 	}
 
 	template<typename ValueType>
@@ -134,208 +152,117 @@ public:
 	{
 		TSynchedValue _value; _value.Set(value);
 
-		TStorage *pStorage=GetEntityStorage(id, true);
-
-		bool changed=true;
-		std::pair<TStorage::iterator, bool> result=pStorage->insert(TStorage::value_type(key, _value));
-		if (!result.second)
-		{
-			if ((result.first->second.GetType()==_value.GetType()) && (*result.first->second.GetPtr<ValueType>()==value))
-				changed=false;
-			else
-				result.first->second=_value;
-		}
-
-		if (changed)
+		if (StoreValue(CSynchedValueTable::eS_Entity, id, key, _value, value))
 			OnEntityChanged(id, key, _value);
 	}
 
 	void SetEntityValue(EntityId id, TSynchedKey key, const TSynchedValue &value)
 	{
-		TStorage *pStorage=GetEntityStorage(id, true);
-
-		bool changed=true; // always true since we can't compare two TSynchedValue
-		std::pair<TStorage::iterator, bool> result=pStorage->insert(TStorage::value_type(key, value));
-		if (!result.second)
-			result.first->second=value;
+		StoreValue(CSynchedValueTable::eS_Entity, id, key, value);
 
-		if (changed)
-			OnEntityChanged(id, key, value);
+		OnEntityChanged(id, key, value); // always changed since we can't compare two TSynchedValue
 	}
 
 	template<typename ValueType>
 	bool GetGlobalValue(TSynchedKey key, ValueType &value) const
 	{
-		TStorage::const_iterator it=m_globalStorage.find(key);
-		if (it==m_globalStorage.end())
-			return false;
-
-		value=*it->second.GetPtr<ValueType>();
-
-		return true;
+		return CopyValue(m_values.Find(CSynchedValueTable::eS_Global, 0, key), value);
 	}
 
-	bool GetGlobalValue(TSynchedKey key, TSynchedValue &value) const
+	template<typename ValueType>
+	bool GetChannelValue(int channelId, TSynchedKey key, ValueType &value) const
 	{
-		TStorage::const_iterator it=m_globalStorage.find(key);
-		if (it==m_globalStorage.end())
+		CSynchedValueTable::EScope scope;
+		uint32 owner;
+		if (!GetChannelOwner(channelId, scope, owner))
 			return false;
 
-		value=it->second;
+		return CopyValue(m_values.Find(scope, owner, key), value);
+	}
 
-		return true;
+	template<typename ValueType>
+	bool GetChannelValue(TSynchedKey key, ValueType &value) const
+	{
+		return CopyValue(m_values.Find(CSynchedValueTable::eS_LocalChannel, 0, key), value);
 	}
 
 	template<typename ValueType>
-	bool GetChannelValue(int channelId, TSynchedKey key, ValueType &value) const
+	bool GetEntityValue(EntityId entityId, TSynchedKey key, ValueType &value) const
 	{
-		if (!gEnv->bServer)
-			return false;
+		return CopyValue(m_values.Find(CSynchedValueTable::eS_Entity, entityId, key), value);
+	}
 
-		const TStorage *pStorage=0;
-		TChannelStorageMap::const_iterator cit=m_channelStorageMap.find(channelId);
-		if (cit!=m_channelStorageMap.end())
-			pStorage=&cit->second;
-		else
-		{
-			INetChannel *pNetChannel=m_pGameFramework->GetNetChannel(channelId);
-			if (pNetChannel && pNetChannel->IsLocal())
-				pStorage=&m_channelStorage;
-		}
-		
-		if (!pStorage)
-			return false;
+	int GetGlobalValueType(TSynchedKey key) const
+	{
+		const TSynchedValue *pValue=m_values.Find(CSynchedValueTable::eS_Global, 0, key);
 
-		TStorage::const_iterator it=pStorage->find(key);
-		if (it==pStorage->end())
-			return false;
+		return pValue?pValue->GetType():eSVT_None;
+	}
 
-		value=*it->second.GetPtr<ValueType>();
+	int GetEntityValueType(EntityId id, TSynchedKey key) const
+	{
+		const TSynchedValue *pValue=m_values.Find(CSynchedValueTable::eS_Entity, id, key);
 
-		return true;
+		return pValue?pValue->GetType():eSVT_None;
 	}
 
-	bool GetChannelValue(int channelId, TSynchedKey key, TSynchedValue &value) const
-	{
-		const TStorage *pStorage=0;
-		TChannelStorageMap::const_iterator cit=m_channelStorageMap.find(channelId);
-		if (cit!=m_channelStorageMap.end())
-			pStorage=&cit->second;
-		else
-		{
-			INetChannel *pNetChannel=m_pGameFramework->GetNetChannel(channelId);
-			if (pNetChannel && pNetChannel->IsLocal())
-				pStorage=&m_channelStorage;
-		}
-
-		if (!pStorage)
-			return false;
+	virtual void Reset();
 
-		TStorage::const_iterator it=pStorage->find(key);
-		if (it==pStorage->end())
-			return false;
+	virtual void Dump();
+
+	virtual void SerializeValue(TSerialize ser, TSynchedKey &key, TSynchedValue &value, int type);
+	virtual void SerializeEntityValue(TSerialize ser, EntityId id, TSynchedKey &key, TSynchedValue &value, int type);
 
-		value=it->second;
+	// where the values of a channel are kept, fails for remote channels on clients
+	virtual bool GetChannelOwner(int channelId, CSynchedValueTable::EScope &scope, uint32 &owner) const;
 
-		return true;
-	}
+	virtual void OnGlobalChanged(TSynchedKey key, const TSynchedValue &value) {};
+	virtual void OnChannelChanged(int channelId, TSynchedKey key, const TSynchedValue &value) {};
+	virtual void OnEntityChanged(EntityId id, TSynchedKey key, const TSynchedValue &value) {};
 
+	void GetStorageMemoryStatistics(ICrySizer * s) const;
+
+protected:
 	template<typename ValueType>
-	bool GetChannelValue(TSynchedKey key, ValueType &value) const
+	bool StoreValue(CSynchedValueTable::EScope scope, uint32 owner, TSynchedKey key, const TSynchedValue &_value, const ValueType &value)
 	{
-		TStorage::const_iterator it=m_channelStorage.find(key);
-		if (it==m_channelStorage.end())
+		bool inserted;
+		TSynchedValue &stored=m_values.Insert(scope, owner, key, inserted);
+		if (!inserted && (stored.GetType()==_value.GetType()) && (*stored.GetPtr<ValueType>()==value))
 			return false;
 
-		value=*it->second.GetPtr<ValueType>();
-
+		stored=_value;
 		return true;
 	}
 
-	bool GetChannelValue(TSynchedKey key, TSynchedValue &value) const
+	void StoreValue(CSynchedValueTable::EScope scope, uint32 owner, TSynchedKey key, const TSynchedValue &value)
 	{
-		TStorage::const_iterator it=m_channelStorage.find(key);
-		if (it==m_channelStorage.end())
-			return false;
-
-		value=it->second;
-
-		return true;
+		bool inserted;
+		m_values.Insert(scope, owner, key, inserted)=value;
 	}
 
 	template<typename ValueType>
-	bool GetEntityValue(EntityId entityId, TSynchedKey key, ValueType &value) const
+	static bool CopyValue(const TSynchedValue *pValue, ValueType &value)
 	{
-		TEntityStorageMap::const_iterator eit=m_entityStorage.find(entityId);
-		if (eit==m_entityStorage.end())
+		if (!pValue)
 			return false;
 
-		TStorage::const_iterator it=eit->second.find(key);
-		if (it==eit->second.end())
-			return false;
-
-		value=*it->second.GetPtr<ValueType>();
+		value=*pValue->GetPtr<ValueType>();
 
 		return true;
 	}
 
-	bool GetEntityValue(EntityId entityId, TSynchedKey key, TSynchedValue &value) const
+	static bool CopyValue(const TSynchedValue *pValue, TSynchedValue &value)
 	{
-		TEntityStorageMap::const_iterator eit=m_entityStorage.find(entityId);
-		if (eit==m_entityStorage.end())
-			return false;
-
-		TStorage::const_iterator it=eit->second.find(key);
-		if (it==eit->second.end())
+		if (!pValue)
 			return false;
 
-		value=it->second;
+		value=*pValue;
 
 		return true;
 	}
 
-	int GetGlobalValueType(TSynchedKey key) const
-	{
-		TStorage::const_iterator it=m_globalStorage.find(key);
-		if (it==m_globalStorage.end())
-			return eSVT_None;
-
-		return it->second.GetType();
-	}
-
-	int GetEntityValueType(EntityId id, TSynchedKey key) const
-	{
-		TEntityStorageMap::const_iterator eit=m_entityStorage.find(id);
-		if (eit==m_entityStorage.end())
-			return eSVT_None;
-
-		TStorage::const_iterator it=eit->second.find(key);
-		if (it==eit->second.end())
-			return eSVT_None;
-
-		return it->second.GetType();
-	}
-
-	virtual void Reset();
-
-	virtual void Dump();
-
-	virtual void SerializeValue(TSerialize ser, TSynchedKey &key, TSynchedValue &value, int type);
-	virtual void SerializeEntityValue(TSerialize ser, EntityId id, TSynchedKey &key, TSynchedValue &value, int type);
-
-	virtual TStorage *GetEntityStorage(EntityId id, bool create=false);
-	virtual TStorage *GetChannelStorage(int channelId, bool create=false);
-
-	virtual void OnGlobalChanged(TSynchedKey key, const TSynchedValue &value) {};
-	virtual void OnChannelChanged(int channelId, TSynchedKey key, const TSynchedValue &value) {};
-	virtual void OnEntityChanged(EntityId id, TSynchedKey key, const TSynchedValue &value) {};
-
-	void GetStorageMemoryStatistics(ICrySizer * s) const;
-
-	TStorage						m_globalStorage;
-	TStorage						m_channelStorage;
-	TChannelStorageMap	m_channelStorageMap;
-	TEntityStorageMap		m_entityStorage;
+	CSynchedValueTable	m_values;
 
 	IGameFramework			*m_pGameFramework;
 };
@@ -18,6 +18,7 @@ History:
 
 #include "IVehicleSystem.h"
 #include "VehicleMovementAmphibious.h"
+#include "GameNetProfiler.h"
 
 
 #define THREAD_SAFE 1
@@ -212,6 +213,7 @@ void CVehicleMovementAmphibiousT<Wheeled>::ProcessMovement(const float deltaTime
 template <class Wheeled>
 void CVehicleMovementAmphibiousT<Wheeled>::Serialize(TSerialize ser, EEntityAspects aspects) 
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, this->m_pEntity, aspects);
 	Wheeled::Serialize(ser, aspects);  
 
 	if (ser.GetSerializationTarget() != eST_Network)
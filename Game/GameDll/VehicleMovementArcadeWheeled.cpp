@@ -18,6 +18,7 @@ handling from the engine default
 #include "GameCVars.h"
 
 #include "VehicleMovementArcadeWheeled.h"
+#include "GameNetProfiler.h"
 
 #include "IVehicleSystem.h"
 #include "Network/NetActionSync.h"
@@ -27,6 +28,7 @@ handling from the engine default
 #include "Player.h"
 
 #include "NetInputChainDebug.h"
+#include "WaterQueryCache.h"
 
 DEFINE_SHARED_PARAMS_TYPE_INFO(CVehicleMovementArcadeWheeled::SSharedParams);
 
@@ -2063,7 +2065,8 @@ void CVehicleMovementArcadeWheeled::EnableLowLevelPhysics(int state, int bThread
 	}
 }
 
-static inline void SolveFriction(Vec3& dVel, Vec3& dAngVel, const Vec3& vel, const Vec3& angVel, SVehicleChassis* c, SVehicleWheel* w, ClampedImpulse* maxTractionImpulse, ClampedImpulse* maxLateralImpulse, float solverERP, float dt)
+// The denominators only depend on the wheel frame and are computed once per tick by ArcadeWheelsComputeFrames
+static inline void SolveFriction(Vec3& dVel, Vec3& dAngVel, const Vec3& vel, const Vec3& angVel, SVehicleChassis* c, SVehicleWheel* w, const SArcadeWheelLanes& lanes, int i, ClampedImpulse* maxTractionImpulse, ClampedImpulse* maxLateralImpulse, float solverERP, float dt)
 {
 	Vec3 wheelVel = vel + angVel.cross(w->worldOffset);
 
@@ -2071,19 +2074,19 @@ static inline void SolveFriction(Vec3& dVel, Vec3& dAngVel, const Vec3& vel, con
 	if (!w->locked)
 	{
 		float slipSpeed = -w->w * w->radius + wheelVel.dot(w->frictionDir[0]);
-		float denom = w->invMass + w->radius * w->radius * w->invInertia;
+		float denom = lanes.wheelDenom[i];
 		float impulse = clampedImpulseApply(maxTractionImpulse, solverERP * slipSpeed / denom);
 		w->w += impulse * w->radius * w->invInertia;
 		float velChange = - impulse * w->invMass;	// This is the vel change imparted on just the wheel
 		// Bring velChange back to zero by applying impulse to chassis
-		denom = w->invMass + computeDenominator(c->invMass, c->invInertia, w->worldOffset, w->frictionDir[0]);
+		denom = w->invMass + lanes.inlineDenom[i];
 		impulse = velChange / denom;
 		addImpulseAtOffset(dVel, dAngVel, c->invMass, c->invInertia, w->worldOffset, impulse * w->frictionDir[0]);
 	}
 	else
 	{
 		float slipSpeed = wheelVel.dot(w->frictionDir[0]);
-		float denom = computeDenominator(c->invMass, c->invInertia, w->worldOffset, w->frictionDir[0]);
+		float denom = lanes.inlineDenom[i];
 		float impulse = clampedImpulseApply(maxTractionImpulse, -solverERP*slipSpeed / denom);
 		addImpulseAtOffset(dVel, dAngVel, c->invMass, c->invInertia, w->worldOffset, impulse * w->frictionDir[0]);
 	}
@@ -2091,7 +2094,7 @@ static inline void SolveFriction(Vec3& dVel, Vec3& dAngVel, const Vec3& vel, con
 	// Lateral
 	{
 		float errorV = wheelVel.dot(w->frictionDir[1]);
-		float denom = computeDenominator(c->invMass, c->invInertia, w->worldOffset, w->frictionDir[1]);
+		float denom = lanes.lateralDenom[i];
 		float impulse0 = -solverERP * errorV / denom;
 		float impulse = clampedImpulseApply(maxLateralImpulse, impulse0);
 		Vec3 impulseV = impulse * w->frictionDir[1];
@@ -2363,25 +2366,56 @@ void CVehicleMovementArcadeWheeled::InternalPhysicsTick(float dt)
 
 		if (numWheelsThatCanHadnBrake) handBrakeForce /= (float)numWheelsThatCanHadnBrake;
 
+		// Wheel frames, slip speeds and solver denominators, four wheels at a time
+		SArcadeWheelLanes& lanes = m_wheelLanes;
+		lanes.numWheels = numWheels;
+		for (int i=0; i<numWheels; i++)
+		{
+			const SVehicleWheel* w = &m_wheels[i];
+			const pe_status_wheel& status = m_wheelStatus[i];
+			const Vec3 statusNormal = status.bContact ? status.normContact : Vec3Constants<float>::fVec3_Zero;
+			lanes.offsetX[i] = w->offset.x;
+			lanes.offsetY[i] = w->offset.y;
+			lanes.offsetZ[i] = w->offset.z;
+			lanes.cosSteer[i] = cosf(status.steer);
+			lanes.sinSteer[i] = sinf(status.steer);
+			lanes.statusNormalX[i] = statusNormal.x;
+			lanes.statusNormalY[i] = statusNormal.y;
+			lanes.statusNormalZ[i] = statusNormal.z;
+			lanes.radius[i] = w->radius;
+			lanes.w[i] = w->w;
+			lanes.invMass[i] = w->invMass;
+			lanes.invInertia[i] = w->invInertia;
+		}
+		lanes.ClearPadding();
+
+		SArcadeChassisFrame chassisFrame;
+		chassisFrame.xAxis = xAxis;
+		chassisFrame.yAxis = yAxis;
+		chassisFrame.zAxis = zAxis;
+		chassisFrame.vel = vel;
+		chassisFrame.angVel = angVel;
+		chassisFrame.contactNormal = m_handling.contactNormal;
+		chassisFrame.invMass = c->invMass;
+		chassisFrame.invInertia = c->invInertia;
+
+		// CryAction ticks the vehicles one at a time, so the batch is this vehicle alone
+		SArcadeWheelBatchItem batchItem = { &chassisFrame, &lanes };
+		ArcadeWheelsComputeFrames(&batchItem, 1);
+
 
 		for (int i=0; i<numWheels; i++)
 		{
 			SVehicleWheel* w = &m_wheels[i];
 
-			w->contactNormal = m_handling.contactNormal;
-			if (m_wheelStatus[i].bContact) w->contactNormal = w->contactNormal + m_wheelStatus[i].normContact;
-			//w->contactNormal = w->contactNormal - axis*(axis.dot(w->contactNormal));
-			w->contactNormal.normalize();
+			w->contactNormal.Set(lanes.contactNormalX[i], lanes.contactNormalY[i], lanes.contactNormalZ[i]);
+			w->worldOffset.Set(lanes.worldOffsetX[i], lanes.worldOffsetY[i], lanes.worldOffsetZ[i]);
 
-			w->worldOffset = bodyRot * w->offset;
-			Vec3 axis = (xAxis * cosf(m_wheelStatus[i].steer)) - (yAxis * sinf(m_wheelStatus[i].steer));
+			// Inline and lateral direction
+			w->frictionDir[0].Set(lanes.inlineDirX[i], lanes.inlineDirY[i], lanes.inlineDirZ[i]);
+			w->frictionDir[1].Set(lanes.lateralDirX[i], lanes.lateralDirY[i], lanes.lateralDirZ[i]);
 
-			// Calc inline and lateral direction
-			w->frictionDir[0] = (w->contactNormal.cross(axis)).normalize();
-			w->frictionDir[1] = (w->frictionDir[0].cross(w->contactNormal)).normalize(); //axis;
-
-			Vec3 wheelVel = vel + angVel.cross(w->worldOffset);
-			w->slipSpeed = fabsf(wheelVel.dot(w->frictionDir[0]) - w->w*w->radius);
+			w->slipSpeed = lanes.slipSpeed[i];
 
 			if (lockAllWheels || (m_action.bHandBrake & w->bCanLock))
 			{
@@ -2487,7 +2521,7 @@ void CVehicleMovementArcadeWheeled::InternalPhysicsTick(float dt)
 			for (int i=0; i<numWheels; i++)
 			{
 				SVehicleWheel* w = &m_wheels[i];
-				SolveFriction(dVel, dAngVel, vel, angVel, &m_chassis, w, &maxTractionImpulse[i], &maxLateralImpulse[i], solverERP, dt);
+				SolveFriction(dVel, dAngVel, vel, angVel, &m_chassis, w, lanes, i, &maxTractionImpulse[i], &maxLateralImpulse[i], solverERP, dt);
 			}
 			vel = vel + dVel;
 			angVel = angVel + dAngVel;
@@ -2500,7 +2534,7 @@ void CVehicleMovementArcadeWheeled::InternalPhysicsTick(float dt)
 					SVehicleWheel* w = &m_wheels[i];
 					dVel.zero();
 					dAngVel.zero();
-					SolveFriction(dVel, dAngVel, vel, angVel, &m_chassis, w, &maxTractionImpulse[i], &maxLateralImpulse[i], solverERP, dt);
+					SolveFriction(dVel, dAngVel, vel, angVel, &m_chassis, w, lanes, i, &maxTractionImpulse[i], &maxLateralImpulse[i], solverERP, dt);
 					vel = vel + dVel;
 					angVel = angVel + dAngVel;
 				}
@@ -2637,9 +2671,7 @@ void CVehicleMovementArcadeWheeled::UpdateWaterLevels()
 
 		if(GetPhysics()->GetStatus(&wheelStatus))
 		{
-			I3DEngine	*p3DEngine = gEnv->p3DEngine;
-
-			m_wheels[m_iWaterLevelUpdate].waterLevel = gEnv->p3DEngine->GetWaterLevel(&wheelStatus.ptContact);
+			m_wheels[m_iWaterLevelUpdate].waterLevel = g_pGame->GetWaterQueryCache().GetWaterLevel(wheelStatus.ptContact);
 		}
 		else
 		{
@@ -2851,6 +2883,7 @@ void CVehicleMovementArcadeWheeled::GetMovementState(SMovementState& movementSta
 //------------------------------------------------------------------------
 void CVehicleMovementArcadeWheeled::Serialize(TSerialize ser, EEntityAspects aspects) 
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, m_pEntity, aspects);
 	MEMSTAT_CONTEXT(EMemStatContextTypes::MSC_Other, 0, "Vehicle movement arcade wheeled serialization");
 
 	CVehicleMovementBase::Serialize(ser, aspects);
@@ -2900,8 +2933,8 @@ void CVehicleMovementArcadeWheeled::UpdateSurfaceEffects(const float deltaTime)
 	if (status.speed < 0.01f)
 		return;
 
-	float distSq = m_pVehicle->GetEntity()->GetWorldPos().GetSquaredDistance(gEnv->pRenderer->GetCamera().GetPosition());
-	if (distSq > sqr(300.f) || (distSq > sqr(50.f) && !m_isProbablyVisible ))
+	const float lodCountScale = UpdateSurfaceEffectLod(m_isProbablyVisible);
+	if (lodCountScale <= 0.f)
 		return;
 
 	IPhysicalEntity* pPhysics = GetPhysics();
@@ -3040,10 +3073,10 @@ void CVehicleMovementArcadeWheeled::UpdateSurfaceEffects(const float deltaTime)
 		if (matId != emitterIt->matId)
 		{
 			// change effect                        
-			const char* effect = GetEffectByIndex(matId, layer.GetName());
-			IParticleEffect* pEff = 0;   
+			const char* effect = 0;
+			IParticleEffect* pEff = GetSurfaceParticleEffect(matId, emitterIt->layer, effect);
 
-			if (effect && (pEff = gEnv->pParticleManager->FindEffect(effect)))
+			if (pEff)
 			{     
 #if ENABLE_VEHICLE_DEBUG
 				if (DebugParticles())          
@@ -3088,7 +3121,7 @@ void CVehicleMovementArcadeWheeled::UpdateSurfaceEffects(const float deltaTime)
 		{
 			SpawnParams sp;
 			sp.fSizeScale = sizeScale;
-			sp.fCountScale = countScale;
+			sp.fCountScale = countScale * lodCountScale;
 			sp.fSpeedScale = speedScale;
 			info.pParticleEmitter->SetSpawnParams(sp);
 		}
@@ -19,6 +19,7 @@ History:
 #include "Network/NetActionSync.h"
 #include "IVehicleSystem.h"
 #include "VehicleMovementBase.h"
+#include "ArcadeWheelLanes.h"
 
 
 
@@ -363,6 +364,8 @@ protected:
 	int             m_numWheels;
 	float           m_invNumWheels;
 
+	SArcadeWheelLanes	m_wheelLanes;		// per tick wheel frames and solver denominators
+
 	float m_invTurningRadius;
 
 	//------------------------------------------------------------------------------
@@ -13,6 +13,7 @@ History:
 *************************************************************************/
 #include "StdAfx.h"
 #include "VehicleMovementBase.h"
+#include "GameNetProfiler.h"
 
 #include "Game.h"
 #include "GameCVars.h"
@@ -22,6 +23,7 @@ History:
 #include <IEffectSystem.h>
 #include "GameUtils.h"
 #include "VehicleClient.h"
+#include "VehicleSurfaceEffectCache.h"
 
 #define RUNSOUND_FADEIN_TIME 0.5f
 #define RUNSOUND_FADEOUT_TIME 0.5f
@@ -70,6 +72,8 @@ m_soundMasterVolume(1.f),
 m_dampAngle(ZERO),
 m_dampAngVel(ZERO),
 m_pPaParams(NULL),
+m_surfaceEffectClass(-1),
+m_surfaceEffectLod(eSEL_Full),
 m_engineDisabledTimerId(-1),
 m_engineDisabledFXId(-1),
 m_engineStartingForceFeedbackFxId(InvalidForceFeedbackFxId),
@@ -119,6 +123,7 @@ bool CVehicleMovementBase::Init(IVehicle* pVehicle, const CVehicleParams& table)
 
 	// init particles
 	m_pPaParams = m_pVehicle->GetParticleParams();  
+	m_surfaceEffectClass = g_pGame->GetVehicleSurfaceEffectCache().GetClassHandle(m_pEntity->GetClass(), m_pVehicle->GetModification(), m_pPaParams ? m_pPaParams->GetEnvironmentParticles() : NULL);
 	InitExhaust();    
 
 	for (int i=0; i<eVMA_Max; ++i)
@@ -1742,6 +1747,15 @@ SMFXResourceListPtr CVehicleMovementBase::GetEffectNode(int matId)
 	if (matId <= 0)
 		return 0;
 
+	if (CVehicleSurfaceEffectCache::SSurface* pSurface = g_pGame->GetVehicleSurfaceEffectCache().GetSurface(m_surfaceEffectClass, matId))
+	{
+#if ENABLE_VEHICLE_DEBUG
+		if (!pSurface->pResources && DebugParticles())
+			CryLog("GetEffectString for %s -> %i failed", m_pPaParams->GetEnvironmentParticles()->GetMFXRowName(), matId);
+#endif
+		return pSurface->pResources;
+	}
+
 	if(IMaterialEffects *mfx = g_pGame->GetIGameFramework()->GetIMaterialEffects())
 	{
 		const char* mfxRow = m_pVehicle->GetParticleParams()->GetEnvironmentParticles()->GetMFXRowName();
@@ -1785,6 +1799,7 @@ const char* CVehicleMovementBase::GetEffectByIndex(int matId, const char* userna
 //------------------------------------------------------------------------
 float CVehicleMovementBase::GetSurfaceSoundParam(int matId)
 { 
+	// the resource list comes from the shared cache, the sound info is per vehicle
 	SMFXResourceListPtr pResourceList = GetEffectNode(matId);
 
 	if (pResourceList.get() && pResourceList->m_soundList)
@@ -1804,6 +1819,54 @@ float CVehicleMovementBase::GetSurfaceSoundParam(int matId)
 	return 0.f;  
 }
 
+//------------------------------------------------------------------------
+IParticleEffect* CVehicleMovementBase::GetSurfaceParticleEffect(int matId, int layer, const char*& effectName)
+{
+	if (const CVehicleSurfaceEffectCache::SLayerEffect* pLayerEffect = g_pGame->GetVehicleSurfaceEffectCache().GetLayerEffect(m_surfaceEffectClass, matId, layer))
+	{
+		effectName = pLayerEffect->pEffectName;
+		return pLayerEffect->pEffect;
+	}
+
+	// surface id out of the cached range
+	effectName = GetEffectByIndex(matId, m_pPaParams->GetEnvironmentParticles()->GetLayer(layer).GetName());
+
+	return effectName ? gEnv->pParticleManager->FindEffect(effectName) : NULL;
+}
+
+//------------------------------------------------------------------------
+float CVehicleMovementBase::UpdateSurfaceEffectLod(bool isVisible)
+{
+	const float cullDistSq = sqr(300.f);
+	const float hiddenCullDistSq = sqr(50.f);
+
+	const float distSq = m_pEntity->GetWorldPos().GetSquaredDistance(gEnv->pRenderer->GetCamera().GetPosition());
+
+	ESurfaceEffectLod lod = eSEL_Full;
+	if (distSq > cullDistSq || (distSq > hiddenCullDistSq && !isVisible))
+		lod = eSEL_Culled;
+	else if (distSq > sqr(g_pGameCVars->v_pa_surface_lodDist))
+		lod = eSEL_Reduced;
+
+	if (lod == eSEL_Culled && m_surfaceEffectLod != eSEL_Culled)
+	{
+		// stop the emitters rather than leaving them spawning with the last parameters
+		RemoveSurfaceEffects();
+	}
+
+	m_surfaceEffectLod = lod;
+
+	switch (lod)
+	{
+	case eSEL_Reduced:
+		return g_pGameCVars->v_pa_surface_lodCountScale;
+	case eSEL_Culled:
+		return 0.f;
+	default:
+		return 1.f;
+	}
+}
+
 
 //------------------------------------------------------------------------
 void CVehicleMovementBase::InitSurfaceEffects()
@@ -1932,8 +1995,8 @@ void CVehicleMovementBase::UpdateSurfaceEffects(const float deltaTime)
 	if (status.speed < 0.01f)
 		return;
 
-	float distSq = m_pVehicle->GetEntity()->GetWorldPos().GetSquaredDistance(gEnv->pRenderer->GetCamera().GetPosition());
-	if (distSq > sqr(300.f) || (distSq > sqr(50.f) && !m_isProbablyVisible))
+	const float lodCountScale = UpdateSurfaceEffectLod(m_isProbablyVisible);
+	if (lodCountScale <= 0.f)
 		return;
 
 	float powerNorm = CLAMP(abs(m_movementAction.power), 0.f, 1.f);
@@ -1967,7 +2030,7 @@ void CVehicleMovementBase::UpdateSurfaceEffects(const float deltaTime)
 			}
 
 			emitterIt->pGroundEffect->Stop(false);
-			emitterIt->pGroundEffect->SetBaseScale(sizeScale, countScale, speedScale);
+			emitterIt->pGroundEffect->SetBaseScale(sizeScale, countScale * lodCountScale, speedScale);
 			emitterIt->pGroundEffect->Update();      
 		}   
 	}
@@ -2293,6 +2356,7 @@ void CVehicleMovementBase::DebugDraw(const float deltaTime)
 //------------------------------------------------------------------------
 void CVehicleMovementBase::Serialize(TSerialize ser, EEntityAspects aspects)
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, m_pEntity, aspects);
 	// SVehicleMovementAction m_movementAction;
 
 	if (ser.GetSerializationTarget() != eST_Network)
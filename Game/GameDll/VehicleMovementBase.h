@@ -412,6 +412,10 @@ protected:
 	SMFXResourceListPtr GetEffectNode(int matId);
 	const char* GetEffectByIndex(int matId, const char* username);
 	float GetSurfaceSoundParam(int matId);
+	IParticleEffect* GetSurfaceParticleEffect(int matId, int layer, const char*& effectName);
+
+	// distance/visibility LOD of the surface effects, returns the count scale to apply (0 when culled)
+	float UpdateSurfaceEffectLod(bool isVisible);
 
 	virtual bool GenerateWind() { return true; }
 	void InitWind();
@@ -467,6 +471,15 @@ protected:
 
 	SParticleParams* m_pPaParams;
 	SParticleStatus m_paStats;
+	int m_surfaceEffectClass; // handle into the vehicle surface effect cache
+
+	enum ESurfaceEffectLod
+	{
+		eSEL_Full = 0,
+		eSEL_Reduced,
+		eSEL_Culled,
+	};
+	ESurfaceEffectLod m_surfaceEffectLod;
 	SSurfaceSoundStatus m_surfaceSoundStats;
 	SMovementSoundStatus m_soundStats;
 
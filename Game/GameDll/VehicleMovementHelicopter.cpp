@@ -18,6 +18,7 @@ History:
 #include "IMovementController.h"
 #include "IVehicleSystem.h"
 #include "VehicleMovementHelicopter.h"
+#include "GameNetProfiler.h"
 #include "VehicleActionLandingGears.h"
 #include "ICryAnimation.h"
 #include "GameUtils.h"
@@ -1163,6 +1164,7 @@ bool CVehicleMovementHelicopter::RequestMovement(CMovementRequest& movementReque
 //------------------------------------------------------------------------
 void CVehicleMovementHelicopter::Serialize(TSerialize ser, EEntityAspects aspects)
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, m_pEntity, aspects);
 	CVehicleMovementBase::Serialize(ser, aspects);
 
 	if ((ser.GetSerializationTarget() == eST_Network) &&(aspects & eEA_GameClientDynamic))
@@ -17,6 +17,7 @@ History:
 #include <StlUtils.h>
 #include "IVehicleSystem.h"
 #include "VehicleMovementHovercraft.h"
+#include "GameNetProfiler.h"
 #include "GameCVars.h"
 
 #define PE_ACTION_THREAD_SAFE 0
@@ -863,6 +864,7 @@ void CVehicleMovementHovercraft::GetMemoryUsage(ICrySizer * s) const
 //------------------------------------------------------------------------
 void CVehicleMovementHovercraft::Serialize(TSerialize ser, EEntityAspects aspects)
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, m_pEntity, aspects);
   CVehicleMovementBase::Serialize(ser, aspects);
 
   if (ser.GetSerializationTarget() == eST_Network)
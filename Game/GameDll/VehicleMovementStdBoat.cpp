@@ -17,6 +17,7 @@ History:
 
 #include "IVehicleSystem.h"
 #include "VehicleMovementStdBoat.h"
+#include "GameNetProfiler.h"
 #include <IAgent.h>
 #include "Network/NetActionSync.h"
 
@@ -416,8 +417,8 @@ void CVehicleMovementStdBoat::UpdateSurfaceEffects(const float deltaTime)
 	IEntity* pEntity = m_pVehicle->GetEntity();
 	const Matrix34& worldTM = pEntity->GetWorldTM();
 
-	float distSq = worldTM.GetTranslation().GetSquaredDistance(gEnv->pRenderer->GetCamera().GetPosition());
-	if (distSq > sqr(300.f) || (distSq > sqr(50.f) && !m_pVehicle->GetGameObject()->IsProbablyVisible()))
+	const float lodCountScale = UpdateSurfaceEffectLod(m_pVehicle->GetGameObject()->IsProbablyVisible());
+	if (lodCountScale <= 0.f)
 		return;
 
 	Matrix34 worldTMInv = worldTM.GetInverted();
@@ -476,10 +477,10 @@ void CVehicleMovementStdBoat::UpdateSurfaceEffects(const float deltaTime)
 		if (matId && matId != emitterIt->matId)
 		{
 			// change effect       
-			IParticleEffect* pEff = 0;                
-			const char* effect = GetEffectByIndex( matId, layer.GetName() );
+			const char* effect = 0;
+			IParticleEffect* pEff = GetSurfaceParticleEffect(matId, emitterIt->layer, effect);
 
-			if (effect && (pEff = gEnv->pParticleManager->FindEffect(effect)))
+			if (pEff)
 			{  
 #if ENABLE_VEHICLE_DEBUG
 				if (DebugParticles())              
@@ -511,7 +512,7 @@ void CVehicleMovementStdBoat::UpdateSurfaceEffects(const float deltaTime)
 		{
 			SpawnParams sp;
 			sp.fSizeScale = sizeScale;
-			sp.fCountScale = countScale;    
+			sp.fCountScale = countScale * lodCountScale;    
 			sp.fSpeedScale = speedScale;
 			info.pParticleEmitter->SetSpawnParams(sp);
 
@@ -1061,6 +1062,7 @@ bool CVehicleMovementStdBoat::RequestMovement(CMovementRequest& movementRequest)
 //------------------------------------------------------------------------
 void CVehicleMovementStdBoat::Serialize(TSerialize ser, EEntityAspects aspects) 
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, m_pEntity, aspects);
 	CVehicleMovementBase::Serialize(ser, aspects);
 
 	if (ser.GetSerializationTarget() == eST_Network) 
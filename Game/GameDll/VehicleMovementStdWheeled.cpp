@@ -16,6 +16,7 @@ History:
 #include "GameCVars.h"
 
 #include "VehicleMovementStdWheeled.h"
+#include "GameNetProfiler.h"
 
 #include "IVehicleSystem.h"
 #include "Network/NetActionSync.h"
@@ -1801,6 +1802,7 @@ void CVehicleMovementStdWheeled::GetMovementState(SMovementState& movementState)
 //------------------------------------------------------------------------
 void CVehicleMovementStdWheeled::Serialize(TSerialize ser, EEntityAspects aspects) 
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, m_pEntity, aspects);
 	CVehicleMovementBase::Serialize(ser, aspects);
 
 	if (ser.GetSerializationTarget() == eST_Network)
@@ -1841,8 +1843,8 @@ void CVehicleMovementStdWheeled::UpdateSurfaceEffects(const float deltaTime)
 	if (status.speed < 0.01f)
 		return;
 
-	float distSq = m_pVehicle->GetEntity()->GetWorldPos().GetSquaredDistance(gEnv->pRenderer->GetCamera().GetPosition());
-	if (distSq > sqr(300.f) || (distSq > sqr(50.f) && !m_pVehicle->GetGameObject()->IsProbablyVisible()))
+	const float lodCountScale = UpdateSurfaceEffectLod(m_pVehicle->GetGameObject()->IsProbablyVisible());
+	if (lodCountScale <= 0.f)
 		return;
 
 	IPhysicalEntity* pPhysics = GetPhysics();
@@ -1979,10 +1981,10 @@ void CVehicleMovementStdWheeled::UpdateSurfaceEffects(const float deltaTime)
 		if (matId != emitterIt->matId)
 		{
 			// change effect                        
-			const char* effect = GetEffectByIndex(matId, layer.GetName());
-			IParticleEffect* pEff = 0;   
+			const char* effect = 0;
+			IParticleEffect* pEff = GetSurfaceParticleEffect(matId, emitterIt->layer, effect);
 
-			if (effect && (pEff = gEnv->pParticleManager->FindEffect(effect)))
+			if (pEff)
 			{      
 #if ENABLE_VEHICLE_DEBUG
 				if (DebugParticles())          
@@ -2027,7 +2029,7 @@ void CVehicleMovementStdWheeled::UpdateSurfaceEffects(const float deltaTime)
 		{
 			SpawnParams sp;
 			sp.fSizeScale = sizeScale;
-			sp.fCountScale = countScale;
+			sp.fCountScale = countScale * lodCountScale;
 			sp.fSpeedScale = speedScale;
 			info.pParticleEmitter->SetSpawnParams(sp);
 		}
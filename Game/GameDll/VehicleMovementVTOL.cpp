@@ -20,6 +20,7 @@ History:
 
 #include "IVehicleSystem.h"
 #include "VehicleMovementVTOL.h"
+#include "GameNetProfiler.h"
 #include "VehicleActionLandingGears.h"
 
 #include "IRenderAuxGeom.h"
@@ -966,6 +967,7 @@ void CVehicleMovementVTOL::GetMemoryUsage(ICrySizer * s) const
 //------------------------------------------------------------------------
 void CVehicleMovementVTOL::Serialize(TSerialize ser, EEntityAspects aspects)
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, m_pEntity, aspects);
 	CVehicleMovementHelicopter::Serialize(ser, aspects);
 
 	if ((ser.GetSerializationTarget() == eST_Network) &&(aspects & eEA_GameClientDynamic))
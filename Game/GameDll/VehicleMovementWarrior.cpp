@@ -16,6 +16,7 @@ History:
 #include "GameUtils.h"
 #include "IVehicleSystem.h"
 #include "VehicleMovementWarrior.h"
+#include "GameNetProfiler.h"
 
 
 enum 
@@ -376,6 +377,7 @@ void CVehicleMovementWarrior::StopEngine()
 //------------------------------------------------------------------------
 void CVehicleMovementWarrior::Serialize(TSerialize ser, EEntityAspects aspects)
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, m_pEntity, aspects);
   CVehicleMovementHovercraft::Serialize(ser, aspects);
 
   if (ser.GetSerializationTarget() != eST_Network)
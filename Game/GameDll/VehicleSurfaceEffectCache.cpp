@@ -0,0 +1,153 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Surface effect cache shared by all vehicles of an entity class and
+modification.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "VehicleSurfaceEffectCache.h"
+#include "Game.h"
+#include <IVehicleSystem.h>
+
+//------------------------------------------------------------------------
+CVehicleSurfaceEffectCache::CVehicleSurfaceEffectCache()
+{
+}
+
+//------------------------------------------------------------------------
+int CVehicleSurfaceEffectCache::GetClassHandle(const IEntityClass* pClass, const char* modification, const SEnvironmentParticles* pEnvParams)
+{
+	if (!pClass || !pEnvParams)
+		return -1;
+
+	if (!modification)
+		modification = "";
+
+	const int numClasses = (int)m_classes.size();
+	for (int i = 0; i < numClasses; ++i)
+	{
+		if (m_classes[i].pClass == pClass && m_classes[i].modification == modification)
+			return i;
+	}
+
+	m_classes.push_back(SClassEffects());
+
+	SClassEffects& classEffects = m_classes.back();
+	classEffects.pClass = pClass;
+	classEffects.modification = modification;
+	classEffects.mfxRow = pEnvParams->GetMFXRowName();
+
+	const int numLayers = (int)pEnvParams->GetLayerCount();
+	classEffects.layerNames.reserve(numLayers);
+	for (int i = 0; i < numLayers; ++i)
+		classEffects.layerNames.push_back(pEnvParams->GetLayer(i).GetName());
+
+	return numClasses;
+}
+
+//------------------------------------------------------------------------
+CVehicleSurfaceEffectCache::SSurface* CVehicleSurfaceEffectCache::GetSurface(int classHandle, int matId)
+{
+	if (classHandle < 0 || classHandle >= (int)m_classes.size() || matId < 0 || matId >= eMaxSurfaceId)
+		return NULL;
+
+	SClassEffects& classEffects = m_classes[classHandle];
+
+	if (matId < (int)classEffects.surfaces.size() && classEffects.surfaces[matId].resolved)
+		return &classEffects.surfaces[matId];
+
+	return ResolveSurface(classEffects, matId);
+}
+
+//------------------------------------------------------------------------
+const CVehicleSurfaceEffectCache::SLayerEffect* CVehicleSurfaceEffectCache::GetLayerEffect(int classHandle, int matId, int layer)
+{
+	SSurface* pSurface = GetSurface(classHandle, matId);
+	if (!pSurface)
+		return NULL;
+
+	SClassEffects& classEffects = m_classes[classHandle];
+
+	const int numLayers = (int)classEffects.layerNames.size();
+	if (layer < 0 || layer >= numLayers)
+		return NULL;
+
+	SLayerEffect& layerEffect = classEffects.layerEffects[matId * numLayers + layer];
+
+	if (!layerEffect.resolved)
+	{
+		layerEffect.resolved = true;
+
+		if (pSurface->pResources)
+		{
+			// same match as the resource list walk in CVehicleMovementBase::GetEffectByIndex
+			const char* layerName = classEffects.layerNames[layer].c_str();
+			SMFXParticleListNode* pList = pSurface->pResources->m_particleList;
+
+			while (pList && pList->m_particleParams.userdata && 0 != strcmp(pList->m_particleParams.userdata, layerName))
+				pList = pList->pNext;
+
+			if (pList && pList->m_particleParams.name)
+			{
+				layerEffect.pEffectName = pList->m_particleParams.name;
+				layerEffect.pEffect = gEnv->pParticleManager->FindEffect(layerEffect.pEffectName);
+			}
+		}
+	}
+
+	return &layerEffect;
+}
+
+//------------------------------------------------------------------------
+CVehicleSurfaceEffectCache::SSurface* CVehicleSurfaceEffectCache::ResolveSurface(SClassEffects& classEffects, int matId)
+{
+	if (matId >= (int)classEffects.surfaces.size())
+	{
+		classEffects.surfaces.resize(matId + 1);
+		classEffects.layerEffects.resize((matId + 1) * classEffects.layerNames.size());
+	}
+
+	SSurface& surface = classEffects.surfaces[matId];
+	surface.resolved = true;
+
+	IMaterialEffects* pMaterialEffects = g_pGame->GetIGameFramework()->GetIMaterialEffects();
+	if (matId > 0 && pMaterialEffects)
+	{
+		TMFXEffectId effectId = pMaterialEffects->GetEffectId(classEffects.mfxRow.c_str(), matId);
+		if (effectId != InvalidEffectId)
+			surface.pResources = pMaterialEffects->GetResources(effectId);
+	}
+
+	return &surface;
+}
+
+//------------------------------------------------------------------------
+void CVehicleSurfaceEffectCache::Reset()
+{
+	for (TClassEffects::iterator it = m_classes.begin(); it != m_classes.end(); ++it)
+	{
+		stl::free_container(it->surfaces);
+		stl::free_container(it->layerEffects);
+	}
+}
+
+//------------------------------------------------------------------------
+void CVehicleSurfaceEffectCache::GetMemoryStatistics(ICrySizer* s) const
+{
+	s->Add(*this);
+	s->AddContainer(m_classes);
+	for (TClassEffects::const_iterator it = m_classes.begin(); it != m_classes.end(); ++it)
+	{
+		s->Add(it->modification);
+		s->Add(it->mfxRow);
+		s->AddContainer(it->layerNames);
+		s->AddContainer(it->surfaces);
+		s->AddContainer(it->layerEffects);
+	}
+}
@@ -0,0 +1,84 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Surface effect cache shared by all vehicles of an entity class and
+modification.
+Maps the surface id under a wheel/hull to the material effect resource
+list of the class' MFX row and to the particle effect of each
+environment layer. Entries are resolved on first use and kept until the
+level is unloaded, so changing surface becomes an array lookup instead of
+a material effects query.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __VEHICLESURFACEEFFECTCACHE_H__
+#define __VEHICLESURFACEEFFECTCACHE_H__
+
+#pragma once
+
+#include "IMaterialEffects.h"
+
+struct SEnvironmentParticles;
+
+class CVehicleSurfaceEffectCache
+{
+public:
+	enum
+	{
+		eMaxSurfaceId = 512,		// surface ids at or above this aren't cached
+	};
+
+	struct SSurface
+	{
+		SSurface() : resolved(false) {}
+
+		SMFXResourceListPtr	pResources;
+		bool								resolved;
+	};
+
+	struct SLayerEffect
+	{
+		SLayerEffect() : pEffectName(NULL), resolved(false) {}
+
+		const char*									pEffectName;		// points into the resource list of the surface
+		_smart_ptr<IParticleEffect>	pEffect;
+		bool												resolved;
+	};
+
+	CVehicleSurfaceEffectCache();
+
+	// returns the handle of the class and modification, -1 if they have no environment particles
+	int		GetClassHandle(const IEntityClass* pClass, const char* modification, const SEnvironmentParticles* pEnvParams);
+
+	// NULL for surface ids out of the cached range
+	SSurface*						GetSurface(int classHandle, int matId);
+	const SLayerEffect*	GetLayerEffect(int classHandle, int matId, int layer);
+
+	// drops the resolved entries, class handles stay valid
+	void	Reset();
+
+	void	GetMemoryStatistics(ICrySizer* s) const;
+
+private:
+	struct SClassEffects
+	{
+		const IEntityClass*				pClass;
+		string										modification;		// modifications can change the MFX row and the layers
+		string										mfxRow;
+		std::vector<string>				layerNames;
+		std::vector<SSurface>			surfaces;				// indexed by surface id
+		std::vector<SLayerEffect>	layerEffects;		// indexed by surface id * layer count + layer
+	};
+
+	typedef std::vector<SClassEffects> TClassEffects;
+
+	SSurface*	ResolveSurface(SClassEffects& classEffects, int matId);
+
+	TClassEffects	m_classes;
+};
+
+#endif //__VEHICLESURFACEEFFECTCACHE_H__
@@ -0,0 +1,151 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Frame scoped cache for water level and water bottom queries.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#include "StdAfx.h"
+#include "WaterQueryCache.h"
+#include "GameCVars.h"
+#include "Utility/CryWatch.h"
+
+//------------------------------------------------------------------------
+CWaterQueryCache::CWaterQueryCache()
+: m_frameId(0)
+, m_invCellSize(1.0f)
+, m_hits(0)
+, m_misses(0)
+{
+	Reset();
+}
+
+//------------------------------------------------------------------------
+void CWaterQueryCache::Reset()
+{
+	for (int i = 0; i < eTableSize; ++i)
+	{
+		m_entries[i].key = 0;
+		m_entries[i].frameId = -1;
+	}
+
+	m_hits = 0;
+	m_misses = 0;
+}
+
+//------------------------------------------------------------------------
+void CWaterQueryCache::Update()
+{
+#if CRY_WATCH_ENABLED
+	if (g_pGameCVars->g_waterQueryCache_debug)
+		CryWatch("WaterQueryCache: %d hits, %d engine queries", m_hits, m_misses);
+#endif
+
+	// bumping the frame id invalidates every entry at once
+	++m_frameId;
+	m_hits = 0;
+	m_misses = 0;
+
+	const float cellSize = g_pGameCVars->g_waterQueryCache_cellSize;
+	m_invCellSize = (cellSize > 0.0f) ? 1.0f / cellSize : 0.0f;
+}
+
+//------------------------------------------------------------------------
+uint64 CWaterQueryCache::MakeKey(const Vec3& pos, EQueryType type) const
+{
+	// 20 bits per cell coordinate in disjoint ranges: type in bits 0-1, z 2-21, y 22-41, x 42-61
+	const uint64 x = (uint64)(int_round(pos.x * m_invCellSize) & 0xfffff);
+	const uint64 y = (uint64)(int_round(pos.y * m_invCellSize) & 0xfffff);
+	const uint64 z = (uint64)(int_round(pos.z * m_invCellSize) & 0xfffff);
+
+	// bit 63 is never set by a coordinate, the key is never 0 so a cleared entry can't match
+	return (x << 42) | (y << 22) | (z << 2) | ((uint64)type & 0x3) | ((uint64)1 << 63);
+}
+
+//------------------------------------------------------------------------
+CWaterQueryCache::SEntry* CWaterQueryCache::FindEntry(uint64 key, float maxRelevantDepth, bool& found)
+{
+	uint32 h = (uint32)(key ^ (key >> 29) ^ (key >> 47));
+	h = stl::hash_uint32()(h);
+
+	for (int i = 0; i < eMaxProbes; ++i)
+	{
+		SEntry& entry = m_entries[(h + i) & eTableMask];
+		if (entry.frameId != m_frameId)
+		{
+			found = false;
+			return &entry;
+		}
+		if (entry.key == key && entry.maxRelevantDepth == maxRelevantDepth)
+		{
+			found = true;
+			return &entry;
+		}
+	}
+
+	// neighbourhood is full, caller queries the engine directly
+	found = false;
+	return NULL;
+}
+
+//------------------------------------------------------------------------
+float CWaterQueryCache::GetWaterLevel(const Vec3& pos)
+{
+	if (m_invCellSize <= 0.0f)
+		return gEnv->p3DEngine->GetWaterLevel(&pos);
+
+	const uint64 key = MakeKey(pos, eQT_WaterLevel);
+
+	bool found;
+	SEntry* pEntry = FindEntry(key, 0.0f, found);
+	if (found)
+	{
+		++m_hits;
+		return pEntry->value;
+	}
+
+	++m_misses;
+	const float waterLevel = gEnv->p3DEngine->GetWaterLevel(&pos);
+	if (pEntry)
+	{
+		pEntry->key = key;
+		pEntry->frameId = m_frameId;
+		pEntry->maxRelevantDepth = 0.0f;
+		pEntry->value = waterLevel;
+	}
+
+	return waterLevel;
+}
+
+//------------------------------------------------------------------------
+float CWaterQueryCache::GetBottomLevel(const Vec3& pos, float maxRelevantDepth)
+{
+	if (m_invCellSize <= 0.0f)
+		return gEnv->p3DEngine->GetBottomLevel(pos, maxRelevantDepth);
+
+	const uint64 key = MakeKey(pos, eQT_BottomLevel);
+
+	bool found;
+	SEntry* pEntry = FindEntry(key, maxRelevantDepth, found);
+	if (found)
+	{
+		++m_hits;
+		return pEntry->value;
+	}
+
+	++m_misses;
+	const float bottomLevel = gEnv->p3DEngine->GetBottomLevel(pos, maxRelevantDepth);
+	if (pEntry)
+	{
+		pEntry->key = key;
+		pEntry->frameId = m_frameId;
+		pEntry->maxRelevantDepth = maxRelevantDepth;
+		pEntry->value = bottomLevel;
+	}
+
+	return bottomLevel;
+}
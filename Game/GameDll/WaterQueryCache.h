@@ -0,0 +1,68 @@
+/*************************************************************************
+Crytek Source File.
+Copyright (C), Crytek Studios, 2001-2010.
+-------------------------------------------------------------------------
+Description:
+Frame scoped cache for water level and water bottom queries.
+Queries are snapped to a grid cell; the first request for a cell in a
+frame goes to the 3D engine, every other request for the same cell in
+that frame is served from the cache.
+
+-------------------------------------------------------------------------
+History:
+
+*************************************************************************/
+#ifndef __WATERQUERYCACHE_H__
+#define __WATERQUERYCACHE_H__
+
+#pragma once
+
+class CWaterQueryCache
+{
+public:
+	CWaterQueryCache();
+
+	// call once per frame before any game object update
+	void	Update();
+	void	Reset();
+
+	float	GetWaterLevel(const Vec3& pos);
+	float	GetBottomLevel(const Vec3& pos, float maxRelevantDepth);
+
+	void	GetMemoryStatistics(ICrySizer* s) const { s->Add(*this); }
+
+private:
+	enum
+	{
+		eTableSize = 256,				// must be a power of two
+		eTableMask = eTableSize - 1,
+		eMaxProbes = 8,
+	};
+
+	enum EQueryType
+	{
+		eQT_WaterLevel = 0,
+		eQT_BottomLevel,
+	};
+
+	struct SEntry
+	{
+		uint64	key;
+		int			frameId;
+		float		maxRelevantDepth;
+		float		value;
+	};
+
+	uint64	MakeKey(const Vec3& pos, EQueryType type) const;
+	SEntry*	FindEntry(uint64 key, float maxRelevantDepth, bool& found);
+
+	SEntry	m_entries[eTableSize];
+	int			m_frameId;
+	float		m_invCellSize;
+
+	// stats for the last frame, shown with g_waterQueryCache_debug
+	int			m_hits;
+	int			m_misses;
+};
+
+#endif //__WATERQUERYCACHE_H__
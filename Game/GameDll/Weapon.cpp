@@ -21,6 +21,7 @@ History:
 #include <IVehicleSystem.h>
 #include "WeaponSystem.h"
 #include "Weapon.h"
+#include "GameNetProfiler.h"
 #include "ISerialize.h"
 #include "ScriptBind_Weapon.h"
 #include "Player.h"
@@ -572,6 +573,7 @@ static int calcNumShots(uint8 prevCount, uint8 newCount)
 //------------------------------------------------------------------------
 bool CWeapon::NetSerialize( TSerialize ser, EEntityAspects aspect, uint8 profile, int flags )
 {
+	GAME_NET_PROFILE_SERIALIZE(ser, GetEntity(), aspect);
 	if (!CItem::NetSerialize(ser, aspect, profile, flags))
 		return false;
 
@@ -11,6 +11,7 @@
 
 *************************************************************************/
 #include "StdAfx.h"
+#include "GameNetProfiler.h"
 #include "Weapon.h"
 #include "Actor.h"
 #include "Game.h"
@@ -492,6 +493,7 @@ void CWeapon::RequestSetZoomState(bool zoomed)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestStartFire)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestStartFire);
 	CHECK_OWNER_REQUEST();
 
 	CActor *pActor=GetActorByNetChannel(pNetChannel);
@@ -510,6 +512,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestStartFire)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestStopFire)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestStopFire);
 	CHECK_OWNER_REQUEST();
 
 	CActor *pActor=GetActorByNetChannel(pNetChannel);
@@ -528,6 +531,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestStopFire)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestShoot)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestShoot);
 	CHECK_OWNER_REQUEST();
 
 	bool ok=true;
@@ -557,6 +561,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestShoot)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestShootEx)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestShootEx);
 	CHECK_OWNER_REQUEST();
 
 	bool ok=true;
@@ -587,6 +592,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestShootEx)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestStartMeleeAttack)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestStartMeleeAttack);
 	CHECK_OWNER_REQUEST();
 
 	CActor *pActor=GetActorByNetChannel(pNetChannel);
@@ -607,6 +613,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestStartMeleeAttack)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestFireMode)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestFireMode);
 	CHECK_OWNER_REQUEST();
 
 	SetCurrentFireMode(params.id);
@@ -617,6 +624,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestFireMode)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestReload)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestReload);
 	CHECK_OWNER_REQUEST();
 
 	bool ok=true;
@@ -639,6 +647,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestReload)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestCancelReload)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestCancelReload);
 	CHECK_OWNER_REQUEST();
 
 	SvCancelReload();
@@ -649,6 +658,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestCancelReload)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, ClLock)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, ClLock);
 	if (m_fm)
 		m_fm->Lock(params.entityId, params.partId);
 
@@ -658,6 +668,7 @@ IMPLEMENT_RMI(CWeapon, ClLock)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, ClUnlock)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, ClUnlock);
 	if (m_fm)
 		m_fm->Unlock();
 
@@ -668,6 +679,7 @@ IMPLEMENT_RMI(CWeapon, ClUnlock)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestLock)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestLock);
 	CHECK_OWNER_REQUEST();
 
 	if (m_fm)
@@ -681,6 +693,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestLock)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestUnlock)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestUnlock);
 	CHECK_OWNER_REQUEST();
 
 	if (m_fm)
@@ -694,6 +707,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestUnlock)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, SvRequestWeaponRaised)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestWeaponRaised);
 	CHECK_OWNER_REQUEST();
 
 	CHANGED_NETWORK_STATE(this, ASPECT_STREAM);
@@ -703,6 +717,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestWeaponRaised)
 
 IMPLEMENT_RMI(CWeapon, SvRequestSetZoomState)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestSetZoomState);
 	CHECK_OWNER_REQUEST();
 
 	if (params.zoomed)
@@ -717,6 +732,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestSetZoomState)
 
 IMPLEMENT_RMI(CWeapon, SvRequestZoom)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, SvRequestZoom);
 	CHECK_OWNER_REQUEST();
 
 	bool ok=true;
@@ -747,6 +763,7 @@ IMPLEMENT_RMI(CWeapon, SvRequestZoom)
 //------------------------------------------------------------------------
 IMPLEMENT_RMI(CWeapon, ClZoom)
 {
+	GAME_NET_PROFILE_RMI(CWeapon, ClZoom);
 	NetZoom(params.fov);
 
 	return true;